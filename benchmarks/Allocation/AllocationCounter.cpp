@@ -0,0 +1,130 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::uint64_t> s_allocations{ 0U };
+    std::atomic<std::uint64_t> s_deallocations{ 0U };
+    std::atomic<std::uint64_t> s_bytes{ 0U };
+    std::atomic<bool> s_isBudgetExceeded{ false };
+}
+
+namespace kmMqtt
+{
+    bool isAllocationCountingEnabled() noexcept
+    {
+#ifdef KMMQTT_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    AllocationCount getAllocationCount() noexcept
+    {
+        AllocationCount count;
+        count.allocations = s_allocations.load(std::memory_order_relaxed);
+        count.deallocations = s_deallocations.load(std::memory_order_relaxed);
+        count.bytes = s_bytes.load(std::memory_order_relaxed);
+        return count;
+    }
+
+    void markAllocationBudgetExceeded() noexcept
+    {
+        s_isBudgetExceeded = true;
+    }
+
+    bool wasAllocationBudgetExceeded() noexcept
+    {
+        return s_isBudgetExceeded;
+    }
+}
+
+#ifdef KMMQTT_COUNT_ALLOCATIONS
+
+//Replacements for the global allocation functions, every other form of new and delete forwards to these.
+
+namespace
+{
+    void* countedAllocate(std::size_t size) noexcept
+    {
+        s_allocations.fetch_add(1U, std::memory_order_relaxed);
+        s_bytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size == 0U ? 1U : size);
+    }
+
+    void countedFree(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+        {
+            s_deallocations.fetch_add(1U, std::memory_order_relaxed);
+            std::free(ptr);
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    void* ptr{ countedAllocate(size) };
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    countedFree(ptr);
+}
+
+#endif //KMMQTT_COUNT_ALLOCATIONS
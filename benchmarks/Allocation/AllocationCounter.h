@@ -0,0 +1,38 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef BENCHMARKS_ALLOCATION_ALLOCATIONCOUNTER_H
+#define BENCHMARKS_ALLOCATION_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+namespace kmMqtt
+{
+    /**
+     * @brief Heap traffic through the global operator new and delete since the process started.
+     */
+    struct AllocationCount
+    {
+        std::uint64_t allocations{ 0U };
+        std::uint64_t deallocations{ 0U };
+        std::uint64_t bytes{ 0U }; //Bytes requested from operator new, frees are not subtracted.
+    };
+
+    /**
+     * @brief True when the benchmarks are built with ENABLE_ALLOCATION_COUNTING and operator new and delete are replaced
+     * with counting versions. Otherwise getAllocationCount() always returns zeros.
+     */
+    bool isAllocationCountingEnabled() noexcept;
+
+    AllocationCount getAllocationCount() noexcept;
+
+    /**
+     * @brief Record that an allocation budget was exceeded, the benchmark executable then exits with a failure code.
+     */
+    void markAllocationBudgetExceeded() noexcept;
+    bool wasAllocationBudgetExceeded() noexcept;
+}
+
+#endif //BENCHMARKS_ALLOCATION_ALLOCATIONCOUNTER_H
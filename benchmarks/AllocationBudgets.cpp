@@ -0,0 +1,157 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include "Allocation/AllocationCounter.h"
+#include "Loopback/LoopbackClient.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+#ifdef KMMQTT_COUNT_ALLOCATIONS
+
+//Heap allocations per operation on the steady state path of a TickMode::SYNC client, counted by the replaced global
+//operator new (ENABLE_ALLOCATION_COUNTING). A benchmark fails, and the executable exits with 1, when its average goes
+//over its budget.
+//
+//Budgets are the counts at the time they were set with the default SBO options, plus headroom for allocations amortized
+//over a batch (broker stand-in read chunks, buffer growth). Lower a budget together with the change that removes an
+//allocation, so it cannot come back unnoticed.
+
+static constexpr std::size_t k_operationsPerIteration{ 1000U };
+static constexpr std::size_t k_payloadSize{ 16U }; //Fits in the ByteBuffer SBO, the payload itself does not allocate.
+
+static constexpr double k_publishQos0Budget{ 14.5 };
+static constexpr double k_publishQos1Budget{ 22.5 };
+static constexpr double k_receiveQos0Budget{ 10.5 };
+static constexpr double k_receiveQos1Budget{ 11.5 };
+
+static void checkAllocationBudget(benchmark::State& state, const AllocationCount& before, std::size_t operations, double budget)
+{
+    const AllocationCount after{ getAllocationCount() };
+
+    const double allocationsPerOperation{ static_cast<double>(after.allocations - before.allocations) / static_cast<double>(operations) };
+    const double bytesPerOperation{ static_cast<double>(after.bytes - before.bytes) / static_cast<double>(operations) };
+
+    state.counters["allocs_per_op"] = allocationsPerOperation;
+    state.counters["bytes_per_op"] = bytesPerOperation;
+    state.counters["budget"] = budget;
+
+    if (allocationsPerOperation > budget)
+    {
+        markAllocationBudgetExceeded();
+        state.SkipWithError(("Allocation budget exceeded: " + std::to_string(allocationsPerOperation) +
+            " allocations per operation, budget " + std::to_string(budget) + ".").c_str());
+    }
+}
+
+static void publishBatch(LoopbackClient& loopback, Qos qos)
+{
+    const std::vector<std::uint8_t> payloadBytes(k_payloadSize, 0xA5U);
+
+    for (std::size_t i = 0; i < k_operationsPerIteration; ++i)
+    {
+        ByteBuffer payload{ k_payloadSize };
+        payload.append(payloadBytes.data(), k_payloadSize);
+
+        PublishOptions options;
+        options.qos = qos;
+
+        loopback.client.publish("bench/allocations", std::move(payload), std::move(options));
+    }
+}
+
+//QoS 0 publish, until the broker read it. QoS 1 publish, until its PUBACK was received and the publish completed.
+static void BM_Allocations_Publish(benchmark::State& state)
+{
+    const Qos qos{ static_cast<Qos>(state.range(0)) };
+    const double budget{ qos == Qos::QOS_0 ? k_publishQos0Budget : k_publishQos1Budget };
+
+    LoopbackClient loopback;
+
+    std::atomic<std::size_t> completed{ 0U };
+    loopback.client.onPublishCompletedEvent().add([&](const PublishCompleteEventDetails&)
+        {
+            completed.fetch_add(1U, std::memory_order_relaxed);
+        });
+
+    std::size_t target{ 0U };
+    const auto runBatch = [&]()
+        {
+            target += k_operationsPerIteration;
+            publishBatch(loopback, qos);
+            loopback.tickUntil([&]()
+                {
+                    return (qos == Qos::QOS_0 ? loopback.broker->publishesReceived.load() : completed.load()) >= target;
+                });
+        };
+
+    //Grow queues, pools and buffers to their steady state size first.
+    runBatch();
+
+    const AllocationCount before{ getAllocationCount() };
+
+    for (auto _ : state)
+    {
+        runBatch();
+    }
+
+    checkAllocationBudget(state, before, static_cast<std::size_t>(state.iterations()) * k_operationsPerIteration, budget);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * k_operationsPerIteration));
+}
+
+//Received publish, until its callback ran and, for QoS 1, the client's PUBACK reached the broker.
+static void BM_Allocations_Receive(benchmark::State& state)
+{
+    const std::uint8_t qos{ static_cast<std::uint8_t>(state.range(0)) };
+    const double budget{ qos == 0U ? k_receiveQos0Budget : k_receiveQos1Budget };
+
+    LoopbackClient loopback;
+
+    std::atomic<std::size_t> received{ 0U };
+    loopback.client.onPublishEvent().add([&](const PublishEventDetails&, const Publish&)
+        {
+            received.fetch_add(1U, std::memory_order_relaxed);
+        });
+
+    std::vector<std::uint8_t> batch;
+    for (std::size_t i = 0; i < k_operationsPerIteration; ++i)
+    {
+        LoopbackBroker::encodePublish(batch, "bench/allocations", k_payloadSize, qos, static_cast<std::uint16_t>(i + 1U));
+    }
+
+    std::size_t target{ 0U };
+    const auto runBatch = [&]()
+        {
+            loopback.broker->queueInbound(batch);
+            target += k_operationsPerIteration;
+            loopback.tickUntil([&]()
+                {
+                    return received.load() >= target && (qos == 0U || loopback.broker->acknowledgementsReceived.load() >= target);
+                });
+        };
+
+    runBatch();
+
+    const AllocationCount before{ getAllocationCount() };
+
+    for (auto _ : state)
+    {
+        runBatch();
+    }
+
+    checkAllocationBudget(state, before, static_cast<std::size_t>(state.iterations()) * k_operationsPerIteration, budget);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * k_operationsPerIteration));
+}
+
+BENCHMARK(BM_Allocations_Publish)->Arg(0)->Arg(1)->ArgName("qos")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Allocations_Receive)->Arg(0)->Arg(1)->ArgName("qos")->Unit(benchmark::kMillisecond);
+
+#endif //KMMQTT_COUNT_ALLOCATIONS
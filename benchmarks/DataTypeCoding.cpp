@@ -0,0 +1,124 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include <kmMqtt/Mqtt/Packets/DataTypes.h>
+#include <kmMqtt/Utils/Utils.h>
+#include <kmMqtt/ByteBuffer.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+static void BM_EncodeVariableByteInteger(benchmark::State& state)
+{
+    const VariableByteInteger value{ VariableByteInteger::tryCreateFromValue(static_cast<std::uint32_t>(state.range(0))) };
+    ByteBuffer buffer{ value.encodingSize() };
+
+    for (auto _ : state)
+    {
+        buffer.clear();
+        value.encode(buffer);
+        benchmark::DoNotOptimize(buffer.bytes());
+    }
+}
+
+static void BM_DecodeVariableByteInteger(benchmark::State& state)
+{
+    const VariableByteInteger value{ VariableByteInteger::tryCreateFromValue(static_cast<std::uint32_t>(state.range(0))) };
+    ByteBuffer buffer{ value.encodingSize() };
+    value.encode(buffer);
+
+    for (auto _ : state)
+    {
+        buffer.resetReadCursor();
+        const VariableByteInteger decoded{ VariableByteInteger::tryCreateFromBuffer(buffer) };
+        benchmark::DoNotOptimize(decoded.uint32Value());
+    }
+}
+
+static void BM_EncodeUTF8String(benchmark::State& state)
+{
+    const UTF8String value{ std::string(static_cast<std::size_t>(state.range(0)), 'a') };
+    ByteBuffer buffer{ value.encodingSize() };
+
+    for (auto _ : state)
+    {
+        buffer.clear();
+        value.encode(buffer);
+        benchmark::DoNotOptimize(buffer.bytes());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * value.encodingSize()));
+}
+
+static void BM_DecodeUTF8String(benchmark::State& state)
+{
+    const UTF8String value{ std::string(static_cast<std::size_t>(state.range(0)), 'a') };
+    ByteBuffer buffer{ value.encodingSize() };
+    value.encode(buffer);
+
+    for (auto _ : state)
+    {
+        buffer.resetReadCursor();
+        UTF8String decoded;
+        decoded.decode(buffer);
+        benchmark::DoNotOptimize(decoded);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * value.encodingSize()));
+}
+
+//Splits one socket read holding `packets` QoS 0 publishes with a 64 byte payload into one buffer per packet.
+static void BM_SeparateMqttPackets(benchmark::State& state)
+{
+    const std::size_t packetCount{ static_cast<std::size_t>(state.range(0)) };
+    const std::string topic{ "bench/separate" };
+    const std::size_t payloadSize{ 64U };
+    const std::size_t remainingLength{ 2U + topic.size() + 1U + payloadSize };
+
+    ByteBuffer read{ packetCount * (2U + remainingLength) };
+    for (std::size_t i = 0; i < packetCount; ++i)
+    {
+        read += 0x30U;
+        read += static_cast<std::uint8_t>(remainingLength);
+        read += static_cast<std::uint8_t>(topic.size() >> 8);
+        read += static_cast<std::uint8_t>(topic.size() & 0xFFU);
+        read.append(reinterpret_cast<const std::uint8_t*>(topic.data()), topic.size());
+        read += 0x00U; //No properties
+
+        for (std::size_t b = 0; b < payloadSize; ++b)
+        {
+            read += 0xA5U;
+        }
+    }
+
+    std::vector<ByteBuffer> packets;
+    packets.reserve(packetCount);
+
+    for (auto _ : state)
+    {
+        packets.clear();
+        read.resetReadCursor();
+
+        std::size_t leftOver{ 0U };
+        const bool isSuccess{ separateMqttPacketByteBuffers(read, packets, leftOver) };
+        benchmark::DoNotOptimize(isSuccess);
+        benchmark::DoNotOptimize(packets.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * packetCount));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * read.size()));
+}
+
+//Largest values encoded in 1, 2, 3 and 4 bytes.
+BENCHMARK(BM_EncodeVariableByteInteger)->Arg(127)->Arg(16383)->Arg(2097151)->Arg(268435455)->ArgName("value");
+BENCHMARK(BM_DecodeVariableByteInteger)->Arg(127)->Arg(16383)->Arg(2097151)->Arg(268435455)->ArgName("value");
+BENCHMARK(BM_EncodeUTF8String)->Arg(0)->Arg(8)->Arg(64)->Arg(1024)->Arg(65535)->ArgName("length");
+BENCHMARK(BM_DecodeUTF8String)->Arg(0)->Arg(8)->Arg(64)->Arg(1024)->Arg(65535)->ArgName("length");
+BENCHMARK(BM_SeparateMqttPackets)->Arg(1)->Arg(16)->Arg(256)->Arg(4096)->ArgName("packets");
@@ -0,0 +1,58 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include <kmMqtt/Utils/Event.h>
+
+using namespace kmMqtt;
+
+static events::Event<int> s_sharedEvent;
+
+template<int TId>
+static void addListener(events::Event<int>& event)
+{
+	event.add([](int v) { benchmark::DoNotOptimize(v + TId); });
+}
+
+static void addListeners(events::Event<int>& event, std::int64_t count)
+{
+	//Each listener needs a distinct type, Event dedups callbacks of the same lambda type.
+	if (count > 0) addListener<0>(event);
+	if (count > 1) addListener<1>(event);
+	if (count > 2) addListener<2>(event);
+	if (count > 3) addListener<3>(event);
+}
+
+static void BM_Invoke_Event(benchmark::State& state)
+{
+	events::Event<int> event;
+	addListeners(event, state.range(0));
+
+	int value{ 0 };
+	for (auto _ : state)
+	{
+		event.invoke(++value);
+	}
+}
+
+//Several threads firing the same event, as with a parallel callback dispatcher.
+static void BM_Invoke_Event_Contended(benchmark::State& state)
+{
+	if (state.thread_index() == 0)
+	{
+		s_sharedEvent.removeAll();
+		addListeners(s_sharedEvent, 1);
+	}
+
+	int value{ 0 };
+	for (auto _ : state)
+	{
+		s_sharedEvent.invoke(++value);
+	}
+}
+
+// Register benchmarks
+BENCHMARK(BM_Invoke_Event)->Arg(1)->Arg(4);
+BENCHMARK(BM_Invoke_Event_Contended)->Threads(1)->Threads(4);
@@ -0,0 +1,375 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "LoopbackBroker.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace kmMqtt
+{
+    namespace
+    {
+        constexpr std::size_t k_compactThreshold{ 1024U * 1024U };
+        constexpr std::uint16_t k_firstInboundPacketId{ 0x8000U };
+
+        void appendVariableByteInteger(std::vector<std::uint8_t>& out, std::size_t value)
+        {
+            do
+            {
+                std::uint8_t encodedByte{ static_cast<std::uint8_t>(value % 128U) };
+                value /= 128U;
+
+                if (value > 0U)
+                {
+                    encodedByte |= 0x80U;
+                }
+
+                out.push_back(encodedByte);
+            } while (value > 0U);
+        }
+
+        //Returns the number of bytes the integer takes, or 0 if it is not complete yet.
+        std::size_t readVariableByteInteger(const std::uint8_t* data, std::size_t size, std::size_t& outValue) noexcept
+        {
+            outValue = 0U;
+            std::size_t multiplier{ 1U };
+
+            for (std::size_t i = 0; i < size && i < 4U; ++i)
+            {
+                outValue += (data[i] & 0x7FU) * multiplier;
+                multiplier *= 128U;
+
+                if ((data[i] & 0x80U) == 0U)
+                {
+                    return i + 1U;
+                }
+            }
+
+            return 0U;
+        }
+
+        std::uint16_t readUint16(const std::uint8_t* data) noexcept
+        {
+            return static_cast<std::uint16_t>((data[0] << 8) | data[1]);
+        }
+    }
+
+    constexpr std::size_t LoopbackBroker::k_defaultReadChunkSize;
+
+    LoopbackBroker::~LoopbackBroker()
+    {
+        stopReaderThread();
+    }
+
+    void LoopbackBroker::startReaderThread()
+    {
+        std::lock_guard<std::mutex> guard{ m_outboundMutex };
+
+        if (m_isReaderRunning)
+        {
+            return;
+        }
+
+        m_isReaderRunning = true;
+        m_readerThread = std::thread{ [this]() { readerLoop(); } };
+    }
+
+    void LoopbackBroker::stopReaderThread()
+    {
+        {
+            std::lock_guard<std::mutex> guard{ m_outboundMutex };
+            m_isReaderRunning = false;
+        }
+
+        m_outboundCondition.notify_all();
+
+        if (m_readerThread.joinable() && m_readerThread.get_id() != std::this_thread::get_id())
+        {
+            m_readerThread.join();
+        }
+    }
+
+    void LoopbackBroker::setReadPaused(bool paused) noexcept
+    {
+        {
+            std::lock_guard<std::mutex> guard{ m_outboundMutex };
+            m_readPaused = paused;
+        }
+
+        m_outboundCondition.notify_all();
+    }
+
+    bool LoopbackBroker::connect(const mqtt::Address& address) noexcept
+    {
+        (void)address;
+
+        {
+            std::lock_guard<std::mutex> guard{ m_outboundMutex };
+            m_connected = true;
+        }
+
+        m_outboundCondition.notify_all();
+
+        if (m_onConnect)
+        {
+            m_onConnect(true);
+        }
+
+        return true;
+    }
+
+    int LoopbackBroker::send(const ByteBuffer& data) noexcept
+    {
+        if (!m_connected)
+        {
+            return -1;
+        }
+
+        std::unique_lock<std::mutex> lock{ m_outboundMutex };
+        m_stream.insert(m_stream.end(), data.bytes(), data.bytes() + data.size());
+
+        std::size_t offset{ 0U };
+        while (m_stream.size() - offset >= 2U)
+        {
+            std::size_t remainingLength{ 0U };
+            const std::size_t lengthBytes{ readVariableByteInteger(m_stream.data() + offset + 1U, m_stream.size() - offset - 1U, remainingLength) };
+            const std::size_t headerSize{ 1U + lengthBytes };
+
+            if (lengthBytes == 0U || m_stream.size() - offset < headerSize + remainingLength)
+            {
+                break;
+            }
+
+            handlePacket(m_stream.data() + offset, headerSize, remainingLength);
+            offset += headerSize + remainingLength;
+        }
+
+        m_stream.erase(m_stream.begin(), m_stream.begin() + static_cast<std::ptrdiff_t>(offset));
+
+        lock.unlock();
+        m_outboundCondition.notify_all();
+
+        return static_cast<int>(data.size());
+    }
+
+    bool LoopbackBroker::close() noexcept
+    {
+        if (m_connected)
+        {
+            {
+                std::lock_guard<std::mutex> guard{ m_outboundMutex };
+                m_connected = false;
+                m_stream.clear();
+                m_outbound.clear();
+                m_outboundReadOffset = 0U;
+            }
+
+            if (m_onDisconnect)
+            {
+                m_onDisconnect();
+            }
+        }
+
+        return true;
+    }
+
+    void LoopbackBroker::tick() noexcept
+    {
+        if (m_readerThread.joinable())
+        {
+            return;
+        }
+
+        ByteBuffer chunk{ 0U };
+        if (takeChunk(chunk) && m_onRecvd)
+        {
+            m_onRecvd(std::move(chunk));
+        }
+    }
+
+    bool LoopbackBroker::takeChunk(ByteBuffer& outChunk)
+    {
+        std::lock_guard<std::mutex> guard{ m_outboundMutex };
+
+        if (!m_connected || m_readPaused || m_outboundReadOffset >= m_outbound.size())
+        {
+            return false;
+        }
+
+        const std::size_t chunkSize{ std::min(m_readChunkSize, m_outbound.size() - m_outboundReadOffset) };
+        outChunk = ByteBuffer{ chunkSize };
+        outChunk.append(m_outbound.data() + m_outboundReadOffset, chunkSize);
+        m_outboundReadOffset += chunkSize;
+
+        if (m_outboundReadOffset == m_outbound.size())
+        {
+            m_outbound.clear();
+            m_outboundReadOffset = 0U;
+        }
+        else if (m_outboundReadOffset >= k_compactThreshold)
+        {
+            m_outbound.erase(m_outbound.begin(), m_outbound.begin() + static_cast<std::ptrdiff_t>(m_outboundReadOffset));
+            m_outboundReadOffset = 0U;
+        }
+
+        return true;
+    }
+
+    void LoopbackBroker::readerLoop()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock{ m_outboundMutex };
+                m_outboundCondition.wait(lock, [this]()
+                    {
+                        return !m_isReaderRunning || (m_connected && !m_readPaused && m_outboundReadOffset < m_outbound.size());
+                    });
+
+                if (!m_isReaderRunning)
+                {
+                    return;
+                }
+            }
+
+            ByteBuffer chunk{ 0U };
+            if (takeChunk(chunk) && m_onRecvd)
+            {
+                m_onRecvd(std::move(chunk));
+            }
+        }
+    }
+
+    void LoopbackBroker::queueInbound(const std::vector<std::uint8_t>& bytes)
+    {
+        {
+            std::lock_guard<std::mutex> guard{ m_outboundMutex };
+            m_outbound.insert(m_outbound.end(), bytes.begin(), bytes.end());
+        }
+
+        m_outboundCondition.notify_all();
+    }
+
+    void LoopbackBroker::encodePublish(std::vector<std::uint8_t>& out, const char* topic, std::size_t payloadSize, std::uint8_t qos, std::uint16_t packetId)
+    {
+        const std::size_t topicLength{ std::strlen(topic) };
+        const std::size_t packetIdSize{ qos > 0U ? 2U : 0U };
+
+        out.push_back(static_cast<std::uint8_t>(0x30U | (qos << 1)));
+        appendVariableByteInteger(out, 2U + topicLength + packetIdSize + 1U + payloadSize);
+        out.push_back(static_cast<std::uint8_t>(topicLength >> 8));
+        out.push_back(static_cast<std::uint8_t>(topicLength & 0xFFU));
+        out.insert(out.end(), topic, topic + topicLength);
+
+        if (qos > 0U)
+        {
+            out.push_back(static_cast<std::uint8_t>(packetId >> 8));
+            out.push_back(static_cast<std::uint8_t>(packetId & 0xFFU));
+        }
+
+        out.push_back(0x00U); //No properties
+        out.insert(out.end(), payloadSize, 0xA5U);
+    }
+
+    void LoopbackBroker::handlePacket(const std::uint8_t* packet, std::size_t headerSize, std::size_t remainingLength)
+    {
+        const std::uint8_t* body{ packet + headerSize };
+
+        switch (packet[0] >> 4)
+        {
+        case 1: //CONNECT
+        {
+            const std::uint8_t connAck[5]{ 0x20, 0x03, 0x00, 0x00, 0x00 };
+            m_outbound.insert(m_outbound.end(), connAck, connAck + sizeof(connAck));
+            break;
+        }
+        case 3: //PUBLISH
+        {
+            publishesReceived.fetch_add(1U, std::memory_order_relaxed);
+            bytesReceived.fetch_add(headerSize + remainingLength, std::memory_order_relaxed);
+
+            const std::uint8_t qos{ static_cast<std::uint8_t>((packet[0] >> 1) & 0x03U) };
+            const std::size_t packetIdOffset{ 2U + readUint16(body) };
+
+            if (qos > 0U)
+            {
+                reply(qos == 1U ? 0x40U : 0x50U, readUint16(body + packetIdOffset));
+            }
+
+            if (m_echo)
+            {
+                const std::size_t echoStart{ m_outbound.size() };
+                m_outbound.insert(m_outbound.end(), packet, packet + headerSize + remainingLength);
+
+                if (qos > 0U)
+                {
+                    const std::uint16_t inboundId{ nextInboundPacketId() };
+                    m_outbound[echoStart + headerSize + packetIdOffset] = static_cast<std::uint8_t>(inboundId >> 8);
+                    m_outbound[echoStart + headerSize + packetIdOffset + 1U] = static_cast<std::uint8_t>(inboundId & 0xFFU);
+                }
+            }
+            break;
+        }
+        case 4: //PUBACK
+        case 7: //PUBCOMP
+            acknowledgementsReceived.fetch_add(1U, std::memory_order_relaxed);
+            break;
+        case 5: //PUBREC for an echoed QoS 2 publish
+            reply(0x62U, readUint16(body));
+            break;
+        case 6: //PUBREL
+            reply(0x70U, readUint16(body));
+            break;
+        case 8: //SUBSCRIBE
+        {
+            std::size_t propertiesLength{ 0U };
+            std::size_t offset{ 2U };
+            offset += readVariableByteInteger(body + offset, remainingLength - offset, propertiesLength);
+            offset += propertiesLength;
+
+            std::vector<std::uint8_t> grantedQos;
+            while (offset + 2U < remainingLength)
+            {
+                offset += 2U + readUint16(body + offset);
+                grantedQos.push_back(body[offset] & 0x03U);
+                offset += 1U;
+            }
+
+            m_outbound.push_back(0x90U);
+            appendVariableByteInteger(m_outbound, 3U + grantedQos.size());
+            m_outbound.push_back(body[0]);
+            m_outbound.push_back(body[1]);
+            m_outbound.push_back(0x00U); //No properties
+            m_outbound.insert(m_outbound.end(), grantedQos.begin(), grantedQos.end());
+            break;
+        }
+        case 12: //PINGREQ
+            m_outbound.push_back(0xD0U);
+            m_outbound.push_back(0x00U);
+            break;
+        default: //DISCONNECT, AUTH... need no reply.
+            break;
+        }
+    }
+
+    void LoopbackBroker::reply(std::uint8_t fixedHeader, std::uint16_t packetId)
+    {
+        m_outbound.push_back(fixedHeader);
+        m_outbound.push_back(0x02U);
+        m_outbound.push_back(static_cast<std::uint8_t>(packetId >> 8));
+        m_outbound.push_back(static_cast<std::uint8_t>(packetId & 0xFFU));
+    }
+
+    std::uint16_t LoopbackBroker::nextInboundPacketId() noexcept
+    {
+        //Session state keys inbound QoS 2 and outbound publishes by packet ID alone, so echoed publishes take IDs from the
+        //upper half of the range, away from the client's own IDs, which are reused from the bottom.
+        m_lastInboundPacketId = m_lastInboundPacketId < k_firstInboundPacketId || m_lastInboundPacketId == 0xFFFFU
+            ? k_firstInboundPacketId
+            : static_cast<std::uint16_t>(m_lastInboundPacketId + 1U);
+        return m_lastInboundPacketId;
+    }
+}
@@ -0,0 +1,131 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef BENCHMARKS_LOOPBACK_LOOPBACKBROKER_H
+#define BENCHMARKS_LOOPBACK_LOOPBACKBROKER_H
+
+#include <kmMqtt/Interfaces/IMqttEnvironment.h>
+#include <kmMqtt/Interfaces/IWebSocket.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kmMqtt
+{
+    /**
+     * @brief In-process MQTT 5 broker stand-in, plugged into the client as its IWebSocket.
+     *
+     * Bytes sent by the client are split into packets and answered in line, as a broker with a single subscriber would:
+     * CONNECT -> CONNACK, PUBLISH QoS 1 -> PUBACK, PUBLISH QoS 2 -> PUBREC, PUBREL -> PUBCOMP, SUBSCRIBE -> SUBACK,
+     * PINGREQ -> PINGRESP. With echo enabled each received PUBLISH is also sent back to the client, and inbound QoS 2
+     * publishes are released when the client's PUBREC arrives.
+     *
+     * Replies are delivered in chunks of up to `readChunkSize` bytes, like reads from a real socket: on the next socket
+     * tick(), or from a reader thread once startReaderThread() is called, which wakes a TickMode::ASYNC client the way a
+     * real socket implementation would.
+     */
+    class LoopbackBroker : public IWebSocket
+    {
+    public:
+        static constexpr std::size_t k_defaultReadChunkSize{ 64U * 1024U };
+
+        ~LoopbackBroker() override;
+
+        bool connect(const mqtt::Address& address) noexcept override;
+        int send(const ByteBuffer& data) noexcept override;
+        bool close() noexcept override;
+        void tick() noexcept override;
+
+        void setReadPaused(bool paused) noexcept override;
+        bool isConnected() const noexcept override { return m_connected; }
+        int getLastError() const noexcept override { return 0; }
+        int getLastCloseCode() const noexcept override { return 0; }
+        const char* getLastCloseReason() const noexcept override { return ""; }
+        void setOnConnectCallback(OnConnectCallback cb) noexcept override { m_onConnect = std::move(cb); }
+        void setOnDisconnectCallback(OnDisconnectCallback cb) noexcept override { m_onDisconnect = std::move(cb); }
+        void setOnRecvdCallback(OnRecvdCallback cb) noexcept override { m_onRecvd = std::move(cb); }
+        void setOnErrorCallback(OnErrorCallback cb) noexcept override { m_onError = std::move(cb); }
+
+        /**
+         * @brief Send every PUBLISH received from the client back to it, with the same QoS.
+         */
+        void setEcho(bool echo) noexcept { m_echo = echo; }
+
+        void setReadChunkSize(std::size_t size) noexcept { m_readChunkSize = size; }
+
+        /**
+         * @brief Deliver replies from a dedicated thread as soon as they are queued, instead of on tick().
+         */
+        void startReaderThread();
+        void stopReaderThread();
+
+        /**
+         * @brief Queue bytes to be read by the client, e.g. a batch made with encodePublish().
+         */
+        void queueInbound(const std::vector<std::uint8_t>& bytes);
+
+        /**
+         * @brief Encode a PUBLISH as the broker would send it, with an empty property section.
+         * The packet ID is only written for QoS 1 and 2.
+         */
+        static void encodePublish(std::vector<std::uint8_t>& out, const char* topic, std::size_t payloadSize, std::uint8_t qos, std::uint16_t packetId);
+
+        std::atomic<std::size_t> publishesReceived{ 0U };
+        std::atomic<std::size_t> bytesReceived{ 0U };
+        std::atomic<std::size_t> acknowledgementsReceived{ 0U }; //PUBACK and PUBCOMP sent by the client for echoed or queued publishes.
+
+    private:
+        void handlePacket(const std::uint8_t* packet, std::size_t headerSize, std::size_t remainingLength);
+        void reply(std::uint8_t fixedHeader, std::uint16_t packetId);
+        std::uint16_t nextInboundPacketId() noexcept;
+        bool takeChunk(ByteBuffer& outChunk);
+        void readerLoop();
+
+        std::mutex m_outboundMutex;
+        std::condition_variable m_outboundCondition;
+        std::thread m_readerThread;
+        bool m_isReaderRunning{ false };
+
+        std::vector<std::uint8_t> m_stream;
+        std::vector<std::uint8_t> m_outbound;
+        std::size_t m_outboundReadOffset{ 0U };
+        std::size_t m_readChunkSize{ k_defaultReadChunkSize };
+        std::uint16_t m_lastInboundPacketId{ 0U };
+        std::atomic<bool> m_connected{ false };
+        bool m_readPaused{ false };
+        bool m_echo{ false };
+
+        OnConnectCallback m_onConnect;
+        OnDisconnectCallback m_onDisconnect;
+        OnRecvdCallback m_onRecvd;
+        OnErrorCallback m_onError;
+    };
+
+    /**
+     * @brief Environment handing a LoopbackBroker to the client as its socket.
+     */
+    class LoopbackEnvironment : public IMqttEnvironment
+    {
+    public:
+        Config createConfig() const noexcept override { return Config{}; }
+
+        std::shared_ptr<IWebSocket> createWebSocket() const noexcept override
+        {
+            auto broker{ std::make_shared<LoopbackBroker>() };
+            brokerPtr = broker.get();
+            return broker;
+        }
+
+        mutable LoopbackBroker* brokerPtr{ nullptr };
+    };
+}
+
+#endif //BENCHMARKS_LOOPBACK_LOOPBACKBROKER_H
@@ -0,0 +1,86 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef BENCHMARKS_LOOPBACK_LOOPBACKCLIENT_H
+#define BENCHMARKS_LOOPBACK_LOOPBACKCLIENT_H
+
+#include "LoopbackBroker.h"
+
+#include <kmMqtt/MqttClient.h>
+#include <kmMqtt/Logger/LoggerInstance.h>
+
+#include <thread>
+#include <utility>
+
+namespace kmMqtt
+{
+    /**
+     * @brief Client connected to a LoopbackBroker. In TickMode::SYNC it is ticked by the thread driving the benchmark, in
+     * TickMode::ASYNC the broker delivers replies from its reader thread and the client ticks itself.
+     */
+    struct LoopbackClient
+    {
+        explicit LoopbackClient(const MqttClientOptions& options = MqttClientOptions{ TickMode::SYNC })
+            : client{ &environment, options },
+            broker{ environment.brokerPtr }
+        {
+            //Per-publish info logs would dominate the measurement.
+            if (getLogger() != nullptr)
+            {
+                getLogger()->setLowestLogLevel(LogLevel::Warning);
+            }
+
+            if (client.getIsTickAsync())
+            {
+                broker->startReaderThread();
+            }
+
+            mqtt::ConnectArgs args{ "kmMqtt_Benchmark" };
+            args.cleanStart = true;
+            args.keepAliveInSec = 0U;
+
+            mqtt::ConnectAddress address;
+            address.primaryAddress = mqtt::Address::createURL("", "localhost", "1883", "");
+
+            client.connect(std::move(args), std::move(address));
+
+            tickUntil([this]() { return client.getConnectionStatus() == mqtt::ConnectionStatus::CONNECTED; });
+        }
+
+        ~LoopbackClient()
+        {
+            client.disconnect();
+            tickUntil([this]() { return client.getConnectionStatus() == mqtt::ConnectionStatus::DISCONNECTED; });
+
+            //Join the reader before the client it delivers to is destroyed.
+            broker->stopReaderThread();
+        }
+
+        /**
+         * @brief Tick until `isDone` returns true, or just wait for it when the client ticks itself.
+         */
+        template<typename Predicate>
+        void tickUntil(Predicate&& isDone)
+        {
+            while (!isDone())
+            {
+                if (client.getIsTickAsync())
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    client.tick();
+                }
+            }
+        }
+
+        LoopbackEnvironment environment;
+        mqtt::MqttClient client;
+        LoopbackBroker* broker;
+    };
+}
+
+#endif //BENCHMARKS_LOOPBACK_LOOPBACKCLIENT_H
@@ -0,0 +1,169 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include "Loopback/LoopbackClient.h"
+
+#include <kmMqtt/Dispatchers/DefaultDispatcher.h>
+#include <kmMqtt/Dispatchers/ImmediateDispatcher.h>
+#include <kmMqtt/Mqtt/ClientMetrics.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+//Length of one paced run, each benchmark iteration is one run.
+static constexpr std::chrono::milliseconds k_runDuration{ 500 };
+static constexpr std::size_t k_payloadSize{ 64U };
+
+static void setLatencyCounters(benchmark::State& state, const char* name, const LatencyHistogramSnapshot& snapshot)
+{
+    const std::string prefix{ name };
+    state.counters[prefix + "_p50_us"] = static_cast<double>(snapshot.getValueAtQuantile(0.5));
+    state.counters[prefix + "_p99_us"] = static_cast<double>(snapshot.getValueAtQuantile(0.99));
+    state.counters[prefix + "_p999_us"] = static_cast<double>(snapshot.getValueAtQuantile(0.999));
+    state.counters[prefix + "_max_us"] = static_cast<double>(snapshot.maxMicroseconds);
+}
+
+//Publishes QoS 1 messages at a fixed rate to the echoing broker stand-in and records publish -> PUBACK and
+//publish -> publish callback of the echo.
+//
+//Latency is measured from when each publish was scheduled to be sent, not from when it was actually sent. A stall in the
+//client delays every publish behind it, and timing from the actual send would hide that wait (coordinated omission).
+static void BM_Loopback_Latency(benchmark::State& state, TickMode tickMode, bool deferCallbacks)
+{
+    const std::size_t rate{ static_cast<std::size_t>(state.range(0)) };
+    const std::chrono::nanoseconds interval{ std::chrono::nanoseconds{ std::chrono::seconds(1) } / static_cast<std::int64_t>(rate) };
+    const std::size_t messagesPerRun{ rate * static_cast<std::size_t>(k_runDuration.count()) / 1000U };
+
+    MqttClientOptions options{ tickMode };
+    if (deferCallbacks)
+    {
+        options.callbackDispatcher(std::make_shared<DefaultDispatcher>());
+    }
+    else
+    {
+        options.callbackDispatcher(std::make_shared<ImmediateDispatcher>());
+    }
+
+    LoopbackClient loopback{ options };
+    loopback.broker->setEcho(true);
+
+    LatencyHistogram ackLatency;
+    LatencyHistogram callbackLatency;
+
+    //Written before the first publish of a run and read by callbacks of that run only.
+    TimePoint runStart;
+    std::size_t runFirstIndex{ 0U };
+
+    const auto scheduledTime = [&](std::size_t index) -> TimePoint
+        {
+            return runStart + interval * static_cast<std::int64_t>(index - runFirstIndex);
+        };
+
+    //The broker stand-in acknowledges in order, so the Nth PUBACK belongs to the Nth publish.
+    std::atomic<std::size_t> acknowledged{ 0U };
+    loopback.client.onPublishCompletedEvent().add([&](const PublishCompleteEventDetails&)
+        {
+            const TimePoint now{ std::chrono::steady_clock::now() };
+            ackLatency.record(now - scheduledTime(acknowledged.fetch_add(1U)));
+        });
+
+    std::atomic<std::size_t> received{ 0U };
+    loopback.client.onPublishEvent().add([&](const PublishEventDetails&, const Publish& packet)
+        {
+            const TimePoint now{ std::chrono::steady_clock::now() };
+            const ByteBuffer& payload{ packet.getPayloadHeader().payload };
+
+            std::size_t index{ 0U };
+            for (std::size_t i = 0; i < sizeof(std::uint64_t); ++i)
+            {
+                index = (index << 8) | payload.bytes()[i];
+            }
+
+            callbackLatency.record(now - scheduledTime(index));
+            received.fetch_add(1U);
+        });
+
+    std::size_t sent{ 0U };
+
+    for (auto _ : state)
+    {
+        runFirstIndex = sent;
+        runStart = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < messagesPerRun; ++i)
+        {
+            const std::size_t index{ sent + i };
+            const TimePoint scheduled{ scheduledTime(index) };
+
+            while (std::chrono::steady_clock::now() < scheduled)
+            {
+                if (loopback.client.getIsTickAsync())
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    loopback.client.tick();
+                }
+            }
+
+            ByteBuffer payload{ k_payloadSize };
+            for (std::size_t b = 0; b < sizeof(std::uint64_t); ++b)
+            {
+                payload += static_cast<std::uint8_t>(static_cast<std::uint64_t>(index) >> (8U * (sizeof(std::uint64_t) - 1U - b)));
+            }
+
+            while (payload.size() < k_payloadSize)
+            {
+                payload += 0xA5U;
+            }
+
+            PublishOptions publishOptions;
+            publishOptions.qos = Qos::QOS_1;
+
+            if (!loopback.client.publish("bench/latency", std::move(payload), std::move(publishOptions)).noError())
+            {
+                state.SkipWithError("publish() failed.");
+                return;
+            }
+        }
+
+        sent += messagesPerRun;
+        loopback.tickUntil([&]() { return acknowledged.load() >= sent && received.load() >= sent; });
+    }
+
+    setLatencyCounters(state, "ack", ackLatency.snapshot());
+    setLatencyCounters(state, "callback", callbackLatency.snapshot());
+    state.SetItemsProcessed(static_cast<std::int64_t>(sent));
+}
+
+//Compare builds with --benchmark_filter=Loopback_Latency --benchmark_out=latency.json --benchmark_out_format=json.
+//DefaultDispatcher defers callbacks to tick() and only applies to TickMode::SYNC, ASYNC clients replace it with
+//ImmediateDispatcher.
+BENCHMARK_CAPTURE(BM_Loopback_Latency, sync_immediate, TickMode::SYNC, false)
+    ->Arg(1000)->Arg(10000)->Arg(50000)
+    ->ArgName("rate")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Loopback_Latency, sync_default, TickMode::SYNC, true)
+    ->Arg(1000)->Arg(10000)->Arg(50000)
+    ->ArgName("rate")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_Loopback_Latency, async_immediate, TickMode::ASYNC, false)
+    ->Arg(1000)->Arg(10000)->Arg(50000)
+    ->ArgName("rate")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,206 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include "Loopback/LoopbackClient.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+//Messages published or received per benchmark iteration, split across the producers.
+static constexpr std::size_t k_messagesPerIteration{ 1000U };
+
+//Publish throughput: `producers` threads publish while the benchmark thread ticks the client, until the broker received
+//every QoS 0 publish or the client completed every QoS 1/2 flow.
+static void BM_Loopback_Publish(benchmark::State& state)
+{
+    const Qos qos{ static_cast<Qos>(state.range(0)) };
+    const std::size_t payloadSize{ static_cast<std::size_t>(state.range(1)) };
+    const std::size_t producers{ static_cast<std::size_t>(state.range(2)) };
+    const std::size_t perProducer{ k_messagesPerIteration / producers };
+    const std::size_t messagesPerIteration{ perProducer * producers };
+
+    LoopbackClient loopback;
+
+    std::atomic<std::size_t> completed{ 0U };
+    loopback.client.onPublishCompletedEvent().add([&](const PublishCompleteEventDetails&)
+        {
+            completed.fetch_add(1U, std::memory_order_relaxed);
+        });
+
+    const std::vector<std::uint8_t> payloadBytes(payloadSize, 0xA5U);
+    std::atomic<bool> failed{ false };
+    std::size_t target{ 0U };
+
+    for (auto _ : state)
+    {
+        target += messagesPerIteration;
+
+        std::vector<std::thread> threads;
+        threads.reserve(producers);
+
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&]()
+                {
+                    for (std::size_t i = 0; i < perProducer && !failed; ++i)
+                    {
+                        while (true)
+                        {
+                            ByteBuffer payload{ payloadSize };
+                            payload.append(payloadBytes.data(), payloadSize);
+
+                            PublishOptions options;
+                            options.qos = qos;
+
+                            const ReqResult result{ loopback.client.publish("bench/publish", std::move(payload), std::move(options)) };
+                            if (result.noError())
+                            {
+                                break;
+                            }
+
+                            if (result.errorCode() != ClientErrorCode::Would_Block)
+                            {
+                                failed = true;
+                                break;
+                            }
+
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        loopback.tickUntil([&]()
+            {
+                const std::size_t done{ qos == Qos::QOS_0 ? loopback.broker->publishesReceived.load() : completed.load() };
+                return done >= target || failed;
+            });
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        if (failed)
+        {
+            state.SkipWithError("publish() failed.");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * messagesPerIteration));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * messagesPerIteration * payloadSize));
+}
+
+//Receive throughput: the broker delivers a batch of publishes, timed until every publish callback ran and the client
+//acknowledged every QoS 1/2 publish.
+static void BM_Loopback_Receive(benchmark::State& state)
+{
+    const std::uint8_t qos{ static_cast<std::uint8_t>(state.range(0)) };
+    const std::size_t payloadSize{ static_cast<std::size_t>(state.range(1)) };
+
+    LoopbackClient loopback;
+
+    std::atomic<std::size_t> received{ 0U };
+    loopback.client.onPublishEvent().add([&](const PublishEventDetails&, const Publish&)
+        {
+            received.fetch_add(1U, std::memory_order_relaxed);
+        });
+
+    std::vector<std::uint8_t> batch;
+    for (std::size_t i = 0; i < k_messagesPerIteration; ++i)
+    {
+        LoopbackBroker::encodePublish(batch, "bench/receive", payloadSize, qos, static_cast<std::uint16_t>(i + 1U));
+    }
+
+    std::size_t target{ 0U };
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        loopback.broker->queueInbound(batch);
+        target += k_messagesPerIteration;
+        state.ResumeTiming();
+
+        loopback.tickUntil([&]()
+            {
+                return received.load() >= target && (qos == 0U || loopback.broker->acknowledgementsReceived.load() >= target);
+            });
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * k_messagesPerIteration));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * k_messagesPerIteration * payloadSize));
+}
+
+//Round trip: every publish is echoed back by the broker, timed until the client received all of them.
+static void BM_Loopback_Echo(benchmark::State& state)
+{
+    const Qos qos{ static_cast<Qos>(state.range(0)) };
+    const std::size_t payloadSize{ static_cast<std::size_t>(state.range(1)) };
+
+    LoopbackClient loopback;
+    loopback.broker->setEcho(true);
+
+    std::atomic<std::size_t> received{ 0U };
+    loopback.client.onPublishEvent().add([&](const PublishEventDetails&, const Publish&)
+        {
+            received.fetch_add(1U, std::memory_order_relaxed);
+        });
+
+    const std::vector<std::uint8_t> payloadBytes(payloadSize, 0xA5U);
+    std::size_t target{ 0U };
+
+    for (auto _ : state)
+    {
+        target += k_messagesPerIteration;
+
+        for (std::size_t i = 0; i < k_messagesPerIteration; ++i)
+        {
+            ByteBuffer payload{ payloadSize };
+            payload.append(payloadBytes.data(), payloadSize);
+
+            PublishOptions options;
+            options.qos = qos;
+
+            while (loopback.client.publish("bench/echo", std::move(payload), std::move(options)).errorCode() == ClientErrorCode::Would_Block)
+            {
+                loopback.client.tick();
+                payload = ByteBuffer{ payloadSize };
+                payload.append(payloadBytes.data(), payloadSize);
+                options = PublishOptions{};
+                options.qos = qos;
+            }
+        }
+
+        loopback.tickUntil([&]() { return received.load() >= target; });
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * k_messagesPerIteration));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * k_messagesPerIteration * payloadSize));
+}
+
+BENCHMARK(BM_Loopback_Publish)
+    ->ArgsProduct({ { 0, 1, 2 }, { 16, 1024, 16384 }, { 1, 4 } })
+    ->ArgNames({ "qos", "payload", "producers" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_Loopback_Receive)
+    ->ArgsProduct({ { 0, 1, 2 }, { 16, 1024, 16384 } })
+    ->ArgNames({ "qos", "payload" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_Loopback_Echo)
+    ->ArgsProduct({ { 0, 1, 2 }, { 16, 1024, 16384 } })
+    ->ArgNames({ "qos", "payload" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
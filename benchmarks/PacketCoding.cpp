@@ -0,0 +1,288 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include <kmMqtt/Mqtt/PacketHelper.h>
+#include <kmMqtt/Mqtt/MqttConnectionInfo.h>
+#include <kmMqtt/Mqtt/Packets/Subscribe/SubscribeAck.h>
+#include <kmMqtt/Mqtt/Params/ConnectArgs.h>
+#include <kmMqtt/Mqtt/Params/DisconnectArgs.h>
+#include <kmMqtt/Mqtt/Params/PublishOptions.h>
+#include <kmMqtt/Mqtt/Params/PubAckOptions.h>
+#include <kmMqtt/Mqtt/Params/PubCompOptions.h>
+#include <kmMqtt/Mqtt/Params/PubRecOptions.h>
+#include <kmMqtt/Mqtt/Params/PubRelOptions.h>
+#include <kmMqtt/Mqtt/Params/SubscribeOptions.h>
+#include <kmMqtt/Mqtt/Params/UnSubscribeOptions.h>
+#include <kmMqtt/Mqtt/Params/Topic.h>
+#include <kmMqtt/ByteBuffer.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+//Encode and decode cost of each packet type on its own, without the send and receive queues around it.
+//CONNECT, SUBSCRIBE, UNSUBSCRIBE and PINGREQ are only ever sent by the client, so they have no decoder to measure, the
+//same goes for the encoders of CONNACK, SUBACK, UNSUBACK and PINGRESP. Those are decoded from bytes as a broker would
+//send them.
+
+static MqttConnectionInfo makeConnectionInfo()
+{
+    MqttConnectionInfo connectionInfo;
+    connectionInfo.connectArgs = ConnectArgs("kmMqtt_Benchmark");
+    connectionInfo.connectArgs.cleanStart = true;
+    connectionInfo.connectArgs.keepAliveInSec = 60U;
+    return connectionInfo;
+}
+
+static ByteBuffer makePayload(std::size_t size)
+{
+    ByteBuffer payload{ size };
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        payload += 0xA5U;
+    }
+
+    return payload;
+}
+
+static std::vector<Topic> makeTopics(std::size_t count)
+{
+    std::vector<Topic> topics;
+    topics.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        topics.emplace_back("bench/topic/" + std::to_string(i));
+    }
+
+    return topics;
+}
+
+static ByteBuffer toByteBuffer(const std::vector<std::uint8_t>& bytes)
+{
+    ByteBuffer buffer{ bytes.size() };
+    buffer.append(bytes.data(), bytes.size());
+    return buffer;
+}
+
+//Re-encodes the same packet, the headers are built once so only the serialization into the data buffer is timed.
+template<typename TPacket>
+static void encodeLoop(benchmark::State& state, TPacket& packet)
+{
+    for (auto _ : state)
+    {
+        EncodeResult result{ packet.encode() };
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(packet.getDataBuffer().bytes());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * packet.getDataBuffer().size()));
+}
+
+//Decodes a fresh packet from a copy of `encoded` each iteration, as the receive path constructs one per frame.
+template<typename TPacket>
+static void decodeLoop(benchmark::State& state, const ByteBuffer& encoded)
+{
+    {
+        TPacket packet{ ByteBuffer{ encoded } };
+        if (packet.decode().code != DecodeErrorCode::NO_ERROR)
+        {
+            state.SkipWithError("decode() failed.");
+            return;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        TPacket packet{ ByteBuffer{ encoded } };
+        DecodeResult result{ packet.decode() };
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * encoded.size()));
+}
+
+static void BM_EncodeConnect(benchmark::State& state)
+{
+    const MqttConnectionInfo connectionInfo{ makeConnectionInfo() };
+    Connect packet{ createConnectPacket(connectionInfo) };
+    encodeLoop(state, packet);
+}
+
+static void BM_EncodePublish(benchmark::State& state)
+{
+    const MqttConnectionInfo connectionInfo{ makeConnectionInfo() };
+    const ByteBuffer payload{ makePayload(static_cast<std::size_t>(state.range(0))) };
+
+    PublishOptions options;
+    options.qos = Qos::QOS_1;
+
+    Publish packet{ createPublishPacket(connectionInfo, false, "bench/publish", payload, options, 1U) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodePublish(benchmark::State& state)
+{
+    const MqttConnectionInfo connectionInfo{ makeConnectionInfo() };
+    const ByteBuffer payload{ makePayload(static_cast<std::size_t>(state.range(0))) };
+
+    PublishOptions options;
+    options.qos = Qos::QOS_1;
+
+    Publish packet{ createPublishPacket(connectionInfo, false, "bench/publish", payload, options, 1U) };
+    packet.encode();
+    decodeLoop<Publish>(state, packet.getDataBuffer());
+}
+
+static void BM_EncodePubAck(benchmark::State& state)
+{
+    PublishAck packet{ createPubAckPacket(1U, PubAckReasonCode::SUCCESS, PubAckOptions{}) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodePubAck(benchmark::State& state)
+{
+    PublishAck packet{ createPubAckPacket(1U, PubAckReasonCode::SUCCESS, PubAckOptions{}) };
+    packet.encode();
+    decodeLoop<PublishAck>(state, packet.getDataBuffer());
+}
+
+static void BM_EncodePubRec(benchmark::State& state)
+{
+    PublishRec packet{ createPubRecPacket(1U, PubRecReasonCode::SUCCESS, PubRecOptions{}) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodePubRec(benchmark::State& state)
+{
+    PublishRec packet{ createPubRecPacket(1U, PubRecReasonCode::SUCCESS, PubRecOptions{}) };
+    packet.encode();
+    decodeLoop<PublishRec>(state, packet.getDataBuffer());
+}
+
+static void BM_EncodePubRel(benchmark::State& state)
+{
+    PublishRel packet{ createPubRelPacket(1U, PubRelReasonCode::SUCCESS, PubRelOptions{}) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodePubRel(benchmark::State& state)
+{
+    PublishRel packet{ createPubRelPacket(1U, PubRelReasonCode::SUCCESS, PubRelOptions{}) };
+    packet.encode();
+    decodeLoop<PublishRel>(state, packet.getDataBuffer());
+}
+
+static void BM_EncodePubComp(benchmark::State& state)
+{
+    PublishComp packet{ createPubCompPacket(1U, PubCompReasonCode::SUCCESS, PubCompOptions{}) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodePubComp(benchmark::State& state)
+{
+    PublishComp packet{ createPubCompPacket(1U, PubCompReasonCode::SUCCESS, PubCompOptions{}) };
+    packet.encode();
+    decodeLoop<PublishComp>(state, packet.getDataBuffer());
+}
+
+static void BM_EncodeSubscribe(benchmark::State& state)
+{
+    Subscribe packet{ createSubscribePacket(1U, makeTopics(static_cast<std::size_t>(state.range(0))), SubscribeOptions{}) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodeSubAck(benchmark::State& state)
+{
+    const std::size_t filters{ static_cast<std::size_t>(state.range(0)) };
+
+    //Packet ID, empty properties and one reason code per filter, a remaining length of at most 2 bytes.
+    std::vector<std::uint8_t> bytes{ 0x90U };
+    const std::size_t remainingLength{ 3U + filters };
+    if (remainingLength < 128U)
+    {
+        bytes.push_back(static_cast<std::uint8_t>(remainingLength));
+    }
+    else
+    {
+        bytes.push_back(static_cast<std::uint8_t>((remainingLength % 128U) | 0x80U));
+        bytes.push_back(static_cast<std::uint8_t>(remainingLength / 128U));
+    }
+
+    bytes.push_back(0x00U);
+    bytes.push_back(0x01U);
+    bytes.push_back(0x00U); //No properties
+    bytes.insert(bytes.end(), filters, 0x01U); //GRANTED_QOS_1
+
+    decodeLoop<SubscribeAck>(state, toByteBuffer(bytes));
+}
+
+static void BM_EncodeUnSubscribe(benchmark::State& state)
+{
+    UnSubscribe packet{ createUnSubscribePacket(1U, makeTopics(static_cast<std::size_t>(state.range(0))), UnSubscribeOptions{}) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodeUnSubAck(benchmark::State& state)
+{
+    decodeLoop<UnSubscribeAck>(state, toByteBuffer({ 0xB0U, 0x04U, 0x00U, 0x01U, 0x00U, 0x00U }));
+}
+
+static void BM_DecodeConnAck(benchmark::State& state)
+{
+    decodeLoop<ConnectAck>(state, toByteBuffer({ 0x20U, 0x03U, 0x00U, 0x00U, 0x00U }));
+}
+
+static void BM_EncodeDisconnect(benchmark::State& state)
+{
+    const MqttConnectionInfo connectionInfo{ makeConnectionInfo() };
+    Disconnect packet{ createDisconnectPacket(connectionInfo, DisconnectArgs{}, DisconnectReasonCode::NORMAL_DISCONNECTION) };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodeDisconnect(benchmark::State& state)
+{
+    const MqttConnectionInfo connectionInfo{ makeConnectionInfo() };
+    Disconnect packet{ createDisconnectPacket(connectionInfo, DisconnectArgs{}, DisconnectReasonCode::NORMAL_DISCONNECTION) };
+    packet.encode();
+    decodeLoop<Disconnect>(state, packet.getDataBuffer());
+}
+
+static void BM_EncodePingReq(benchmark::State& state)
+{
+    PingReq packet{ createPingRequestPacket() };
+    encodeLoop(state, packet);
+}
+
+static void BM_DecodePingResp(benchmark::State& state)
+{
+    decodeLoop<PingResp>(state, toByteBuffer({ 0xD0U, 0x00U }));
+}
+
+BENCHMARK(BM_EncodeConnect);
+BENCHMARK(BM_EncodePublish)->Arg(0)->Arg(16)->Arg(1024)->Arg(16384)->Arg(262144)->ArgName("payload");
+BENCHMARK(BM_DecodePublish)->Arg(0)->Arg(16)->Arg(1024)->Arg(16384)->Arg(262144)->ArgName("payload");
+BENCHMARK(BM_EncodePubAck);
+BENCHMARK(BM_DecodePubAck);
+BENCHMARK(BM_EncodePubRec);
+BENCHMARK(BM_DecodePubRec);
+BENCHMARK(BM_EncodePubRel);
+BENCHMARK(BM_DecodePubRel);
+BENCHMARK(BM_EncodePubComp);
+BENCHMARK(BM_DecodePubComp);
+BENCHMARK(BM_EncodeSubscribe)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->ArgName("filters");
+BENCHMARK(BM_DecodeSubAck)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->ArgName("filters");
+BENCHMARK(BM_EncodeUnSubscribe)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->ArgName("filters");
+BENCHMARK(BM_DecodeUnSubAck);
+BENCHMARK(BM_DecodeConnAck);
+BENCHMARK(BM_EncodeDisconnect);
+BENCHMARK(BM_DecodeDisconnect);
+BENCHMARK(BM_EncodePingReq);
+BENCHMARK(BM_DecodePingResp);
@@ -0,0 +1,150 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "WireReplaySocket.h"
+
+#include <chrono>
+
+namespace kmMqtt
+{
+    WireReplaySocket::WireReplaySocket(std::shared_ptr<const std::vector<mqtt::WireCaptureRecord>> capture, ReplayTiming timing)
+        : m_capture{ std::move(capture) },
+        m_timing{ timing }
+    {
+        if (!m_capture->empty())
+        {
+            m_captureStart = m_capture->front().time;
+        }
+    }
+
+    bool WireReplaySocket::connect(const mqtt::Address& address) noexcept
+    {
+        (void)address;
+
+        m_connected = true;
+        m_hasClientSent = false;
+        m_nextRecord = 0U;
+        m_replayStart = std::chrono::steady_clock::now();
+        skipSentRecords();
+
+        if (m_onConnect)
+        {
+            m_onConnect(true);
+        }
+
+        return true;
+    }
+
+    int WireReplaySocket::send(const ByteBuffer& data) noexcept
+    {
+        if (!m_connected)
+        {
+            return -1;
+        }
+
+        m_hasClientSent = true;
+        return static_cast<int>(data.size());
+    }
+
+    bool WireReplaySocket::close() noexcept
+    {
+        if (m_connected)
+        {
+            m_connected = false;
+
+            if (m_onDisconnect)
+            {
+                m_onDisconnect();
+            }
+        }
+
+        return true;
+    }
+
+    void WireReplaySocket::tick() noexcept
+    {
+        if (!m_connected || !m_hasClientSent || m_readPaused || isFinished())
+        {
+            return;
+        }
+
+        const mqtt::WireCaptureRecord& record{ (*m_capture)[m_nextRecord] };
+
+        if (m_timing == ReplayTiming::ORIGINAL && std::chrono::steady_clock::now() - m_replayStart < record.time - m_captureStart)
+        {
+            return;
+        }
+
+        ++m_nextRecord;
+        skipSentRecords();
+
+        bytesDelivered += record.bytes.size();
+
+        ByteBuffer chunk{ record.bytes.size() };
+        chunk.append(record.bytes.data(), record.bytes.size());
+
+        if (m_onRecvd)
+        {
+            m_onRecvd(std::move(chunk));
+        }
+    }
+
+    void WireReplaySocket::skipSentRecords() noexcept
+    {
+        while (m_nextRecord < m_capture->size() && (*m_capture)[m_nextRecord].direction != mqtt::WireDirection::RECEIVED)
+        {
+            ++m_nextRecord;
+        }
+    }
+
+    std::size_t WireReplaySocket::countReceivedPackets(const std::vector<mqtt::WireCaptureRecord>& capture, mqtt::PacketType packetType)
+    {
+        std::vector<std::uint8_t> stream;
+        for (const auto& record : capture)
+        {
+            if (record.direction == mqtt::WireDirection::RECEIVED)
+            {
+                stream.insert(stream.end(), record.bytes.begin(), record.bytes.end());
+            }
+        }
+
+        std::size_t count{ 0U };
+        std::size_t offset{ 0U };
+
+        while (offset + 1U < stream.size())
+        {
+            std::size_t remainingLength{ 0U };
+            std::size_t multiplier{ 1U };
+            std::size_t lengthBytes{ 0U };
+
+            for (std::size_t i = offset + 1U; i < stream.size() && lengthBytes < 4U; ++i)
+            {
+                remainingLength += (stream[i] & 0x7FU) * multiplier;
+                multiplier *= 128U;
+                ++lengthBytes;
+
+                if ((stream[i] & 0x80U) == 0U)
+                {
+                    break;
+                }
+            }
+
+            const std::size_t packetEnd{ offset + 1U + lengthBytes + remainingLength };
+            if (packetEnd > stream.size())
+            {
+                break;
+            }
+
+            if (static_cast<mqtt::PacketType>(stream[offset] >> 4) == packetType)
+            {
+                ++count;
+            }
+
+            offset = packetEnd;
+        }
+
+        return count;
+    }
+}
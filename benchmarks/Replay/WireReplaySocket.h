@@ -0,0 +1,115 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef BENCHMARKS_REPLAY_WIREREPLAYSOCKET_H
+#define BENCHMARKS_REPLAY_WIREREPLAYSOCKET_H
+
+#include <kmMqtt/Interfaces/IMqttEnvironment.h>
+#include <kmMqtt/Interfaces/IWebSocket.h>
+#include <kmMqtt/Mqtt/Packets/PacketType.h>
+#include <kmMqtt/Mqtt/Tracing/WireCaptureFileSink.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace kmMqtt
+{
+    enum class ReplayTiming : std::uint8_t
+    {
+        MAX_SPEED, //The next chunk on every socket tick.
+        ORIGINAL, //Each chunk once as much time has passed since connect() as had passed since the start of the capture.
+    };
+
+    /**
+     * @brief Socket feeding the received bytes of a wire capture back to a TickMode::SYNC client, so they go through the
+     * packet splitting, receive queue and dispatch path the way they did when captured.
+     *
+     * Chunks are delivered as the socket originally delivered them, from the client's first send on, so the captured
+     * CONNACK answers the replaying client's CONNECT. Sent records and everything the replaying client sends are dropped,
+     * acknowledgements the client's own publishes got in the capture are handled as unknown packet IDs.
+     */
+    class WireReplaySocket : public IWebSocket
+    {
+    public:
+        WireReplaySocket(std::shared_ptr<const std::vector<mqtt::WireCaptureRecord>> capture, ReplayTiming timing);
+
+        bool connect(const mqtt::Address& address) noexcept override;
+        int send(const ByteBuffer& data) noexcept override;
+        bool close() noexcept override;
+        void tick() noexcept override;
+
+        void setReadPaused(bool paused) noexcept override { m_readPaused = paused; }
+        bool isConnected() const noexcept override { return m_connected; }
+        int getLastError() const noexcept override { return 0; }
+        int getLastCloseCode() const noexcept override { return 0; }
+        const char* getLastCloseReason() const noexcept override { return ""; }
+        void setOnConnectCallback(OnConnectCallback cb) noexcept override { m_onConnect = std::move(cb); }
+        void setOnDisconnectCallback(OnDisconnectCallback cb) noexcept override { m_onDisconnect = std::move(cb); }
+        void setOnRecvdCallback(OnRecvdCallback cb) noexcept override { m_onRecvd = std::move(cb); }
+        void setOnErrorCallback(OnErrorCallback cb) noexcept override { m_onError = std::move(cb); }
+
+        /**
+         * @brief Every received chunk of the capture has been delivered.
+         */
+        bool isFinished() const noexcept { return m_nextRecord == m_capture->size(); }
+
+        /**
+         * @brief Count the packets of a type in the received bytes of a capture, e.g. the publishes a replay should
+         * dispatch.
+         */
+        static std::size_t countReceivedPackets(const std::vector<mqtt::WireCaptureRecord>& capture, mqtt::PacketType packetType);
+
+        std::size_t bytesDelivered{ 0U };
+
+    private:
+        void skipSentRecords() noexcept;
+
+        std::shared_ptr<const std::vector<mqtt::WireCaptureRecord>> m_capture;
+        ReplayTiming m_timing;
+        std::size_t m_nextRecord{ 0U };
+        TimePoint m_captureStart;
+        TimePoint m_replayStart;
+        bool m_connected{ false };
+        bool m_hasClientSent{ false };
+        bool m_readPaused{ false };
+
+        OnConnectCallback m_onConnect;
+        OnDisconnectCallback m_onDisconnect;
+        OnRecvdCallback m_onRecvd;
+        OnErrorCallback m_onError;
+    };
+
+    /**
+     * @brief Environment handing a WireReplaySocket to the client as its socket.
+     */
+    class WireReplayEnvironment : public IMqttEnvironment
+    {
+    public:
+        WireReplayEnvironment(std::shared_ptr<const std::vector<mqtt::WireCaptureRecord>> capture, ReplayTiming timing)
+            : m_capture{ std::move(capture) },
+            m_timing{ timing }
+        {
+        }
+
+        Config createConfig() const noexcept override { return Config{}; }
+
+        std::shared_ptr<IWebSocket> createWebSocket() const noexcept override
+        {
+            auto socket{ std::make_shared<WireReplaySocket>(m_capture, m_timing) };
+            socketPtr = socket.get();
+            return socket;
+        }
+
+        mutable WireReplaySocket* socketPtr{ nullptr };
+
+    private:
+        std::shared_ptr<const std::vector<mqtt::WireCaptureRecord>> m_capture;
+        ReplayTiming m_timing;
+    };
+}
+
+#endif //BENCHMARKS_REPLAY_WIREREPLAYSOCKET_H
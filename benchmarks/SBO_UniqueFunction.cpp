@@ -6,6 +6,7 @@
 #include <benchmark/benchmark.h>
 #include "Functor.h"
 #include <kmMqtt/Utils/UniqueFunction.h>
+#include <kmMqtt/Utils/Deferrer.h>
 #include <queue>
 
 using namespace kmMqtt;
@@ -51,7 +52,72 @@ static void BM_SBO_UniqueFunction(benchmark::State& state)
     }
 }
 
+static constexpr std::size_t deferredPerTick{ 16 };
+
+template<std::size_t N>
+static void deferAndInvoke(benchmark::State& state)
+{
+	events::Deferrer deferrer;
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < deferredPerTick; ++i)
+		{
+			deferrer.defer(Functor<N>{});
+		}
+
+		deferrer.invokeEvents();
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * deferredPerTick));
+}
+
+//Defers a tick's worth of callables into the arena backed Deferrer and invokes them, as SYNC mode does every tick.
+static void BM_Arena_Deferrer(benchmark::State& state)
+{
+	if (state.range(0) == testOne)
+	{
+		deferAndInvoke<testOne>(state);
+	}
+	else if (state.range(0) == testTwo)
+	{
+		deferAndInvoke<testTwo>(state);
+	}
+	else if (state.range(0) == testThree)
+	{
+		deferAndInvoke<testThree>(state);
+	}
+	else if (state.range(0) == testFour)
+	{
+		deferAndInvoke<testFour>(state);
+	}
+}
+
+//Baseline, heap allocating every deferred callable into a queue (previous Deferrer implementation).
+static void BM_Heap_Deferrer(benchmark::State& state)
+{
+	std::queue<UniqueFunction> queue;
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < deferredPerTick; ++i)
+		{
+			queue.emplace(Functor<testFour>{});
+		}
+
+		while (!queue.empty())
+		{
+			queue.front()();
+			queue.pop();
+		}
+	}
+
+	state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * deferredPerTick));
+}
+
 // Register benchmarks
 BENCHMARK(BM_SBO_UniqueFunction)->Arg(testOne)->Arg(testTwo)->Arg(testThree)->Arg(testFour);
+BENCHMARK(BM_Arena_Deferrer)->Arg(testOne)->Arg(testTwo)->Arg(testThree)->Arg(testFour);
+BENCHMARK(BM_Heap_Deferrer);
 
 
@@ -0,0 +1,116 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include <kmMqtt/Mqtt/Transport/SendQueue.h>
+#include <kmMqtt/Mqtt/Transport/Jobs/PublishComposer.h>
+#include <kmMqtt/Mqtt/ReceiveMaximumTracker.h>
+#include <kmMqtt/Mqtt/MqttConnectionInfo.h>
+#include <kmMqtt/Interfaces/IWebSocket.h>
+#include <kmMqtt/Utils/PacketIdPool.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+namespace
+{
+    //Accepts every byte straight away, so only the queue's own work is measured.
+    class NullWebSocket : public IWebSocket
+    {
+    public:
+        bool connect(const Address& address) noexcept override { (void)address; return true; }
+        int send(const ByteBuffer& data) noexcept override { return static_cast<int>(data.size()); }
+        bool close() noexcept override { return true; }
+        void tick() noexcept override {}
+
+        bool isConnected() const noexcept override { return true; }
+        int getLastError() const noexcept override { return 0; }
+        int getLastCloseCode() const noexcept override { return 0; }
+        const char* getLastCloseReason() const noexcept override { return ""; }
+        void setOnConnectCallback(OnConnectCallback cb) noexcept override { (void)cb; }
+        void setOnDisconnectCallback(OnDisconnectCallback cb) noexcept override { (void)cb; }
+        void setOnRecvdCallback(OnRecvdCallback cb) noexcept override { (void)cb; }
+        void setOnErrorCallback(OnErrorCallback cb) noexcept override { (void)cb; }
+    };
+}
+
+//Composes and sends `batch` queued publishes through sendNextBatch(), for QoS 0 and QoS 1 lanes.
+//Queueing is not timed, see the loopback benchmarks for publish() end to end.
+static void BM_SendQueue_SendNextBatch(benchmark::State& state)
+{
+    const Qos qos{ static_cast<Qos>(state.range(0)) };
+    const std::size_t batch{ static_cast<std::size_t>(state.range(1)) };
+    const std::size_t payloadSize{ static_cast<std::size_t>(state.range(2)) };
+
+    MqttConnectionInfo connectionInfo;
+    connectionInfo.connectArgs = ConnectArgs("kmMqtt_Benchmark");
+
+    PacketIdPool packetIdPool;
+    ReceiveMaximumTracker tracker{ 65535, 65535 };
+
+    SendQueue queue;
+    queue.setSocket(std::make_shared<NullWebSocket>());
+    queue.setReceiveMaximumTracker(&tracker);
+
+    const std::vector<std::uint8_t> payloadBytes(payloadSize, 0xA5U);
+    std::vector<std::uint16_t> packetIds;
+    packetIds.reserve(batch);
+    SendBatchResult result;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        const TimePoint queuedTime{ std::chrono::steady_clock::now() };
+
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            ByteBuffer payload{ payloadSize };
+            payload.append(payloadBytes.data(), payloadSize);
+
+            PublishOptions options;
+            options.qos = qos;
+
+            std::uint16_t packetId{ 0U };
+            if (qos != Qos::QOS_0)
+            {
+                packetId = packetIdPool.getId();
+                packetIds.push_back(packetId);
+            }
+
+            queue.addToQueue(std::make_unique<PublishComposer>(&connectionInfo, &packetIdPool, packetId, "bench/sendqueue",
+                std::move(payload), std::move(options), &tracker, false, queuedTime));
+        }
+        state.ResumeTiming();
+
+        while (queue.nextSendTime(std::chrono::steady_clock::now()) != TimePoint::max())
+        {
+            result = SendBatchResult{};
+            queue.sendNextBatch(result);
+            benchmark::DoNotOptimize(result.totalBytesSent);
+        }
+
+        //Nothing acknowledges the QoS 1 publishes, hand their IDs and receive maximum quota straight back.
+        state.PauseTiming();
+        for (const std::uint16_t packetId : packetIds)
+        {
+            tracker.incrementReceiveAllowance(packetId);
+            packetIdPool.releaseId(packetId);
+        }
+        packetIds.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * batch));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * batch * payloadSize));
+}
+
+BENCHMARK(BM_SendQueue_SendNextBatch)
+    ->ArgsProduct({ { 0, 1 }, { 1, 16, 256 }, { 16, 1024 } })
+    ->ArgNames({ "qos", "batch", "payload" });
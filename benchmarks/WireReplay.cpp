@@ -0,0 +1,185 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <benchmark/benchmark.h>
+#include "Loopback/LoopbackClient.h"
+#include "Replay/WireReplaySocket.h"
+
+#include <kmMqtt/Mqtt/Tracing/WireCaptureFileSink.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+//Replays a wire capture through the packet splitting, receive queue and dispatch path of a TickMode::SYNC client.
+//Set KMMQTT_REPLAY_CAPTURE to a file written by WireCaptureFileSink to replay traffic captured from a real broker,
+//otherwise a mix of QoS 0, 1 and 2 publishes of varying size is captured from the loopback broker stand-in first.
+
+static constexpr std::size_t k_syntheticPublishes{ 3000U };
+static constexpr std::size_t k_idleTicksAfterReplay{ 1000U };
+
+/**
+ * @brief Wire capture sink keeping the records in memory.
+ */
+class MemoryWireCaptureSink : public IWireCaptureSink
+{
+public:
+    void onWireBytes(WireDirection direction, const std::uint8_t* bytes, std::size_t size, TimePoint time) noexcept override
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        records.push_back({ direction, time, std::vector<std::uint8_t>(bytes, bytes + size) });
+    }
+
+    std::vector<WireCaptureRecord> records;
+
+private:
+    std::mutex m_mutex;
+};
+
+static std::vector<WireCaptureRecord> captureSyntheticTraffic()
+{
+    static constexpr std::size_t k_payloadSizes[]{ 16U, 256U, 4096U };
+
+    auto sink{ std::make_shared<MemoryWireCaptureSink>() };
+
+    {
+        LoopbackClient loopback{ MqttClientOptions{ TickMode::SYNC }.wireCapture(sink) };
+
+        std::atomic<std::size_t> received{ 0U };
+        loopback.client.onPublishEvent().add([&](const PublishEventDetails&, const Publish&)
+            {
+                received.fetch_add(1U, std::memory_order_relaxed);
+            });
+
+        std::vector<std::uint8_t> batch;
+        std::size_t acknowledged{ 0U };
+        for (std::size_t i = 0; i < k_syntheticPublishes; ++i)
+        {
+            const std::uint8_t qos{ static_cast<std::uint8_t>(i % 3U) };
+            const std::string topic{ "bench/replay/" + std::to_string(i % 16U) };
+            LoopbackBroker::encodePublish(batch, topic.c_str(), k_payloadSizes[(i / 3U) % 3U], qos, static_cast<std::uint16_t>(i + 1U));
+
+            acknowledged += qos > 0U ? 1U : 0U;
+        }
+
+        loopback.broker->setReadChunkSize(16U * 1024U);
+        loopback.broker->queueInbound(batch);
+        loopback.tickUntil([&]()
+            {
+                return received.load() >= k_syntheticPublishes && loopback.broker->acknowledgementsReceived.load() >= acknowledged;
+            });
+    }
+
+    return std::move(sink->records);
+}
+
+static std::shared_ptr<const std::vector<WireCaptureRecord>> loadCapture(std::string& outError)
+{
+    const char* path{ std::getenv("KMMQTT_REPLAY_CAPTURE") };
+    if (path == nullptr)
+    {
+        static const auto synthetic{ std::make_shared<const std::vector<WireCaptureRecord>>(captureSyntheticTraffic()) };
+        return synthetic;
+    }
+
+    auto records{ std::make_shared<std::vector<WireCaptureRecord>>() };
+    if (!WireCaptureFileSink::readFile(path, *records))
+    {
+        outError = std::string{ "Cannot read wire capture: " } + path;
+        return nullptr;
+    }
+
+    return records;
+}
+
+static void BM_Replay_Capture(benchmark::State& state)
+{
+    const ReplayTiming timing{ static_cast<ReplayTiming>(state.range(0)) };
+
+    std::string error;
+    const auto capture{ loadCapture(error) };
+    if (capture == nullptr)
+    {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const std::size_t expectedPublishes{ WireReplaySocket::countReceivedPackets(*capture, PacketType::PUBLISH) };
+
+    std::size_t publishes{ 0U };
+    std::size_t bytes{ 0U };
+
+    if (getLogger() != nullptr)
+    {
+        getLogger()->setLowestLogLevel(LogLevel::Warning);
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+
+        WireReplayEnvironment environment{ capture, timing };
+        auto client{ std::make_unique<MqttClient>(&environment, MqttClientOptions{ TickMode::SYNC }) };
+
+        std::size_t received{ 0U };
+        client->onPublishEvent().add([&](const PublishEventDetails&, const Publish&) { ++received; });
+
+        ConnectArgs args{ "kmMqtt_Replay" };
+        args.cleanStart = true;
+        args.keepAliveInSec = 0U;
+
+        ConnectAddress address;
+        address.primaryAddress = Address::createURL("", "localhost", "1883", "");
+
+        state.ResumeTiming();
+
+        client->connect(std::move(args), std::move(address));
+
+        while (!environment.socketPtr->isFinished())
+        {
+            client->tick();
+        }
+
+        //Publishes the capture holds but the client does not dispatch, e.g. after a captured DISCONNECT, must not stall it.
+        for (std::size_t idleTicks = 0; received < expectedPublishes && idleTicks < k_idleTicksAfterReplay; ++idleTicks)
+        {
+            client->tick();
+        }
+
+        state.PauseTiming();
+
+        publishes += received;
+        bytes += environment.socketPtr->bytesDelivered;
+
+        client->disconnect();
+        while (client->getConnectionStatus() != ConnectionStatus::DISCONNECTED)
+        {
+            client->tick();
+        }
+
+        client.reset();
+
+        state.ResumeTiming();
+    }
+
+    state.counters["publishes_per_replay"] = static_cast<double>(publishes) / static_cast<double>(state.iterations());
+    state.counters["expected_publishes"] = static_cast<double>(expectedPublishes);
+    state.SetItemsProcessed(static_cast<std::int64_t>(publishes));
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+}
+
+BENCHMARK(BM_Replay_Capture)
+    ->Arg(static_cast<int>(ReplayTiming::MAX_SPEED))
+    ->Arg(static_cast<int>(ReplayTiming::ORIGINAL))
+    ->ArgName("original_timing")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
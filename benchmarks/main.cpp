@@ -4,5 +4,19 @@
 // See LICENSE file in the project root for full license information.
 
 #include <benchmark/benchmark.h>
+#include "Allocation/AllocationCounter.h"
 
-BENCHMARK_MAIN();
\ No newline at end of file
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    //Lets CI fail on an allocation regression, see AllocationBudgets.cpp.
+    return kmMqtt::wasAllocationBudgetExceeded() ? 1 : 0;
+}
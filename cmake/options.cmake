@@ -12,6 +12,7 @@ option(ENABLE_ASAN "Should AddressSanitizer be enabled?" OFF)
 option(ENABLE_UBSAN "Should UndefinedBehaviorSanitizer be enabled?" OFF)
 option(ENABLE_TSAN "Should ThreadSanitizer be enabled?" OFF)
 option(ENABLE_MSAN "Should MemorySanitizer be enabled?" OFF)
+option(ENABLE_ALLOCATION_COUNTING "Should the benchmarks count heap allocations and check per-operation allocation budgets?" OFF)
 
 #SBO
 option(ENABLE_BYTEBUFFER_SBO "Enable the SBO for ByteBuffer class. Buffer SBO size set to 128 (BYTEBUFFER_SBO_MAX_SIZE) bytes as default." ON)
@@ -42,9 +43,11 @@ message(STATUS "  ENABLE_ASAN: ${ENABLE_ASAN}")
 message(STATUS "  ENABLE_UBSAN: ${ENABLE_UBSAN}")
 message(STATUS "  ENABLE_TSAN: ${ENABLE_TSAN}")
 message(STATUS "  ENABLE_MSAN: ${ENABLE_MSAN}")
+message(STATUS "  ENABLE_ALLOCATION_COUNTING: ${ENABLE_ALLOCATION_COUNTING}")
 message(STATUS "  BUILD_IXWEBSOCKET: ${BUILD_IXWEBSOCKET}")
 
 # Sets
 set(LOG_BUFFER_SIZE 2048 CACHE STRING "Fixed log buffer size in bytes")
 set(BYTEBUFFER_SBO_MAX_SIZE 128 CACHE STRING "Fixed buffer on stack max size for ByteBuffer class (Used by packets on receive and send)")
-set(UNIQUEFUNCTION_SBO_MAX_SIZE 32 CACHE STRING "Fixed buffer on stack max size for UniqueFunction class")
\ No newline at end of file
+set(UNIQUEFUNCTION_SBO_MAX_SIZE 32 CACHE STRING "Fixed buffer on stack max size for UniqueFunction class")
+set(DEFERRER_ARENA_BLOCK_SIZE 4096 CACHE STRING "Size in bytes of each arena block used to store deferred callbacks in SYNC tick mode")
\ No newline at end of file
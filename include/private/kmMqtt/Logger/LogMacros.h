@@ -0,0 +1,80 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_LOGGER_LOGMACROS_H
+#define INCLUDE_PRIVATE_KMMQTT_LOGGER_LOGMACROS_H
+
+#include <kmMqtt/Logger/Log.h>
+
+//Values of the LOG_LEVEL_TARGET build option, logs below the compiled level are removed from the build.
+//Ordered as LogLevel, so the compiled level strips the same logs the runtime level would.
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_ERROR 4
+
+#if !defined(ENABLE_LOGS)
+#define COMPILED_LOG_LEVEL 999
+#elif defined(LOG_LEVEL)
+#define COMPILED_LOG_LEVEL LOG_LEVEL
+#else
+#define COMPILED_LOG_LEVEL LOG_LEVEL_TRACE
+#endif
+
+/**
+ * Library logging. Arguments are only evaluated once the logger's lowest log level lets the log through, so they may be
+ * expensive (ByteBuffer::toString(), allTopicsToStr()). Logs below the compiled level are never evaluated, they stay in
+ * an `if (false)` only so arguments used nowhere else do not trigger unused variable warnings.
+ */
+#define LOG_IF_ENABLED(logLevel, logFunction, ...)\
+	do\
+	{\
+		if (::kmMqtt::isLogLevelEnabled(logLevel))\
+		{\
+			::kmMqtt::logFunction(__VA_ARGS__);\
+		}\
+	} while (false)
+
+#define LOG_COMPILED_OUT(logFunction, ...)\
+	do\
+	{\
+		if (false)\
+		{\
+			::kmMqtt::logFunction(__VA_ARGS__);\
+		}\
+	} while (false)
+
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(...) LOG_IF_ENABLED(::kmMqtt::LogLevel::Trace, LogTrace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) LOG_COMPILED_OUT(LogTrace, __VA_ARGS__)
+#endif
+
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_IF_ENABLED(::kmMqtt::LogLevel::Info, LogInfo, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_COMPILED_OUT(LogInfo, __VA_ARGS__)
+#endif
+
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_IF_ENABLED(::kmMqtt::LogLevel::Debug, LogDebug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_COMPILED_OUT(LogDebug, __VA_ARGS__)
+#endif
+
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_WARNING
+#define LOG_WARNING(...) LOG_IF_ENABLED(::kmMqtt::LogLevel::Warning, LogWarning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) LOG_COMPILED_OUT(LogWarning, __VA_ARGS__)
+#endif
+
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_IF_ENABLED(::kmMqtt::LogLevel::Error, LogError, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_COMPILED_OUT(LogError, __VA_ARGS__)
+#endif
+
+#endif //INCLUDE_PRIVATE_KMMQTT_LOGGER_LOGMACROS_H
@@ -0,0 +1,82 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_LOGGER_LOGRECORD_H
+#define INCLUDE_PRIVATE_KMMQTT_LOGGER_LOGRECORD_H
+
+#include <kmMqtt/Interfaces/ILogger.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace kmMqtt
+{
+	/**
+	 * @brief Single producer, single consumer FIFO of length prefixed records in a fixed block of memory.
+	 *
+	 * Head and tail count bytes ever read and written, the producer only moves the tail and the consumer only moves the
+	 * head, so neither side takes a lock. Records are always stored contiguously, a record that does not fit before the
+	 * end of the block starts at offset 0.
+	 */
+	class LogRing
+	{
+	public:
+		explicit LogRing(std::size_t capacity);
+
+		/**
+		 * @brief Producer side, copy a record into the ring.
+		 * @return false if there is not enough free room right now.
+		 */
+		bool tryPush(const std::uint8_t* data, std::size_t size) noexcept;
+
+		/**
+		 * @brief Consumer side, oldest record without removing it.
+		 * @return false if the ring is empty.
+		 */
+		bool front(const std::uint8_t*& outData, std::uint32_t& outSize) noexcept;
+
+		/**
+		 * @brief Consumer side, remove the record returned by front().
+		 */
+		void pop() noexcept;
+
+		bool empty() const noexcept { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+		std::size_t capacity() const noexcept { return m_capacity; }
+
+	private:
+		static constexpr std::size_t k_lengthSize{ 4U };
+		static constexpr std::uint32_t k_wrapMarker{ 0xFFFFFFFFU };
+
+		void skipWrap(std::size_t& head) const noexcept;
+
+		std::unique_ptr<std::uint8_t[]> m_data;
+		std::size_t m_capacity;
+		std::atomic<std::size_t> m_head{ 0U };
+		std::atomic<std::size_t> m_tail{ 0U };
+	};
+
+	/**
+	 * @brief Capture a log call as a record: level, category and format pointers, then each argument the format consumes.
+	 * Integers and floating point values are stored widened, %s strings are copied.
+	 * @return Record size, 0 if it does not fit in `capacity` bytes.
+	 */
+	std::size_t encodeLogRecord(std::uint8_t* out, std::size_t capacity, LogLevel level, const char* category, const char* format, va_list args) noexcept;
+
+	/**
+	 * @brief Format a record written by encodeLogRecord(), giving the same text vsnprintf would have for the original call.
+	 */
+	void formatLogRecord(const std::uint8_t* record, std::size_t size, char* out, std::size_t outSize, LogLevel& outLevel, const char*& outCategory) noexcept;
+
+	/**
+	 * @brief Capture a log call into the calling thread's ring if asynchronous logging is running.
+	 * @return false if it is not running and the caller must write the log itself.
+	 */
+	bool tryLogAsync(LogLevel level, const char* category, const char* format, va_list args) noexcept;
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_LOGGER_LOGRECORD_H
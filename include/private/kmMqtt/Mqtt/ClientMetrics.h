@@ -0,0 +1,144 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_CLIENTMETRICS_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_CLIENTMETRICS_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/GlobalTypes.h"
+#include "kmMqtt/Mqtt/MqttClientMetrics.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Fixed size log-linear histogram of durations in microseconds, in the style of HdrHistogram.
+		 *
+		 * Values below 16 get a bucket each, above that every power of two is split into 16 buckets, so the relative error
+		 * stays under 1/16th from 1us up to the cap of 2^40us (~12 days). Recording is a handful of relaxed atomic adds,
+		 * safe from any thread and without allocation.
+		 */
+		class LatencyHistogram
+		{
+		public:
+			static constexpr std::uint32_t k_subBucketBits{ 4U };
+			static constexpr std::uint32_t k_subBucketCount{ 1U << k_subBucketBits };
+			static constexpr std::uint32_t k_maxValueBits{ 40U };
+			static constexpr std::uint64_t k_maxValue{ (static_cast<std::uint64_t>(1U) << k_maxValueBits) - 1U };
+			static constexpr std::size_t k_bucketCount{ (k_maxValueBits - k_subBucketBits + 1U) * k_subBucketCount };
+
+			LatencyHistogram() noexcept;
+
+			void record(std::uint64_t microseconds) noexcept;
+			void record(std::chrono::steady_clock::duration duration) noexcept;
+			void reset() noexcept;
+
+			LatencyHistogramSnapshot snapshot() const;
+
+			static std::size_t getBucketIndex(std::uint64_t value) noexcept;
+			static std::uint64_t getBucketUpperBound(std::size_t index) noexcept;
+
+		private:
+			std::array<std::atomic<std::uint64_t>, k_bucketCount> m_buckets;
+			std::atomic<std::uint64_t> m_sum{ 0U };
+			std::atomic<std::uint64_t> m_min{ UINT64_MAX };
+			std::atomic<std::uint64_t> m_max{ 0U };
+		};
+
+		/**
+		 * @brief Counters, gauges and latency histograms of one client, see MqttClientMetrics.
+		 *
+		 * Every value is a relaxed atomic, so snapshot() never blocks the tick loop and can be called from any thread. A
+		 * snapshot taken while the client is ticking is not a single consistent cut, each value is read on its own.
+		 */
+		class ClientMetrics
+		{
+		public:
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(ClientMetrics)
+
+			ClientMetrics() noexcept;
+
+			void addPacketSent(PacketType packetType, std::size_t bytes) noexcept;
+			void addPacketReceived(PacketType packetType, std::size_t bytes) noexcept;
+			void addPublishRetry() noexcept;
+			void addReconnect() noexcept;
+			void addDecodeError() noexcept;
+
+			void setSendQueueSize(std::size_t packets, std::size_t bytes) noexcept;
+			void setInFlight(std::size_t inFlight, std::size_t receiveMaximum) noexcept;
+			void setMemoryStats(const MqttClientMemoryStats& stats) noexcept;
+
+			/**
+			 * @brief A QoS 1/2 publish went out, start its acknowledgement latency. A resend keeps the original start time.
+			 */
+			void markPublishSent(std::uint16_t packetId, TimePoint now);
+
+			/**
+			 * @brief PUBACK or PUBREC received, record the time since markPublishSent() for the same packet ID.
+			 */
+			void markPublishAcknowledged(std::uint16_t packetId, TimePoint now) noexcept;
+
+			/**
+			 * @brief Forget publishes waiting for an acknowledgement, e.g. the session was discarded.
+			 */
+			void clearPendingAcks() noexcept;
+
+			void recordTickDuration(std::chrono::steady_clock::duration duration) noexcept { m_tickDuration.record(duration); }
+			void recordSocketSendTime(std::chrono::steady_clock::duration duration) noexcept { m_socketSendTime.record(duration); }
+
+			MqttClientMetrics snapshot() const;
+			MqttClientMemoryStats getMemoryStats() const noexcept;
+
+		private:
+			using Counters = std::array<std::atomic<std::uint64_t>, k_packetTypeCount>;
+
+			static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+			{
+				counter.fetch_add(value, std::memory_order_relaxed);
+			}
+
+			Counters m_packetsSent;
+			Counters m_bytesSent;
+			Counters m_packetsReceived;
+			Counters m_bytesReceived;
+
+			std::atomic<std::uint64_t> m_publishRetries{ 0U };
+			std::atomic<std::uint64_t> m_reconnects{ 0U };
+			std::atomic<std::uint64_t> m_decodeErrors{ 0U };
+
+			std::atomic<std::uint64_t> m_sendQueuePackets{ 0U };
+			std::atomic<std::uint64_t> m_sendQueueBytes{ 0U };
+			std::atomic<std::uint64_t> m_inFlightPublishes{ 0U };
+			std::atomic<std::uint64_t> m_receiveMaximum{ 0U };
+
+			std::atomic<std::uint64_t> m_sendQueueMemory{ 0U };
+			std::atomic<std::uint64_t> m_sendBufferMemory{ 0U };
+			std::atomic<std::uint64_t> m_receiveQueueMemory{ 0U };
+			std::atomic<std::uint64_t> m_pendingCallbackMemory{ 0U };
+			std::atomic<std::uint64_t> m_sessionStateMemory{ 0U };
+			std::atomic<std::uint64_t> m_propertyMemory{ 0U };
+			std::atomic<std::uint64_t> m_topicAliasMemory{ 0U };
+			std::atomic<std::uint64_t> m_offlineSpoolMemory{ 0U };
+			std::atomic<std::uint64_t> m_loggerMemory{ 0U };
+
+			LatencyHistogram m_publishAckLatency;
+			LatencyHistogram m_tickDuration;
+			LatencyHistogram m_socketSendTime;
+
+			std::unordered_map<std::uint16_t, TimePoint> m_publishSendTimes; //Unacknowledged QoS 1/2 publishes by packet ID.
+			std::mutex m_publishSendTimesMutex;
+		};
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_CLIENTMETRICS_H
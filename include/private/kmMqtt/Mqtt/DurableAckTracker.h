@@ -0,0 +1,104 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_DURABLEACKTRACKER_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_DURABLEACKTRACKER_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/Enums/Qos.h"
+#include "kmMqtt/Mqtt/State/SessionState/IAsyncSessionStatePersistantStore.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Holds PUBACK/PUBREC for received publishes until an asynchronous session state store reports that the
+		 * changes made before them are durable.
+		 *
+		 * Acks are grouped into batches, one durability barrier per batch (usually one per received packet batch), and
+		 * released strictly in batch order so acks still go out in the order the publishes were received.
+		 * hold() may be called from any thread, everything else is called by the internal tick loop.
+		 */
+		class DurableAckTracker
+		{
+		public:
+			struct Ack
+			{
+				Qos qos;
+				std::uint16_t packetId;
+			};
+
+			/**
+			 * @param onBatchCompleted Called from the store's thread whenever a barrier completes, used to wake the tick loop.
+			 */
+			explicit DurableAckTracker(std::function<void()> onBatchCompleted);
+			~DurableAckTracker() noexcept;
+
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(DurableAckTracker)
+
+			/**
+			 * @brief Hold an ack until the next barrier requested after this call completes.
+			 */
+			void hold(Qos qos, std::uint16_t packetId);
+
+			/**
+			 * @brief Put all acks held since the last call behind a new durability barrier on the store.
+			 */
+			void requestBarrier(IAsyncSessionStatePersistantStore& store);
+
+			/**
+			 * @brief Take the acks of every completed batch at the front of the queue, in order.
+			 *
+			 * @param outAcks Acks that are now durable and can be sent.
+			 * @return Number of acks dropped because their barrier failed.
+			 */
+			std::size_t takeReleased(std::vector<Ack>& outAcks);
+
+			/**
+			 * @brief True if acks are held and not yet behind a barrier, or a barrier has completed but was not taken yet.
+			 */
+			bool hasWork() const;
+
+			/**
+			 * @brief Drop all held acks, e.g. when the connection they belong to is gone.
+			 * Barriers still in flight complete into nothing.
+			 */
+			void clear();
+
+		private:
+			struct Batch
+			{
+				std::uint64_t id;
+				std::vector<Ack> acks;
+			};
+
+			//Shared with the store's callbacks, which can outlive the tracker.
+			struct Completions
+			{
+				std::mutex mutex;
+				std::map<std::uint64_t, bool> results;
+				std::function<void()> onBatchCompleted;
+			};
+
+			mutable std::mutex m_mutex;
+			std::vector<Ack> m_unbarrieredAcks;
+			std::deque<Batch> m_batches;
+			std::uint64_t m_nextBatchId{ 1U };
+
+			std::shared_ptr<Completions> m_completions;
+		};
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_DURABLEACKTRACKER_H
@@ -0,0 +1,112 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_INBOUNDFLOWCONTROL_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_INBOUNDFLOWCONTROL_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/Enums/Qos.h"
+#include "kmMqtt/Mqtt/Params/ReceiveQueueOptions.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Tracks the inbound backlog against the ReceiveQueueOptions watermarks and holds PUBACK/PUBREC while it is
+		 * over them.
+		 *
+		 * The backlog is the last reported size of the receive queue plus publishes handed to the consumer whose callback
+		 * has not returned. Pauses once either reaches its high watermark and resumes once both are back at their low
+		 * watermark. Once acks are held, later acks are held behind them until released, so they keep the order the
+		 * publishes were received in.
+		 * Thread safe, deliveries complete on dispatcher threads while the tick loop updates the receive queue size.
+		 */
+		class InboundFlowControl
+		{
+		public:
+			struct Ack
+			{
+				Qos qos;
+				std::uint16_t packetId;
+			};
+
+			void setOptions(const ReceiveQueueOptions& options) noexcept;
+
+			/**
+			 * @brief Report the bytes and packets waiting in the receive queue to be decoded.
+			 */
+			void setReceiveQueueSize(std::size_t bytes, std::size_t packets) noexcept;
+
+			/**
+			 * @brief A publish of `bytes` was handed to the consumer.
+			 */
+			void addDelivery(std::size_t bytes) noexcept;
+
+			/**
+			 * @brief A waiting publish was replaced by a newer one of a different size, e.g. by inbound conflation.
+			 */
+			void resizeDelivery(std::size_t oldBytes, std::size_t newBytes) noexcept;
+
+			/**
+			 * @brief The publish callback for a delivery of `bytes` has returned.
+			 * @return true if this drained the backlog enough to resume reading, the tick loop should be woken.
+			 */
+			bool completeDelivery(std::size_t bytes) noexcept;
+
+			/**
+			 * @brief Hold an ack if reading is paused or earlier acks are still held.
+			 * @return false if the ack can be sent now.
+			 */
+			bool tryHoldAck(Qos qos, std::uint16_t packetId);
+
+			/**
+			 * @brief Take every held ack, in order, once reading is no longer paused.
+			 */
+			void takeReleasedAcks(std::vector<Ack>& outAcks);
+
+			/**
+			 * @brief Drop held acks, e.g. when the connection they belong to is gone. The broker redelivers the publishes.
+			 */
+			void clearHeldAcks() noexcept;
+
+			/**
+			 * @brief Forget publishes handed to the consumer, e.g. when their pending callbacks were dropped with the client
+			 * state. Callbacks completing afterwards do not take the backlog below zero.
+			 */
+			void clearDeliveries() noexcept;
+
+			bool isPaused() const noexcept;
+			std::size_t getHeldAckCount() const noexcept;
+			std::size_t getPauseCount() const noexcept;
+
+			/**
+			 * @brief Bytes of the publishes handed to the consumer whose callback has not returned.
+			 */
+			std::size_t getDeliveryBytes() const noexcept;
+
+		private:
+			void updatePaused() noexcept;
+
+			ReceiveQueueOptions m_options;
+
+			mutable std::mutex m_mutex;
+			std::size_t m_receiveQueueBytes{ 0U };
+			std::size_t m_receiveQueuePackets{ 0U };
+			std::size_t m_deliveryBytes{ 0U };
+			std::size_t m_deliveryMessages{ 0U };
+			bool m_isPaused{ false };
+			std::size_t m_pauseCount{ 0U };
+			std::vector<Ack> m_heldAcks;
+		};
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_INBOUNDFLOWCONTROL_H
@@ -0,0 +1,44 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_MESSAGEEXPIRY_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_MESSAGEEXPIRY_H
+
+#include "kmMqtt/GlobalTypes.h"
+#include "kmMqtt/Mqtt/Params/PublishOptions.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Rewrite the message expiry interval of a publish held by the client for `held`, e.g. queued or spooled, to
+		 * the time it has left. The broker must see the time left, not the full interval. Rounded up so the message never
+		 * expires early, and at least 1 second.
+		 * Options without a message expiry interval are left unchanged.
+		 *
+		 * @return false if the interval already passed while held.
+		 */
+		inline bool applyHeldTimeToMessageExpiry(PublishOptions& options, Milliseconds held) noexcept
+		{
+			if (!options.addMessageExpiryInterval)
+			{
+				return true;
+			}
+
+			const std::int64_t expiryMs{ static_cast<std::int64_t>(options.messageExpiryInterval) * 1000 };
+			const std::int64_t heldMs{ static_cast<std::int64_t>(held.count()) };
+
+			options.messageExpiryInterval = static_cast<std::uint32_t>(std::max<std::int64_t>((expiryMs - heldMs + 999) / 1000, 1));
+
+			return heldMs < expiryMs;
+		}
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_MESSAGEEXPIRY_H
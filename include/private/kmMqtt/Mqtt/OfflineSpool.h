@@ -0,0 +1,136 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_OFFLINESPOOL_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_OFFLINESPOOL_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/Params/OfflineSpoolOptions.h"
+#include "kmMqtt/Mqtt/State/SessionState/MessageContainerData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief FIFO of length prefixed records in a fixed block of memory, wrapping around at the end.
+		 * Records are always stored contiguously, a record that does not fit before the end of the block starts at offset 0.
+		 */
+		class SpoolRing
+		{
+		public:
+			void reset(std::uint8_t* base, std::size_t capacity) noexcept;
+
+			bool push(const std::vector<std::uint8_t>& record) noexcept;
+			bool front(const std::uint8_t*& outData, std::uint32_t& outSize) noexcept;
+			void pop() noexcept;
+
+			bool empty() const noexcept { return m_count == 0U; }
+			bool canEverFit(std::size_t recordSize) const noexcept { return recordSize + k_lengthSize <= m_capacity; }
+			std::size_t getCount() const noexcept { return m_count; }
+			std::size_t getUsedBytes() const noexcept { return m_usedBytes; }
+
+		private:
+			static constexpr std::size_t k_lengthSize{ 4U };
+			static constexpr std::uint32_t k_wrapMarker{ 0xFFFFFFFFU };
+
+			void skipWrap() noexcept;
+
+			std::uint8_t* m_base{ nullptr };
+			std::size_t m_capacity{ 0U };
+			std::size_t m_head{ 0U };
+			std::size_t m_tail{ 0U };
+			std::size_t m_count{ 0U };
+			std::size_t m_usedBytes{ 0U };
+		};
+
+		/**
+		 * @brief Holds publishes made while the client is not connected and hands them back in order, rate limited, once it is.
+		 *
+		 * New publishes go to the memory ring until it is full, then to the memory-mapped spill file. Once anything is in the
+		 * file, new publishes keep going there until it drains, so every file record is newer than every memory record and
+		 * draining memory first preserves publish order.
+		 * Not thread safe, the client serializes access.
+		 */
+		class OfflineSpool
+		{
+		public:
+			explicit OfflineSpool(const OfflineSpoolOptions& options);
+			~OfflineSpool() noexcept;
+
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(OfflineSpool)
+
+			/**
+			 * @brief Spool a publish.
+			 * @return false if there is no room, with OfflineSpoolOverflow::DROP_OLDEST only if the message can never fit.
+			 */
+			bool push(const char* topic, const ByteBuffer& payload, const PublishOptions& options);
+
+			/**
+			 * @brief Take the oldest spooled publish that has not expired. Message expiry is rewritten to the time it has left.
+			 * @return false if the spool is empty.
+			 */
+			bool pop(PublishMessageData& outData, TimePoint now);
+
+			/**
+			 * @brief Refill the drain budget to the full burst, e.g. when a new connection is established.
+			 */
+			void resetDrainBudget(TimePoint now) noexcept;
+
+			/**
+			 * @brief Consume one publish worth of drain budget.
+			 * @return false if the drain rate has been reached for now.
+			 */
+			bool tryTakeDrainToken(TimePoint now) noexcept;
+
+			/**
+			 * @brief Time at which the next publish may be drained, now if the budget allows it already.
+			 */
+			TimePoint nextDrainTime(TimePoint now) const noexcept;
+
+			bool empty() const noexcept { return m_memoryRing.empty() && m_fileRing.empty(); }
+			std::size_t getCount() const noexcept { return m_memoryRing.getCount() + m_fileRing.getCount(); }
+			std::size_t getUsedBytes() const noexcept { return m_memoryRing.getUsedBytes() + m_fileRing.getUsedBytes(); }
+			std::size_t getMemoryUsedBytes() const noexcept { return m_memoryRing.getUsedBytes(); }
+			std::size_t getDroppedCount() const noexcept { return m_droppedCount; }
+			std::size_t getExpiredCount() const noexcept { return m_expiredCount; }
+
+		private:
+			bool tryPushRecord(const std::vector<std::uint8_t>& record) noexcept;
+			SpoolRing* oldestRing() noexcept;
+			bool openSpillFile(std::size_t capacity) noexcept;
+			void closeSpillFile() noexcept;
+			void refillDrainTokens(TimePoint now) noexcept;
+
+			OfflineSpoolOptions m_options;
+
+			std::vector<std::uint8_t> m_memory;
+			SpoolRing m_memoryRing;
+			SpoolRing m_fileRing;
+
+			std::uint8_t* m_mappedFile{ nullptr };
+			std::size_t m_mappedSize{ 0U };
+#if defined(_WIN32)
+			void* m_fileHandle{ nullptr };
+			void* m_mappingHandle{ nullptr };
+#else
+			int m_fileDescriptor{ -1 };
+#endif
+
+			double m_drainTokens{ 0.0 };
+			TimePoint m_lastDrainRefill{};
+
+			std::size_t m_droppedCount{ 0U };
+			std::size_t m_expiredCount{ 0U };
+		};
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_OFFLINESPOOL_H
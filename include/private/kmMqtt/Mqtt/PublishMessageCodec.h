@@ -0,0 +1,68 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_PUBLISHMESSAGECODEC_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_PUBLISHMESSAGECODEC_H
+
+#include "kmMqtt/Mqtt/State/SessionState/MessageContainerData.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Appends big endian values to a byte vector. Used for the on-disk formats of the session store and offline spool.
+		 */
+		struct BinaryWriter
+		{
+			std::vector<std::uint8_t>& out;
+
+			void u8(std::uint8_t v) { out.push_back(v); }
+			void u16(std::uint16_t v) { u8(static_cast<std::uint8_t>(v >> 8)); u8(static_cast<std::uint8_t>(v)); }
+			void u32(std::uint32_t v) { u16(static_cast<std::uint16_t>(v >> 16)); u16(static_cast<std::uint16_t>(v)); }
+			void i64(std::int64_t v) { u32(static_cast<std::uint32_t>(static_cast<std::uint64_t>(v) >> 32)); u32(static_cast<std::uint32_t>(v)); }
+			void bytes(const std::uint8_t* data, std::size_t size) { out.insert(out.end(), data, data + size); }
+			void str(const std::string& v) { u16(static_cast<std::uint16_t>(v.size())); bytes(reinterpret_cast<const std::uint8_t*>(v.data()), std::min<std::size_t>(v.size(), 0xFFFFU)); }
+		};
+
+		/**
+		 * @brief Reads big endian values written by BinaryWriter. Reading past the end sets ok to false and returns zeros.
+		 */
+		struct BinaryReader
+		{
+			const std::uint8_t* data;
+			std::size_t size;
+			std::size_t pos{ 0U };
+			bool ok{ true };
+
+			bool has(std::size_t n) { ok = ok && (size - pos) >= n; return ok; }
+			std::uint8_t u8() { return has(1U) ? data[pos++] : 0U; }
+			std::uint16_t u16() { const std::uint16_t hi{ u8() }; return static_cast<std::uint16_t>((hi << 8) | u8()); }
+			std::uint32_t u32() { const std::uint32_t hi{ u16() }; return (hi << 16) | u16(); }
+			std::int64_t i64() { const std::uint64_t hi{ u32() }; return static_cast<std::int64_t>((hi << 32) | u32()); }
+			const std::uint8_t* bytes(std::size_t n) { if (!has(n)) return nullptr; const std::uint8_t* p{ data + pos }; pos += n; return p; }
+			std::string str() { const std::uint16_t n{ u16() }; const std::uint8_t* p{ bytes(n) }; return p != nullptr ? std::string(reinterpret_cast<const char*>(p), n) : std::string{}; }
+		};
+
+		/**
+		 * @brief Serialize topic, payload and publish options of a message.
+		 */
+		void encodePublishMessageData(BinaryWriter& writer, const PublishMessageData& data);
+
+		/**
+		 * @brief Deserialize a message written by encodePublishMessageData().
+		 * @return false if the data is truncated.
+		 */
+		bool decodePublishMessageData(BinaryReader& reader, PublishMessageData& outData);
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_PUBLISHMESSAGECODEC_H
@@ -0,0 +1,52 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_PRIVATE_KMMQTT_MQTT_TRACING_TRACE_H
+#define INCLUDE_PRIVATE_KMMQTT_MQTT_TRACING_TRACE_H
+
+#include "kmMqtt/Mqtt/Tracing/ITraceSink.h"
+#include "kmMqtt/Mqtt/Tracing/IWireCaptureSink.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Stamp a lifecycle event if tracing is enabled, a single null check otherwise.
+		 */
+		inline void trace(ITraceSink* const sink, TraceStage stage, PacketType packetType, std::uint16_t packetId, std::size_t bytes, TimePoint time) noexcept
+		{
+			if (sink != nullptr)
+			{
+				sink->onTraceEvent({ stage, packetType, packetId, static_cast<std::uint32_t>(bytes), time });
+			}
+		}
+
+		inline void trace(ITraceSink* const sink, TraceStage stage, PacketType packetType, std::uint16_t packetId, std::size_t bytes = 0U) noexcept
+		{
+			if (sink != nullptr)
+			{
+				sink->onTraceEvent({ stage, packetType, packetId, static_cast<std::uint32_t>(bytes), std::chrono::steady_clock::now() });
+			}
+		}
+
+		/**
+		 * @brief Copy socket bytes if wire capture is enabled, a single null check otherwise.
+		 */
+		inline void captureWire(IWireCaptureSink* const sink, WireDirection direction, const std::uint8_t* bytes, std::size_t size) noexcept
+		{
+			if (sink != nullptr)
+			{
+				sink->onWireBytes(direction, bytes, size, std::chrono::steady_clock::now());
+			}
+		}
+	}
+}
+
+#endif //INCLUDE_PRIVATE_KMMQTT_MQTT_TRACING_TRACE_H
@@ -11,6 +11,7 @@
 #include <kmMqtt/Mqtt/MqttConnectionInfo.h>
 #include <cstdint>
 #include <functional>
+#include <string>
 #include <kmMqtt/Mqtt/Packets/ErrorCodes.h>
 #include <kmMqtt/Mqtt/Transport/SendResultData.h>
 
@@ -53,6 +54,18 @@ namespace kmMqtt
 			ByteBuffer encodedData;
 		};
 
+		/**
+		 * @brief Send queue lane of a packet, lower values are sent first.
+		 */
+		enum class SendPriority : std::uint8_t
+		{
+			CONTROL, //Pings, acks, subscribes and any other non publish packet.
+			QOS, //QoS 1 and QoS 2 publishes.
+			BULK, //QoS 0 publishes.
+			DISCONNECT, //Graceful disconnect, sent once the publishes queued before it are, nothing is sent after it.
+			_COUNT
+		};
+
 		/**
 		 * @brief Interface for packet composer jobs.
 		 * Used internally in SendQueue to create packets to be sent over the network.
@@ -84,6 +97,48 @@ namespace kmMqtt
 			 */
 			virtual Qos getQos() const noexcept { return Qos::QOS_0; };
 
+			/**
+			 * @brief Rough size of the encoded packet, used to account queued bytes before the packet is composed.
+			 * 
+			 * @return Estimated size in bytes. Defaults to 0 for small control packets, which are only counted as packets.
+			 */
+			virtual std::size_t getEstimatedSize() const noexcept { return 0U; };
+
+			/**
+			 * @brief Lane the packet is queued in.
+			 * 
+			 * @return SendPriority. Defaults to SendPriority::CONTROL.
+			 */
+			virtual SendPriority getPriority() const noexcept { return SendPriority::CONTROL; };
+
+			/**
+			 * @brief Key under which a newer queued packet replaces this one while it is unsent.
+			 * 
+			 * @return Conflation key, or nullptr if the packet is never conflated (default).
+			 */
+			virtual const std::string* getConflationKey() const noexcept { return nullptr; };
+
+			/**
+			 * @brief Take over the contents of a newer packet with the same conflation key, keeping this packet's place in the queue.
+			 * Only called with a packet of the same type, as conflation keys are only returned by one packet type.
+			 */
+			virtual void conflate(IPacketComposer&& newer) noexcept { (void)newer; };
+
+			/**
+			 * @brief Whether the packet has outlived its message expiry interval while queued, and should be dropped unsent.
+			 * Only packets never sent before can expire, dropping one frees its packet ID.
+			 * 
+			 * @return True if the packet has expired, false if it never expires (default).
+			 */
+			virtual bool isExpired(TimePoint now) const noexcept { (void)now; return false; };
+
+			/**
+			 * @brief Packet ID the packet is sent with.
+			 * 
+			 * @return Packet ID, or 0 if the packet has none or does not expose it (default).
+			 */
+			virtual std::uint16_t getPacketId() const noexcept { return 0U; };
+
 			/**
 			 * @brief Compose the packet ready for sending across the network.
 			 * 
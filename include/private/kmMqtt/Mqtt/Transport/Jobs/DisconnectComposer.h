@@ -28,6 +28,7 @@ namespace kmMqtt
 
 			ComposeResult compose() noexcept override;
 			void cancel() noexcept override;
+			SendPriority getPriority() const noexcept override { return SendPriority::DISCONNECT; };
 
 		private:
 			DisconnectArgs m_options;
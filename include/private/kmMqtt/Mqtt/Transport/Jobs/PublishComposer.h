@@ -25,11 +25,18 @@ namespace kmMqtt
 				ByteBuffer&& payload,
 				PublishOptions&& pubOptions,
 				ReceiveMaximumTracker* recMaxTracker,
-				bool isDup) noexcept;
+				bool isDup,
+				TimePoint queuedTime) noexcept;
 
 			bool canSend() const noexcept override;
 			ComposeResult compose() noexcept override;
 			Qos getQos() const noexcept override;
+			std::size_t getEstimatedSize() const noexcept override;
+			SendPriority getPriority() const noexcept override;
+			const std::string* getConflationKey() const noexcept override;
+			void conflate(IPacketComposer&& newer) noexcept override;
+			bool isExpired(TimePoint now) const noexcept override;
+			std::uint16_t getPacketId() const noexcept override;
 			void cancel() noexcept override;
 
 		private:
@@ -40,6 +47,7 @@ namespace kmMqtt
 			PublishOptions m_publishOptions;
 			ReceiveMaximumTracker* m_recMaxTracker;
 			bool m_isDup{ false };
+			TimePoint m_queuedTime; //When the message was first published, message expiry counts from here.
 		};
 	}
 }
@@ -19,6 +19,7 @@
 #include "kmMqtt/Mqtt/Packets/Publish/PublishComp.h"
 #include "kmMqtt/Mqtt/Packets/Publish/PublishRec.h"
 #include "kmMqtt/Mqtt/Packets/Publish/PublishRel.h"
+#include "kmMqtt/Mqtt/Tracing/ITraceSink.h"
 
 #include <queue>
 #include <mutex>
@@ -42,6 +43,8 @@ namespace kmMqtt
 		using PingRespCallback = std::function<void(PingResp&&)>;
 
 		struct ReceiveMaximumTracker;
+		class InboundFlowControl;
+		class ClientMetrics;
 
 		/**
 		 * @brief Queue for receiving MQTT packets into the internal system.
@@ -63,6 +66,8 @@ namespace kmMqtt
 			void addToQueue(ByteBuffer&& byteBuffer);
 			const DecodeResult receiveNextBatch();
 			void clear() noexcept;
+			bool hasPendingPackets() noexcept;
+			std::size_t getQueuedBytes() noexcept;
 
 			void setConnectAcknowledgeCallback(ConAckCallback& callback) noexcept;
 			void setDisconnectCallback(DisconnectCallback& callback) noexcept;
@@ -76,9 +81,20 @@ namespace kmMqtt
 			void setPingResponseCallback(PingRespCallback& callback) noexcept;
 
 			void setReceiveMaximumTracker(ReceiveMaximumTracker* const tracker) noexcept;
+			void setInboundFlowControl(InboundFlowControl* const flowControl) noexcept;
+			void setMetrics(ClientMetrics* const metrics) noexcept;
+
+			/**
+			 * @brief Stamp frame received and decoded for every packet. While set, the time each packet is queued is kept
+			 * until it is decoded.
+			 */
+			void setTraceSink(ITraceSink* const traceSink) noexcept;
 		private:
 			std::queue<ByteBuffer> m_inQueueData;
 			std::queue<ByteBuffer> m_inProgressData;
+			std::size_t m_inQueueBytes{ 0U };
+			std::queue<TimePoint> m_inQueueFrameTimes; //Only filled while tracing, one per packet in m_inQueueData.
+			std::queue<TimePoint> m_inProgressFrameTimes;
 
 			//Callbacks
 			ConAckCallback m_conAckCallback;
@@ -93,6 +109,9 @@ namespace kmMqtt
 			PubRelCallback m_pubRelCallback;
 
 			ReceiveMaximumTracker* m_receiveMaximumTrackerPtr{ nullptr };
+			InboundFlowControl* m_inboundFlowControlPtr{ nullptr }; //Kept across clear(), set once by the owning client.
+			ClientMetrics* m_metricsPtr{ nullptr }; //Kept across clear(), set once by the owning client.
+			ITraceSink* m_traceSinkPtr{ nullptr }; //Kept across clear(), set once by the owning client.
 
 			std::mutex m_mutex;
 		};
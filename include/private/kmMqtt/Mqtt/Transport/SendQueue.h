@@ -7,12 +7,23 @@
 #define INCLUDE_KMMQTT_MQTT_SENDQUEUE_H
 
 #include <kmMqtt/GlobalMacros.h>
+#include <kmMqtt/GlobalTypes.h>
 #include <kmMqtt/Mqtt/Transport/IPacketComposer.h>
 #include <kmMqtt/Interfaces/IWebSocket.h>
+#include <kmMqtt/Mqtt/Params/SendQueueOptions.h>
+#include <kmMqtt/Mqtt/Tracing/ITraceSink.h>
+#include <kmMqtt/Mqtt/Tracing/IWireCaptureSink.h>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace kmMqtt
 {
@@ -28,27 +39,54 @@ namespace kmMqtt
 			bool isRecoverable{ true };
 			std::string unrecoverableReasonStr;
 			SendResultData lastSendResult;
+			bool becameWritable{ false }; //Queue was full and has drained to its low watermarks during this batch.
 		};
 
 		using PacketSendJobPtr = std::unique_ptr<IPacketComposer>;
 
+		/**
+		 * @brief Fixed format acknowledgement (PUBACK, PUBREC, PUBREL or PUBCOMP) with SUCCESS reason code and no properties.
+		 * Encoded straight into the send buffer as 4 bytes, skipping the packet composer and BasePacket machinery.
+		 */
+		struct AckPacket
+		{
+			PacketType packetType{ PacketType::PUBLISH_ACKNOWLEDGE };
+			std::uint16_t packetId{ 0U };
+		};
+
 		struct ReceiveMaximumTracker;
+		class ClientMetrics;
 
 		/**
 		 * @brief Handles the processing and sending of queued up MQTT packets.
-		 * - Stores a queue of packet composers, these are run to construct the encoded packet ready for transport across the network.
+		 * - Stores packet composers in priority lanes (control, QoS 1/2 publishes, QoS 0 publishes), these are run to construct the
+		 *   encoded packet ready for transport across the network. Control packets are composed first every batch, publish
+		 *   lanes are interleaved by weight and capped per batch, so pings and acks never queue behind bulk publishes.
+		 *   A graceful DISCONNECT waits in its own lane until the publishes queued before it are composed, and ends the batch.
 		 * - Encoded packets are first merged into a single byte buffer to minimise send calls.
 		 * - Tries to send the whole buffer across, but if unsuccesfull will proccess the remaining bytes next tick.
-		 * 
-		 * //TODO possible overflow if sending doesnt catch up to data queued up?
+		 * - Tracks queued bytes (estimated for packets not composed yet, plus unsent bytes in the buffer) and queued packets
+		 *   against the watermarks in SendQueueOptions, so producers can be held back when sending does not keep up.
 		 */
 		class SendQueue
 		{
+			enum class FlushTrigger : std::uint8_t
+			{
+				NOT_DUE,
+				IMMEDIATE,
+				IDLE,
+				DEADLINE,
+				THRESHOLD,
+				PIGGYBACK,
+			};
+
 			struct PacketSectionMetadata
 			{
 				std::size_t endByteInBuffer{ 0U };
 				PacketType packetType{ PacketType::RESERVED };
 				std::uint16_t packetId{ 0U };
+				std::size_t packetSize{ 0U };
+				bool isFirstByteSent{ false }; //Only tracked while tracing.
 			};
 
 		public:
@@ -57,19 +95,105 @@ namespace kmMqtt
 
 			void setSocket(std::shared_ptr<IWebSocket> socket) noexcept;
 			void setReceiveMaximumTracker(ReceiveMaximumTracker* const tracker) noexcept;
+			void setMetrics(ClientMetrics* const metrics) noexcept;
+
+			/**
+			 * @brief Stamp composed, first byte sent and last byte sent for every packet. While set, every packet in the
+			 * send buffer is tracked, not only the ones with sent callbacks.
+			 */
+			void setTraceSink(ITraceSink* const traceSink) noexcept;
+			void setWireCaptureSink(IWireCaptureSink* const wireCaptureSink) noexcept;
+			void setOptions(const SendQueueOptions& options) noexcept;
 			void addToQueue(PacketSendJobPtr packetSendJob);
+
+			/**
+			 * @brief False from the moment a high watermark is reached until the queue drains to the low watermarks.
+			 * Safe to call from any thread. Not atomic with a following addToQueue(), so the watermarks are soft limits.
+			 */
+			bool isWritable() const noexcept { return !m_isFull; }
+
+			/**
+			 * @brief Block the calling thread until the queue is writable, or the timeout passes.
+			 * Another thread must be sending for the queue to drain.
+			 * 
+			 * @return true if the queue is writable.
+			 */
+			bool waitUntilWritable(Milliseconds timeout);
+
+			/**
+			 * @brief Queue a fixed format acknowledgement. Safe to call from any thread.
+			 * Queued acks are encoded into the send buffer together on the next flushAcknowledgements() or sendNextBatch().
+			 */
+			void addAcknowledgement(PacketType packetType, std::uint16_t packetId);
+
+			/**
+			 * @brief Encode all queued acknowledgements straight into the send buffer in one go.
+			 */
+			void flushAcknowledgements();
+
 			void sendNextBatch(SendBatchResult& outResult);
 			void clearQueue(const bool graceful = false) noexcept;
 
+			/**
+			 * @brief Earliest time sendNextBatch() has work to do.
+			 * `now` if there are unsent bytes or sendable packets queued, the end of the retry back-off if a batch failed,
+			 * or TimePoint::max() if nothing can be sent (e.g. all packets are held back by receive maximum).
+			 */
+			TimePoint nextSendTime(TimePoint now) noexcept;
+
+			/**
+			 * @brief Time the flush policy releases publishes it is holding back, TimePoint::max() if it holds none.
+			 * Unlike nextSendTime() it ignores unsent bytes, so a tick loop can wait on it while the socket is backed up.
+			 */
+			TimePoint nextFlushTime(TimePoint now) noexcept;
+
+			/**
+			 * @brief Number of queued publishes replaced in place by a newer conflated publish to the same topic.
+			 */
+			std::size_t getConflatedCount() const noexcept { return m_conflatedCount; }
+
+			/**
+			 * @brief Number of queued publishes dropped unsent because their message expiry interval passed.
+			 */
+			std::size_t getExpiredCount() const noexcept { return m_expiredCount; }
+
+			/**
+			 * @brief Estimated size of the queued packets not composed yet, and composed bytes not sent yet.
+			 * Call from the thread running sendNextBatch(), the send buffer is only changed by it.
+			 */
+			void getQueuedBytes(std::size_t& outQueuedBytes, std::size_t& outSendBufferBytes);
+
 			void setOnPingSentCallback(const std::function<void()>& callback) noexcept;
 			void setOnPubCompSentCallback(const std::function<void(std::uint16_t)>& callback) noexcept;
 			void setOnPubRelSentCallback(const std::function<void(std::uint16_t)>& callback) noexcept;
 			void setOnPubRecSentCallback(const std::function<void(std::uint16_t)>& callback) noexcept;
 			void setOnDisconnectSentCallback(const std::function<void()>& callback) noexcept;
+			void setOnPublishExpiredCallback(const std::function<void(std::uint16_t)>& callback) noexcept;
 
 		private:
+			void processNextBatch(SendBatchResult& outResult);
 			bool trySendBatch(SendBatchResult& outResult, SendResultData& outLastSendResult);
+			bool composeNextInLane(std::deque<PacketSendJobPtr>& lane, std::size_t& fullOutgoingDataSize, SendBatchResult& outResult, SendResultData& outLastSendResult);
+			void notifySentPackets(std::size_t bytesSent);
+			void traceSentPackets(std::size_t bytesSent) noexcept;
+			void cancelQueuedPackets() noexcept;
+			std::size_t getQueuedPacketCount() const noexcept;
+			std::size_t getQueuedPublishCount() const noexcept;
+			bool hasSendableControlPacket() const noexcept;
+			bool hasSendablePublish() const noexcept;
+			FlushTrigger getFlushTrigger(TimePoint now) const noexcept;
+			void updateAdaptiveFlushTarget(FlushTrigger trigger) noexcept;
+			bool applyTcpOptions(bool isMultiPacketBatch) noexcept;
+			void appendAcknowledgements();
+			void reserveSendBuffer(std::size_t size);
 			int sendData(const ByteBuffer& data);
+			void updateWritableState(SendBatchResult& outResult) noexcept;
+			bool isAtHighWatermark() const noexcept;
+			bool isAtLowWatermark() const noexcept;
+			void reportQueueSize() noexcept;
+
+			//Every packet is tracked until sent for tracing and metrics, otherwise only those with a sent callback.
+			bool isTrackingAllPackets() const noexcept { return m_traceSinkPtr != nullptr || m_metricsPtr != nullptr; }
 
 			std::shared_ptr<IWebSocket> m_socket;
 			std::function<void()> m_onPingSentCallback;
@@ -77,6 +201,7 @@ namespace kmMqtt
 			std::function<void(std::uint16_t)> m_onPubRelSentCallback;
 			std::function<void(std::uint16_t)> m_onPubRecSentCallback;
 			std::function<void()> m_onDisconnectSentCallback;
+			std::function<void(std::uint16_t)> m_onPublishExpiredCallback;
 			ByteBuffer m_sendBuffer;
 
 			std::uint8_t m_currentLocalRetry{ 0U };
@@ -87,13 +212,37 @@ namespace kmMqtt
 			const std::chrono::milliseconds k_retryDelayMs{ 250 };
 			std::chrono::steady_clock::time_point m_lastRetryTime;
 
-			std::vector<PacketSendJobPtr> m_nextPacketComposersBatch;
+			std::array<std::deque<PacketSendJobPtr>, static_cast<std::size_t>(SendPriority::_COUNT)> m_lanes;
+			std::unordered_map<std::string, IPacketComposer*> m_conflationIndex; //Unsent conflatable publishes by topic.
+			std::atomic<std::size_t> m_conflatedCount{ 0U };
+			std::atomic<std::size_t> m_expiredCount{ 0U };
+			std::vector<std::uint16_t> m_expiredPacketIds; //Dropped this batch under m_mutex, listener is notified once it is released.
+			std::vector<std::uint16_t> m_expiredPacketIdsToNotify; //Swapped with m_expiredPacketIds, keeps both allocations alive between batches.
+			std::vector<ByteBuffer> m_encodedDataQueue; //Encoded packets of the batch being composed, kept to reuse its allocation.
 			std::vector<PacketSectionMetadata> m_packetsMetadataInBuffer;
 
+			std::vector<AckPacket> m_pendingAcks; //Filled from any thread under m_ackMutex.
+			std::vector<AckPacket> m_acksToAppend; //Swapped with m_pendingAcks under m_mutex, keeps both allocations alive between batches.
+			std::mutex m_ackMutex;
+
 			ReceiveMaximumTracker* m_receiveMaximumTrackerPtr{ nullptr };
+			ClientMetrics* m_metricsPtr{ nullptr };
+			ITraceSink* m_traceSinkPtr{ nullptr };
+			IWireCaptureSink* m_wireCaptureSinkPtr{ nullptr };
+
+			SendQueueOptions m_options;
+			std::size_t m_queuedComposerBytes{ 0U }; //Estimated size of all packets in m_lanes.
+			std::atomic<bool> m_isFull{ false }; //Written under m_mutex.
+			std::condition_variable m_writableCondition;
+
+			TimePoint m_oldestQueuedPublishTime{}; //Enqueue time of the oldest publish not flushed yet.
+			TimePoint m_lastPublishFlushTime{};
+			std::size_t m_adaptiveFlushPackets{ 1U };
+			int m_tcpOptionsHandle{ -1 }; //Handle TCP_NODELAY was last applied to.
 
 			std::mutex m_mutex;
 			bool m_startGracefulClear{ false };
+			bool m_isDisconnectComposed{ false }; //DISCONNECT is in the send buffer, nothing may be composed behind it.
 		};
 	}
 }
@@ -8,10 +8,12 @@
 
 #include "kmMqtt/Utils/Event.h"
 #include "kmMqtt/GlobalMacros.h"
-#include <queue>
-#include <mutex>
-#include <type_traits>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
 
 namespace kmMqtt
 {
@@ -25,19 +27,29 @@ namespace kmMqtt
 #define deferEvent_wCaptures(deferrer, event, captures, ...)\
 	deferrer.defer([captures](){event(__VA_ARGS__);})\
 
+//Size of each arena block deferred callables are bump allocated from. Callables bigger than a block fall back to the heap.
+#if !defined(DEFERRER_ARENA_BLOCK_SIZE) || (DEFERRER_ARENA_BLOCK_SIZE <= 0)
+#undef DEFERRER_ARENA_BLOCK_SIZE
+#define DEFERRER_ARENA_BLOCK_SIZE 4096U
+#endif
+
 	namespace events
 	{
 		struct ICallable
 		{
 			virtual ~ICallable() {}
 			virtual void call() noexcept = 0;
+
+			ICallable* next{ nullptr };
+			bool isHeapAllocated{ false };
 		};
 
 		template<typename TFunc>
 		struct Callable : ICallable
 		{
-			explicit Callable(TFunc&& f)
-				: func(std::move(f))
+			template<typename TArg>
+			explicit Callable(TArg&& f)
+				: func(std::forward<TArg>(f))
 			{
 			}
 
@@ -49,25 +61,82 @@ namespace kmMqtt
 			TFunc func;
 		};
 
+		/**
+		 * @brief Queue of callbacks deferred until the next invokeEvents() call.
+		 * Callables are placement constructed into blocks of a bump allocated arena and linked into an intrusive list, so
+		 * deferring does not allocate once the arena has warmed up. The arena is rewound once the whole queue has been invoked,
+		 * reusing the same blocks every tick.
+		 * Not thread safe.
+		 */
 		class Deferrer
 		{
 		public:
+			Deferrer() noexcept = default;
+			~Deferrer() noexcept;
+
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(Deferrer)
+			DELETE_MOVE_ASSIGNMENT_AND_CONSTRUCTOR(Deferrer)
+
 			template<typename TFunc>
 			void defer(TFunc&& event)
 			{
-				m_events.emplace(std::make_unique<Callable<TFunc>>(std::forward<TFunc>(event)));
+				using CallableType = Callable<std::decay_t<TFunc>>;
+
+				ICallable* callable{ nullptr };
+				void* memory{ allocate(sizeof(CallableType), alignof(CallableType)) };
+
+				if (memory != nullptr)
+				{
+					callable = new (memory) CallableType(std::forward<TFunc>(event));
+				}
+				else
+				{
+					callable = new CallableType(std::forward<TFunc>(event));
+					callable->isHeapAllocated = true;
+				}
+
+				push(callable);
 			}
 
 			void invokeEvents() noexcept;
 			void clear() noexcept;
 
+			bool hasEvents() const noexcept
+			{
+				return m_head != nullptr;
+			}
+
+			/**
+			 * @brief Number of arena blocks currently held.
+			 */
+			std::size_t getArenaBlockCount() const noexcept
+			{
+				return m_blocks.size();
+			}
+
 			void operator()() noexcept
 			{
 				invokeEvents();
 			}
 
 		private:
-			std::queue<std::unique_ptr<ICallable>> m_events;
+			struct ArenaBlock
+			{
+				std::unique_ptr<unsigned char[]> memory;
+				std::size_t used{ 0U };
+			};
+
+			void* allocate(std::size_t size, std::size_t alignment);
+			void push(ICallable* callable) noexcept;
+			void destroy(ICallable* callable) noexcept;
+			void resetArena() noexcept;
+
+			ICallable* m_head{ nullptr };
+			ICallable* m_tail{ nullptr };
+
+			std::vector<ArenaBlock> m_blocks;
+			std::size_t m_currentBlock{ 0U };
+			std::uint32_t m_invokeDepth{ 0U };
 		};
 	}
 }
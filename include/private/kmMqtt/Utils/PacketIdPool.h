@@ -28,27 +28,56 @@ namespace kmMqtt
 	{
 		/**
 		 * @brief Get a new packet ID.
-		 * Packet IDs are in the range [1, 65535].
+		 * Packet IDs are in the range [1, PACKET_POOL_ID_SIZE - 1].
 		 * Reuses Ids that have been released.
 		 * 
-		 * @return A new packet ID.
+		 * @return A new packet ID, or 0 if every ID in the pool is in use.
 		 */
 		std::uint16_t getId() noexcept
 		{
 			LockGuard guard{ m_mutex };
 
-			if (!m_availableIds.empty())
+			while (!m_availableIds.empty())
 			{
 				std::uint16_t nextId{ m_availableIds.top() };
 				m_availableIds.pop();
+
+				if (m_usedIds.test(nextId)) continue; //Reserved since it was released.
+
 				m_usedIds.flip(nextId);
 				return nextId;
 			}
 
+			while (m_nextId < PACKET_POOL_ID_SIZE && m_usedIds.test(m_nextId))
+			{
+				++m_nextId; //Skip reserved Ids.
+			}
+
+			if (m_nextId >= PACKET_POOL_ID_SIZE) return 0U; //Every released Id is reused first, so none are left.
+
 			m_usedIds.flip(m_nextId);
 			return m_nextId++;
 		}
 
+		/**
+		 * @brief Mark a specific packet ID as in use, e.g. for in-flight messages restored from persistent storage.
+		 * 
+		 * @param id The packet ID to reserve.
+		 * @return true if the ID was free and is now reserved, false if it was already in use, is 0 or is outside the pool,
+		 * i.e. not below PACKET_POOL_ID_SIZE.
+		 */
+		bool reserveId(std::uint16_t id) noexcept
+		{
+			if (id == 0U || id >= PACKET_POOL_ID_SIZE) return false;
+
+			LockGuard guard{ m_mutex };
+
+			if (m_usedIds.test(id)) return false;
+
+			m_usedIds.set(id);
+			return true;
+		}
+
 		/**
 		 * @brief Release a packet ID back to the pool.
 		 * 
@@ -56,7 +85,7 @@ namespace kmMqtt
 		 */
 		void releaseId(std::uint16_t id) noexcept
 		{
-			if (id == 0U) return;
+			if (id == 0U || id >= PACKET_POOL_ID_SIZE) return;
 
 			LockGuard guard{ m_mutex };
 
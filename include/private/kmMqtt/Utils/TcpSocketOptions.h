@@ -0,0 +1,30 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_UTILS_TCPSOCKETOPTIONS_H
+#define INCLUDE_KMMQTT_UTILS_TCPSOCKETOPTIONS_H
+
+namespace kmMqtt
+{
+	namespace tcp
+	{
+		/**
+		 * @brief Enable or disable Nagle's algorithm (TCP_NODELAY) on a native socket handle.
+		 * 
+		 * @return true if the option was applied.
+		 */
+		bool setNoDelay(int handle, bool enable) noexcept;
+
+		/**
+		 * @brief Hold back (cork) partial segments until uncorked, so several writes leave as full segments.
+		 * Uses TCP_CORK on Linux and TCP_NOPUSH on BSD/macOS. Not available on Windows.
+		 * 
+		 * @return true if the option was applied.
+		 */
+		bool setCork(int handle, bool enable) noexcept;
+	}
+}
+
+#endif //INCLUDE_KMMQTT_UTILS_TCPSOCKETOPTIONS_H
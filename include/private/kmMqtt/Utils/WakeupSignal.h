@@ -0,0 +1,56 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_UTILS_WAKEUPSIGNAL_H
+#define INCLUDE_KMMQTT_UTILS_WAKEUPSIGNAL_H
+
+#include "kmMqtt/GlobalMacros.h"
+
+namespace kmMqtt
+{
+	/**
+	 * @brief Pollable OS handle that becomes readable when signalled, used to wake an external event loop.
+	 * Uses an eventfd on Linux and a non-blocking pipe on other POSIX platforms. Not available on Windows, where
+	 * getHandle() always returns -1.
+	 * Thread safe, signal() may be called from any thread.
+	 */
+	class WakeupSignal
+	{
+	public:
+		WakeupSignal() noexcept = default;
+		~WakeupSignal() noexcept;
+
+		DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(WakeupSignal)
+		DELETE_MOVE_ASSIGNMENT_AND_CONSTRUCTOR(WakeupSignal)
+
+		/**
+		 * @brief Create the underlying OS handle.
+		 * 
+		 * @return True if the handle was created (or already open), false if unsupported or creation failed.
+		 */
+		bool open() noexcept;
+
+		/**
+		 * @brief Mark the handle readable. Multiple signals before a clear() collapse into one wakeup.
+		 */
+		void signal() noexcept;
+
+		/**
+		 * @brief Drain the handle so it is no longer readable.
+		 */
+		void clear() noexcept;
+
+		/**
+		 * @brief Get the handle to register for read readiness, -1 if not open.
+		 */
+		int getHandle() const noexcept;
+
+	private:
+		int m_readHandle{ -1 };
+		int m_writeHandle{ -1 };
+	};
+}
+
+#endif //INCLUDE_KMMQTT_UTILS_WAKEUPSIGNAL_H
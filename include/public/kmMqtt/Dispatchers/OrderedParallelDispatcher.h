@@ -0,0 +1,110 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_DISPATCHERS_ORDEREDPARALLELDISPATCHER_H
+#define INCLUDE_KMMQTT_DISPATCHERS_ORDEREDPARALLELDISPATCHER_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Interfaces/ICallbackDispatcher.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kmMqtt
+{
+	struct OrderedParallelDispatcherOptions
+	{
+		std::size_t threadCount{ 0U }; //Number of worker threads. 0 uses std::thread::hardware_concurrency().
+		std::size_t laneCount{ 64U }; //Number of serial lanes ordering keys are hashed into.
+		std::size_t maxQueuedCallbacks{ 4096U }; //Max callbacks waiting to run before dispatch() blocks the caller. 0 = unbounded.
+		std::size_t maxCallbacksPerLaneTurn{ 32U }; //Callbacks a worker runs from one lane before giving other lanes a turn.
+	};
+
+	/**
+	 * @brief Callback dispatcher that runs callbacks on a work-stealing thread pool while keeping per-key ordering.
+	 *
+	 * Every ordering key is mapped onto one of a fixed number of serial lanes. Callbacks within a lane run one at a time
+	 * and in the order they were dispatched, while different lanes run in parallel across the worker threads. The MQTT
+	 * client uses the publish topic (or the key returned by MqttClientOptions::publishOrderingKey()) as the ordering key,
+	 * so messages on one topic are always delivered in order and a slow handler on one topic does not stall the others.
+	 * Non-publish events (connect, disconnect, acks...) are dispatched without a key and share lane 0.
+	 *
+	 * When maxQueuedCallbacks is reached, dispatch() blocks until workers catch up. As the client dispatches from its tick
+	 * thread, this applies backpressure to the receive path instead of letting the callback queue grow without bounds.
+	 * Callbacks dispatched from inside a worker never block, to avoid the pool waiting on itself.
+	 *
+	 * @note Destroying the dispatcher runs all callbacks that are still queued before joining the worker threads.
+	 */
+	class PUBLIC_API OrderedParallelDispatcher : public ICallbackDispatcher
+	{
+	public:
+		explicit OrderedParallelDispatcher(const OrderedParallelDispatcherOptions& options = {});
+		~OrderedParallelDispatcher() noexcept override;
+
+		DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(OrderedParallelDispatcher)
+
+		void dispatch(UniqueFunction callback) noexcept override;
+		void dispatchOrdered(UniqueFunction callback, std::size_t orderingKey) noexcept override;
+
+		/**
+		 * @brief Block until every callback dispatched so far has finished running.
+		 */
+		void waitUntilIdle() noexcept;
+
+		/**
+		 * @brief Number of callbacks dispatched but not yet finished.
+		 */
+		std::size_t getQueuedCount() const noexcept;
+
+		std::size_t getThreadCount() const noexcept;
+		std::size_t getLaneCount() const noexcept;
+
+	private:
+		struct Lane
+		{
+			std::mutex mutex;
+			std::deque<UniqueFunction> callbacks;
+			bool isScheduled{ false };
+		};
+
+		struct Worker
+		{
+			std::mutex mutex;
+			std::deque<std::size_t> lanes;
+			std::thread thread;
+		};
+
+		void scheduleLane(std::size_t laneIndex) noexcept;
+		bool tryTakeLane(std::size_t workerIndex, std::size_t& outLaneIndex) noexcept;
+		void runLane(std::size_t laneIndex) noexcept;
+		void workerLoop(std::size_t workerIndex) noexcept;
+
+		bool isWorkerThread() const noexcept;
+
+		OrderedParallelDispatcherOptions m_options;
+
+		std::vector<std::unique_ptr<Lane>> m_lanes;
+		std::vector<std::unique_ptr<Worker>> m_workers;
+
+		std::mutex m_workMutex;
+		std::condition_variable m_workCondition;
+		std::size_t m_scheduledLaneCount{ 0U };
+		std::atomic<bool> m_isStopping{ false };
+
+		mutable std::mutex m_capacityMutex;
+		std::condition_variable m_capacityCondition;
+		std::size_t m_queuedCount{ 0U };
+
+		std::atomic<std::size_t> m_nextWorker{ 0U };
+	};
+}
+
+#endif //INCLUDE_KMMQTT_DISPATCHERS_ORDEREDPARALLELDISPATCHER_H
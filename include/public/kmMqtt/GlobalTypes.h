@@ -13,6 +13,7 @@ namespace kmMqtt
 	using TimePoint = std::chrono::steady_clock::time_point;
 	using Seconds = std::chrono::seconds;
 	using Milliseconds = std::chrono::milliseconds;
+	using Microseconds = std::chrono::microseconds;
 }
 
 #endif //INCLUDE_KMMQTT_GLOBALTYPES_H
@@ -8,6 +8,7 @@
 
 #include "kmMqtt/Utils/UniqueFunction.h"
 #include "kmMqtt/GlobalMacros.h"
+#include <cstddef>
 #include <functional>
 
 namespace kmMqtt
@@ -19,6 +20,20 @@ namespace kmMqtt
 		virtual ~ICallbackDispatcher() noexcept = default;
 
 		virtual void dispatch(UniqueFunction callback) noexcept = 0;
+
+		/**
+		 * @brief Dispatch a callback that must run after all previously dispatched callbacks sharing the same ordering key.
+		 * Callbacks with different keys may run concurrently. Used by the client for received publishes, keyed by topic.
+		 *
+		 * Default implementation forwards to dispatch(), which is correct for any dispatcher that runs callbacks in order.
+		 *
+		 * @param callback The callback to run.
+		 * @param orderingKey Key identifying the serial lane the callback belongs to.
+		 */
+		virtual void dispatchOrdered(UniqueFunction callback, std::size_t /*orderingKey*/) noexcept
+		{
+			dispatch(std::move(callback));
+		}
 	};
 }
 
@@ -72,6 +72,33 @@ namespace kmMqtt
 		 */
 		virtual void tick() noexcept = 0;
 
+		/**
+		 * @brief Get the native OS handle (file descriptor) of the underlying connection, if the implementation exposes one.
+		 * Used in TickMode::SYNC so applications can register the socket in their own event loop (epoll, libuv, asio...) and only
+		 * call tick() when it is readable. Implementations that receive data on their own threads do not need to expose it, as
+		 * the client raises its wakeup handle whenever data is received.
+		 * 
+		 * @return The OS handle, or -1 if not available.
+		 */
+		virtual int getNativeHandle() const noexcept
+		{
+			return -1;
+		}
+
+		/**
+		 * @brief Stop or resume delivering received data, called by the client when its inbound backlog crosses the
+		 * ReceiveQueueOptions watermarks.
+		 * Implementations that own the read loop should stop reading from the connection while paused, so the OS receive
+		 * buffer fills and TCP flow control slows the broker down. Data already read may still be delivered.
+		 * Default does nothing, the client then relies on holding acks back to throttle the broker.
+		 *
+		 * @param paused True to stop reading, false to resume.
+		 */
+		virtual void setReadPaused(bool paused) noexcept
+		{
+			(void)paused;
+		}
+
 		/**
 		 * @brief Check if the WebSocket is connected.
 		 * @return True if connected, false otherwise.
@@ -0,0 +1,59 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_LOGGER_ASYNCLOG_H
+#define INCLUDE_KMMQTT_LOGGER_ASYNCLOG_H
+
+#include <kmMqtt/GlobalTypes.h>
+#include <cstddef>
+
+namespace kmMqtt
+{
+	/**
+	 * @brief Options for asynchronous logging, see startAsyncLogging().
+	 */
+	struct AsyncLogOptions
+	{
+		std::size_t ringBytesPerThread{ 64U * 1024U }; //Capacity of each logging thread's ring, logs that do not fit are dropped.
+		Milliseconds flushInterval{ 10 }; //How often the background thread drains the rings.
+	};
+
+	/**
+	 * @brief Move log formatting and writing off the calling thread.
+	 *
+	 * While running, a log call that passes the logger's lowest log level only copies the level, the category and format
+	 * pointers and the raw arguments into a lock-free ring owned by the calling thread. A background thread drains the
+	 * rings, formats each message and passes it to the ILogger set with setLogger().
+	 * Category and format strings are kept by pointer, so they must be string literals or otherwise outlive the log call.
+	 * %s arguments are copied. Order is kept per thread, logs from different threads may be written out of order.
+	 *
+	 * Calling it while already running does nothing.
+	 */
+	void startAsyncLogging(const AsyncLogOptions& options = {});
+
+	/**
+	 * @brief Write out everything logged so far and go back to formatting logs on the calling thread.
+	 */
+	void stopAsyncLogging();
+
+	/**
+	 * @brief Block until every log made before the call has been passed to the logger. Returns straight away if not running.
+	 */
+	void flushAsyncLogs();
+
+	bool isAsyncLoggingRunning() noexcept;
+
+	/**
+	 * @brief Number of logs dropped because the calling thread's ring was full.
+	 */
+	std::size_t getDroppedLogCount() noexcept;
+
+	/**
+	 * @brief Bytes allocated for the logging threads' rings. A ring is freed once its thread has exited and it is drained.
+	 */
+	std::size_t getAsyncLogBufferBytes() noexcept;
+}
+
+#endif //INCLUDE_KMMQTT_LOGGER_ASYNCLOG_H
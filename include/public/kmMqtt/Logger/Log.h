@@ -6,12 +6,19 @@
 #ifndef INCLUDE_KMMQTT_LOGGER_LOG_H
 #define INCLUDE_KMMQTT_LOGGER_LOG_H
 
+#include <kmMqtt/Interfaces/ILogger.h>
 #include <cstring>
 #include <cstdint>
 #include <exception>
 
 namespace kmMqtt
 {
+    /**
+     * @brief Whether a log at this level would be written, i.e. a logger is set and its lowest log level allows it.
+     * Use it to skip building expensive log arguments.
+     */
+    bool isLogLevelEnabled(LogLevel logLevel) noexcept;
+
     void LogTrace(const char* msg, ...) noexcept;
     void LogTrace(const char* category, const char* msg, ...) noexcept;
 
@@ -23,7 +23,7 @@ namespace kmMqtt
 			Socket_Error = 5U,
 			MQTT_Not_Active = 6U,
 			Failed_Sending_Packet = 7U,
-			Failed_Writing_To_Persistent_Storage = 8U, //Not used yet
+			Failed_Writing_To_Persistent_Storage = 8U, //Session state store failed to durably store a change.
 			Failed_Decoding_Packet = 9U,
 			TimeOut = 8U,
 			Using_Tick_Async = 9U, //Client is using async tick mode, cannot call tick functions explicitly.
@@ -44,6 +44,8 @@ namespace kmMqtt
 			Recv_Topic_Alias_Disallowed = 3001U, //Client received a topic alias but has requested topic aliasing to be disabled on connect.
 			Recv_Invalid_Topic_Alias = 3002U, //Client received a topic alias that is out of range (e.g. 0 or greater than maximum allowed).
 			Recv_Empty_Topic_Name_And_Invalid_Alias = 3003U, //Client allows topic aliases, but received a publish with an empty topic name and invalid topic alias.
+			Offline_Spool_Full = 3004U, //Client is not connected and the offline spool has no room for the publish.
+			Would_Block = 3005U, //Send queue is over its high watermark, retry once WritableEvent fires.
 
 			//Subscribe Errors
 			SubscribeError = 4000U,
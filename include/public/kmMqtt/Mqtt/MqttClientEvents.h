@@ -19,6 +19,7 @@
 #include "Packets/Publish/PublishRel.h"
 #include <kmMqtt/Mqtt/ClientError.h>
 #include "kmMqtt/Mqtt/Enums/ReconnectionStatus.h"
+#include "kmMqtt/Mqtt/MqttClientMetrics.h"
 #include "kmMqtt/Mqtt/Transport/SendResultData.h"
 #include "kmMqtt/Utils/Event.h"
 
@@ -115,6 +116,8 @@ namespace kmMqtt
 		using PublishCompletedEvent = events::Event<const PublishCompleteEventDetails&>;
 		using SubscribeAckEvent = events::Event<const SubscribeAckEventDetails&, const SubscribeAck&>;
 		using UnSubscribeAckEvent = events::Event<const UnSubscribeAckEventDetails&, const UnSubscribeAck&>;
+		using WritableEvent = events::Event<>;
+		using MemoryBudgetExceededEvent = events::Event<const MqttClientMemoryStats&>;
 	}
 }
 
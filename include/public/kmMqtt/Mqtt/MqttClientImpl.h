@@ -9,6 +9,7 @@
 #include "kmMqtt/Config.h"
 #include "kmMqtt/Interfaces/IWebSocket.h"
 #include "kmMqtt/Mqtt/ClientError.h"
+#include "kmMqtt/Mqtt/ClientMetrics.h"
 #include "kmMqtt/Mqtt/Enums/ConnectionStatus.h"
 #include "kmMqtt/Mqtt/MqttClientEvents.h"
 #include "kmMqtt/Mqtt/MqttConnectionInfo.h"
@@ -33,14 +34,19 @@
 #include "kmMqtt/MqttClientOptions.h"
 #include "kmMqtt/Utils/Deferrer.h"
 #include "kmMqtt/Utils/PacketIdPool.h" 
+#include "kmMqtt/Utils/WakeupSignal.h"
 #include "kmMqtt/Interfaces/IMqttEnvironment.h"
 #include "kmMqtt/Mqtt/ReceiveMaximumTracker.h"
+#include "kmMqtt/Mqtt/DurableAckTracker.h"
+#include "kmMqtt/Mqtt/InboundFlowControl.h"
+#include "kmMqtt/Mqtt/OfflineSpool.h"
 
 #include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace kmMqtt
 {
@@ -53,6 +59,17 @@ else\
 {\
 	m_clientOptions.getCallbackDispatcher()->dispatch(__VA_ARGS__);\
 }\
+\
+
+#define DISPATCH_ORDERED_EVENT_TO_CONSUMER(orderingKey, ...)\
+if(m_clientOptions.isUsingInternalCallbackDeferrer())\
+{\
+	m_eventDeferrer.defer(__VA_ARGS__);\
+}\
+else\
+{\
+	m_clientOptions.getCallbackDispatcher()->dispatchOrdered(__VA_ARGS__, orderingKey);\
+}\
 \
 
 	namespace mqtt
@@ -78,6 +95,10 @@ else\
 			ClientError tick() noexcept;
 			void tickAsync() noexcept;
 
+			int getWakeupHandle() const noexcept;
+			int getSocketHandle() const noexcept;
+			TimePoint nextDeadline() noexcept;
+
 			ErrorEvent& onErrorEvent() noexcept;
 			ConnectEvent& onConnectEvent() noexcept;
 			DisconnectEvent& onDisconnectEvent() noexcept;
@@ -86,10 +107,16 @@ else\
 			PublishCompletedEvent& onPublishCompletedEvent() noexcept;
 			SubscribeAckEvent& onSubscribeAckEvent() noexcept;
 			UnSubscribeAckEvent& onUnSubscribeAckEvent() noexcept;
+			WritableEvent& onWritableEvent() noexcept;
+			MemoryBudgetExceededEvent& onMemoryBudgetExceededEvent() noexcept;
 
 			ConnectionStatus getConnectionStatus() const noexcept;
 			const MqttConnectionInfo& getConnectionInfo() const noexcept;
 			bool getIsTickingAsync() const noexcept;
+			std::size_t getInboundConflatedCount() const noexcept;
+			std::size_t getExpiredPublishCount() noexcept;
+			MqttClientMetrics getMetrics() const;
+			MqttClientMemoryStats getMemoryStats() const noexcept;
 
 		private:
 			void pubAck(std::uint16_t packetId, PubAckReasonCode code, PubAckOptions&& options) noexcept;
@@ -115,6 +142,7 @@ else\
 			void handlePubRecSentEvent(std::uint16_t packetId);
 			void handlePubRelSentEvent(std::uint16_t packetId);
 			void handleDisconnectSentEvent();
+			void handlePublishExpiredEvent(std::uint16_t packetId);
 
 			void handleReceivedConnectAcknowledge(ConnectAck&& packet);
 			void handleReceivedDisconnect(Disconnect&& packet);
@@ -128,12 +156,21 @@ else\
 			void handleReceivedPingResponse(PingResp&& packet);
 
 			void firePublishReceivedEvent(Publish&& packet) noexcept;
+			bool tryConflateReceivedPublish(const std::string& topicName, Publish& packet) noexcept;
+			void fireConflatedPublishEvent(const std::string& topicName) noexcept;
+			void acknowledgeReceivedPublish(Qos qos, std::uint16_t packetId) noexcept;
+			void sendReceivedPublishAck(Qos qos, std::uint16_t packetId) noexcept;
 
 			void tickCheckTimeOut();
 			void tickCheckKeepAlive();
 			void tickSendPackets();
 			void tickReceivePackets();
 			void tickPendingPublishMessageRetries();
+			void tickHeldAcknowledgements();
+			void tickOfflineSpool();
+			void tickInboundFlowControl();
+			void recordTickMetrics(TimePoint tickStart) noexcept;
+			void recordMemoryStats() noexcept;
 
 			void handleFailedReconnect(ConnectAck&& packet, ClientErrorCode errorCode = ClientErrorCode::No_Error);
 			void handleFailedConnect(ConnectAck&& packet, ClientErrorCode errorCode = ClientErrorCode::No_Error);
@@ -142,6 +179,10 @@ else\
 			void handleDecodeError(const DecodeResult& result) noexcept;
 
 			int sendPacket(const BasePacket& packet);
+			ReqResult queuePublish(const char* topic, ByteBuffer&& payload, PublishOptions&& options) noexcept;
+			ReqResult waitForSendQueue() noexcept;
+
+			void wakeTickLoop() noexcept;
 
 			ClientError shutdownAsync() noexcept;
 			ClientError shutdownCleanup() noexcept;
@@ -149,12 +190,29 @@ else\
 			std::thread m_mqttMainThread;
 			std::condition_variable m_mqttMainThreadCondition;
 			std::atomic<bool> m_isRunningAsync{ false };
+			bool m_isTickLoopWoken{ false }; //Guarded by m_tickMutex.
+			WakeupSignal m_wakeupSignal;
 
 			MqttClientOptions m_clientOptions;
 			MqttConnectionInfo m_connectionInfo;
 			ReceiveMaximumTracker m_receiveMaximumTracker{ RECEIVE_MAXIMUM_DEFAULT, RECEIVE_MAXIMUM_DEFAULT };
+			DurableAckTracker m_durableAckTracker{ [this]() { wakeTickLoop(); } };
+			InboundFlowControl m_inboundFlowControl;
+			bool m_isSocketReadPaused{ false }; //Last state passed to IWebSocket::setReadPaused(), tick loop only.
+
+			std::unique_ptr<OfflineSpool> m_offlineSpool{ nullptr };
+			std::mutex m_offlineSpoolMutex; //Held across spooling and queueing, so spooled and new publishes keep their order.
 			ConnectionStatus m_connectionStatus{ ConnectionStatus::DISCONNECTED };
 
+			std::unordered_map<std::string, Publish> m_conflatedPublishes; //Newest QoS 0 publish per topic waiting for the callback.
+			std::mutex m_conflatedPublishesMutex;
+			std::atomic<std::size_t> m_inboundConflatedCount{ 0U };
+
+			ClientMetrics m_metrics;
+			bool m_isOverMemoryBudget{ false }; //Tick loop only.
+			ITraceSink* m_traceSinkPtr{ nullptr }; //Owned by m_clientOptions.
+			IWireCaptureSink* m_wireCaptureSinkPtr{ nullptr }; //Owned by m_clientOptions.
+
 			events::Deferrer m_eventDeferrer;
 			ErrorEvent m_errorEvent;
 			ConnectEvent m_connectEvent;
@@ -164,6 +222,8 @@ else\
 			PublishCompletedEvent m_pubCompletedEvent;
 			SubscribeAckEvent m_subAckEvent;
 			UnSubscribeAckEvent m_unSubAckEvent;
+			WritableEvent m_writableEvent;
+			MemoryBudgetExceededEvent m_memoryBudgetExceededEvent;
 
 			SendPubAckEvent m_sendPubAckEvent;
 
@@ -0,0 +1,113 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_MQTTCLIENTMETRICS_H
+#define INCLUDE_KMMQTT_MQTT_MQTTCLIENTMETRICS_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/Packets/PacketType.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		constexpr std::size_t k_packetTypeCount{ static_cast<std::size_t>(PacketType::_COUNT) };
+
+		/**
+		 * @brief Copy of a latency histogram, values are in microseconds.
+		 * Buckets are log-linear (16 per power of two), so any recorded value is within 1/16th of its bucket's upper bound.
+		 */
+		struct PUBLIC_API LatencyHistogramSnapshot
+		{
+			struct Bucket
+			{
+				std::uint64_t upperBoundMicroseconds{ 0U }; //Inclusive.
+				std::uint64_t count{ 0U };
+			};
+
+			std::uint64_t count{ 0U };
+			std::uint64_t sumMicroseconds{ 0U };
+			std::uint64_t minMicroseconds{ 0U };
+			std::uint64_t maxMicroseconds{ 0U };
+			std::vector<Bucket> buckets; //Non-empty buckets only, in ascending order.
+
+			/**
+			 * @brief Upper bound of the bucket holding the value at `quantile` (0.0 to 1.0), capped at the recorded maximum.
+			 * @return 0 if nothing was recorded.
+			 */
+			std::uint64_t getValueAtQuantile(double quantile) const noexcept;
+		};
+
+		/**
+		 * @brief Live bytes held by each part of the client, see MqttClient::getMemoryStats().
+		 * Counts the messages and buffers each part holds, not allocator overhead or spare capacity, so it shows which queue
+		 * is growing rather than adding up to the process RSS. Values are taken at the end of the last tick.
+		 */
+		struct PUBLIC_API MqttClientMemoryStats
+		{
+			std::uint64_t sendQueueBytes{ 0U }; //Estimated size of queued packets not composed yet.
+			std::uint64_t sendBufferBytes{ 0U }; //Composed packets not sent yet.
+			std::uint64_t receiveQueueBytes{ 0U }; //Received bytes not decoded yet, including a partially received packet.
+			std::uint64_t pendingCallbackBytes{ 0U }; //Topic and payload of received publishes whose callback has not returned.
+			std::uint64_t sessionStateBytes{ 0U }; //Topic and payload of QoS 1/2 messages kept in the session state.
+			std::uint64_t propertyBytes{ 0U }; //Response topic, correlation data and user properties of those messages.
+			std::uint64_t topicAliasBytes{ 0U }; //Topic names mapped to topic aliases received from the server.
+			std::uint64_t offlineSpoolBytes{ 0U }; //Publishes spooled in memory while disconnected, the spill file is not counted.
+			std::uint64_t loggerBytes{ 0U }; //Rings of the asynchronous logger, shared by every client in the process.
+
+			std::uint64_t totalBytes() const noexcept
+			{
+				return sendQueueBytes + sendBufferBytes + receiveQueueBytes + pendingCallbackBytes + sessionStateBytes +
+					propertyBytes + topicAliasBytes + offlineSpoolBytes + loggerBytes;
+			}
+		};
+
+		/**
+		 * @brief Point in time copy of the client's metrics, see MqttClient::getMetrics().
+		 * Counters run from the creation of the client, gauges hold the value at the end of the last tick.
+		 */
+		struct PUBLIC_API MqttClientMetrics
+		{
+			//Counters, indexed by PacketType. Bytes are whole MQTT packets including the fixed header, sent packets are counted
+			//once the socket has taken their last byte.
+			std::array<std::uint64_t, k_packetTypeCount> packetsSent{};
+			std::array<std::uint64_t, k_packetTypeCount> bytesSent{};
+			std::array<std::uint64_t, k_packetTypeCount> packetsReceived{};
+			std::array<std::uint64_t, k_packetTypeCount> bytesReceived{};
+
+			std::uint64_t publishRetries{ 0U }; //QoS 1/2 publishes resent with the DUP flag.
+			std::uint64_t reconnects{ 0U };
+			std::uint64_t decodeErrors{ 0U };
+
+			//Gauges.
+			std::uint64_t sendQueuePackets{ 0U }; //Packets queued and not composed yet.
+			std::uint64_t sendQueueBytes{ 0U }; //Estimated bytes of queued packets plus unsent bytes in the send buffer.
+			std::uint64_t inFlightPublishes{ 0U }; //QoS 1/2 publishes sent and not acknowledged yet.
+			std::uint64_t receiveMaximum{ 0U }; //Server's receive maximum, the limit for inFlightPublishes.
+			MqttClientMemoryStats memory;
+
+			//Histograms.
+			LatencyHistogramSnapshot publishAckLatency; //PUBLISH sent through the socket to PUBACK or PUBREC received.
+			LatencyHistogramSnapshot tickDuration; //One pass of the tick loop.
+			LatencyHistogramSnapshot socketSendTime; //One IWebSocket::send() call.
+		};
+
+		/**
+		 * @brief Write the metrics in Prometheus text exposition format 0.0.4, which OpenMetrics scrapers also accept.
+		 * Per packet type counters are labelled `type`, histograms are exported as summaries in seconds.
+		 *
+		 * @param prefix Prepended to each metric name, e.g. `kmmqtt_packets_sent_total`.
+		 */
+		PUBLIC_API std::string toPrometheusText(const MqttClientMetrics& metrics, const char* prefix = "kmmqtt");
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_MQTTCLIENTMETRICS_H
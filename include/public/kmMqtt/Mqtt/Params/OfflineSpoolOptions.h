@@ -0,0 +1,44 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_PARAMS_OFFLINESPOOLOPTIONS_H
+#define INCLUDE_KMMQTT_MQTT_PARAMS_OFFLINESPOOLOPTIONS_H
+
+#include <kmMqtt/GlobalMacros.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		enum class OfflineSpoolOverflow : std::uint8_t
+		{
+			REJECT_NEW, //Default option, publish() fails with Offline_Spool_Full while the spool is full.
+			DROP_OLDEST, //Oldest spooled publishes are discarded to make room for new ones.
+		};
+
+		/**
+		 * @brief Options for the offline spool, which holds publishes made while the client is not connected.
+		 *
+		 * Spooled publishes are kept in a memory ring of maxMemoryBytes. Once it is full they spill into a memory-mapped file
+		 * at spillFilePath, up to maxBytes in total. After the next CONNACK they are sent in the order they were published, at
+		 * no more than drainMessagesPerSecond. The spool only bridges outages within the lifetime of the process, the spill
+		 * file is recreated empty when the client starts.
+		 */
+		struct PUBLIC_API OfflineSpoolOptions
+		{
+			std::size_t maxBytes{ 0U }; //Total bytes the spool may hold across memory and file. 0 disables the spool.
+			std::size_t maxMemoryBytes{ 1024U * 1024U }; //Size of the in-memory ring, capped to maxBytes.
+			std::string spillFilePath{ "" }; //File the spool spills to once the memory ring is full. Empty keeps the spool in memory only.
+			std::uint32_t drainMessagesPerSecond{ 0U }; //Rate spooled publishes are sent at after reconnecting. 0 = as fast as possible.
+			std::uint32_t drainBurst{ 16U }; //Publishes that may be sent at once before the drain rate applies.
+			OfflineSpoolOverflow overflow{ OfflineSpoolOverflow::REJECT_NEW };
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_PARAMS_OFFLINESPOOLOPTIONS_H
@@ -32,7 +32,8 @@ namespace kmMqtt
 				payloadFormatIndicator{ other.payloadFormatIndicator },
 				retain{ other.retain },
 				qos{ other.qos },
-				userProperties{ other.userProperties }
+				userProperties{ other.userProperties },
+				conflate{ other.conflate }
 			{
 				if (other.correlationData != nullptr)
 				{
@@ -60,6 +61,7 @@ namespace kmMqtt
 				retain = other.retain;
 				qos = other.qos;
 				userProperties = other.userProperties;
+				conflate = other.conflate;
 
 				return *this;
 			}
@@ -73,7 +75,8 @@ namespace kmMqtt
 				payloadFormatIndicator{other.payloadFormatIndicator },
 				retain{other.retain},
 				qos{ other.qos },
-				userProperties{ std::move(other.userProperties) }
+				userProperties{ std::move(other.userProperties) },
+				conflate{ other.conflate }
 			{
 				other.correlationData = nullptr;
 			}
@@ -99,6 +102,7 @@ namespace kmMqtt
 				retain = other.retain;
 				qos = other.qos;
 				userProperties = std::move(other.userProperties);
+				conflate = other.conflate;
 
 				other.correlationData = nullptr;
 				other.userProperties.clear();
@@ -115,6 +119,10 @@ namespace kmMqtt
 			bool retain{ false };
 			Qos qos{ Qos::QOS_0 };
 			std::map<std::string, std::string> userProperties;
+
+			//QoS 0 only. While a conflated publish to the same topic is still queued and unsent, this publish replaces its payload
+			//and options in place instead of queuing behind it, so only the latest value is sent. Not kept for spooled publishes.
+			bool conflate{ false };
 		};
 	}
 }
@@ -0,0 +1,41 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_PARAMS_RECEIVEQUEUEOPTIONS_H
+#define INCLUDE_KMMQTT_MQTT_PARAMS_RECEIVEQUEUEOPTIONS_H
+
+#include <kmMqtt/GlobalMacros.h>
+#include <cstddef>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Controls how received publishes build up between the client and a publish callback that can't keep up.
+		 *
+		 * With conflateQos0, a QoS 0 publish received while an earlier one on the same topic is still waiting for the
+		 * callback replaces it, keeping its place in delivery order. Each topic holds at most one waiting QoS 0 message, so
+		 * memory stays bounded by the number of topics. QoS 1/2 publishes are never conflated.
+		 *
+		 * The watermarks bound the inbound backlog: received packets not yet decoded plus publishes whose callback has not
+		 * returned yet. Once bytes or messages reach their high watermark the client stops reading from the socket and holds
+		 * back PUBACK/PUBREC, until both have drained to their low watermark. Held acks keep the broker's in-flight window
+		 * full, so set ConnectArgs::receiveMaximum to the QoS 1/2 backlog the application can afford. Transports that can't
+		 * pause reading (IWebSocket::setReadPaused() not implemented) keep buffering QoS 0 traffic while paused.
+		 */
+		struct PUBLIC_API ReceiveQueueOptions
+		{
+			bool conflateQos0{ false }; //Deliver only the newest waiting QoS 0 message per topic.
+
+			std::size_t highWatermarkBytes{ 0U }; //Inbound backlog bytes at which reading pauses. 0 = no byte limit.
+			std::size_t lowWatermarkBytes{ 0U }; //Inbound backlog bytes the backlog must drain to before reading resumes.
+			std::size_t highWatermarkMessages{ 0U }; //Inbound backlog messages at which reading pauses. 0 = no message limit.
+			std::size_t lowWatermarkMessages{ 0U }; //Inbound backlog messages the backlog must drain to before reading resumes.
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_PARAMS_RECEIVEQUEUEOPTIONS_H
@@ -0,0 +1,72 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_PARAMS_SENDQUEUEOPTIONS_H
+#define INCLUDE_KMMQTT_MQTT_PARAMS_SENDQUEUEOPTIONS_H
+
+#include <kmMqtt/GlobalMacros.h>
+#include <kmMqtt/GlobalTypes.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		enum class SendQueueFullPolicy : std::uint8_t
+		{
+			RETURN_WOULD_BLOCK, //Default option, publish() fails straight away with Would_Block while the send queue is full.
+			BLOCK, //publish() waits up to blockTimeout for the send queue to drain, then fails with Would_Block.
+		};
+
+		enum class FlushMode : std::uint8_t
+		{
+			IMMEDIATE, //Default option, queued publishes are sent on the next tick.
+			THRESHOLD, //Publishes are held until flushBytes, flushPackets or flushDelay is reached, whichever comes first.
+			ADAPTIVE, //Flushes straight away when idle, grows the packet threshold up to flushPackets while publishes keep arriving.
+		};
+
+		/**
+		 * @brief Bounds on the outgoing send queue, so publishing faster than the socket can send does not grow memory without limit.
+		 *
+		 * Once queued bytes or queued packets reach their high watermark the queue is full, and stays full until both have
+		 * drained to their low watermark. While full, publish() applies fullPolicy and WritableEvent fires when it clears.
+		 * Acknowledgements, pings and retries of in-flight QoS 1/2 publishes are always queued and count towards the levels.
+		 * The high watermarks are soft limits: publish() and the offline spool drain check the queue is writable, then queue
+		 * the publish, so concurrent publishers that passed the check may each go over it by one publish.
+		 *
+		 * BLOCK needs the queue to be drained by another thread, use it with TickMode::ASYNC or when publishing from a thread
+		 * other than the one calling tick().
+		 *
+		 * Packets are sent in three lanes: control packets (pings, acks, subscribes) first, then QoS 1/2 and QoS 0 publishes
+		 * interleaved by weight. Order is kept within a lane, so publishes of different QoS may be reordered. A graceful
+		 * disconnect is sent last, once the publishes queued before it have been sent or are held by the receive maximum.
+		 *
+		 * flushMode trades single message latency for fewer, larger writes under load. Control packets are never held, any
+		 * publishes waiting at that point go out with them.
+		 */
+		struct PUBLIC_API SendQueueOptions
+		{
+			std::size_t highWatermarkBytes{ 0U }; //Queued bytes at which the queue becomes full. 0 = no byte limit.
+			std::size_t lowWatermarkBytes{ 0U }; //Queued bytes the queue must drain to before publishes are accepted again.
+			std::size_t highWatermarkPackets{ 0U }; //Queued packets at which the queue becomes full. 0 = no packet limit.
+			std::size_t lowWatermarkPackets{ 0U }; //Queued packets the queue must drain to before publishes are accepted again.
+			SendQueueFullPolicy fullPolicy{ SendQueueFullPolicy::RETURN_WOULD_BLOCK };
+			Milliseconds blockTimeout{ 1000 }; //Longest publish() waits with SendQueueFullPolicy::BLOCK.
+
+			std::size_t maxBatchBytes{ 64U * 1024U }; //Publish bytes composed into the send buffer per batch, bounds how long new control packets wait.
+			std::uint8_t qosLaneWeight{ 4U }; //QoS 1/2 publishes composed per turn when interleaving with QoS 0 publishes.
+			std::uint8_t bulkLaneWeight{ 1U }; //QoS 0 publishes composed per turn when interleaving with QoS 1/2 publishes.
+
+			FlushMode flushMode{ FlushMode::IMMEDIATE };
+			std::size_t flushBytes{ 16U * 1024U }; //Queued publish bytes that trigger a flush.
+			std::size_t flushPackets{ 32U }; //Queued publishes that trigger a flush, the upper bound of the adaptive threshold.
+			Microseconds flushDelay{ 1000 }; //Longest a publish is held before it is flushed.
+			bool manageTcpOptions{ false }; //Set TCP_NODELAY and cork multi packet flushes, needs IWebSocket::getNativeHandle(), e.g. PosixTCPSocket.
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_PARAMS_SENDQUEUEOPTIONS_H
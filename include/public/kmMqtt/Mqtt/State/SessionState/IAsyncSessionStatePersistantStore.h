@@ -0,0 +1,44 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_IASYNCSESSIONSTATEPERSISTANTSTORE_H
+#define INCLUDE_KMMQTT_MQTT_IASYNCSESSIONSTATEPERSISTANTSTORE_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/State/SessionState/ISessionStatePersistantStore.h"
+#include <functional>
+
+namespace kmMqtt
+{
+    namespace mqtt
+    {
+        /**
+         * @brief Session state store whose writes become durable some time after the store call returns.
+         *
+         * The ISessionStatePersistantStore methods only have to queue the change (e.g. in an in-memory batch) and may return
+         * before it reaches disk. The client then uses notifyWhenDurable() as a barrier: PUBACK and PUBREC for received
+         * publishes are held until every change queued before them is durable, so the broker never considers a QoS 2
+         * message delivered before the client can survive a crash without losing it. Other messages keep flowing while
+         * acks are held, so throughput is bounded by the store's batched I/O rather than by the latency of each write.
+         */
+        class PUBLIC_API IAsyncSessionStatePersistantStore : public ISessionStatePersistantStore
+        {
+        public:
+            using DurableCallback = std::function<void(bool success)>;
+
+            /**
+             * @brief Request a callback once every change queued so far, for any client, has been durably stored.
+             *
+             * Must not block. The callback may run on any thread (including inside this call, if nothing is pending) and
+             * must be invoked exactly once. Callbacks must be invoked in the order they were requested.
+             *
+             * @param callback Invoked with true once the changes are durable, or false if storing them failed.
+             */
+            virtual void notifyWhenDurable(DurableCallback callback) = 0;
+        };
+    }
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_IASYNCSESSIONSTATEPERSISTANTSTORE_H
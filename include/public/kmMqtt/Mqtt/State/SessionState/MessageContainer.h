@@ -117,12 +117,28 @@ namespace kmMqtt
 			 */
 			std::size_t size() const noexcept { return m_messageList.size(); }
 
+			/**
+			 * @brief Returns the bytes of the topics and payloads of the messages in the container.
+			 */
+			std::size_t getPayloadBytes() const noexcept { return m_payloadBytes; }
+
+			/**
+			 * @brief Returns the bytes of the response topics, correlation data and user properties of the messages in the container.
+			 */
+			std::size_t getPropertyBytes() const noexcept { return m_propertyBytes; }
+
 		private:
+			void addMessageBytes(const MessageContainerData& msg, bool isAdded) noexcept;
+
 			//Ordered list of messages maintaining insertion/move order.
 			std::list<MessageContainerData> m_messageList;
 
 			//Map from packet ID to list iterator for O(1) lookups.
 			std::unordered_map<std::uint16_t, MsgIter> m_packetIDToMessageMap;
+
+			//Kept up to date on push, erase and clear, so memory accounting does not walk the messages.
+			std::size_t m_payloadBytes{ 0U };
+			std::size_t m_propertyBytes{ 0U };
 		};
 	}
 }
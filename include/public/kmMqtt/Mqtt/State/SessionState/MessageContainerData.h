@@ -72,6 +72,7 @@ namespace kmMqtt
 			}
 
 			TimePoint nextRetryTime;
+			TimePoint queuedTime{ std::chrono::steady_clock::now() }; //Message expiry of retried publishes counts from here.
 			bool canRetry{ false };
 			SavedData data;
 		};
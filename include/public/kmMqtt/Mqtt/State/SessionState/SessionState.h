@@ -25,10 +25,12 @@ namespace kmMqtt
             * @param clientId The client identifier.
             * @param sessionExpiryInterval The session expiry interval in seconds.
             * @param retryInterval The retry interval for message delivery attempts.
+            * @param persistantStore Optional store every message change is mirrored to, for recovery across process restarts.
             */
             SessionState(const char* clientId,
                 std::uint32_t sessionExpiryInterval,
-                std::uint32_t retryInterval = 0U) noexcept;
+                std::uint32_t retryInterval = 0U,
+                std::shared_ptr<ISessionStatePersistantStore> persistantStore = nullptr) noexcept;
 
             /**
 			 * @brief Copy constructor.
@@ -46,6 +48,14 @@ namespace kmMqtt
              */
             ClientErrorCode addPrevSessionState(const SessionState& prevSessionState) noexcept;
 
+            /**
+             * @brief Restores messages read back from the persistant store (e.g. after a process restart).
+             * Messages are not written back to the store as they are already in it.
+             * @param savedData Messages in the order they were persisted.
+             * @return ClientErrorCode indicating success or failure.
+             */
+            ClientErrorCode restoreSavedMessages(const std::vector<SavedData>& savedData) noexcept;
+
             /**
             * @brief Adds a message to the session state.
             * 
@@ -76,6 +86,16 @@ namespace kmMqtt
             */
             const MessageContainer& messages() const noexcept { return m_messages; }
 
+            /**
+            * @brief Gets the bytes of the topics and payloads of the stored messages.
+            */
+            std::size_t getPayloadBytes() const noexcept;
+
+            /**
+            * @brief Gets the bytes of the response topics, correlation data and user properties of the stored messages.
+            */
+            std::size_t getPropertyBytes() const noexcept;
+
             /**
             * @brief Clears all messages from the session state.
             */
@@ -94,7 +114,7 @@ namespace kmMqtt
 
 		private:
 
-            ClientErrorCode addPrevStateMessage(const std::uint16_t packetId, const PublishMessageData& publishMsgData) noexcept;
+            ClientErrorCode addPrevStateMessage(const SavedData& savedData) noexcept;
 
 			const char* m_clientId;
             Milliseconds m_retryInterval;
@@ -0,0 +1,118 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_WALSESSIONSTATEPERSISTANTSTORE_H
+#define INCLUDE_KMMQTT_MQTT_WALSESSIONSTATEPERSISTANTSTORE_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/State/SessionState/IAsyncSessionStatePersistantStore.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		struct WalSessionStoreOptions
+		{
+			std::string directory{ "." }; //Directory the segment files are stored in, created if missing. Must not be shared with other files named *.wal.
+			std::size_t segmentMaxBytes{ 4U * 1024U * 1024U }; //Size after which the active segment is sealed and a new one started.
+			std::uint32_t groupCommitIntervalMs{ 5U }; //Max time a record waits before being written and synced to disk.
+			std::size_t groupCommitMaxBytes{ 64U * 1024U }; //Pending bytes that trigger a commit before groupCommitIntervalMs elapses.
+			std::size_t compactionMinBytes{ 1024U * 1024U }; //Log size below which compaction never runs.
+			float compactionMaxGarbageRatio{ 0.5F }; //Compact once more than this fraction of the log is removed or superseded records.
+		};
+
+		/**
+		 * @brief Session state store backed by an append-only write-ahead log on disk.
+		 *
+		 * Every store operation appends a small checksummed record to an in-memory batch and returns straight away. A commit
+		 * thread writes the batch to the active segment file and syncs it (fdatasync) once per groupCommitIntervalMs or as soon
+		 * as groupCommitMaxBytes are pending, so many publishes share a single sync. Use flush() to wait for everything
+		 * written so far to be durable, or notifyWhenDurable() to be called back without blocking.
+		 *
+		 * Each client ID has its own series of segment files. Segments are rotated at segmentMaxBytes and, once enough of the
+		 * log is garbage (acknowledged, removed or superseded records), the live records are rewritten into a fresh segment and
+		 * the old segments deleted. Recovery replays the segments in order, truncating a torn record at the tail of the last
+		 * segment, and readAll() returns the live messages in the order they were written.
+		 */
+		class PUBLIC_API WalSessionStatePersistantStore : public IAsyncSessionStatePersistantStore
+		{
+		public:
+			explicit WalSessionStatePersistantStore(const WalSessionStoreOptions& options = {});
+			~WalSessionStatePersistantStore() override;
+
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(WalSessionStatePersistantStore)
+
+			bool initialize(const char* clientId) override;
+			bool write(const char* clientId, uint32_t sessionExpiryInterval, const SavedData& data) override;
+			bool readAll(const char* clientId, std::vector<SavedData>& outData) override;
+			bool removeMessage(const char* clientId, std::uint16_t packetId) override;
+			bool updateMessage(const char* clientId, std::uint16_t packetId, PublishMessageStatus newStatus, bool bringToEnd) override;
+			bool removeFromStore(const char* clientId) override;
+			bool removeExpiredFromStore() override;
+			void notifyWhenDurable(DurableCallback callback) override;
+
+			/**
+			 * @brief Block until every record appended so far has been written and synced to disk, or a commit covering them
+			 * failed.
+			 * @return false if writing or syncing any of the records failed. They are still retried in the background.
+			 */
+			bool flush();
+
+			/**
+			 * @brief Rewrite the live records of a client into a new segment and delete the old segments, regardless of
+			 * the garbage ratio.
+			 * @return false if the client is unknown or the compaction failed.
+			 */
+			bool compact(const char* clientId);
+
+			/**
+			 * @brief Number of segment files currently on disk for a client. Mainly for diagnostics and tests.
+			 */
+			std::size_t getSegmentCount(const char* clientId);
+
+		private:
+			struct ClientLog;
+
+			ClientLog* getOrOpenLog(const std::string& clientId);
+			bool appendRecord(ClientLog& log, const std::vector<std::uint8_t>& body);
+			bool commitLog(ClientLog& log);
+			bool compactLog(ClientLog& log);
+			void commitLoop();
+
+			WalSessionStoreOptions m_options;
+
+			std::mutex m_logsMutex; //Guards m_logs, each ClientLog has its own mutex for its records and files.
+			std::map<std::string, std::unique_ptr<ClientLog>> m_logs;
+
+			std::mutex m_commitMutex;
+			std::condition_variable m_commitCondition;
+			std::condition_variable m_durableCondition;
+			std::uint64_t m_appendedSequence{ 0U };
+			std::uint64_t m_durableSequence{ 0U };
+			std::uint64_t m_failedSequence{ 0U }; //Appended sequence covered by the last failed commit, wakes flush() waiters.
+			std::size_t m_pendingBytes{ 0U };
+			std::chrono::steady_clock::time_point m_firstPendingTime;
+			bool m_flushRequested{ false };
+			bool m_commitFailed{ false };
+			bool m_isStopping{ false };
+			std::deque<std::pair<std::uint64_t, DurableCallback>> m_durableCallbacks; //Appended sequence to wait for, oldest first.
+			std::thread m_commitThread;
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_WALSESSIONSTATEPERSISTANTSTORE_H
@@ -7,7 +7,9 @@
 #define INCLUDE_KMMQTT_MQTT_TOPIC_ALIASES_H
 
 #include <unordered_map>
+#include <cstddef>
 #include <cstdint>
+#include <string>
 
 namespace kmMqtt
 {
@@ -16,11 +18,24 @@ namespace kmMqtt
 		class TopicAliases
 		{
 		public:
+			/**
+			 * @brief Map a topic alias to a copy of `topicName`, replacing the topic it was mapped to before.
+			 */
 			bool tryAddTopicAlias(const char* topicName, std::uint16_t topicAlias);
+
+			/**
+			 * @brief Find the topic mapped to `topicAlias`. The pointer stays valid until the alias is mapped again.
+			 */
 			bool tryFindTopicName(std::uint16_t topicAlias, const char*& outTopicName) const;
 
+			/**
+			 * @brief Bytes of the mapped topic names.
+			 */
+			std::size_t getTopicNameBytes() const noexcept { return m_topicNameBytes; }
+
 		protected:
-			std::unordered_multimap<std::uint16_t, const char*> m_topicAliasToNameMap;
+			std::unordered_multimap<std::uint16_t, std::string> m_topicAliasToNameMap;
+			std::size_t m_topicNameBytes{ 0U };
 		};
 	}
 
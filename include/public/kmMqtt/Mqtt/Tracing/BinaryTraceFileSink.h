@@ -0,0 +1,75 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_TRACING_BINARYTRACEFILESINK_H
+#define INCLUDE_KMMQTT_MQTT_TRACING_BINARYTRACEFILESINK_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/Tracing/ITraceSink.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Trace sink writing each event as a fixed 16 byte little endian record to a file.
+		 *
+		 * The file starts with the 8 byte magic `KMTRACE1`, followed by records of:
+		 * - u64 steady clock time since its epoch, in nanoseconds
+		 * - u32 bytes
+		 * - u16 packet ID
+		 * - u8 TraceStage
+		 * - u8 PacketType
+		 *
+		 * Records are buffered in memory and written once the buffer is full, on flush() and on destruction.
+		 */
+		class PUBLIC_API BinaryTraceFileSink : public ITraceSink
+		{
+		public:
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(BinaryTraceFileSink)
+
+			static constexpr std::size_t k_recordSize{ 16U };
+			static constexpr char k_magic[]{ 'K', 'M', 'T', 'R', 'A', 'C', 'E', '1' };
+
+			/**
+			 * @param path File to create, an existing file is truncated.
+			 * @param bufferBytes Records held in memory before they are written to the file.
+			 */
+			explicit BinaryTraceFileSink(const std::string& path, std::size_t bufferBytes = 64U * 1024U);
+			~BinaryTraceFileSink() override;
+
+			void onTraceEvent(const TraceEvent& event) noexcept override;
+
+			/**
+			 * @brief Write buffered records to the file.
+			 */
+			void flush() noexcept;
+
+			bool isOpen() const noexcept { return m_file != nullptr; }
+
+			/**
+			 * @brief Read back a file written by BinaryTraceFileSink, e.g. for tooling.
+			 * @return false if the file cannot be opened or does not start with the magic.
+			 */
+			static bool readFile(const std::string& path, std::vector<TraceEvent>& outEvents);
+
+		private:
+			void writeBuffer() noexcept;
+
+			std::FILE* m_file{ nullptr };
+			std::vector<std::uint8_t> m_buffer;
+			std::size_t m_bufferBytes;
+			std::mutex m_mutex;
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_TRACING_BINARYTRACEFILESINK_H
@@ -0,0 +1,73 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_TRACING_ITRACESINK_H
+#define INCLUDE_KMMQTT_MQTT_TRACING_ITRACESINK_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/GlobalTypes.h"
+#include "kmMqtt/Mqtt/Packets/PacketType.h"
+
+#include <cstdint>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief Point in the life of a packet a trace event is stamped at.
+		 * The time between two stages of the same packet is the span spent in that part of the client.
+		 */
+		enum class TraceStage : std::uint8_t
+		{
+			//Outbound
+			PUBLISH_QUEUED = 0U, //publish() accepted the message into the send queue.
+			COMPOSED = 1U, //Packet was encoded into the send buffer.
+			FIRST_BYTE_SENT = 2U, //Socket accepted the first byte of the packet.
+			LAST_BYTE_SENT = 3U, //Socket accepted the whole packet.
+			ACK_RECEIVED = 4U, //PUBACK, PUBREC or PUBCOMP for an outbound publish was handled.
+
+			//Inbound
+			FRAME_RECEIVED = 5U, //Whole packet was read from the socket and split off the byte stream.
+			DECODED = 6U, //Packet was decoded.
+			DISPATCHED = 7U, //Publish was handed to the callback dispatcher.
+			CALLBACK_COMPLETED = 8U, //Publish callback returned.
+
+			_COUNT
+		};
+
+		/**
+		 * @brief One stamp of a packet's lifecycle.
+		 * Outbound and inbound packets share packet IDs, pair them up by `stage` as well as `packetId`. QoS 0 publishes,
+		 * pings and CONNECT/CONNACK have packet ID 0.
+		 */
+		struct TraceEvent
+		{
+			TraceStage stage{ TraceStage::PUBLISH_QUEUED };
+			PacketType packetType{ PacketType::RESERVED };
+			std::uint16_t packetId{ 0U };
+			//Encoded packet size. Payload size for PUBLISH_QUEUED, topic and payload size for DISPATCHED and CALLBACK_COMPLETED,
+			//0 for ACK_RECEIVED.
+			std::uint32_t bytes{ 0U };
+			TimePoint time;
+		};
+
+		/**
+		 * @brief Receives the lifecycle stamps of every packet when set with MqttClientOptions::traceSink().
+		 *
+		 * Called from the tick thread, from the thread calling publish() and from dispatcher threads, so it must be thread
+		 * safe. It is called in line with sending and receiving, keep it to copying the event somewhere.
+		 */
+		class PUBLIC_API ITraceSink
+		{
+		public:
+			virtual ~ITraceSink() = default;
+
+			virtual void onTraceEvent(const TraceEvent& event) noexcept = 0;
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_TRACING_ITRACESINK_H
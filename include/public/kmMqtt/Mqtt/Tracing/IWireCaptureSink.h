@@ -0,0 +1,43 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_TRACING_IWIRECAPTURESINK_H
+#define INCLUDE_KMMQTT_MQTT_TRACING_IWIRECAPTURESINK_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/GlobalTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		enum class WireDirection : std::uint8_t
+		{
+			RECEIVED = 0U, //Read from the socket, before it is split into packets.
+			SENT = 1U, //Accepted by the socket, a partial send only covers the bytes it took.
+		};
+
+		/**
+		 * @brief Receives every byte the client reads from and writes to its socket when set with
+		 * MqttClientOptions::wireCapture(), e.g. to record production traffic and replay it offline.
+		 *
+		 * Received bytes come in the chunks the socket delivered them in, so a replay goes through the same packet
+		 * splitting. Called from the tick thread and the socket's receive thread, so it must be thread safe. It is called
+		 * in line with sending and receiving, keep it to copying the bytes somewhere.
+		 */
+		class PUBLIC_API IWireCaptureSink
+		{
+		public:
+			virtual ~IWireCaptureSink() = default;
+
+			virtual void onWireBytes(WireDirection direction, const std::uint8_t* bytes, std::size_t size, TimePoint time) noexcept = 0;
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_TRACING_IWIRECAPTURESINK_H
@@ -0,0 +1,87 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#ifndef INCLUDE_KMMQTT_MQTT_TRACING_WIRECAPTUREFILESINK_H
+#define INCLUDE_KMMQTT_MQTT_TRACING_WIRECAPTUREFILESINK_H
+
+#include "kmMqtt/GlobalMacros.h"
+#include "kmMqtt/Mqtt/Tracing/IWireCaptureSink.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		/**
+		 * @brief One socket read or write, read back from a capture file.
+		 */
+		struct WireCaptureRecord
+		{
+			WireDirection direction{ WireDirection::RECEIVED };
+			TimePoint time;
+			std::vector<std::uint8_t> bytes;
+		};
+
+		/**
+		 * @brief Wire capture sink writing each socket read and write as a little endian record to a file.
+		 *
+		 * The file starts with the 8 byte magic `KMWIRE01`, followed by records of:
+		 * - u64 steady clock time since its epoch, in nanoseconds
+		 * - u32 byte count
+		 * - u8 WireDirection
+		 * - the bytes
+		 *
+		 * Records are buffered in memory and written once the buffer is full, on flush() and on destruction.
+		 */
+		class PUBLIC_API WireCaptureFileSink : public IWireCaptureSink
+		{
+		public:
+			DELETE_COPY_ASSIGNMENT_AND_CONSTRUCTOR(WireCaptureFileSink)
+
+			static constexpr std::size_t k_recordHeaderSize{ 13U };
+			static constexpr char k_magic[]{ 'K', 'M', 'W', 'I', 'R', 'E', '0', '1' };
+
+			/**
+			 * @param path File to create, an existing file is truncated.
+			 * @param bufferBytes Records held in memory before they are written to the file. A larger record is written
+			 * straight through.
+			 */
+			explicit WireCaptureFileSink(const std::string& path, std::size_t bufferBytes = 256U * 1024U);
+			~WireCaptureFileSink() override;
+
+			void onWireBytes(WireDirection direction, const std::uint8_t* bytes, std::size_t size, TimePoint time) noexcept override;
+
+			/**
+			 * @brief Write buffered records to the file.
+			 */
+			void flush() noexcept;
+
+			bool isOpen() const noexcept { return m_file != nullptr; }
+
+			/**
+			 * @brief Read back a file written by WireCaptureFileSink, e.g. to replay it.
+			 * A record cut short at the end of the file, e.g. by a crash, is dropped.
+			 * @return false if the file cannot be opened or does not start with the magic.
+			 */
+			static bool readFile(const std::string& path, std::vector<WireCaptureRecord>& outRecords);
+
+		private:
+			void write(const std::uint8_t* data, std::size_t size) noexcept;
+			void writeBuffer() noexcept;
+
+			std::FILE* m_file{ nullptr };
+			std::vector<std::uint8_t> m_buffer;
+			std::size_t m_bufferBytes;
+			std::mutex m_mutex;
+		};
+	}
+}
+
+#endif //INCLUDE_KMMQTT_MQTT_TRACING_WIRECAPTUREFILESINK_H
@@ -15,6 +15,7 @@
 #include "kmMqtt/Mqtt/ReqResult.h"
 #include "kmMqtt/Mqtt/MqttConnectionInfo.h"
 #include "kmMqtt/Mqtt/MqttClientEvents.h"
+#include "kmMqtt/Mqtt/MqttClientMetrics.h"
 #include "kmMqtt/Mqtt/Enums/ConnectionStatus.h"
 #include "kmMqtt/Mqtt/Enums/ReconnectionStatus.h"
 #include "kmMqtt/Mqtt/Params/ConnectArgs.h"
@@ -140,6 +141,33 @@ namespace kmMqtt
 			 */
 			ClientError tick() noexcept;
 
+			/**
+			 * @brief Get the pollable wakeup handle for synchronous mode.
+			 * The handle becomes readable whenever the client has new work for tick() (data received, packets queued, state changes).
+			 * Register it for read readiness in your own event loop (epoll, libuv, asio...) alongside getSocketHandle(), and
+			 * call tick() when either is readable or nextDeadline() is reached. tick() clears the handle.
+			 * 
+			 * @return The OS handle (eventfd on Linux, pipe on other POSIX platforms), or -1 in ASYNC mode or on unsupported platforms.
+			 */
+			int getWakeupHandle() const noexcept;
+
+			/**
+			 * @brief Get the native handle of the underlying socket, see IWebSocket::getNativeHandle().
+			 * Only PosixTCPSocket and WindowsTCPSocket expose one, the DefaultWebsocket the default environments create
+			 * does not, so this is -1 unless the environment creates one of those or a custom socket that does.
+			 * 
+			 * @return The OS handle, or -1 if the socket implementation does not expose one or is not connected.
+			 */
+			int getSocketHandle() const noexcept;
+
+			/**
+			 * @brief Get the next point in time tick() must be called, even if no handle became readable.
+			 * Accounts for connect timeout, keep alive pings, ping response timeout, publish retries, send back-off and pending callbacks.
+			 * 
+			 * @return Time of the next deadline, `now` if there is work pending, or TimePoint::max() if the client is idle.
+			 */
+			TimePoint nextDeadline() noexcept;
+
 			/**
 			 * @brief Accessor for the ErrorEvent.
 			 * Invoked when an error occurs within the MQTT client.
@@ -190,6 +218,8 @@ namespace kmMqtt
 			 * @brief Accessor for the PublishCompletedEvent.
 			 * Invoked when a packet for publish acknowledged, release, received, or complete is received from the broker for a sent publish packet.
 			 * Notifies of the general state of the publish process for its corresponding QOS level. Does not call back on QOS 0 publishes.
+			 * A QOS 1/2 publish dropped because its message expiry interval passed before it was sent completes with packet type
+			 * PUBLISH and an unspecified error reason code.
 			 * 
 			 * @return Reference to the PublishCompletedEvent instance.
 			 */
@@ -211,6 +241,23 @@ namespace kmMqtt
 			 */
 			UnSubscribeAckEvent& onUnSubscribeAckEvent() noexcept;
 
+			/**
+			 * @brief Accessor for the WritableEvent.
+			 * Invoked when a full send queue has drained to its low watermarks and publish() no longer returns Would_Block.
+			 * 
+			 * @return Reference to the WritableEvent instance.
+			 */
+			WritableEvent& onWritableEvent() noexcept;
+
+			/**
+			 * @brief Accessor for the MemoryBudgetExceededEvent.
+			 * Invoked when the total of getMemoryStats() goes over MqttClientOptions::memoryBudget(), with the stats at that
+			 * time. Invoked again only after the total has dropped back under the budget.
+			 * 
+			 * @return Reference to the MemoryBudgetExceededEvent instance.
+			 */
+			MemoryBudgetExceededEvent& onMemoryBudgetExceededEvent() noexcept;
+
 			/**
 			 * @brief Get the connection status of the MQTT client.
 			 * 
@@ -232,6 +279,39 @@ namespace kmMqtt
 			 */
 			bool getIsTickAsync() const noexcept;
 
+			/**
+			 * @brief Get how many received QoS 0 publishes were replaced by a newer one before reaching the publish callback.
+			 * Only counts with ReceiveQueueOptions::conflateQos0 enabled.
+			 * 
+			 * @return Number of conflated received publishes since the client was created.
+			 */
+			std::size_t getInboundConflatedCount() const noexcept;
+
+			/**
+			 * @brief Get how many publishes were dropped unsent because their message expiry interval passed while queued,
+			 * spooled offline or waiting to be retried.
+			 * 
+			 * @return Number of expired publishes since the client was created.
+			 */
+			std::size_t getExpiredPublishCount() noexcept;
+
+			/**
+			 * @brief Get a copy of the client's counters, gauges and latency histograms.
+			 * Lock free and safe to call from any thread, e.g. a metrics endpoint, see toPrometheusText() to export it.
+			 * 
+			 * @return Metrics since the client was created.
+			 */
+			MqttClientMetrics getMetrics() const;
+
+			/**
+			 * @brief Get the live bytes held by the send and receive queues, session state, topic aliases, offline spool and
+			 * logger, to find which one is growing. Also part of getMetrics().
+			 * Lock free and safe to call from any thread, values are taken at the end of the last tick.
+			 * 
+			 * @return Memory held per subsystem.
+			 */
+			MqttClientMemoryStats getMemoryStats() const noexcept;
+
 		private:
 			std::unique_ptr<MqttClientImpl> m_impl{ nullptr };
 		};
@@ -9,8 +9,17 @@
 #include "kmMqtt/Dispatchers/ImmediateDispatcher.h"
 #include "kmMqtt/Interfaces/ICallbackDispatcher.h"
 #include "kmMqtt/Dispatchers/DefaultDispatcher.h"
+#include "kmMqtt/Mqtt/Params/OfflineSpoolOptions.h"
+#include "kmMqtt/Mqtt/Params/ReceiveQueueOptions.h"
+#include "kmMqtt/Mqtt/Params/SendQueueOptions.h"
+#include "kmMqtt/Mqtt/State/SessionState/IAsyncSessionStatePersistantStore.h"
+#include "kmMqtt/Mqtt/Tracing/ITraceSink.h"
+#include "kmMqtt/Mqtt/Tracing/IWireCaptureSink.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace kmMqtt
 {
@@ -20,6 +29,12 @@ namespace kmMqtt
 		SYNC, //tick() must be called manually
 	};
 
+	enum class AckMode : std::uint8_t
+	{
+		ON_DECODE, //Default option, PUBACK/PUBREC is queued as soon as the publish is decoded, independent of the publish callback.
+		AFTER_CALLBACK, //PUBACK/PUBREC is queued once the publish callback has returned, on whichever thread the dispatcher runs it.
+	};
+
 	/**
 	 * @brief Options for configuring the MQTT client behavior.
 	 */
@@ -88,6 +103,147 @@ namespace kmMqtt
 			return *this;
 		}
 
+		/**
+		 * @brief Set the function used to derive the ordering key of a received publish from its topic name.
+		 * The key is passed to ICallbackDispatcher::dispatchOrdered(), publishes sharing a key are delivered in order while
+		 * different keys may be delivered in parallel (e.g. by OrderedParallelDispatcher).
+		 *
+		 * Default hashes the full topic name, so ordering is per topic. Return a constant to keep all publishes in one lane,
+		 * or hash a prefix of the topic to order a whole sub-tree (e.g. per device).
+		 *
+		 * @param orderingKey Function mapping a topic name to an ordering key. nullptr restores the default.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& publishOrderingKey(std::function<std::size_t(const std::string&)> orderingKey)
+		{
+			m_publishOrderingKey = orderingKey ? std::move(orderingKey) : std::hash<std::string>{};
+			return *this;
+		}
+
+		/**
+		 * @brief Set when received QoS 1 and QoS 2 publishes are acknowledged.
+		 * ON_DECODE acknowledges as soon as the publish is decoded, giving the lowest ack latency. AFTER_CALLBACK holds the ack
+		 * until the publish callback has returned, so the broker only considers the message delivered once the application
+		 * has processed it. When using AFTER_CALLBACK with a dispatcher that queues callbacks, unacknowledged publishes count
+		 * towards the client's receive maximum until their callbacks run.
+		 *
+		 * @param mode The desired ack mode. Default is ON_DECODE.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& ackMode(AckMode mode)
+		{
+			m_ackMode = mode;
+			return *this;
+		}
+
+		/**
+		 * @brief Set a store the session state (in-flight QoS 1 and QoS 2 messages) is mirrored to.
+		 * With a store set, a client that connects with a session present on the broker but no session in memory (e.g. after a
+		 * process restart) recovers its in-flight messages from the store. A clean start removes the client's data from the store.
+		 * See WalSessionStatePersistantStore for the built-in file backed implementation.
+		 *
+		 * @param store The store to use, nullptr disables persistence. Default is nullptr.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& sessionStatePersistantStore(std::shared_ptr<mqtt::ISessionStatePersistantStore> store)
+		{
+			m_sessionStatePersistantStore = std::move(store);
+			m_asyncSessionStatePersistantStore = nullptr;
+			return *this;
+		}
+
+		/**
+		 * @brief Set a store whose writes complete asynchronously (e.g. WalSessionStatePersistantStore) as the session state store.
+		 * Behaves like sessionStatePersistantStore(), but PUBACK and PUBREC for received publishes are held until the store
+		 * reports that every change made before them is durable. Acks are still sent in the order the publishes were received.
+		 *
+		 * @param store The store to use, nullptr disables persistence. Default is nullptr.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& asyncSessionStatePersistantStore(std::shared_ptr<mqtt::IAsyncSessionStatePersistantStore> store)
+		{
+			m_sessionStatePersistantStore = store;
+			m_asyncSessionStatePersistantStore = std::move(store);
+			return *this;
+		}
+
+		/**
+		 * @brief Enable the offline spool. Publishes made while the client is not connected are spooled instead of failing with
+		 * Not_Connected, then sent in order after the next successful connect. Spooled publishes return no packet ID.
+		 * While spooled publishes are still draining, new publishes are queued behind them to keep publish order.
+		 *
+		 * @param options Spool limits and drain rate. maxBytes of 0 disables the spool. Default is disabled.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& offlineSpool(const mqtt::OfflineSpoolOptions& options)
+		{
+			m_offlineSpoolOptions = options;
+			return *this;
+		}
+
+		/**
+		 * @brief Bound the outgoing send queue. While it is full publish() returns Would_Block or waits, see SendQueueOptions.
+		 *
+		 * @param options High/low watermarks and the full queue policy. Default is unbounded.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& sendQueue(const mqtt::SendQueueOptions& options)
+		{
+			m_sendQueueOptions = options;
+			return *this;
+		}
+
+		/**
+		 * @brief Control how received publishes wait for the publish callback, see ReceiveQueueOptions.
+		 *
+		 * @param options Inbound conflation and backlog watermarks. Default delivers every received publish without limit.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& receiveQueue(const mqtt::ReceiveQueueOptions& options)
+		{
+			m_receiveQueueOptions = options;
+			return *this;
+		}
+
+		/**
+		 * @brief Stamp every packet's lifecycle (queued, composed, sent, acked, received, decoded, dispatched, callback
+		 * completed) to a sink, to break down where the time of a slow message went. See BinaryTraceFileSink.
+		 *
+		 * @param sink Thread safe sink receiving the stamps. Default is nullptr, tracing disabled.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& traceSink(std::shared_ptr<mqtt::ITraceSink> sink)
+		{
+			m_traceSink = std::move(sink);
+			return *this;
+		}
+
+		/**
+		 * @brief Copy every byte read from and written to the socket to a sink, to replay production traffic offline.
+		 * See WireCaptureFileSink.
+		 *
+		 * @param sink Thread safe sink receiving the bytes. Default is nullptr, capture disabled.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& wireCapture(std::shared_ptr<mqtt::IWireCaptureSink> sink)
+		{
+			m_wireCaptureSink = std::move(sink);
+			return *this;
+		}
+
+		/**
+		 * @brief Fire MqttClient::onMemoryBudgetExceededEvent() once the bytes tracked by MqttClient::getMemoryStats() go
+		 * over the budget. It fires again only after the total has dropped back under the budget.
+		 *
+		 * @param bytes Budget for MqttClientMemoryStats::totalBytes(). Default is 0, no budget.
+		 * @return Reference to the updated MqttClientOptions object.
+		 */
+		MqttClientOptions& memoryBudget(std::size_t bytes)
+		{
+			m_memoryBudget = bytes;
+			return *this;
+		}
+
 		/**
 		 * @brief Get the current tick mode of the MQTT client.
 		 * 
@@ -118,10 +274,120 @@ namespace kmMqtt
 			return m_useInternalCallbackDeferrer;
 		}
 
+		/**
+		 * @brief Get the function used to derive the ordering key of a received publish from its topic name.
+		 * 
+		 * @return The publish ordering key function.
+		 */
+		const std::function<std::size_t(const std::string&)>& getPublishOrderingKey() const
+		{
+			return m_publishOrderingKey;
+		}
+
+		/**
+		 * @brief Get when received QoS 1 and QoS 2 publishes are acknowledged.
+		 * 
+		 * @return The current AckMode.
+		 */
+		AckMode getAckMode() const
+		{
+			return m_ackMode;
+		}
+
+		/**
+		 * @brief Get the store the session state is mirrored to.
+		 * 
+		 * @return Shared pointer to the store, nullptr if persistence is disabled.
+		 */
+		const std::shared_ptr<mqtt::ISessionStatePersistantStore>& getSessionStatePersistantStore() const
+		{
+			return m_sessionStatePersistantStore;
+		}
+
+		/**
+		 * @brief Get the asynchronous session state store, if one was set with asyncSessionStatePersistantStore().
+		 * 
+		 * @return Shared pointer to the store, nullptr if not set.
+		 */
+		const std::shared_ptr<mqtt::IAsyncSessionStatePersistantStore>& getAsyncSessionStatePersistantStore() const
+		{
+			return m_asyncSessionStatePersistantStore;
+		}
+
+		/**
+		 * @brief Get the offline spool options.
+		 * 
+		 * @return The offline spool options, maxBytes is 0 if the spool is disabled.
+		 */
+		const mqtt::OfflineSpoolOptions& getOfflineSpoolOptions() const
+		{
+			return m_offlineSpoolOptions;
+		}
+
+		/**
+		 * @brief Get the send queue bounds.
+		 * 
+		 * @return The send queue options, watermarks are 0 if the queue is unbounded.
+		 */
+		const mqtt::SendQueueOptions& getSendQueueOptions() const
+		{
+			return m_sendQueueOptions;
+		}
+
+		/**
+		 * @brief Get the received publish handling options.
+		 * 
+		 * @return The receive queue options.
+		 */
+		const mqtt::ReceiveQueueOptions& getReceiveQueueOptions() const
+		{
+			return m_receiveQueueOptions;
+		}
+
+		/**
+		 * @brief Get the sink packet lifecycle stamps are sent to.
+		 * 
+		 * @return Shared pointer to the sink, nullptr if tracing is disabled.
+		 */
+		const std::shared_ptr<mqtt::ITraceSink>& getTraceSink() const
+		{
+			return m_traceSink;
+		}
+
+		/**
+		 * @brief Get the sink socket bytes are copied to.
+		 * 
+		 * @return Shared pointer to the sink, nullptr if wire capture is disabled.
+		 */
+		const std::shared_ptr<mqtt::IWireCaptureSink>& getWireCaptureSink() const
+		{
+			return m_wireCaptureSink;
+		}
+
+		/**
+		 * @brief Get the memory budget the memory budget exceeded event is fired for.
+		 * 
+		 * @return Budget in bytes, 0 if there is none.
+		 */
+		std::size_t getMemoryBudget() const
+		{
+			return m_memoryBudget;
+		}
+
 	private:
 		TickMode m_tickMode{ TickMode::ASYNC };
 		std::shared_ptr<ICallbackDispatcher> m_callbackDispatcher{ std::make_shared<DefaultDispatcher>()};
 		bool m_useInternalCallbackDeferrer{ false };
+		std::function<std::size_t(const std::string&)> m_publishOrderingKey{ std::hash<std::string>{} };
+		AckMode m_ackMode{ AckMode::ON_DECODE };
+		std::shared_ptr<mqtt::ISessionStatePersistantStore> m_sessionStatePersistantStore{ nullptr };
+		std::shared_ptr<mqtt::IAsyncSessionStatePersistantStore> m_asyncSessionStatePersistantStore{ nullptr };
+		mqtt::OfflineSpoolOptions m_offlineSpoolOptions{};
+		mqtt::SendQueueOptions m_sendQueueOptions{};
+		mqtt::ReceiveQueueOptions m_receiveQueueOptions{};
+		std::shared_ptr<mqtt::ITraceSink> m_traceSink{ nullptr };
+		std::shared_ptr<mqtt::IWireCaptureSink> m_wireCaptureSink{ nullptr };
+		std::size_t m_memoryBudget{ 0U };
 	};
 }
 
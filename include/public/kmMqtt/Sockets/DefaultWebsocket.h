@@ -16,6 +16,11 @@
 
 namespace kmMqtt
 {
+	/**
+	 * @brief WebSocket transport backed by IXWebSocket, a stub that fails to connect when built with BUILD_IXWEBSOCKET=OFF.
+	 * IXWebSocket reads on its own thread and does not expose its socket, so getNativeHandle() returns -1 and
+	 * SendQueueOptions::manageTcpOptions has no effect. Use PosixTCPSocket or WindowsTCPSocket for a native handle.
+	 */
 	class PUBLIC_API DefaultWebsocket : public IWebSocket
 	{
 	public:
@@ -0,0 +1,64 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#ifndef INCLUDE_ADAPTERS_WEBSOCKETS_POSIXTCPSOCKET_H
+#define INCLUDE_ADAPTERS_WEBSOCKETS_POSIXTCPSOCKET_H
+
+#include "kmMqtt/Interfaces/IWebSocket.h"
+
+namespace kmMqtt
+{
+	/**
+	 * @brief Plain TCP socket for POSIX platforms, the counterpart of WindowsTCPSocket.
+	 * Non-blocking, connects and reads on tick() only, so it suits TickMode::SYNC clients polling getNativeHandle() in their
+	 * own event loop. Exposes its descriptor, so SendQueueOptions::manageTcpOptions applies to it.
+	 */
+	class PUBLIC_API PosixTCPSocket : public IWebSocket
+	{
+	public:
+		PosixTCPSocket() = default;
+		~PosixTCPSocket() override;
+
+		bool connect(const mqtt::Address& address) noexcept override;
+		int send(const ByteBuffer& data) noexcept override;
+		bool close() noexcept override;
+		void tick() noexcept override;
+		int getNativeHandle() const noexcept override { return m_socket; }
+		void setReadPaused(bool paused) noexcept override { m_isReadPaused = paused; }
+
+		bool isConnected() const noexcept override { return m_connected; }
+
+		/**
+		 * @return The negated errno of the last failed call, so failed sends the SDK reports with it stay negative. 0 if none.
+		 */
+		int getLastError() const noexcept override { return m_lastError; }
+		int getLastCloseCode() const noexcept override { return 0; }
+		const char* getLastCloseReason() const noexcept override { return "N/A"; }
+
+		void setOnConnectCallback(OnConnectCallback callback) noexcept override { m_onConnectCallback = std::move(callback); }
+		void setOnDisconnectCallback(OnDisconnectCallback callback) noexcept override { m_onDisconnectCallback = std::move(callback); }
+		void setOnRecvdCallback(OnRecvdCallback callback) noexcept override { m_onRecvdCallback = std::move(callback); }
+		void setOnErrorCallback(OnErrorCallback callback) noexcept override { m_onErrorCallback = std::move(callback); }
+
+	private:
+		void readAvailable() noexcept;
+
+		int m_socket{ -1 };
+		int m_lastError{ 0 };
+		bool m_connected{ false };
+		bool m_isConnecting{ false };
+		bool m_isReadPaused{ false };
+
+		OnConnectCallback m_onConnectCallback;
+		OnDisconnectCallback m_onDisconnectCallback;
+		OnRecvdCallback m_onRecvdCallback;
+		OnErrorCallback m_onErrorCallback;
+	};
+}
+
+#endif //INCLUDE_ADAPTERS_WEBSOCKETS_POSIXTCPSOCKET_H
+#endif //!defined(_WIN32) && !defined(_WIN64)
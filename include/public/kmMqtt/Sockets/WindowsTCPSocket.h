@@ -28,6 +28,8 @@ namespace kmMqtt
 		int send(const ByteBuffer& data) noexcept override;
 		bool close() noexcept override;
 		void tick() noexcept override;
+		int getNativeHandle() const noexcept override;
+		void setReadPaused(bool paused) noexcept override;
 
 		bool isConnected() const noexcept override;
 		int getLastError() const noexcept override;
@@ -40,6 +42,7 @@ namespace kmMqtt
 		void setOnErrorCallback(OnErrorCallback callback) noexcept override { m_onErrorCallback = std::move(callback); }
 
 	private:
+		void readAvailable() noexcept;
 
 		inline void logInfo(const char* msg)
 		{
@@ -66,6 +69,8 @@ namespace kmMqtt
 
 		SOCKET m_socket{};
 		bool m_connected{ false };
+		bool m_isReadPaused{ false };
+		bool m_hasUnreadData{ false }; //FD_READ seen while paused, winsock only signals it again after the next recv().
 
 		OnConnectCallback m_onConnectCallback;
 		OnDisconnectCallback m_onDisconnectCallback;
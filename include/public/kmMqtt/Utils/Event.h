@@ -6,60 +6,84 @@
 #pragma once
 
 #include "kmMqtt/GlobalMacros.h"
-#include <vector>
-#include <mutex>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace kmMqtt
 {
 	namespace events
 	{
+		/**
+		 * @brief Multicast event with a copy-on-write listener list.
+		 * Listeners are stored in an immutable list that is swapped atomically. invoke() only takes a snapshot of the current
+		 * list and does not wait for add()/remove() to copy it, so events can be fired concurrently from multiple threads (e.g.
+		 * by a parallel callback dispatcher) and listeners may add or remove listeners from inside a callback.
+		 * add()/remove() pay for copying the list, which is expected to be rare compared to invoke().
+		 *
+		 * invoke() is not lock-free: the C++14 std::atomic_load/atomic_store overloads for shared_ptr are implemented with a
+		 * small pool of global locks in libstdc++, libc++ and MSVC. Each is held only to copy the pointer and bump its
+		 * reference count, never while callbacks run, but it may briefly contend with other shared_ptr atomics hashed to it.
+		 *
+		 * Listeners are std::function rather than UniqueFunction: UniqueFunction is move-only and void() only, while the
+		 * copy-on-write list copies every listener into the next list, and remove() finds listeners by their target.
+		 *
+		 * Listeners removed while an invoke() is in progress may still be called by that invoke().
+		 */
 		template <typename...Args>
 		class Event
 		{
 		public:
 			using Callback = std::function<void(Args...)>;
+			using CallbackList = std::vector<Callback>;
 
 			Event() noexcept = default;
 			virtual ~Event() {};
 
 			void add(const Callback& callback)
 			{
-				LockGuard lock(m_mutex);
+				LockGuard lock(m_writeMutex);
 
-				for (auto iter = m_callbacks.begin(); iter != m_callbacks.end(); ++iter)
+				const auto current{ std::atomic_load(&m_callbacks) };
+				if (find(*current, callback) != current->end())
 				{
-					if (iter->target_type() == callback.target_type() &&
-						iter->template target<void(*)(Args...)>() == callback.template target<void(*)(Args...)>())
-					{
-						return;
-					}
+					return;
 				}
 
-				m_callbacks.emplace_back(callback);
+				auto next{ std::make_shared<CallbackList>() };
+				next->reserve(current->size() + 1);
+				next->insert(next->end(), current->begin(), current->end());
+				next->emplace_back(callback);
+
+				std::atomic_store(&m_callbacks, std::shared_ptr<const CallbackList>{ std::move(next) });
 			}
 
 			void remove(const Callback& callback)
 			{
-				std::lock_guard<std::mutex> lock(m_mutex);
+				LockGuard lock(m_writeMutex);
 
-				for (auto iter = m_callbacks.begin(); iter != m_callbacks.end(); ++iter)
+				const auto current{ std::atomic_load(&m_callbacks) };
+				const auto found{ find(*current, callback) };
+				if (found == current->end())
 				{
-					if (iter->target_type() == callback.target_type() &&
-						iter->template target<void(*)(Args...)>() == callback.template target<void(*)(Args...)>())
-					{
-						*iter = std::move(m_callbacks.back());
-						m_callbacks.pop_back();
-						break;
-					}
+					return;
 				}
+
+				auto next{ std::make_shared<CallbackList>() };
+				next->reserve(current->size() - 1);
+				next->insert(next->end(), current->begin(), found);
+				next->insert(next->end(), found + 1, current->end());
+
+				std::atomic_store(&m_callbacks, std::shared_ptr<const CallbackList>{ std::move(next) });
 			}
 
 			virtual void invoke(Args... args) noexcept
 			{
-				std::lock_guard<std::mutex> lock(m_mutex);
+				const auto snapshot{ std::atomic_load(&m_callbacks) };
 
-				for (const auto& callback : m_callbacks)
+				for (const auto& callback : *snapshot)
 				{
 					callback(args...);
 				}
@@ -67,8 +91,16 @@ namespace kmMqtt
 
 			void removeAll()
 			{
-				LockGuard lock(m_mutex);
-				m_callbacks.clear();
+				LockGuard lock(m_writeMutex);
+				std::atomic_store(&m_callbacks, std::shared_ptr<const CallbackList>{ std::make_shared<CallbackList>() });
+			}
+
+			/**
+			 * @brief Get the number of listeners currently registered.
+			 */
+			std::size_t size() const noexcept
+			{
+				return std::atomic_load(&m_callbacks)->size();
 			}
 
 			void operator()(Args... args) noexcept { invoke(args...); }
@@ -76,8 +108,22 @@ namespace kmMqtt
 			void operator-=(const Callback& callback) { remove(callback); }
 
 		private:
-			std::vector<Callback> m_callbacks;
-			std::mutex m_mutex;
+			static typename CallbackList::const_iterator find(const CallbackList& callbacks, const Callback& callback) noexcept
+			{
+				for (auto iter = callbacks.begin(); iter != callbacks.end(); ++iter)
+				{
+					if (iter->target_type() == callback.target_type() &&
+						iter->template target<void(*)(Args...)>() == callback.template target<void(*)(Args...)>())
+					{
+						return iter;
+					}
+				}
+
+				return callbacks.end();
+			}
+
+			std::shared_ptr<const CallbackList> m_callbacks{ std::make_shared<CallbackList>() };
+			std::mutex m_writeMutex;
 		};
 	}
 }
\ No newline at end of file
@@ -59,10 +59,18 @@ namespace kmMqtt
 		size_t packetStart{ 0 };
 		while (packetStart < buffer.size())
 		{
-			// If there are not enough bytes left to read a full packet header, break out of the loop.
-			if (buffer.size() - buffer.readCursor() < 2)
+			//Remaining Length is 1 to 4 bytes, each but the last with the continuation bit set. If the fixed header is not
+			//complete yet, keep it as left over bytes until the rest arrives.
+			size_t lengthEnd{ packetStart + 1 };
+			while (lengthEnd < buffer.size() && (buffer[lengthEnd] & 0x80U) != 0U && lengthEnd - packetStart < 4)
 			{
-				return !packets.empty();;
+				++lengthEnd;
+			}
+
+			if (lengthEnd >= buffer.size())
+			{
+				leftOverPosition = buffer.size() - packetStart;
+				return !packets.empty();
 			}
 
 			buffer.resetReadCursor();
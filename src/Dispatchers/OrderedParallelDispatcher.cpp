@@ -0,0 +1,275 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Dispatchers/OrderedParallelDispatcher.h"
+#include "kmMqtt/Logger/LogMacros.h"
+
+#include <exception>
+
+namespace kmMqtt
+{
+	namespace
+	{
+		//Identifies the dispatcher (and worker) owning the current thread, so workers can schedule onto their own queue
+		//and never block on their own pool.
+		thread_local const OrderedParallelDispatcher* t_ownerDispatcher{ nullptr };
+		thread_local std::size_t t_workerIndex{ 0U };
+	}
+
+	OrderedParallelDispatcher::OrderedParallelDispatcher(const OrderedParallelDispatcherOptions& options)
+		: m_options(options)
+	{
+		if (m_options.threadCount == 0U)
+		{
+			m_options.threadCount = std::thread::hardware_concurrency();
+			m_options.threadCount = m_options.threadCount == 0U ? 1U : m_options.threadCount;
+		}
+
+		m_options.laneCount = m_options.laneCount == 0U ? 1U : m_options.laneCount;
+		m_options.maxCallbacksPerLaneTurn = m_options.maxCallbacksPerLaneTurn == 0U ? 1U : m_options.maxCallbacksPerLaneTurn;
+
+		m_lanes.reserve(m_options.laneCount);
+		for (std::size_t i = 0U; i < m_options.laneCount; ++i)
+		{
+			m_lanes.emplace_back(new Lane());
+		}
+
+		m_workers.reserve(m_options.threadCount);
+		for (std::size_t i = 0U; i < m_options.threadCount; ++i)
+		{
+			m_workers.emplace_back(new Worker());
+		}
+
+		for (std::size_t i = 0U; i < m_options.threadCount; ++i)
+		{
+			m_workers[i]->thread = std::thread(&OrderedParallelDispatcher::workerLoop, this, i);
+		}
+	}
+
+	OrderedParallelDispatcher::~OrderedParallelDispatcher() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_workMutex };
+			m_isStopping = true;
+		}
+		m_workCondition.notify_all();
+
+		{
+			std::lock_guard<std::mutex> lock{ m_capacityMutex };
+		}
+		m_capacityCondition.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			if (worker->thread.joinable())
+			{
+				worker->thread.join();
+			}
+		}
+	}
+
+	void OrderedParallelDispatcher::dispatch(UniqueFunction callback) noexcept
+	{
+		dispatchOrdered(std::move(callback), 0U);
+	}
+
+	void OrderedParallelDispatcher::dispatchOrdered(UniqueFunction callback, std::size_t orderingKey) noexcept
+	{
+		{
+			std::unique_lock<std::mutex> lock{ m_capacityMutex };
+
+			if (m_options.maxQueuedCallbacks > 0U && !isWorkerThread())
+			{
+				m_capacityCondition.wait(lock, [this]() { return m_queuedCount < m_options.maxQueuedCallbacks || m_isStopping; });
+			}
+
+			++m_queuedCount;
+		}
+
+		const std::size_t laneIndex{ orderingKey % m_options.laneCount };
+		Lane& lane{ *m_lanes[laneIndex] };
+		bool needsScheduling{ false };
+
+		{
+			std::lock_guard<std::mutex> lock{ lane.mutex };
+			lane.callbacks.push_back(std::move(callback));
+
+			if (!lane.isScheduled)
+			{
+				lane.isScheduled = true;
+				needsScheduling = true;
+			}
+		}
+
+		if (needsScheduling)
+		{
+			scheduleLane(laneIndex);
+		}
+	}
+
+	void OrderedParallelDispatcher::waitUntilIdle() noexcept
+	{
+		if (isWorkerThread())
+		{
+			LOG_WARNING("OrderedParallelDispatcher", "waitUntilIdle() called from a worker thread, ignoring to avoid deadlock.");
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock{ m_capacityMutex };
+		m_capacityCondition.wait(lock, [this]() { return m_queuedCount == 0U; });
+	}
+
+	std::size_t OrderedParallelDispatcher::getQueuedCount() const noexcept
+	{
+		std::lock_guard<std::mutex> lock{ m_capacityMutex };
+		return m_queuedCount;
+	}
+
+	std::size_t OrderedParallelDispatcher::getThreadCount() const noexcept
+	{
+		return m_options.threadCount;
+	}
+
+	std::size_t OrderedParallelDispatcher::getLaneCount() const noexcept
+	{
+		return m_options.laneCount;
+	}
+
+	void OrderedParallelDispatcher::scheduleLane(std::size_t laneIndex) noexcept
+	{
+		//Workers keep lanes they reschedule on their own queue (better cache locality), others are spread round robin.
+		const std::size_t workerIndex{ isWorkerThread() ? t_workerIndex : m_nextWorker.fetch_add(1U) % m_workers.size() };
+
+		{
+			Worker& worker{ *m_workers[workerIndex] };
+			std::lock_guard<std::mutex> lock{ worker.mutex };
+			worker.lanes.push_back(laneIndex);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{ m_workMutex };
+			++m_scheduledLaneCount;
+		}
+		m_workCondition.notify_one();
+	}
+
+	bool OrderedParallelDispatcher::tryTakeLane(std::size_t workerIndex, std::size_t& outLaneIndex) noexcept
+	{
+		{
+			Worker& own{ *m_workers[workerIndex] };
+			std::lock_guard<std::mutex> lock{ own.mutex };
+
+			if (!own.lanes.empty())
+			{
+				outLaneIndex = own.lanes.front();
+				own.lanes.pop_front();
+				return true;
+			}
+		}
+
+		//Steal from the back of other workers' queues.
+		for (std::size_t i = 1U; i < m_workers.size(); ++i)
+		{
+			Worker& victim{ *m_workers[(workerIndex + i) % m_workers.size()] };
+			std::lock_guard<std::mutex> lock{ victim.mutex };
+
+			if (!victim.lanes.empty())
+			{
+				outLaneIndex = victim.lanes.back();
+				victim.lanes.pop_back();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void OrderedParallelDispatcher::runLane(std::size_t laneIndex) noexcept
+	{
+		Lane& lane{ *m_lanes[laneIndex] };
+
+		for (std::size_t i = 0U; i < m_options.maxCallbacksPerLaneTurn; ++i)
+		{
+			std::unique_lock<std::mutex> laneLock{ lane.mutex };
+
+			if (lane.callbacks.empty())
+			{
+				lane.isScheduled = false;
+				return;
+			}
+
+			UniqueFunction callback{ std::move(lane.callbacks.front()) };
+			lane.callbacks.pop_front();
+			laneLock.unlock();
+
+			try
+			{
+				callback();
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR("OrderedParallelDispatcher", "Callback threw an exception: %s", e.what());
+			}
+			catch (...)
+			{
+				LOG_ERROR("OrderedParallelDispatcher", "Callback threw an unknown exception.");
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ m_capacityMutex };
+				--m_queuedCount;
+			}
+			m_capacityCondition.notify_all();
+		}
+
+		{
+			std::lock_guard<std::mutex> laneLock{ lane.mutex };
+
+			if (lane.callbacks.empty())
+			{
+				lane.isScheduled = false;
+				return;
+			}
+		}
+
+		//Lane still has work, put it back so other lanes get a turn. It stays marked as scheduled so no other worker runs it meanwhile.
+		scheduleLane(laneIndex);
+	}
+
+	void OrderedParallelDispatcher::workerLoop(std::size_t workerIndex) noexcept
+	{
+		t_ownerDispatcher = this;
+		t_workerIndex = workerIndex;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock{ m_workMutex };
+				m_workCondition.wait(lock, [this]() { return m_scheduledLaneCount > 0U || m_isStopping; });
+
+				if (m_scheduledLaneCount == 0U)
+				{
+					return; //Stopping and fully drained.
+				}
+
+				--m_scheduledLaneCount;
+			}
+
+			//A lane is guaranteed to be queued somewhere as the counter is only raised after the push.
+			std::size_t laneIndex{ 0U };
+			while (!tryTakeLane(workerIndex, laneIndex))
+			{
+				std::this_thread::yield();
+			}
+
+			runLane(laneIndex);
+		}
+	}
+
+	bool OrderedParallelDispatcher::isWorkerThread() const noexcept
+	{
+		return t_ownerDispatcher == this;
+	}
+}
@@ -0,0 +1,277 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <kmMqtt/Logger/AsyncLog.h>
+#include <kmMqtt/Logger/LoggerInstance.h>
+#include "kmMqtt/Logger/LogRecord.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 2048
+#endif
+
+namespace kmMqtt
+{
+	namespace
+	{
+		struct ThreadLogRing
+		{
+			explicit ThreadLogRing(std::size_t capacity)
+				: ring{ capacity }
+			{
+			}
+
+			LogRing ring;
+			std::atomic<bool> isRetired{ false }; //Owning thread has exited, the ring is removed once drained.
+		};
+
+		struct AsyncLogState
+		{
+			~AsyncLogState()
+			{
+				stop();
+			}
+
+			void start(const AsyncLogOptions& newOptions);
+			void stop();
+			void flush();
+			void run();
+			void drain(std::vector<std::shared_ptr<ThreadLogRing>>& rings);
+			ThreadLogRing* getThreadRing();
+
+			std::atomic<bool> isRunning{ false };
+			std::atomic<std::size_t> droppedCount{ 0U };
+			std::atomic<std::size_t> ringBytes{ 0U };
+
+			std::mutex controlMutex; //Serializes start and stop.
+			std::thread thread;
+
+			std::mutex mutex;
+			std::condition_variable wakeup;
+			std::condition_variable flushed;
+			AsyncLogOptions options;
+			std::vector<std::shared_ptr<ThreadLogRing>> rings;
+			bool isStopRequested{ false };
+			std::uint64_t flushRequested{ 0U };
+			std::uint64_t flushCompleted{ 0U };
+		};
+
+		AsyncLogState g_asyncLog;
+
+		struct ThreadRingHolder
+		{
+			~ThreadRingHolder()
+			{
+				if (ring != nullptr)
+				{
+					ring->isRetired.store(true, std::memory_order_release);
+				}
+			}
+
+			std::shared_ptr<ThreadLogRing> ring;
+		};
+
+		thread_local ThreadRingHolder t_threadRing;
+
+		void AsyncLogState::start(const AsyncLogOptions& newOptions)
+		{
+			std::lock_guard<std::mutex> controlLock{ controlMutex };
+			if (thread.joinable())
+			{
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ mutex };
+				options = newOptions;
+				isStopRequested = false;
+			}
+
+			thread = std::thread{ [this]() { run(); } };
+			isRunning.store(true, std::memory_order_release);
+		}
+
+		void AsyncLogState::stop()
+		{
+			std::lock_guard<std::mutex> controlLock{ controlMutex };
+			if (!thread.joinable())
+			{
+				return;
+			}
+
+			isRunning.store(false, std::memory_order_release);
+
+			{
+				std::lock_guard<std::mutex> lock{ mutex };
+				isStopRequested = true;
+			}
+
+			wakeup.notify_one();
+			thread.join();
+		}
+
+		void AsyncLogState::flush()
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			if (!isRunning.load(std::memory_order_acquire))
+			{
+				return;
+			}
+
+			const std::uint64_t ticket{ ++flushRequested };
+			wakeup.notify_one();
+			flushed.wait(lock, [this, ticket]() { return flushCompleted >= ticket || isStopRequested; });
+		}
+
+		void AsyncLogState::run()
+		{
+			std::vector<std::shared_ptr<ThreadLogRing>> drainRings;
+			std::unique_lock<std::mutex> lock{ mutex };
+
+			while (true)
+			{
+				const std::uint64_t flushTicket{ flushRequested };
+				const bool isStopping{ isStopRequested };
+				drainRings.assign(rings.begin(), rings.end());
+
+				lock.unlock();
+				drain(drainRings);
+				lock.lock();
+
+				//Retired is checked before empty, the owning thread cannot push after it retired.
+				rings.erase(std::remove_if(rings.begin(), rings.end(), [this](const std::shared_ptr<ThreadLogRing>& ring)
+					{
+						if (ring->isRetired.load(std::memory_order_acquire) && ring->ring.empty())
+						{
+							ringBytes.fetch_sub(ring->ring.capacity(), std::memory_order_relaxed);
+							return true;
+						}
+
+						return false;
+					}), rings.end());
+
+				flushCompleted = flushTicket;
+				flushed.notify_all();
+
+				if (isStopping)
+				{
+					break;
+				}
+
+				wakeup.wait_for(lock, options.flushInterval, [this]() { return isStopRequested || flushRequested != flushCompleted; });
+			}
+		}
+
+		void AsyncLogState::drain(std::vector<std::shared_ptr<ThreadLogRing>>& drainRings)
+		{
+			char buffer[LOG_BUFFER_SIZE];
+
+			for (const auto& threadRing : drainRings)
+			{
+				const std::uint8_t* record{ nullptr };
+				std::uint32_t size{ 0U };
+
+				while (threadRing->ring.front(record, size))
+				{
+					LogLevel level{ LogLevel::Info };
+					const char* category{ nullptr };
+					formatLogRecord(record, size, buffer, sizeof(buffer), level, category);
+					threadRing->ring.pop();
+
+					ILogger* logger{ getLogger() };
+					if (logger == nullptr)
+					{
+						continue;
+					}
+
+					if (category != nullptr)
+					{
+						logger->Log(level, category, buffer);
+					}
+					else
+					{
+						logger->Log(level, buffer);
+					}
+				}
+			}
+		}
+
+		ThreadLogRing* AsyncLogState::getThreadRing()
+		{
+			if (t_threadRing.ring == nullptr)
+			{
+				std::lock_guard<std::mutex> lock{ mutex };
+				t_threadRing.ring = std::make_shared<ThreadLogRing>(std::max<std::size_t>(options.ringBytesPerThread, LOG_BUFFER_SIZE));
+				rings.push_back(t_threadRing.ring);
+				ringBytes.fetch_add(t_threadRing.ring->ring.capacity(), std::memory_order_relaxed);
+			}
+
+			return t_threadRing.ring.get();
+		}
+	}
+
+	void startAsyncLogging(const AsyncLogOptions& options)
+	{
+		g_asyncLog.start(options);
+	}
+
+	void stopAsyncLogging()
+	{
+		g_asyncLog.stop();
+	}
+
+	void flushAsyncLogs()
+	{
+		g_asyncLog.flush();
+	}
+
+	bool isAsyncLoggingRunning() noexcept
+	{
+		return g_asyncLog.isRunning.load(std::memory_order_acquire);
+	}
+
+	std::size_t getDroppedLogCount() noexcept
+	{
+		return g_asyncLog.droppedCount.load(std::memory_order_relaxed);
+	}
+
+	std::size_t getAsyncLogBufferBytes() noexcept
+	{
+		return g_asyncLog.ringBytes.load(std::memory_order_relaxed);
+	}
+
+	bool tryLogAsync(LogLevel level, const char* category, const char* format, va_list args) noexcept
+	{
+		if (!g_asyncLog.isRunning.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		std::uint8_t record[LOG_BUFFER_SIZE];
+		const std::size_t size{ encodeLogRecord(record, sizeof(record), level, category, format, args) };
+
+		ThreadLogRing* threadRing{ nullptr };
+		try
+		{
+			threadRing = g_asyncLog.getThreadRing();
+		}
+		catch (const std::bad_alloc&)
+		{
+		}
+
+		if (size == 0U || threadRing == nullptr || !threadRing->ring.tryPush(record, size))
+		{
+			g_asyncLog.droppedCount.fetch_add(1U, std::memory_order_relaxed);
+		}
+
+		return true;
+	}
+}
@@ -5,21 +5,13 @@
 
 #include <kmMqtt/Logger/Log.h>
 #include <kmMqtt/Logger/LoggerInstance.h>
+#include "kmMqtt/Logger/LogMacros.h"
+#include "kmMqtt/Logger/LogRecord.h"
 #include <cstdarg>
 
 namespace kmMqtt
 {
 
-#define TRACE 0
-#define INFO 1
-#define DEBUG 2
-#define WARNING 3
-#define ERROR 4
-
-#ifndef ENABLE_LOGS
-#define LOG_LEVEL 999
-#endif //ENABLE_LOGS
-
 #ifndef LOG_BUFFER_SIZE
 #define LOG_BUFFER_SIZE 2048
 #endif
@@ -31,26 +23,52 @@ namespace kmMqtt
 #define VSNPRINTF(buffer, size, fmt, args) std::vsnprintf(buffer, size, fmt, args)
 #endif
 
+	bool isLogLevelEnabled(const LogLevel logLevel) noexcept
+	{
+		const ILogger* logger{ getLogger() };
+		return logger != nullptr && logLevel >= logger->getLowestLogLevel();
+	}
+
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_ERROR
 namespace
 {
-#define FORMAT_MSG(msg, lastParam)\
-	char buffer[LOG_BUFFER_SIZE];\
+	void writeLog(const LogLevel logLevel, const char* category, const char* msg, va_list args) noexcept
+	{
+		if (tryLogAsync(logLevel, category, msg, args))
+		{
+			return;
+		}
+
+		char buffer[LOG_BUFFER_SIZE];
+		VSNPRINTF(buffer, sizeof(buffer), msg, args);
+
+		if (category != nullptr)
+		{
+			getLogger()->Log(logLevel, category, buffer);
+		}
+		else
+		{
+			getLogger()->Log(logLevel, buffer);
+		}
+	}
+
+#define LOG_CATEGORY(logLevel, category, msg, lastParam)\
+	if (!isLogLevelEnabled(logLevel))\
+	{\
+		return;\
+	}\
 	va_list args;\
 	va_start(args, lastParam);\
-	VSNPRINTF(buffer, sizeof(buffer), msg, args);\
+	writeLog(logLevel, category, msg, args);\
 	va_end(args);\
 
 #define LOG(logLevel, msg, lastParam)\
-	FORMAT_MSG(msg, lastParam)\
-	getLogger()->Log(logLevel, buffer);\
-
-#define LOG_CATEGORY(logLevel, category, msg, lastParam)\
-	FORMAT_MSG(msg, lastParam)\
-	getLogger()->Log(logLevel,category, buffer);\
+	LOG_CATEGORY(logLevel, nullptr, msg, lastParam)\
 
 }
+#endif //COMPILED_LOG_LEVEL <= LOG_LEVEL_ERROR
 
-#if LOG_LEVEL <= TRACE
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_TRACE
 	void LogTrace(const char* msg, ...) noexcept
 	{
 		LOG(LogLevel::Trace, msg, msg);
@@ -69,9 +87,9 @@ namespace
 	void LogTrace(const char* /*category*/, const char* /*msg*/, ...) noexcept
 	{
 	}
-#endif //LOG_LEVEL <= TRACE
+#endif //COMPILED_LOG_LEVEL <= LOG_LEVEL_TRACE
 
-#if LOG_LEVEL <= INFO
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_INFO
 	void LogInfo(const char* msg, ...) noexcept
 	{
 		LOG(LogLevel::Info, msg, msg);
@@ -89,9 +107,9 @@ namespace
 	void LogInfo(const char* /*category*/, const char* /*msg*/, ...) noexcept
 	{
 	}
-#endif //LOG_LEVEL <= INFO
+#endif //COMPILED_LOG_LEVEL <= LOG_LEVEL_INFO
 
-#if LOG_LEVEL <= DEBUG
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_DEBUG
 	void LogDebug(const char* msg, ...) noexcept
 	{
 		LOG(LogLevel::Debug, msg, msg);
@@ -109,9 +127,9 @@ namespace
 	void LogDebug(const char* /*category*/, const char* /*msg*/, ...) noexcept
 	{
 	}
-#endif //LOG_LEVEL <= DEBUG
+#endif //COMPILED_LOG_LEVEL <= LOG_LEVEL_DEBUG
 
-#if LOG_LEVEL <= WARNING
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_WARNING
 	void LogWarning(const char* msg, ...) noexcept
 	{
 		LOG(LogLevel::Warning, msg, msg);
@@ -129,9 +147,9 @@ namespace
 	void LogWarning(const char* /*category*/, const char* /*msg*/, ...) noexcept
 	{
 	}
-#endif //LOG_LEVEL <= WARNING
+#endif //COMPILED_LOG_LEVEL <= LOG_LEVEL_WARNING
 
-#if LOG_LEVEL <= ERROR
+#if COMPILED_LOG_LEVEL <= LOG_LEVEL_ERROR
 	void LogError(const char* msg, ...) noexcept
 	{
 		LOG(LogLevel::Error, msg, msg);
@@ -149,7 +167,7 @@ namespace
 	void LogError(const char* /*category*/, const char* /*msg*/, ...) noexcept
 	{
 	}
-#endif //LOG_LEVEL <= ERROR
+#endif //COMPILED_LOG_LEVEL <= LOG_LEVEL_ERROR
 
 	void LogException(const char* category, const std::exception& e) noexcept(false)
 	{
@@ -0,0 +1,542 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Logger/LogRecord.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace kmMqtt
+{
+	namespace
+	{
+		enum class LengthModifier : std::uint8_t
+		{
+			NONE,
+			HH,
+			H,
+			L,
+			LL,
+			J,
+			Z,
+			T,
+			LONG_DOUBLE,
+		};
+
+		enum class ArgKind : std::uint8_t
+		{
+			NONE, //%% or an unknown conversion, consumes no argument.
+			SIGNED,
+			UNSIGNED,
+			FLOATING,
+			CHARACTER,
+			TEXT,
+			POINTER,
+			COUNT, //%n, the pointer is consumed but nothing is written through it.
+		};
+
+		using SignedSize = std::make_signed<std::size_t>::type;
+		using UnsignedPtrDiff = std::make_unsigned<std::ptrdiff_t>::type;
+
+		constexpr std::uint32_t k_nullString{ 0xFFFFFFFFU };
+		constexpr std::size_t k_maxSpecLength{ 32U };
+
+		struct FormatSpec
+		{
+			const char* end{ nullptr }; //One past the conversion character.
+			bool hasStarWidth{ false };
+			bool hasStarPrecision{ false };
+			int precision{ -1 }; //Literal precision, -1 if none or given by '*'.
+			LengthModifier length{ LengthModifier::NONE };
+			ArgKind kind{ ArgKind::NONE };
+		};
+
+		//Parse the conversion starting at the '%' `p` points to, the same way for capture and for formatting.
+		FormatSpec parseSpec(const char* p) noexcept
+		{
+			FormatSpec spec;
+			++p;
+
+			while (*p != '\0' && std::strchr("-+ #0", *p) != nullptr)
+			{
+				++p;
+			}
+
+			if (*p == '*')
+			{
+				spec.hasStarWidth = true;
+				++p;
+			}
+
+			while (*p >= '0' && *p <= '9')
+			{
+				++p;
+			}
+
+			if (*p == '.')
+			{
+				++p;
+				if (*p == '*')
+				{
+					spec.hasStarPrecision = true;
+					++p;
+				}
+				else
+				{
+					spec.precision = 0;
+					while (*p >= '0' && *p <= '9')
+					{
+						spec.precision = spec.precision * 10 + (*p - '0');
+						++p;
+					}
+				}
+			}
+
+			switch (*p)
+			{
+			case 'h': ++p; spec.length = *p == 'h' ? (++p, LengthModifier::HH) : LengthModifier::H; break;
+			case 'l': ++p; spec.length = *p == 'l' ? (++p, LengthModifier::LL) : LengthModifier::L; break;
+			case 'j': ++p; spec.length = LengthModifier::J; break;
+			case 'z': ++p; spec.length = LengthModifier::Z; break;
+			case 't': ++p; spec.length = LengthModifier::T; break;
+			case 'L': ++p; spec.length = LengthModifier::LONG_DOUBLE; break;
+			default: break;
+			}
+
+			switch (*p)
+			{
+			case 'd': case 'i': spec.kind = ArgKind::SIGNED; break;
+			case 'u': case 'o': case 'x': case 'X': spec.kind = ArgKind::UNSIGNED; break;
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': spec.kind = ArgKind::FLOATING; break;
+			case 'c': spec.kind = ArgKind::CHARACTER; break;
+			case 's': spec.kind = ArgKind::TEXT; break;
+			case 'p': spec.kind = ArgKind::POINTER; break;
+			case 'n': spec.kind = ArgKind::COUNT; break;
+			default: break;
+			}
+
+			spec.end = *p != '\0' ? p + 1 : p;
+			return spec;
+		}
+
+		struct RecordWriter
+		{
+			std::uint8_t* out;
+			std::size_t capacity;
+			std::size_t pos{ 0U };
+			bool ok{ true };
+
+			void bytes(const void* data, std::size_t size) noexcept
+			{
+				ok = ok && capacity - pos >= size;
+				if (ok)
+				{
+					std::memcpy(out + pos, data, size);
+					pos += size;
+				}
+			}
+
+			template<typename T>
+			void value(T v) noexcept
+			{
+				bytes(&v, sizeof(T));
+			}
+		};
+
+		struct RecordReader
+		{
+			const std::uint8_t* data;
+			std::size_t size;
+			std::size_t pos{ 0U };
+
+			template<typename T>
+			T value() noexcept
+			{
+				T v{};
+				if (size - pos >= sizeof(T))
+				{
+					std::memcpy(&v, data + pos, sizeof(T));
+					pos += sizeof(T);
+				}
+				return v;
+			}
+
+			const char* bytes(std::size_t n) noexcept
+			{
+				n = std::min(n, size - pos);
+				const char* p{ reinterpret_cast<const char*>(data + pos) };
+				pos += n;
+				return p;
+			}
+		};
+
+		void captureSigned(RecordWriter& writer, LengthModifier length, va_list& args) noexcept
+		{
+			switch (length)
+			{
+			case LengthModifier::L: writer.value<std::int64_t>(va_arg(args, long)); break;
+			case LengthModifier::LL: writer.value<std::int64_t>(va_arg(args, long long)); break;
+			case LengthModifier::J: writer.value<std::int64_t>(va_arg(args, std::intmax_t)); break;
+			case LengthModifier::Z: writer.value<std::int64_t>(va_arg(args, SignedSize)); break;
+			case LengthModifier::T: writer.value<std::int64_t>(va_arg(args, std::ptrdiff_t)); break;
+			default: writer.value<std::int64_t>(va_arg(args, int)); break;
+			}
+		}
+
+		void captureUnsigned(RecordWriter& writer, LengthModifier length, va_list& args) noexcept
+		{
+			switch (length)
+			{
+			case LengthModifier::L: writer.value<std::uint64_t>(va_arg(args, unsigned long)); break;
+			case LengthModifier::LL: writer.value<std::uint64_t>(va_arg(args, unsigned long long)); break;
+			case LengthModifier::J: writer.value<std::uint64_t>(va_arg(args, std::uintmax_t)); break;
+			case LengthModifier::Z: writer.value<std::uint64_t>(va_arg(args, std::size_t)); break;
+			case LengthModifier::T: writer.value<std::uint64_t>(va_arg(args, UnsignedPtrDiff)); break;
+			default: writer.value<std::uint64_t>(va_arg(args, unsigned int)); break;
+			}
+		}
+
+		void captureString(RecordWriter& writer, const FormatSpec& spec, int starPrecision, va_list& args) noexcept
+		{
+			const char* str{ va_arg(args, const char*) };
+			if (str == nullptr)
+			{
+				writer.value<std::uint32_t>(k_nullString);
+				return;
+			}
+
+			//Precision bounds the read, the string does not have to be null terminated then.
+			const int precision{ spec.hasStarPrecision ? starPrecision : spec.precision };
+			std::size_t length{ 0U };
+			while ((precision < 0 || length < static_cast<std::size_t>(precision)) && str[length] != '\0')
+			{
+				++length;
+			}
+
+			writer.value<std::uint32_t>(static_cast<std::uint32_t>(length));
+			writer.bytes(str, length);
+		}
+
+		template<typename T>
+		int formatArg(char* out, std::size_t size, const char* specText, const FormatSpec& spec, int width, int precision, T value) noexcept
+		{
+			if (spec.hasStarWidth && spec.hasStarPrecision)
+			{
+				return std::snprintf(out, size, specText, width, precision, value);
+			}
+
+			if (spec.hasStarWidth)
+			{
+				return std::snprintf(out, size, specText, width, value);
+			}
+
+			if (spec.hasStarPrecision)
+			{
+				return std::snprintf(out, size, specText, precision, value);
+			}
+
+			return std::snprintf(out, size, specText, value);
+		}
+
+		int formatSigned(char* out, std::size_t size, const char* specText, const FormatSpec& spec, int width, int precision, std::int64_t v) noexcept
+		{
+			switch (spec.length)
+			{
+			case LengthModifier::L: return formatArg(out, size, specText, spec, width, precision, static_cast<long>(v));
+			case LengthModifier::LL: return formatArg(out, size, specText, spec, width, precision, static_cast<long long>(v));
+			case LengthModifier::J: return formatArg(out, size, specText, spec, width, precision, static_cast<std::intmax_t>(v));
+			case LengthModifier::Z: return formatArg(out, size, specText, spec, width, precision, static_cast<SignedSize>(v));
+			case LengthModifier::T: return formatArg(out, size, specText, spec, width, precision, static_cast<std::ptrdiff_t>(v));
+			default: return formatArg(out, size, specText, spec, width, precision, static_cast<int>(v));
+			}
+		}
+
+		int formatUnsigned(char* out, std::size_t size, const char* specText, const FormatSpec& spec, int width, int precision, std::uint64_t v) noexcept
+		{
+			switch (spec.length)
+			{
+			case LengthModifier::L: return formatArg(out, size, specText, spec, width, precision, static_cast<unsigned long>(v));
+			case LengthModifier::LL: return formatArg(out, size, specText, spec, width, precision, static_cast<unsigned long long>(v));
+			case LengthModifier::J: return formatArg(out, size, specText, spec, width, precision, static_cast<std::uintmax_t>(v));
+			case LengthModifier::Z: return formatArg(out, size, specText, spec, width, precision, static_cast<std::size_t>(v));
+			case LengthModifier::T: return formatArg(out, size, specText, spec, width, precision, static_cast<UnsignedPtrDiff>(v));
+			default: return formatArg(out, size, specText, spec, width, precision, static_cast<unsigned int>(v));
+			}
+		}
+	}
+
+	LogRing::LogRing(std::size_t capacity)
+		: m_data{ new std::uint8_t[capacity] }, m_capacity{ capacity }
+	{
+	}
+
+	bool LogRing::tryPush(const std::uint8_t* data, std::size_t size) noexcept
+	{
+		const std::size_t recordSize{ k_lengthSize + size };
+		if (recordSize > m_capacity)
+		{
+			return false;
+		}
+
+		std::size_t tail{ m_tail.load(std::memory_order_relaxed) };
+		const std::size_t head{ m_head.load(std::memory_order_acquire) };
+
+		const std::size_t offset{ tail % m_capacity };
+		const std::size_t bytesToEnd{ m_capacity - offset };
+		const std::size_t padding{ bytesToEnd < recordSize ? bytesToEnd : 0U }; //Not enough room before the end, start at offset 0.
+
+		if (tail - head + padding + recordSize > m_capacity)
+		{
+			return false;
+		}
+
+		if (padding >= k_lengthSize)
+		{
+			std::memcpy(m_data.get() + offset, &k_wrapMarker, k_lengthSize);
+		}
+
+		tail += padding;
+
+		const std::uint32_t length{ static_cast<std::uint32_t>(size) };
+		std::memcpy(m_data.get() + tail % m_capacity, &length, k_lengthSize);
+		std::memcpy(m_data.get() + tail % m_capacity + k_lengthSize, data, size);
+
+		m_tail.store(tail + recordSize, std::memory_order_release);
+		return true;
+	}
+
+	void LogRing::skipWrap(std::size_t& head) const noexcept
+	{
+		const std::size_t offset{ head % m_capacity };
+		if (m_capacity - offset < k_lengthSize)
+		{
+			head += m_capacity - offset;
+			return;
+		}
+
+		std::uint32_t length{ 0U };
+		std::memcpy(&length, m_data.get() + offset, k_lengthSize);
+
+		if (length == k_wrapMarker)
+		{
+			head += m_capacity - offset;
+		}
+	}
+
+	bool LogRing::front(const std::uint8_t*& outData, std::uint32_t& outSize) noexcept
+	{
+		std::size_t head{ m_head.load(std::memory_order_relaxed) };
+		if (head == m_tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		skipWrap(head);
+		m_head.store(head, std::memory_order_release); //Padding is free for the producer straight away.
+
+		std::memcpy(&outSize, m_data.get() + head % m_capacity, k_lengthSize);
+		outData = m_data.get() + head % m_capacity + k_lengthSize;
+		return true;
+	}
+
+	void LogRing::pop() noexcept
+	{
+		const std::size_t head{ m_head.load(std::memory_order_relaxed) };
+
+		std::uint32_t length{ 0U };
+		std::memcpy(&length, m_data.get() + head % m_capacity, k_lengthSize);
+
+		m_head.store(head + k_lengthSize + length, std::memory_order_release);
+	}
+
+	std::size_t encodeLogRecord(std::uint8_t* out, std::size_t capacity, LogLevel level, const char* category, const char* format, va_list argList) noexcept
+	{
+		//Copied so it can be passed on by reference, va_list is an array type on some platforms.
+		va_list args;
+		va_copy(args, argList);
+
+		RecordWriter writer{ out, capacity };
+		writer.value(level);
+		writer.value(category);
+		writer.value(format);
+
+		const char* p{ format };
+		while (p != nullptr && *p != '\0')
+		{
+			if (*p != '%')
+			{
+				++p;
+				continue;
+			}
+
+			const FormatSpec spec{ parseSpec(p) };
+			p = spec.end;
+
+			int starPrecision{ -1 };
+			if (spec.hasStarWidth)
+			{
+				writer.value<std::int32_t>(va_arg(args, int));
+			}
+			if (spec.hasStarPrecision)
+			{
+				starPrecision = va_arg(args, int);
+				writer.value<std::int32_t>(starPrecision);
+			}
+
+			switch (spec.kind)
+			{
+			case ArgKind::SIGNED:
+				captureSigned(writer, spec.length, args);
+				break;
+			case ArgKind::UNSIGNED:
+				captureUnsigned(writer, spec.length, args);
+				break;
+			case ArgKind::FLOATING:
+				if (spec.length == LengthModifier::LONG_DOUBLE)
+				{
+					writer.value<long double>(va_arg(args, long double));
+				}
+				else
+				{
+					writer.value<double>(va_arg(args, double));
+				}
+				break;
+			case ArgKind::CHARACTER:
+				writer.value<std::int32_t>(va_arg(args, int));
+				break;
+			case ArgKind::TEXT:
+				captureString(writer, spec, starPrecision, args);
+				break;
+			case ArgKind::POINTER:
+				writer.value<const void*>(va_arg(args, const void*));
+				break;
+			case ArgKind::COUNT:
+				(void)va_arg(args, void*);
+				break;
+			case ArgKind::NONE:
+				break;
+			}
+		}
+
+		va_end(args);
+		return writer.ok ? writer.pos : 0U;
+	}
+
+	void formatLogRecord(const std::uint8_t* record, std::size_t size, char* out, std::size_t outSize, LogLevel& outLevel, const char*& outCategory) noexcept
+	{
+		if (outSize == 0U)
+		{
+			return;
+		}
+
+		RecordReader reader{ record, size };
+		outLevel = reader.value<LogLevel>();
+		outCategory = reader.value<const char*>();
+		const char* format{ reader.value<const char*>() };
+
+		std::size_t pos{ 0U };
+		out[0] = '\0';
+
+		//snprintf returns the length it wanted to write, keep pos on the terminator once the output is full.
+		const auto advance = [&pos, outSize](int written) noexcept
+		{
+			if (written > 0)
+			{
+				pos = std::min(pos + static_cast<std::size_t>(written), outSize - 1U);
+			}
+		};
+
+		const char* p{ format };
+		while (p != nullptr && *p != '\0' && pos < outSize - 1U)
+		{
+			if (*p != '%')
+			{
+				out[pos++] = *p++;
+				out[pos] = '\0';
+				continue;
+			}
+
+			const char* specBegin{ p };
+			const FormatSpec spec{ parseSpec(p) };
+			p = spec.end;
+
+			char specText[k_maxSpecLength];
+			const std::size_t specLength{ std::min(static_cast<std::size_t>(spec.end - specBegin), k_maxSpecLength - 1U) };
+			std::memcpy(specText, specBegin, specLength);
+			specText[specLength] = '\0';
+
+			const int width{ spec.hasStarWidth ? reader.value<std::int32_t>() : 0 };
+			const int precision{ spec.hasStarPrecision ? reader.value<std::int32_t>() : 0 };
+			char* const dest{ out + pos };
+			const std::size_t destSize{ outSize - pos };
+
+			switch (spec.kind)
+			{
+			case ArgKind::SIGNED:
+				advance(formatSigned(dest, destSize, specText, spec, width, precision, reader.value<std::int64_t>()));
+				break;
+			case ArgKind::UNSIGNED:
+				advance(formatUnsigned(dest, destSize, specText, spec, width, precision, reader.value<std::uint64_t>()));
+				break;
+			case ArgKind::FLOATING:
+				if (spec.length == LengthModifier::LONG_DOUBLE)
+				{
+					advance(formatArg(dest, destSize, specText, spec, width, precision, reader.value<long double>()));
+				}
+				else
+				{
+					advance(formatArg(dest, destSize, specText, spec, width, precision, reader.value<double>()));
+				}
+				break;
+			case ArgKind::CHARACTER:
+				advance(formatArg(dest, destSize, specText, spec, width, precision, static_cast<int>(reader.value<std::int32_t>())));
+				break;
+			case ArgKind::TEXT:
+			{
+				const std::uint32_t length{ reader.value<std::uint32_t>() };
+				if (length == k_nullString)
+				{
+					advance(std::snprintf(dest, destSize, "%s", "(null)"));
+					break;
+				}
+
+				//The copy is not null terminated, print it with an explicit precision in place of the original one.
+				char stringSpec[k_maxSpecLength];
+				std::size_t stringSpecLength{ 0U };
+				for (const char* c = specBegin; c < spec.end - 1 && *c != '.' && *c != 'l' && stringSpecLength < k_maxSpecLength - 4U; ++c)
+				{
+					stringSpec[stringSpecLength++] = *c;
+				}
+				std::memcpy(stringSpec + stringSpecLength, ".*s", 4U);
+
+				const char* str{ reader.bytes(length) };
+				if (spec.hasStarWidth)
+				{
+					advance(std::snprintf(dest, destSize, stringSpec, width, static_cast<int>(length), str));
+				}
+				else
+				{
+					advance(std::snprintf(dest, destSize, stringSpec, static_cast<int>(length), str));
+				}
+				break;
+			}
+			case ArgKind::POINTER:
+				advance(formatArg(dest, destSize, specText, spec, width, precision, reader.value<const void*>()));
+				break;
+			case ArgKind::COUNT:
+				break;
+			case ArgKind::NONE:
+				if (specLength == 2U && specText[1] == '%')
+				{
+					out[pos++] = '%';
+					out[pos] = '\0';
+				}
+				break;
+			}
+		}
+	}
+}
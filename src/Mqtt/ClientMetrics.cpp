@@ -0,0 +1,278 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/ClientMetrics.h"
+
+#include <algorithm>
+#include <initializer_list>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		namespace
+		{
+			std::uint32_t getHighestBit(std::uint64_t value) noexcept
+			{
+				std::uint32_t bit{ 0U };
+				for (std::uint32_t step = 32U; step > 0U; step >>= 1U)
+				{
+					if ((value >> step) != 0U)
+					{
+						value >>= step;
+						bit += step;
+					}
+				}
+
+				return bit;
+			}
+		}
+
+		constexpr std::uint32_t LatencyHistogram::k_subBucketBits;
+		constexpr std::uint32_t LatencyHistogram::k_subBucketCount;
+		constexpr std::uint32_t LatencyHistogram::k_maxValueBits;
+		constexpr std::uint64_t LatencyHistogram::k_maxValue;
+		constexpr std::size_t LatencyHistogram::k_bucketCount;
+
+		LatencyHistogram::LatencyHistogram() noexcept
+		{
+			for (auto& bucket : m_buckets)
+			{
+				bucket.store(0U, std::memory_order_relaxed);
+			}
+		}
+
+		std::size_t LatencyHistogram::getBucketIndex(std::uint64_t value) noexcept
+		{
+			value = std::min(value, k_maxValue);
+
+			if (value < k_subBucketCount)
+			{
+				return static_cast<std::size_t>(value);
+			}
+
+			//Top k_subBucketBits + 1 bits of the value pick the bucket, the leading 1 bit selects the power of two.
+			const std::uint32_t shift{ getHighestBit(value) - k_subBucketBits };
+			return static_cast<std::size_t>((shift + 1U) * k_subBucketCount + ((value >> shift) - k_subBucketCount));
+		}
+
+		std::uint64_t LatencyHistogram::getBucketUpperBound(std::size_t index) noexcept
+		{
+			if (index < k_subBucketCount)
+			{
+				return static_cast<std::uint64_t>(index);
+			}
+
+			const std::uint32_t shift{ static_cast<std::uint32_t>(index / k_subBucketCount) - 1U };
+			const std::uint64_t subBucket{ static_cast<std::uint64_t>(index % k_subBucketCount) };
+			return ((k_subBucketCount + subBucket + 1U) << shift) - 1U;
+		}
+
+		void LatencyHistogram::record(std::uint64_t microseconds) noexcept
+		{
+			m_buckets[getBucketIndex(microseconds)].fetch_add(1U, std::memory_order_relaxed);
+			m_sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+			std::uint64_t current{ m_min.load(std::memory_order_relaxed) };
+			while (microseconds < current && !m_min.compare_exchange_weak(current, microseconds, std::memory_order_relaxed))
+			{
+			}
+
+			current = m_max.load(std::memory_order_relaxed);
+			while (microseconds > current && !m_max.compare_exchange_weak(current, microseconds, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		void LatencyHistogram::record(std::chrono::steady_clock::duration duration) noexcept
+		{
+			const auto microseconds{ std::chrono::duration_cast<std::chrono::microseconds>(duration).count() };
+			record(microseconds > 0 ? static_cast<std::uint64_t>(microseconds) : 0U);
+		}
+
+		void LatencyHistogram::reset() noexcept
+		{
+			for (auto& bucket : m_buckets)
+			{
+				bucket.store(0U, std::memory_order_relaxed);
+			}
+
+			m_sum.store(0U, std::memory_order_relaxed);
+			m_min.store(UINT64_MAX, std::memory_order_relaxed);
+			m_max.store(0U, std::memory_order_relaxed);
+		}
+
+		LatencyHistogramSnapshot LatencyHistogram::snapshot() const
+		{
+			LatencyHistogramSnapshot result;
+
+			//Count is summed from the buckets, so quantiles stay consistent with it while values are being recorded.
+			for (std::size_t i = 0; i < k_bucketCount; ++i)
+			{
+				const std::uint64_t count{ m_buckets[i].load(std::memory_order_relaxed) };
+				if (count != 0U)
+				{
+					result.buckets.push_back({ getBucketUpperBound(i), count });
+					result.count += count;
+				}
+			}
+
+			if (result.count != 0U)
+			{
+				result.sumMicroseconds = m_sum.load(std::memory_order_relaxed);
+				result.minMicroseconds = m_min.load(std::memory_order_relaxed);
+				result.maxMicroseconds = m_max.load(std::memory_order_relaxed);
+			}
+
+			return result;
+		}
+
+		ClientMetrics::ClientMetrics() noexcept
+		{
+			for (Counters* counters : { &m_packetsSent, &m_bytesSent, &m_packetsReceived, &m_bytesReceived })
+			{
+				for (auto& counter : *counters)
+				{
+					counter.store(0U, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		void ClientMetrics::addPacketSent(PacketType packetType, std::size_t bytes) noexcept
+		{
+			const std::size_t index{ static_cast<std::size_t>(packetType) };
+			if (index < k_packetTypeCount)
+			{
+				add(m_packetsSent[index], 1U);
+				add(m_bytesSent[index], bytes);
+			}
+		}
+
+		void ClientMetrics::addPacketReceived(PacketType packetType, std::size_t bytes) noexcept
+		{
+			const std::size_t index{ static_cast<std::size_t>(packetType) };
+			if (index < k_packetTypeCount)
+			{
+				add(m_packetsReceived[index], 1U);
+				add(m_bytesReceived[index], bytes);
+			}
+		}
+
+		void ClientMetrics::addPublishRetry() noexcept
+		{
+			add(m_publishRetries, 1U);
+		}
+
+		void ClientMetrics::addReconnect() noexcept
+		{
+			add(m_reconnects, 1U);
+		}
+
+		void ClientMetrics::addDecodeError() noexcept
+		{
+			add(m_decodeErrors, 1U);
+		}
+
+		void ClientMetrics::setSendQueueSize(std::size_t packets, std::size_t bytes) noexcept
+		{
+			m_sendQueuePackets.store(packets, std::memory_order_relaxed);
+			m_sendQueueBytes.store(bytes, std::memory_order_relaxed);
+		}
+
+		void ClientMetrics::setInFlight(std::size_t inFlight, std::size_t receiveMaximum) noexcept
+		{
+			m_inFlightPublishes.store(inFlight, std::memory_order_relaxed);
+			m_receiveMaximum.store(receiveMaximum, std::memory_order_relaxed);
+		}
+
+		void ClientMetrics::setMemoryStats(const MqttClientMemoryStats& stats) noexcept
+		{
+			m_sendQueueMemory.store(stats.sendQueueBytes, std::memory_order_relaxed);
+			m_sendBufferMemory.store(stats.sendBufferBytes, std::memory_order_relaxed);
+			m_receiveQueueMemory.store(stats.receiveQueueBytes, std::memory_order_relaxed);
+			m_pendingCallbackMemory.store(stats.pendingCallbackBytes, std::memory_order_relaxed);
+			m_sessionStateMemory.store(stats.sessionStateBytes, std::memory_order_relaxed);
+			m_propertyMemory.store(stats.propertyBytes, std::memory_order_relaxed);
+			m_topicAliasMemory.store(stats.topicAliasBytes, std::memory_order_relaxed);
+			m_offlineSpoolMemory.store(stats.offlineSpoolBytes, std::memory_order_relaxed);
+			m_loggerMemory.store(stats.loggerBytes, std::memory_order_relaxed);
+		}
+
+		void ClientMetrics::markPublishSent(std::uint16_t packetId, TimePoint now)
+		{
+			LockGuard guard{ m_publishSendTimesMutex };
+			m_publishSendTimes.emplace(packetId, now);
+		}
+
+		void ClientMetrics::markPublishAcknowledged(std::uint16_t packetId, TimePoint now) noexcept
+		{
+			TimePoint sentTime;
+
+			{
+				LockGuard guard{ m_publishSendTimesMutex };
+				const auto pending{ m_publishSendTimes.find(packetId) };
+				if (pending == m_publishSendTimes.end())
+				{
+					return;
+				}
+
+				sentTime = pending->second;
+				m_publishSendTimes.erase(pending);
+			}
+
+			m_publishAckLatency.record(now - sentTime);
+		}
+
+		void ClientMetrics::clearPendingAcks() noexcept
+		{
+			LockGuard guard{ m_publishSendTimesMutex };
+			m_publishSendTimes.clear();
+		}
+
+		MqttClientMetrics ClientMetrics::snapshot() const
+		{
+			MqttClientMetrics result;
+
+			for (std::size_t i = 0; i < k_packetTypeCount; ++i)
+			{
+				result.packetsSent[i] = m_packetsSent[i].load(std::memory_order_relaxed);
+				result.bytesSent[i] = m_bytesSent[i].load(std::memory_order_relaxed);
+				result.packetsReceived[i] = m_packetsReceived[i].load(std::memory_order_relaxed);
+				result.bytesReceived[i] = m_bytesReceived[i].load(std::memory_order_relaxed);
+			}
+
+			result.publishRetries = m_publishRetries.load(std::memory_order_relaxed);
+			result.reconnects = m_reconnects.load(std::memory_order_relaxed);
+			result.decodeErrors = m_decodeErrors.load(std::memory_order_relaxed);
+
+			result.sendQueuePackets = m_sendQueuePackets.load(std::memory_order_relaxed);
+			result.sendQueueBytes = m_sendQueueBytes.load(std::memory_order_relaxed);
+			result.inFlightPublishes = m_inFlightPublishes.load(std::memory_order_relaxed);
+			result.receiveMaximum = m_receiveMaximum.load(std::memory_order_relaxed);
+			result.memory = getMemoryStats();
+
+			result.publishAckLatency = m_publishAckLatency.snapshot();
+			result.tickDuration = m_tickDuration.snapshot();
+			result.socketSendTime = m_socketSendTime.snapshot();
+
+			return result;
+		}
+
+		MqttClientMemoryStats ClientMetrics::getMemoryStats() const noexcept
+		{
+			MqttClientMemoryStats result;
+			result.sendQueueBytes = m_sendQueueMemory.load(std::memory_order_relaxed);
+			result.sendBufferBytes = m_sendBufferMemory.load(std::memory_order_relaxed);
+			result.receiveQueueBytes = m_receiveQueueMemory.load(std::memory_order_relaxed);
+			result.pendingCallbackBytes = m_pendingCallbackMemory.load(std::memory_order_relaxed);
+			result.sessionStateBytes = m_sessionStateMemory.load(std::memory_order_relaxed);
+			result.propertyBytes = m_propertyMemory.load(std::memory_order_relaxed);
+			result.topicAliasBytes = m_topicAliasMemory.load(std::memory_order_relaxed);
+			result.offlineSpoolBytes = m_offlineSpoolMemory.load(std::memory_order_relaxed);
+			result.loggerBytes = m_loggerMemory.load(std::memory_order_relaxed);
+			return result;
+		}
+	}
+}
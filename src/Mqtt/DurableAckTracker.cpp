@@ -0,0 +1,133 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/DurableAckTracker.h"
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		DurableAckTracker::DurableAckTracker(std::function<void()> onBatchCompleted)
+			: m_completions(std::make_shared<Completions>())
+		{
+			m_completions->onBatchCompleted = std::move(onBatchCompleted);
+		}
+
+		DurableAckTracker::~DurableAckTracker() noexcept
+		{
+			//Store may still complete barriers after the client is gone, stop them reaching back into it.
+			std::lock_guard<std::mutex> lock{ m_completions->mutex };
+			m_completions->onBatchCompleted = nullptr;
+		}
+
+		void DurableAckTracker::hold(Qos qos, std::uint16_t packetId)
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			m_unbarrieredAcks.push_back(Ack{ qos, packetId });
+		}
+
+		void DurableAckTracker::requestBarrier(IAsyncSessionStatePersistantStore& store)
+		{
+			std::uint64_t batchId{ 0U };
+
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+
+				if (m_unbarrieredAcks.empty())
+				{
+					return;
+				}
+
+				batchId = m_nextBatchId++;
+				m_batches.push_back(Batch{ batchId, std::move(m_unbarrieredAcks) });
+				m_unbarrieredAcks.clear();
+			}
+
+			std::weak_ptr<Completions> weakCompletions{ m_completions };
+			store.notifyWhenDurable([weakCompletions, batchId](bool success)
+			{
+				const std::shared_ptr<Completions> completions{ weakCompletions.lock() };
+				if (completions == nullptr)
+				{
+					return;
+				}
+
+				std::lock_guard<std::mutex> lock{ completions->mutex };
+				completions->results[batchId] = success;
+
+				if (completions->onBatchCompleted)
+				{
+					completions->onBatchCompleted();
+				}
+			});
+		}
+
+		std::size_t DurableAckTracker::takeReleased(std::vector<Ack>& outAcks)
+		{
+			std::size_t droppedCount{ 0U };
+
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			std::lock_guard<std::mutex> completionsLock{ m_completions->mutex };
+
+			while (!m_batches.empty())
+			{
+				const auto result{ m_completions->results.find(m_batches.front().id) };
+				if (result == m_completions->results.end())
+				{
+					break;
+				}
+
+				std::vector<Ack>& acks{ m_batches.front().acks };
+				if (result->second)
+				{
+					outAcks.insert(outAcks.end(), acks.begin(), acks.end());
+				}
+				else
+				{
+					droppedCount += acks.size();
+				}
+
+				m_completions->results.erase(result);
+				m_batches.pop_front();
+			}
+
+			//Results of barriers that were in flight when clear() was called.
+			const std::uint64_t oldestBatchId{ m_batches.empty() ? m_nextBatchId : m_batches.front().id };
+			m_completions->results.erase(m_completions->results.begin(), m_completions->results.lower_bound(oldestBatchId));
+
+			return droppedCount;
+		}
+
+		bool DurableAckTracker::hasWork() const
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+
+			if (!m_unbarrieredAcks.empty())
+			{
+				return true;
+			}
+
+			if (m_batches.empty())
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> completionsLock{ m_completions->mutex };
+			return m_completions->results.find(m_batches.front().id) != m_completions->results.end();
+		}
+
+		void DurableAckTracker::clear()
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			std::lock_guard<std::mutex> completionsLock{ m_completions->mutex };
+
+			m_unbarrieredAcks.clear();
+			m_batches.clear();
+
+			//Ids are never reused, barriers still in flight complete into results that takeReleased() discards.
+			m_completions->results.clear();
+		}
+	}
+}
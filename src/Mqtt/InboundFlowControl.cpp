@@ -0,0 +1,148 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/InboundFlowControl.h"
+
+#include <algorithm>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		void InboundFlowControl::setOptions(const ReceiveQueueOptions& options) noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_options = options;
+			updatePaused();
+		}
+
+		void InboundFlowControl::setReceiveQueueSize(std::size_t bytes, std::size_t packets) noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_receiveQueueBytes = bytes;
+			m_receiveQueuePackets = packets;
+			updatePaused();
+		}
+
+		void InboundFlowControl::addDelivery(std::size_t bytes) noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_deliveryBytes += bytes;
+			++m_deliveryMessages;
+			updatePaused();
+		}
+
+		void InboundFlowControl::resizeDelivery(std::size_t oldBytes, std::size_t newBytes) noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_deliveryBytes = m_deliveryBytes - std::min(oldBytes, m_deliveryBytes) + newBytes;
+			updatePaused();
+		}
+
+		bool InboundFlowControl::completeDelivery(std::size_t bytes) noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_deliveryBytes -= std::min(bytes, m_deliveryBytes);
+			m_deliveryMessages -= m_deliveryMessages > 0U ? 1U : 0U;
+
+			const bool wasPaused{ m_isPaused };
+			updatePaused();
+
+			return wasPaused && !m_isPaused;
+		}
+
+		bool InboundFlowControl::tryHoldAck(Qos qos, std::uint16_t packetId)
+		{
+			LockGuard guard{ m_mutex };
+
+			if (!m_isPaused && m_heldAcks.empty())
+			{
+				return false;
+			}
+
+			m_heldAcks.push_back(Ack{ qos, packetId });
+			return true;
+		}
+
+		void InboundFlowControl::takeReleasedAcks(std::vector<Ack>& outAcks)
+		{
+			LockGuard guard{ m_mutex };
+
+			if (m_isPaused)
+			{
+				return;
+			}
+
+			outAcks.insert(outAcks.end(), m_heldAcks.begin(), m_heldAcks.end());
+			m_heldAcks.clear();
+		}
+
+		void InboundFlowControl::clearHeldAcks() noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_heldAcks.clear();
+		}
+
+		void InboundFlowControl::clearDeliveries() noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_deliveryBytes = 0U;
+			m_deliveryMessages = 0U;
+			updatePaused();
+		}
+
+		bool InboundFlowControl::isPaused() const noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_isPaused;
+		}
+
+		std::size_t InboundFlowControl::getHeldAckCount() const noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_heldAcks.size();
+		}
+
+		std::size_t InboundFlowControl::getPauseCount() const noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_pauseCount;
+		}
+
+		std::size_t InboundFlowControl::getDeliveryBytes() const noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_deliveryBytes;
+		}
+
+		void InboundFlowControl::updatePaused() noexcept
+		{
+			const std::size_t bytes{ m_receiveQueueBytes + m_deliveryBytes };
+			const std::size_t messages{ m_receiveQueuePackets + m_deliveryMessages };
+
+			if (!m_isPaused)
+			{
+				const bool isAtHighWatermark{ (m_options.highWatermarkBytes > 0U && bytes >= m_options.highWatermarkBytes) ||
+					(m_options.highWatermarkMessages > 0U && messages >= m_options.highWatermarkMessages) };
+
+				if (isAtHighWatermark)
+				{
+					m_isPaused = true;
+					++m_pauseCount;
+				}
+
+				return;
+			}
+
+			const bool isAtLowWatermark{ (m_options.highWatermarkBytes == 0U || bytes <= m_options.lowWatermarkBytes) &&
+				(m_options.highWatermarkMessages == 0U || messages <= m_options.lowWatermarkMessages) };
+
+			if (isAtLowWatermark)
+			{
+				m_isPaused = false;
+			}
+		}
+	}
+}
@@ -4,6 +4,8 @@
 // See LICENSE file in the project root for full license information.
 
 #include "kmMqtt/Mqtt/MqttClientImpl.h"
+#include "kmMqtt/Logger/LogMacros.h"
+#include "kmMqtt/Logger/AsyncLog.h"
 
 #include "kmMqtt/MqttClientOptions.h"
 #include "kmMqtt/Mqtt/Transport/Jobs/ConnectComposer.h"
@@ -13,6 +15,7 @@
 #include "kmMqtt/Mqtt/Transport/Jobs/SubscribeComposer.h"
 #include "kmMqtt/Mqtt/Transport/Jobs/UnSubscribeComposer.h"
 #include "kmMqtt/Mqtt/PacketHelper.h"
+#include "kmMqtt/Mqtt/Tracing/Trace.h"
 #include "kmMqtt/Logger/LoggerInstance.h"
 #include "kmMqtt/Logger/DefaultLogger.h"
 #include "kmMqtt/Mqtt/ReqResult.h"
@@ -21,10 +24,28 @@
 #include "kmMqtt/Mqtt/Transport/Jobs/PubCompComposer.h"
 #include "kmMqtt/Mqtt/Transport/Jobs/DisconnectComposer.h"
 
+#include <algorithm>
+
 namespace kmMqtt
 {
 	namespace mqtt
 	{
+		namespace
+		{
+			//Acks with a SUCCESS reason code and no properties have a fixed 4 byte encoding and skip the packet composers.
+			template<typename OptionsT>
+			bool canUseFastAck(bool isSuccess, const OptionsT& options) noexcept
+			{
+#ifdef FORCE_ADD_PROPERTIES
+				(void)isSuccess;
+				(void)options;
+				return false;
+#else
+				return isSuccess && options.reasonString.empty() && options.userProperties.empty();
+#endif
+			}
+		}
+
 		MqttClientImpl::MqttClientImpl(const IMqttEnvironment* const env, const MqttClientOptions& clientOptions)
 			: m_clientOptions{ clientOptions },
 			m_config(env->createConfig()),
@@ -48,6 +69,35 @@ namespace kmMqtt
 			m_sendQueue.setOnPubRecSentCallback([this](std::uint16_t packetId) { handlePubRecSentEvent(packetId); });
 			m_sendQueue.setOnPubRelSentCallback([this](std::uint16_t packetId) { handlePubRelSentEvent(packetId); });
 			m_sendQueue.setOnDisconnectSentCallback([this]() { handleDisconnectSentEvent(); });
+			m_sendQueue.setOnPublishExpiredCallback([this](std::uint16_t packetId) { handlePublishExpiredEvent(packetId); });
+			m_sendQueue.setOptions(m_clientOptions.getSendQueueOptions());
+			m_sendQueue.setMetrics(&m_metrics);
+
+			m_traceSinkPtr = m_clientOptions.getTraceSink().get();
+			m_sendQueue.setTraceSink(m_traceSinkPtr);
+
+			m_wireCaptureSinkPtr = m_clientOptions.getWireCaptureSink().get();
+			m_sendQueue.setWireCaptureSink(m_wireCaptureSinkPtr);
+
+			m_inboundFlowControl.setOptions(m_clientOptions.getReceiveQueueOptions());
+			m_receiveQueue.setInboundFlowControl(&m_inboundFlowControl);
+			m_receiveQueue.setMetrics(&m_metrics);
+			m_receiveQueue.setTraceSink(m_traceSinkPtr);
+
+			if (m_clientOptions.getTickMode() == TickMode::SYNC)
+			{
+				m_wakeupSignal.open();
+			}
+
+			if (m_clientOptions.getSessionStatePersistantStore() != nullptr && !m_clientOptions.getSessionStatePersistantStore()->removeExpiredFromStore())
+			{
+				LOG_WARNING("MqttClient", "Failed to remove expired sessions from persistant store.");
+			}
+
+			if (m_clientOptions.getOfflineSpoolOptions().maxBytes > 0U)
+			{
+				m_offlineSpool = std::make_unique<OfflineSpool>(m_clientOptions.getOfflineSpoolOptions());
+			}
 		}
 
 		MqttClientImpl::~MqttClientImpl()
@@ -65,23 +115,23 @@ namespace kmMqtt
 			{
 				LockGuard guard{ m_mutex };
 
-				LogDebug("MqttClient", "Starting MQTT connection proccess.");
+				LOG_DEBUG("MqttClient", "Starting MQTT connection proccess.");
 
 				if (m_connectionStatus == ConnectionStatus::CONNECTED || m_connectionStatus == ConnectionStatus::CONNECTING)
 				{
-					LogWarning("MqttClient", "Cannot connect() again while already connected or attempting to connect.");
+					LOG_WARNING("MqttClient", "Cannot connect() again while already connected or attempting to connect.");
 					return m_connectionStatus == ConnectionStatus::CONNECTED ? ReqResult{ ClientErrorCode::Already_Connected } : ReqResult{ ClientErrorCode::Already_Connecting };
 				}
 
 				if (address.primaryAddress.hostname().empty())
 				{
-					LogError("MqttClient", "Cannot connect() without primary address.");
+					LOG_ERROR("MqttClient", "Cannot connect() without primary address.");
 					return ReqResult{ ClientErrorCode::Missing_Argument, "Cannot connect() without primary address." };
 				}
 
 				if (args.clientId.empty())
 				{
-					LogError("MqttClient", "Cannot connect() without client ID argument.");
+					LOG_ERROR("MqttClient", "Cannot connect() without client ID argument.");
 					return ReqResult{ ClientErrorCode::Missing_Argument, "Cannot connect() without client ID argument." };
 				}
 
@@ -89,26 +139,26 @@ namespace kmMqtt
 				{
 					if (args.will->payload != nullptr && args.will->payload->size() <= 0)
 					{
-						LogError("MqttClient", "Payload size must be bigger than 0! Payload is included in the will, but payload size is 0.");
+						LOG_ERROR("MqttClient", "Payload size must be bigger than 0! Payload is included in the will, but payload size is 0.");
 						return ReqResult{ ClientErrorCode::Invalid_Argument, "Payload size must be bigger than 0! Payload is included in the will, but payload size is 0." };
 					}
 
 					if (args.will->correlationData != nullptr && args.will->correlationData->size() <= 0)
 					{
-						LogError("MqttClient", "Correlatation data size must be bigger than 0! Correlatation data is included in the will, but Correlatation data size is 0.");
+						LOG_ERROR("MqttClient", "Correlatation data size must be bigger than 0! Correlatation data is included in the will, but Correlatation data size is 0.");
 						return ReqResult{ ClientErrorCode::Invalid_Argument, "Correlatation data size must be bigger than 0! Correlatation data is included in the will, but Correlatation data size is 0." };
 					}
 
 					if (args.will->willTopic.empty())
 					{
-						LogError("MqttClient", "Attempted to add a Will to the Connect packet, but Will Topic has not been set!");
+						LOG_ERROR("MqttClient", "Attempted to add a Will to the Connect packet, but Will Topic has not been set!");
 						return ReqResult{ ClientErrorCode::Missing_Argument, "Attempted to add a Will to the Connect packet, but Will Topic has not been set!" };
 					}
 				}
 
 				m_receiveQueue.clear();
 
-				LogInfo("MqttClient",
+				LOG_INFO("MqttClient",
 					"Hostname: %s\n\tPort: %s\n\tUsername: %s\n\tClientId: %s\n\tVersion: %d\n\tProtocol Name: %s",
 					address.primaryAddress.hostname().c_str(),
 					address.primaryAddress.port().c_str(),
@@ -123,7 +173,7 @@ namespace kmMqtt
 				m_connectionInfo.reconnectAddress.reset(m_connectionInfo.connectAddress);
 				m_connectionInfo.receiveMaximumAsClient = m_connectionInfo.connectArgs.receiveMaximum == 0 ? RECEIVE_MAXIMUM_DEFAULT : m_connectionInfo.connectArgs.receiveMaximum;
 
-				LogInfo("MqttClient", "Socket attempting to connect.");
+				LOG_INFO("MqttClient", "Socket attempting to connect.");
 
 				const bool sConnectResult{ m_socket->connect(m_connectionInfo.connectAddress.primaryAddress) };
 
@@ -136,24 +186,90 @@ namespace kmMqtt
 				m_connectionInfo.connectionStartTime = std::chrono::steady_clock::now();
 			}
 
-			m_mqttMainThreadCondition.notify_all();
+			wakeTickLoop();
 
 			return ReqResult{ ClientErrorCode::No_Error };
 		}
 
 		ReqResult MqttClientImpl::publish(const char* topic, ByteBuffer&& payload, PublishOptions&& options) noexcept
 		{
-			LogTrace("MqttClient", "Started publish(): Topic: %s", topic);
+			LOG_TRACE("MqttClient", "Started publish(): Topic: %s", topic);
+
+			//Spooled publishes drain into the same send queue, so backpressure applies to both paths.
+			if (m_connectionStatus == ConnectionStatus::CONNECTED)
+			{
+				const ReqResult waitResult{ waitForSendQueue() };
+				if (!waitResult.noError())
+				{
+					return waitResult;
+				}
+			}
+
+			if (m_offlineSpool != nullptr)
+			{
+				std::lock_guard<std::mutex> spoolGuard{ m_offlineSpoolMutex };
+
+				if (m_connectionStatus != ConnectionStatus::CONNECTED || !m_offlineSpool->empty())
+				{
+					if (!m_offlineSpool->push(topic, payload, options))
+					{
+						LOG_WARNING("MqttClient", "Offline spool is full, cannot publish()! Topic: %s", topic);
+						return ReqResult{ ClientErrorCode::Offline_Spool_Full, "Client not connected and offline spool is full, cannot publish()!" };
+					}
+
+					LOG_DEBUG("MqttClient", "Spooled publish message until connected, Topic: %s, Spooled: %d", topic, m_offlineSpool->getCount());
+					wakeTickLoop();
+					return ReqResult{ ClientErrorCode::No_Error };
+				}
+
+				return queuePublish(topic, std::move(payload), std::move(options));
+			}
 
 			if (m_connectionStatus != ConnectionStatus::CONNECTED)
 			{
-				LogError("MqttClient", "Client not connected, cannot publish()!");
+				LOG_ERROR("MqttClient", "Client not connected, cannot publish()!");
 				return ReqResult{ ClientErrorCode::Not_Connected, "Client not connected, cannot publish()!" };
 			}
 
+			return queuePublish(topic, std::move(payload), std::move(options));
+		}
+
+		ReqResult MqttClientImpl::waitForSendQueue() noexcept
+		{
+			if (m_sendQueue.isWritable())
+			{
+				return ReqResult{ ClientErrorCode::No_Error };
+			}
+
+			const SendQueueOptions& options{ m_clientOptions.getSendQueueOptions() };
+			if (options.fullPolicy == SendQueueFullPolicy::BLOCK)
+			{
+				wakeTickLoop();
+
+				if (m_sendQueue.waitUntilWritable(options.blockTimeout))
+				{
+					if (m_connectionStatus != ConnectionStatus::CONNECTED)
+					{
+						LOG_ERROR("MqttClient", "Client disconnected while waiting for send queue, cannot publish()!");
+						return ReqResult{ ClientErrorCode::Not_Connected, "Client disconnected while waiting for send queue, cannot publish()!" };
+					}
+
+					return ReqResult{ ClientErrorCode::No_Error };
+				}
+
+				LOG_WARNING("MqttClient", "Timed out waiting for send queue to drain, cannot publish()!");
+				return ReqResult{ ClientErrorCode::Would_Block, "Timed out waiting for send queue to drain, cannot publish()!" };
+			}
+
+			LOG_DEBUG("MqttClient", "Send queue is full, cannot publish()!");
+			return ReqResult{ ClientErrorCode::Would_Block, "Send queue is full, cannot publish()!" };
+		}
+
+		ReqResult MqttClientImpl::queuePublish(const char* topic, ByteBuffer&& payload, PublishOptions&& options) noexcept
+		{
 			if (options.topicAlias > m_connectionInfo.maxServerTopicAlias)
 			{
-				LogError("MqttClient", "Topic alias exceeds `max server topic alias` received from broker.");
+				LOG_ERROR("MqttClient", "Topic alias exceeds `max server topic alias` received from broker.");
 			}
 
 			std::uint16_t packetId{ 0U };
@@ -172,6 +288,9 @@ namespace kmMqtt
 				}
 			}
 
+			const std::size_t payloadSize{ payload.size() };
+			const TimePoint queuedTime{ std::chrono::steady_clock::now() };
+
 			m_sendQueue.addToQueue(std::make_unique<PublishComposer>(&m_connectionInfo,
 				&m_packetIdPool,
 				packetId,
@@ -179,11 +298,14 @@ namespace kmMqtt
 				std::move(payload),
 				std::move(options),
 				&m_receiveMaximumTracker,
-				false));
+				false,
+				queuedTime));
 
-			LogInfo("MqttClient", "Queued publish message for sending, Topic: %s, Packet ID: %d, QOS: %d", topic, packetId, static_cast<std::uint8_t>(options.qos));
+			trace(m_traceSinkPtr, TraceStage::PUBLISH_QUEUED, PacketType::PUBLISH, packetId, payloadSize, queuedTime);
 
-			m_mqttMainThreadCondition.notify_all();
+			LOG_INFO("MqttClient", "Queued publish message for sending, Topic: %s, Packet ID: %d, QOS: %d", topic, packetId, static_cast<std::uint8_t>(options.qos));
+
+			wakeTickLoop();
 
 			return ReqResult{ ClientErrorCode::No_Error, packetId };
 		}
@@ -192,19 +314,19 @@ namespace kmMqtt
 		{
 			if (m_connectionStatus != ConnectionStatus::CONNECTED)
 			{
-				LogError("MqttClient", "Client not connected, cannot subscribe()!");
+				LOG_ERROR("MqttClient", "Client not connected, cannot subscribe()!");
 				return ReqResult{ ClientErrorCode::Not_Connected, "Client not connected, cannot subscribe()!" };
 			}
 
 			if (topics.empty())
 			{
-				LogError("MqttClient", "Cannot subscribe to an empty list of topics!");
+				LOG_ERROR("MqttClient", "Cannot subscribe to an empty list of topics!");
 				return ReqResult{ ClientErrorCode::Invalid_Argument, "Cannot subscribe to an empty list of topics!" };
 			}
 
 			if (!m_connectionInfo.subscribeIdentifiersSupported && options.subscribeIdentifier.uint32Value() > 0)
 			{
-				LogError("MqttClient", "Subscribe Identifiers not supported by broker.");
+				LOG_ERROR("MqttClient", "Subscribe Identifiers not supported by broker.");
 				return ReqResult{ ClientErrorCode::SubscribeIdentifiersNotSupported, "Subscribe Identifiers not supported by broker." };
 			}
 
@@ -221,8 +343,8 @@ namespace kmMqtt
 				topics,
 				std::move(options)));
 
-			LogTrace("MqttClient", "Started subscribe: Subscribing to; %s", allTopicsToStr(topics).c_str());
-			m_mqttMainThreadCondition.notify_all();
+			LOG_TRACE("MqttClient", "Started subscribe: Subscribing to; %s", allTopicsToStr(topics).c_str());
+			wakeTickLoop();
 
 			return ReqResult{ ClientErrorCode::No_Error, packetId };
 		}
@@ -231,13 +353,13 @@ namespace kmMqtt
 		{
 			if (m_connectionStatus != ConnectionStatus::CONNECTED)
 			{
-				LogWarning("MqttClient", "Client not connected, cannot unSubscribe()!");
+				LOG_WARNING("MqttClient", "Client not connected, cannot unSubscribe()!");
 				return ReqResult{ ClientErrorCode::Not_Connected, "Client not connected, cannot unSubscribe()!" };
 			}
 
 			if (topics.empty())
 			{
-				LogError("MqttClient", "Cannot unsubscribe with an empty list of topics!");
+				LOG_ERROR("MqttClient", "Cannot unsubscribe with an empty list of topics!");
 				return ReqResult{ ClientErrorCode::Invalid_Argument, "Cannot unsubscribe with an empty list of topics!" };
 			}
 
@@ -254,9 +376,9 @@ namespace kmMqtt
 				topics,
 				std::move(options)));
 
-			LogTrace("MqttClient", "Started unSubscribe: Unsubscribing from %s", allTopicsToStr(topics).c_str());
+			LOG_TRACE("MqttClient", "Started unSubscribe: Unsubscribing from %s", allTopicsToStr(topics).c_str());
 
-			m_mqttMainThreadCondition.notify_all();
+			wakeTickLoop();
 
 			return ReqResult{ ClientErrorCode::No_Error, packetId };
 		}
@@ -265,7 +387,7 @@ namespace kmMqtt
 		{
 			if (m_connectionStatus == ConnectionStatus::DISCONNECTED)
 			{
-				LogWarning("MqttClient", "Client already disconnected, cannot disconnect()!");
+				LOG_WARNING("MqttClient", "Client already disconnected, cannot disconnect()!");
 				return ReqResult{ ClientErrorCode::Not_Connected, "Client not connected, cannot disconnect()!" };
 			}
 
@@ -273,7 +395,7 @@ namespace kmMqtt
 				args.willPublish ? DisconnectReasonCode::DISCONNECT_WITH_WILL_MESSAGE : DisconnectReasonCode::NORMAL_DISCONNECTION,
 				args);
 
-			m_mqttMainThreadCondition.notify_all();
+			wakeTickLoop();
 
 			return ReqResult{ ClientErrorCode::No_Error };
 		}
@@ -292,21 +414,33 @@ namespace kmMqtt
 
 			assert(m_socket != nullptr);
 
-			LogInfo("MqttClient", "Client shutdown.");
+			LOG_INFO("MqttClient", "Client shutdown.");
 
 			shutdownCleanup();
 
 			return ClientErrorCode::No_Error;
 		}
 
+		void MqttClientImpl::wakeTickLoop() noexcept
+		{
+			{
+				//Set under the wait mutex so a wake between the tick thread's predicate check and its wait is not lost.
+				LockGuard guard{ m_tickMutex };
+				m_isTickLoopWoken = true;
+			}
+
+			m_mqttMainThreadCondition.notify_all();
+			m_wakeupSignal.signal();
+		}
+
 		ClientError MqttClientImpl::shutdownAsync() noexcept
 		{
-			LogInfo("MqttClient", "Client shutting down async.");
+			LOG_INFO("MqttClient", "Client shutting down async.");
 
 			bool expectedVal{ true };
 			if (!m_isRunningAsync.compare_exchange_strong(expectedVal, false))
 			{
-				LogInfo("MqttClient", "Client not running asynchronously, cannot shutdownAsync(). Ignoring.");
+				LOG_INFO("MqttClient", "Client not running asynchronously, cannot shutdownAsync(). Ignoring.");
 				return ClientErrorCode::No_Error;
 			}
 
@@ -354,20 +488,27 @@ namespace kmMqtt
 
 			if (m_clientOptions.getTickMode() == TickMode::ASYNC)
 			{
-				LogWarning("MqttClient", "Cannot call tick() when client is configured to tick asynchronously (tickAsync set as true in constructor).");
+				LOG_WARNING("MqttClient", "Cannot call tick() when client is configured to tick asynchronously (tickAsync set as true in constructor).");
 				return ClientErrorCode::Using_Tick_Async;
 			}
 
 			assert(m_socket != nullptr);
 
+			m_wakeupSignal.clear();
+
+			const TimePoint tickStart{ std::chrono::steady_clock::now() };
+
 			tickCheckTimeOut();
 
 			if (m_connectionStatus != ConnectionStatus::DISCONNECTED)
 			{
 				if (m_socket->isConnected())
 				{
+					tickHeldAcknowledgements();
+					tickOfflineSpool();
 					tickSendPackets();
 					tickReceivePackets();
+					tickInboundFlowControl();
 					tickCheckKeepAlive();
 					tickPendingPublishMessageRetries();
 				}
@@ -381,6 +522,8 @@ namespace kmMqtt
 				m_eventDeferrer.invokeEvents();
 			}
 
+			recordTickMetrics(tickStart);
+
 			return ClientErrorCode::No_Error;
 		}
 
@@ -390,7 +533,7 @@ namespace kmMqtt
 
 			if (m_isRunningAsync.exchange(true))
 			{
-				LogWarning("MqttClient", "tickAsync() called while already ticking asynchronously.");
+				LOG_WARNING("MqttClient", "tickAsync() called while already ticking asynchronously.");
 				return;
 			}
 
@@ -400,28 +543,39 @@ namespace kmMqtt
 					while (true)
 					{
 						{
+							//Wait for new work, the idle tick interval, or the send queue flush policy releasing held publishes.
+							const TimePoint now{ std::chrono::steady_clock::now() };
+							const TimePoint waitUntil{ std::min(now + std::chrono::milliseconds(m_config.tickAsyncWaitForMS), m_sendQueue.nextFlushTime(now)) };
+
 							std::unique_lock<std::mutex> lock{ m_tickMutex };
 
-							m_mqttMainThreadCondition.wait_for(lock, std::chrono::milliseconds(m_config.tickAsyncWaitForMS), [this] {
-								return !m_isRunningAsync;
+							m_mqttMainThreadCondition.wait_until(lock, waitUntil, [this] {
+								return !m_isRunningAsync || m_isTickLoopWoken;
 								});
+
+							m_isTickLoopWoken = false;
 						}
 
 						if (!m_isRunningAsync)
 						{
-							LogInfo("MqttClient", "Client shutdown.");
+							LOG_INFO("MqttClient", "Client shutdown.");
 							shutdownCleanup();
 							break; //Exit thread loop
 						}
 
+						const TimePoint tickStart{ std::chrono::steady_clock::now() };
+
 						tickCheckTimeOut();
 
 						if (m_connectionStatus != ConnectionStatus::DISCONNECTED)
 						{
 							if (m_socket->isConnected())
 							{
+								tickHeldAcknowledgements();
+								tickOfflineSpool();
 								tickSendPackets();
 								tickReceivePackets();
+								tickInboundFlowControl();
 								tickCheckKeepAlive();
 								tickPendingPublishMessageRetries();
 							}
@@ -434,23 +588,103 @@ namespace kmMqtt
 							LockGuard guard{ m_mutex };
 							m_eventDeferrer.invokeEvents();
 						}
+
+						recordTickMetrics(tickStart);
 					}
 					});
 			}
 			catch (const std::exception& e)
 			{
-				LogError("MqttClient", "Exception in tickAsync thread: %s", e.what());
+				LOG_ERROR("MqttClient", "Exception in tickAsync thread: %s", e.what());
 				shutdownAsync();
 				m_isRunningAsync = false;
 			}
 			catch (...)
 			{
-				LogError("MqttClient", "Unknown exception in tickAsync thread.");
+				LOG_ERROR("MqttClient", "Unknown exception in tickAsync thread.");
 				shutdownAsync();
 				m_isRunningAsync = false;
 			}
 		}
 
+		int MqttClientImpl::getWakeupHandle() const noexcept
+		{
+			return m_wakeupSignal.getHandle();
+		}
+
+		int MqttClientImpl::getSocketHandle() const noexcept
+		{
+			return m_socket->getNativeHandle();
+		}
+
+		TimePoint MqttClientImpl::nextDeadline() noexcept
+		{
+			const TimePoint now{ std::chrono::steady_clock::now() };
+			TimePoint deadline{ TimePoint::max() };
+
+			{
+				LockGuard guard{ m_mutex };
+				if (m_eventDeferrer.hasEvents())
+				{
+					return now;
+				}
+			}
+
+			if (m_connectionStatus == ConnectionStatus::DISCONNECTED)
+			{
+				return deadline;
+			}
+
+			if (m_connectionStatus == ConnectionStatus::CONNECTING || m_connectionStatus == ConnectionStatus::RECONNECTING)
+			{
+				deadline = std::min(deadline, m_connectionInfo.connectionStartTime + Milliseconds(m_config.connectTimeOutMS));
+			}
+
+			if (!m_socket->isConnected())
+			{
+				return std::max(deadline, now);
+			}
+
+			if (m_receiveQueue.hasPendingPackets() || m_durableAckTracker.hasWork())
+			{
+				return now;
+			}
+
+			deadline = std::min(deadline, m_sendQueue.nextSendTime(now));
+
+			if (m_offlineSpool != nullptr && m_connectionStatus == ConnectionStatus::CONNECTED)
+			{
+				std::lock_guard<std::mutex> spoolGuard{ m_offlineSpoolMutex };
+				if (!m_offlineSpool->empty() && m_sendQueue.isWritable())
+				{
+					deadline = std::min(deadline, m_offlineSpool->nextDrainTime(now));
+				}
+			}
+
+			if (m_connectionStatus == ConnectionStatus::CONNECTED && (m_connectionInfo.serverKeepAlive != 0 || m_config.pingAlways))
+			{
+				if (m_connectionInfo.awaitingPingResponse)
+				{
+					//Timeout check is exclusive, so step over it by a millisecond.
+					deadline = std::min(deadline, m_connectionInfo.lastPingReqSentTime + Milliseconds(m_config.pingTimeOutMS + 1));
+				}
+				else
+				{
+					const TimePoint lastPacketTime{ m_config.pingAlways ? m_connectionInfo.lastPingReqSentTime : m_connectionInfo.lastControlPacketTime };
+					deadline = std::min(deadline, lastPacketTime + m_connectionInfo.pingInterval);
+				}
+			}
+
+			const auto& msgs{ m_connectionInfo.sessionState.messages() };
+			//Sorted by next retry time. Overdue messages have already been re-queued by the last tick, so only future retries count.
+			if (msgs.size() > 0 && msgs.begin()->nextRetryTime > now)
+			{
+				deadline = std::min(deadline, msgs.begin()->nextRetryTime);
+			}
+
+			return std::max(deadline, now);
+		}
+
 		ErrorEvent& MqttClientImpl::onErrorEvent() noexcept
 		{
 			return m_errorEvent;
@@ -491,6 +725,16 @@ namespace kmMqtt
 			return m_unSubAckEvent;
 		}
 
+		WritableEvent& MqttClientImpl::onWritableEvent() noexcept
+		{
+			return m_writableEvent;
+		}
+
+		MemoryBudgetExceededEvent& MqttClientImpl::onMemoryBudgetExceededEvent() noexcept
+		{
+			return m_memoryBudgetExceededEvent;
+		}
+
 		ConnectionStatus MqttClientImpl::getConnectionStatus() const noexcept
 		{
 			return m_connectionStatus;
@@ -506,8 +750,42 @@ namespace kmMqtt
 			return m_clientOptions.getTickMode() == TickMode::ASYNC;
 		}
 
+		std::size_t MqttClientImpl::getInboundConflatedCount() const noexcept
+		{
+			return m_inboundConflatedCount.load();
+		}
+
+		MqttClientMetrics MqttClientImpl::getMetrics() const
+		{
+			return m_metrics.snapshot();
+		}
+
+		MqttClientMemoryStats MqttClientImpl::getMemoryStats() const noexcept
+		{
+			return m_metrics.getMemoryStats();
+		}
+
+		std::size_t MqttClientImpl::getExpiredPublishCount() noexcept
+		{
+			std::size_t count{ m_sendQueue.getExpiredCount() };
+
+			if (m_offlineSpool != nullptr)
+			{
+				std::lock_guard<std::mutex> spoolGuard{ m_offlineSpoolMutex };
+				count += m_offlineSpool->getExpiredCount();
+			}
+
+			return count;
+		}
+
 		void MqttClientImpl::pubAck(std::uint16_t packetId, PubAckReasonCode code, PubAckOptions&& options) noexcept
 		{
+			if (canUseFastAck(code == PubAckReasonCode::SUCCESS, options))
+			{
+				m_sendQueue.addAcknowledgement(PacketType::PUBLISH_ACKNOWLEDGE, packetId);
+				return;
+			}
+
 			m_sendQueue.addToQueue(std::make_unique<PubAckComposer>(&m_connectionInfo,
 				packetId,
 				code,
@@ -516,6 +794,12 @@ namespace kmMqtt
 
 		void MqttClientImpl::pubRec (std::uint16_t packetId, PubRecReasonCode code, PubRecOptions&& options) noexcept
 		{
+			if (canUseFastAck(code == PubRecReasonCode::SUCCESS, options))
+			{
+				m_sendQueue.addAcknowledgement(PacketType::PUBLISH_RECEIVED, packetId);
+				return;
+			}
+
 			m_sendQueue.addToQueue(std::make_unique<PubRecComposer>(&m_connectionInfo,
 				packetId,
 				code,
@@ -524,6 +808,12 @@ namespace kmMqtt
 
 		void MqttClientImpl::pubRel(std::uint16_t packetId, PubRelReasonCode code, PubRelOptions&& options) noexcept
 		{
+			if (canUseFastAck(code == PubRelReasonCode::SUCCESS, options))
+			{
+				m_sendQueue.addAcknowledgement(PacketType::PUBLISH_RELEASED, packetId);
+				return;
+			}
+
 			m_sendQueue.addToQueue(std::make_unique<PubRelComposer>(&m_connectionInfo,
 				packetId,
 				code,
@@ -534,6 +824,12 @@ namespace kmMqtt
 		{
 			m_connectionInfo.sessionState.updateMessage(packetId, PublishMessageStatus::NeedToSendPubComp);
 
+			if (canUseFastAck(code == PubCompReasonCode::SUCCESS, options))
+			{
+				m_sendQueue.addAcknowledgement(PacketType::PUBLISH_COMPLETE, packetId);
+				return;
+			}
+
 			m_sendQueue.addToQueue(std::make_unique<PubCompComposer>(&m_connectionInfo,
 				packetId,
 				code,
@@ -563,14 +859,14 @@ namespace kmMqtt
 
 						if (failedConnectionReasonCode == SERVER_MOVED_VAL)
 						{
-							LogInfo("MqttClient", "Disconnect packet contains a SERVER_REFERENCE for new temporary server: ", serverRef->getString().c_str());
+							LOG_INFO("MqttClient", "Disconnect packet contains a SERVER_REFERENCE for new temporary server: ", serverRef->getString().c_str());
 
 							m_connectionInfo.reconnectAddress.addAddresses(addresses);
 							m_connectionInfo.reconnectAddress.tryCycleToNextPrimaryAddress();
 						}
 						else
 						{
-							LogInfo("MqttClient", "Disconnect packet contains a SERVER_REFERENCE for new permanent server: ", serverRef->getString().c_str());
+							LOG_INFO("MqttClient", "Disconnect packet contains a SERVER_REFERENCE for new permanent server: ", serverRef->getString().c_str());
 							m_connectionInfo.connectAddress.primaryAddress = addresses[0];
 							m_connectionInfo.reconnectAddress.primaryAddress = addresses[0];
 							addresses.erase(addresses.begin());
@@ -583,13 +879,13 @@ namespace kmMqtt
 					}
 					else
 					{
-						LogWarning("MqttClient", "Disconnect packet contains an empty SERVER_REFERENCE property!");
+						LOG_WARNING("MqttClient", "Disconnect packet contains an empty SERVER_REFERENCE property!");
 					}
 				}
 
 				if (m_connectionInfo.reconnectAddress.tryCycleToNextPrimaryAddress())
 				{
-					LogInfo("MqttClient",
+					LOG_INFO("MqttClient",
 						"Disconnect reason is %s but no SERVER_REFERENCE, will try reconnect using additionally provided addresses. ",
 						failedConnectionReasonCode == SERVER_MOVED_VAL ? "SERVER_MOVED" : "USE_ANOTHER_SERVER");
 
@@ -607,9 +903,11 @@ namespace kmMqtt
 
 			m_connectionStatus = ConnectionStatus::RECONNECTING;
 			m_receiveQueue.clear();
+			m_metrics.addReconnect();
+			m_metrics.clearPendingAcks(); //Unacknowledged publishes are resent after reconnecting, timed again from then.
 
-			LogDebug("MqttClient", "Starting MQTT re-connection proccess.");
-			LogInfo("MqttClient",
+			LOG_DEBUG("MqttClient", "Starting MQTT re-connection proccess.");
+			LOG_INFO("MqttClient",
 				"Hostname: %s\n\tPort: %s\n\tUsername: %s\n\tClientId: %s\n\tVersion: %d\n\tProtocol Name: %s",
 				m_connectionInfo.reconnectAddress.primaryAddress.hostname().c_str(),
 				m_connectionInfo.reconnectAddress.primaryAddress.port().c_str(),
@@ -618,7 +916,7 @@ namespace kmMqtt
 				static_cast<std::uint8_t>(m_connectionInfo.connectArgs.version),
 				m_connectionInfo.connectArgs.protocolName.c_str());
 
-			LogInfo("MqttClient", "Socket attempting to connect.");
+			LOG_INFO("MqttClient", "Socket attempting to connect.");
 			m_socket->connect(m_connectionInfo.reconnectAddress.primaryAddress);
 
 			m_connectionInfo.connectionStartTime = std::chrono::steady_clock::now();
@@ -629,11 +927,11 @@ namespace kmMqtt
 			{
 				LockGuard guard{ m_mutex };
 
-				LogInfo("MqttClient", "Starting internal disconnect: %s", args.disconnectReasonText.c_str());
+				LOG_INFO("MqttClient", "Starting internal disconnect: %s", args.disconnectReasonText.c_str());
 
 				if (m_connectionStatus == ConnectionStatus::DISCONNECTED)
 				{
-					LogWarning("MqttClient", "Client not connected, cannot perform internal disconnect. Ignoring.");
+					LOG_WARNING("MqttClient", "Client not connected, cannot perform internal disconnect. Ignoring.");
 					return;
 				}
 
@@ -653,12 +951,12 @@ namespace kmMqtt
 				{
 					if (sendPacket(packet) != 0)
 					{
-						LogWarning("MqttClient", "Failed to send disconnect packet during internal disconnect. Skipping sending to broker.");
+						LOG_WARNING("MqttClient", "Failed to send disconnect packet during internal disconnect. Skipping sending to broker.");
 					}
 				}
 				else
 				{
-					LogWarning("MqttClient", "Failed to encode disconnect packet during internal disconnect. Skipping sending to broker.");
+					LOG_WARNING("MqttClient", "Failed to encode disconnect packet during internal disconnect. Skipping sending to broker.");
 				}
 
 				if (args.clearQueue)
@@ -672,7 +970,7 @@ namespace kmMqtt
 
 				if (!m_socket->close())
 				{
-					LogError("MqttClient", "Error closing socket properly during internal disconnect: %d", m_socket->getLastError());
+					LOG_ERROR("MqttClient", "Error closing socket properly during internal disconnect: %d", m_socket->getLastError());
 				}
 
 				clearState();
@@ -688,20 +986,20 @@ namespace kmMqtt
 
 				if (m_connectionStatus == ConnectionStatus::DISCONNECTED)
 				{
-					LogWarning("MqttClient", "Client not connected, cannot perform internal disconnect. Ignoring.");
+					LOG_WARNING("MqttClient", "Client not connected, cannot perform internal disconnect. Ignoring.");
 					return;
 				}
 
 				const DisconnectReasonCode code{ packet.getVariableHeader().reasonCode };
 
-				LogInfo("MqttClient",
+				LOG_INFO("MqttClient",
 					"Starting disconnect from received Disconnect packet with reason code: %d",
 					static_cast<std::uint8_t>(packet.getVariableHeader().reasonCode));
 
 				const UTF8String* reasonText;
 				if (packet.getVariableHeader().properties.tryGetProperty(PropertyType::REASON_STRING, reasonText))
 				{
-					LogDebug("MqttClient", "Disconnect Reason String: %s", reasonText->getString().c_str());
+					LOG_DEBUG("MqttClient", "Disconnect Reason String: %s", reasonText->getString().c_str());
 				}
 
 				m_socket->setOnDisconnectCallback(nullptr);
@@ -729,11 +1027,11 @@ namespace kmMqtt
 
 				if (m_connectionStatus == ConnectionStatus::DISCONNECTED)
 				{
-					LogWarning("MqttClient", "Client not connected, cannot perform internal disconnect. Ignoring.");
+					LOG_WARNING("MqttClient", "Client not connected, cannot perform internal disconnect. Ignoring.");
 					return;
 				}
 
-				LogInfo("MqttClient",
+				LOG_INFO("MqttClient",
 					"Starting external disconnect due to socket error code: %d, reason: %s",
 					closeCode,
 					reason.c_str());
@@ -755,13 +1053,23 @@ namespace kmMqtt
 			}
 
 			m_connectionInfo.clear();
+			m_durableAckTracker.clear();
+			m_metrics.clearPendingAcks();
+			m_inboundFlowControl.clearHeldAcks();
+			m_inboundFlowControl.clearDeliveries();
+
+			if (m_isSocketReadPaused)
+			{
+				m_socket->setReadPaused(false);
+				m_isSocketReadPaused = false;
+			}
 		}
 
 		void MqttClientImpl::handleSocketConnectEvent(bool success)
 		{
 			if (success)
 			{
-				LogDebug("MqttClient", "Socket connected!");
+				LOG_DEBUG("MqttClient", "Socket connected!");
 
 				ConAckCallback conAckCallback{ std::bind(&MqttClientImpl::handleReceivedConnectAcknowledge, this, std::placeholders::_1) };
 				DisconnectCallback disconnectCallback{ std::bind(&MqttClientImpl::handleReceivedDisconnect, this, std::placeholders::_1) };
@@ -787,12 +1095,12 @@ namespace kmMqtt
 
 				m_sendQueue.addToQueue(std::make_unique<ConnectComposer>(&m_connectionInfo));
 
-				LogTrace("MqttClient", "Connect packet send request queued, to be resolved on next tick.");
+				LOG_TRACE("MqttClient", "Connect packet send request queued, to be resolved on next tick.");
 			}
 			else
 			{
 				m_connectionStatus = ConnectionStatus::DISCONNECTED;
-				LogError("MqttClient", "Socket failed to connect!");
+				LOG_ERROR("MqttClient", "Socket failed to connect!");
 
 				if (m_connectionStatus == ConnectionStatus::RECONNECTING)
 				{
@@ -803,17 +1111,21 @@ namespace kmMqtt
 					DISPATCH_EVENT_TO_CONSUMER([&, p = ConnectAck{}]() {m_connectEvent({ false, false, ClientErrorCode::Socket_Connect_Failed }, p); });
 				}
 			}
+			wakeTickLoop();
 		}
 
 		void MqttClientImpl::handleSocketDisconnectEvent()
 		{
 			handleExternalDisconnect(m_socket->getLastError(), m_socket->getLastCloseReason());
+			wakeTickLoop();
 		}
 
 		void MqttClientImpl::handleSocketDataReceivedEvent(ByteBuffer&& buffer)
 		{
 			LockGuard guard{ m_receiverMutex };
 
+			captureWire(m_wireCaptureSinkPtr, WireDirection::RECEIVED, buffer.bytes(), buffer.size());
+
 			ByteBuffer fullBuffer{ buffer.size() + m_leftOverBuffer.size() };
 			fullBuffer.append(m_leftOverBuffer.bytes(), m_leftOverBuffer.size());
 			fullBuffer.append(buffer.bytes(), buffer.size());
@@ -834,11 +1146,16 @@ namespace kmMqtt
 				m_leftOverBuffer = ByteBuffer{ leftOver };
 				m_leftOverBuffer.append(fullBuffer.bytes() + fullBuffer.size() - leftOver, leftOver);
 			}
+			else
+			{
+				m_leftOverBuffer = ByteBuffer{ 0U };
+			}
+			wakeTickLoop();
 		}
 
 		void MqttClientImpl::handleSocketErrorEvent(int error)
 		{
-			LogError("MqttClient", "Shutting down, socket error occurred: %d", error);
+			LOG_ERROR("MqttClient", "Shutting down, socket error occurred: %d", error);
 			shutdown();
 		}
 
@@ -872,6 +1189,20 @@ namespace kmMqtt
 			m_connectionInfo.sessionState.updateMessage(packetId, PublishMessageStatus::WaitingForPubComp);
 		}
 
+		void MqttClientImpl::handlePublishExpiredEvent(std::uint16_t packetId)
+		{
+			if (packetId == 0U)
+			{
+				return;
+			}
+
+			//QoS 1/2 publish is given up on, so it must not be retried on this or a later connection.
+			m_connectionInfo.sessionState.removeMessage(packetId);
+			m_packetIdPool.releaseId(packetId);
+
+			DISPATCH_EVENT_TO_CONSUMER([&, id = packetId]() {m_pubCompletedEvent({ PacketType::PUBLISH, id, static_cast<std::uint8_t>(PubAckReasonCode::UNSPECIFIED_ERROR) }); });
+		}
+
 		void MqttClientImpl::handleDisconnectSentEvent()
 		{
 			m_sendQueue.clearQueue(true);
@@ -880,7 +1211,7 @@ namespace kmMqtt
 
 			if (!m_socket->close())
 			{
-				LogError("MqttClient", "Error closing socket properly during internal disconnect: %d", m_socket->getLastError());
+				LOG_ERROR("MqttClient", "Error closing socket properly during internal disconnect: %d", m_socket->getLastError());
 			}
 
 			clearState();
@@ -896,6 +1227,12 @@ namespace kmMqtt
 				m_connectionStatus = ConnectionStatus::CONNECTED;
 				m_connectionInfo.hasBeenConnected = true;
 
+				if (m_offlineSpool != nullptr)
+				{
+					std::lock_guard<std::mutex> spoolGuard{ m_offlineSpoolMutex };
+					m_offlineSpool->resetDrainBudget(std::chrono::steady_clock::now());
+				}
+
 				m_connectionInfo.reconnectAddress.reset(m_connectionInfo.connectAddress);
 
 				//Handle properties received from the server.
@@ -962,7 +1299,7 @@ namespace kmMqtt
 				if (packet.getVariableHeader().properties.tryGetProperty(PropertyType::ASSIGNED_CLIENT_IDENTIFIER, assignedClientId))
 				{
 					m_connectionInfo.connectArgs.clientId = assignedClientId->getString();
-					LogInfo("MqttClient", "Broker assigned client identifier: %s", m_connectionInfo.connectArgs.clientId.c_str());
+					LOG_INFO("MqttClient", "Broker assigned client identifier: %s", m_connectionInfo.connectArgs.clientId.c_str());
 				}
 
 				const uint8_t* subIdentifierAvailable{ nullptr };
@@ -971,17 +1308,61 @@ namespace kmMqtt
 					m_connectionInfo.subscribeIdentifiersSupported = *subIdentifierAvailable == 1;
 				}
 
+				const auto& persistantStore{ m_clientOptions.getSessionStatePersistantStore() };
+				const char* clientId{ m_connectionInfo.connectArgs.clientId.c_str() };
+
+				if (persistantStore != nullptr && !persistantStore->initialize(clientId))
+				{
+					LOG_ERROR("MqttClient", "Failed to initialize session state persistant store, Client ID: %s", clientId);
+				}
+
 				const SessionState prevSessionState{ std::move(m_connectionInfo.sessionState) };
-				m_connectionInfo.sessionState = SessionState{ m_connectionInfo.connectArgs.clientId.c_str(),
+				m_connectionInfo.sessionState = SessionState{ clientId,
 					m_connectionInfo.connectArgs.sessionExpiryInterval,
-					m_config.retryPublishIntervalMS };
+					m_config.retryPublishIntervalMS,
+					persistantStore };
+
+				const bool isSessionPresent{ packet.getVariableHeader().flags.getFlagValue(ConnectAcknowledgeFlags::SESSION_PRESENT) == 1 };
+
+				if (!isSessionPresent)
+				{
+					//New session on broker side, anything persisted for this client belongs to a session that no longer exists.
+					m_connectionInfo.sessionState.clear();
+				}
+				else if (prevSessionState.getClientId().empty() && persistantStore != nullptr)
+				{
+					//No session in memory (e.g. process restarted), recover in-flight messages from the persistant store.
+					std::vector<SavedData> savedData;
+
+					if (persistantStore->readAll(clientId, savedData))
+					{
+						for (const auto& data : savedData)
+						{
+							const bool isOutgoing{ data.status == PublishMessageStatus::WaitingForAck ||
+								data.status == PublishMessageStatus::WaitingForPubRec ||
+								data.status == PublishMessageStatus::WaitingForPubComp };
+
+							if (isOutgoing)
+							{
+								m_packetIdPool.reserveId(data.packetID);
+							}
+						}
+
+						m_connectionInfo.sessionState.restoreSavedMessages(savedData);
+						LOG_INFO("MqttClient", "Recovered %d session state messages from persistant store, Client ID: %s", savedData.size(), clientId);
+					}
+					else
+					{
+						LOG_ERROR("MqttClient", "Failed to read session state from persistant store, Client ID: %s", clientId);
+					}
+				}
 
 				//If session present flag is set, merge previous session state into new one (e.g. pending publish, pubrec, pubrel...).
-				if (packet.getVariableHeader().flags.getFlagValue(ConnectAcknowledgeFlags::SESSION_PRESENT) == 1)
+				if (isSessionPresent)
 				{
-					if (prevSessionState.getClientId().empty())
+					if (prevSessionState.getClientId().empty() && persistantStore == nullptr)
 					{
-						LogError("MqttClient", "Broker indicated existing session present, but client has no previous session state to restore.");
+						LOG_ERROR("MqttClient", "Broker indicated existing session present, but client has no previous session state to restore.");
 
 						if (m_connectionStatus == ConnectionStatus::RECONNECTING)
 						{
@@ -1000,7 +1381,7 @@ namespace kmMqtt
 
 				if (m_connectionStatus == ConnectionStatus::RECONNECTING)
 				{
-					LogDebug("MqttClient", "Reconnection complete to broker: %s Port: %s",
+					LOG_DEBUG("MqttClient", "Reconnection complete to broker: %s Port: %s",
 						m_connectionInfo.reconnectAddress.primaryAddress.hostname().c_str(),
 						m_connectionInfo.reconnectAddress.primaryAddress.port().c_str());
 
@@ -1008,7 +1389,7 @@ namespace kmMqtt
 				}
 				else
 				{
-					LogDebug("MqttClient", "Client connected to broker: %s Port: %s",
+					LOG_DEBUG("MqttClient", "Client connected to broker: %s Port: %s",
 						m_connectionInfo.connectAddress.primaryAddress.hostname().c_str(),
 						m_connectionInfo.reconnectAddress.primaryAddress.port().c_str());
 
@@ -1044,6 +1425,9 @@ namespace kmMqtt
 		{
 			const auto packetId{ packet.getVariableHeader().packetId };
 
+			m_metrics.markPublishAcknowledged(packetId, std::chrono::steady_clock::now());
+			trace(m_traceSinkPtr, TraceStage::ACK_RECEIVED, PacketType::PUBLISH_ACKNOWLEDGE, packetId);
+
 			m_connectionInfo.sessionState.removeMessage(packetId);
 			m_packetIdPool.releaseId(packetId);
 
@@ -1054,6 +1438,8 @@ namespace kmMqtt
 		{
 			const auto packetId{ packet.getVariableHeader().packetId };
 
+			trace(m_traceSinkPtr, TraceStage::ACK_RECEIVED, PacketType::PUBLISH_COMPLETE, packetId);
+
 			m_connectionInfo.sessionState.removeMessage(packetId);
 			m_packetIdPool.releaseId(packetId);
 
@@ -1065,9 +1451,12 @@ namespace kmMqtt
 			const auto packetId{ packet.getVariableHeader().packetId };
 			const auto reasonCode{ packet.getVariableHeader().reasonCode };
 
+			m_metrics.markPublishAcknowledged(packetId, std::chrono::steady_clock::now());
+			trace(m_traceSinkPtr, TraceStage::ACK_RECEIVED, PacketType::PUBLISH_RECEIVED, packetId);
+
 			if (reasonCode >= PubRecReasonCode::UNSPECIFIED_ERROR)
 			{
-				LogWarning("MqttClient", "Received PUBREC packet with non-success reason code: %d for Packet ID %d. Cancelling publish message.",
+				LOG_WARNING("MqttClient", "Received PUBREC packet with non-success reason code: %d for Packet ID %d. Cancelling publish message.",
 					static_cast<std::uint8_t>(reasonCode),
 					packetId);
 
@@ -1112,7 +1501,7 @@ namespace kmMqtt
 			if (!foundPacketId)
 			{
 				m_packetIdPool.releaseId(packetId);
-				LogWarning("MqttClient", "Received SUBACK packet with Packet ID %d, but no pending subscription found for it.", packetId);
+				LOG_WARNING("MqttClient", "Received SUBACK packet with Packet ID %d, but no pending subscription found for it.", packetId);
 				return;
 			}
 
@@ -1143,7 +1532,7 @@ namespace kmMqtt
 			if (!foundPacketId)
 			{
 				m_packetIdPool.releaseId(packetId);
-				LogWarning("MqttClient", "Received UNSUBACK packet with Packet ID %d, but no pending un-subscription found for it.", packetId);
+				LOG_WARNING("MqttClient", "Received UNSUBACK packet with Packet ID %d, but no pending un-subscription found for it.", packetId);
 				return;
 			}
 
@@ -1171,7 +1560,7 @@ namespace kmMqtt
 			{
 				if (m_connectionInfo.connectArgs.maximumTopicAliases == 0)
 				{
-					LogError("MqttClient", "Client does not allow topic aliases but server has sent us a topic alias of value %d.", *topicAlias);
+					LOG_ERROR("MqttClient", "Client does not allow topic aliases but server has sent us a topic alias of value %d.", *topicAlias);
 
 					DisconnectArgs args;
 					args.gracefulDisconnect = false;
@@ -1184,7 +1573,7 @@ namespace kmMqtt
 
 				if (*topicAlias <= 0 || *topicAlias > m_connectionInfo.connectArgs.maximumTopicAliases)
 				{
-					LogError("MqttClient",
+					LOG_ERROR("MqttClient",
 						"Publish packet TOPIC ALIAS is invalid: %d\nTOPIC ALIAS - Min allowed value: %d. Max allowed value: %d",
 						*topicAlias,
 						1,
@@ -1214,7 +1603,7 @@ namespace kmMqtt
 			}
 			else if (topicName.empty())
 			{
-				LogError("MqttClient", "Publish packet TOPIC ALIAS is invalid and TOPIC NAME is empty.");
+				LOG_ERROR("MqttClient", "Publish packet TOPIC ALIAS is invalid and TOPIC NAME is empty.");
 
 				DisconnectArgs args;
 				args.gracefulDisconnect = false;
@@ -1227,22 +1616,134 @@ namespace kmMqtt
 
 			const auto qos{ packet.getVariableHeader().qos };
 			const auto id{ packet.getVariableHeader().packetIdentifier };
-
-			DISPATCH_EVENT_TO_CONSUMER([&, tName = topicName, pload = &packet.getPayloadHeader().payload, p = std::move(packet)]() {m_publishEvent({ std::move(tName), pload }, p); });
+			const bool ackAfterCallback{ qos != Qos::QOS_0 && m_clientOptions.getAckMode() == AckMode::AFTER_CALLBACK };
 
 			//TODO authorization check (adapter?) ? send failed pub ack?
 
-			//After packet is sent to application layer, send PUBACK packet back to the server (As per QOS 1 specification) 
+			if (qos == Qos::QOS_2)
+			{
+				PublishMessageData data{ topicName, {}, {} };
+				m_connectionInfo.sessionState.addMessage(id, std::move(data));
+			}
+
+			//Internal deferrer runs everything in order on the ticking thread, so the key is only evaluated for external dispatchers.
+			const std::size_t orderingKey{ m_clientOptions.isUsingInternalCallbackDeferrer() ? 0U : m_clientOptions.getPublishOrderingKey()(topicName) };
+
+			if (qos == Qos::QOS_0 && m_clientOptions.getReceiveQueueOptions().conflateQos0)
+			{
+				if (tryConflateReceivedPublish(topicName, packet))
+				{
+					return;
+				}
+
+				DISPATCH_ORDERED_EVENT_TO_CONSUMER(orderingKey, [&, tName = topicName]() { fireConflatedPublishEvent(tName); });
+				return;
+			}
+
+			//Counted before acking, so the publish that reaches the high watermark already has its ack held.
+			const std::size_t deliveryBytes{ topicName.size() + packet.getPayloadHeader().payload.size() };
+			m_inboundFlowControl.addDelivery(deliveryBytes);
+
+			if (!ackAfterCallback)
+			{
+				acknowledgeReceivedPublish(qos, id);
+			}
+
+			trace(m_traceSinkPtr, TraceStage::DISPATCHED, PacketType::PUBLISH, id, deliveryBytes);
+
+			DISPATCH_ORDERED_EVENT_TO_CONSUMER(orderingKey, [&, tName = topicName, pload = &packet.getPayloadHeader().payload, p = std::move(packet), ackAfterCallback, qos, id, deliveryBytes]()
+			{
+				m_publishEvent({ std::move(tName), pload }, p);
+				trace(m_traceSinkPtr, TraceStage::CALLBACK_COMPLETED, PacketType::PUBLISH, id, deliveryBytes);
+
+				if (m_inboundFlowControl.completeDelivery(deliveryBytes))
+				{
+					wakeTickLoop();
+				}
+
+				//Callback may run on a dispatcher thread after the connection was lost, acks are only valid for the live connection.
+				if (ackAfterCallback && m_connectionStatus == ConnectionStatus::CONNECTED)
+				{
+					acknowledgeReceivedPublish(qos, id);
+					wakeTickLoop();
+				}
+			});
+		}
+
+		bool MqttClientImpl::tryConflateReceivedPublish(const std::string& topicName, Publish& packet) noexcept
+		{
+			LockGuard guard{ m_conflatedPublishesMutex };
+
+			const std::size_t deliveryBytes{ topicName.size() + packet.getPayloadHeader().payload.size() };
+
+			auto it{ m_conflatedPublishes.find(topicName) };
+			if (it == m_conflatedPublishes.end())
+			{
+				m_inboundFlowControl.addDelivery(deliveryBytes);
+				m_conflatedPublishes.emplace(topicName, std::move(packet));
+				return false;
+			}
+
+			//Callback for this topic is already dispatched and not yet run, it picks up the newest message when it does.
+			m_inboundFlowControl.resizeDelivery(topicName.size() + it->second.getPayloadHeader().payload.size(), deliveryBytes);
+			m_conflatedPublishes.erase(it);
+			m_conflatedPublishes.emplace(topicName, std::move(packet));
+			++m_inboundConflatedCount;
+
+			LOG_TRACE("MqttClient", "Conflated received QoS 0 publish, Topic: %s", topicName.c_str());
+			return true;
+		}
+
+		void MqttClientImpl::fireConflatedPublishEvent(const std::string& topicName) noexcept
+		{
+			std::unique_lock<std::mutex> lock{ m_conflatedPublishesMutex };
+
+			auto it{ m_conflatedPublishes.find(topicName) };
+			if (it == m_conflatedPublishes.end())
+			{
+				return;
+			}
+
+			const Publish packet{ std::move(it->second) };
+			m_conflatedPublishes.erase(it);
+			lock.unlock();
+
+			m_publishEvent({ topicName, &packet.getPayloadHeader().payload }, packet);
+
+			if (m_inboundFlowControl.completeDelivery(topicName.size() + packet.getPayloadHeader().payload.size()))
+			{
+				wakeTickLoop();
+			}
+		}
+
+		void MqttClientImpl::acknowledgeReceivedPublish(Qos qos, std::uint16_t packetId) noexcept
+		{
+			//Held while the inbound backlog is over its watermarks, the broker's receive maximum then stops it sending more.
+			if (qos != Qos::QOS_0 && m_inboundFlowControl.tryHoldAck(qos, packetId))
+			{
+				return;
+			}
+
+			sendReceivedPublishAck(qos, packetId);
+		}
+
+		void MqttClientImpl::sendReceivedPublishAck(Qos qos, std::uint16_t packetId) noexcept
+		{
+			//With an async store, the ack must not reach the broker before the received message is durable.
+			if (qos != Qos::QOS_0 && m_clientOptions.getAsyncSessionStatePersistantStore() != nullptr)
+			{
+				m_durableAckTracker.hold(qos, packetId);
+				return;
+			}
+
+			//Send PUBACK (QOS 1) or PUBREC (QOS 2) packet back to the server.
 			if (qos == Qos::QOS_1)
 			{
-				pubAck(id, PubAckReasonCode::SUCCESS, PubAckOptions{});
+				pubAck(packetId, PubAckReasonCode::SUCCESS, PubAckOptions{});
 			}
 			else if (qos == Qos::QOS_2)
 			{
-				PublishMessageData data{ topicName, {}, {} };
-				m_connectionInfo.sessionState.addMessage(id, std::move(data));
-
-				pubRec(id, PubRecReasonCode::SUCCESS, PubRecOptions{});
+				pubRec(packetId, PubRecReasonCode::SUCCESS, PubRecOptions{});
 			}
 		}
 
@@ -1320,6 +1821,11 @@ namespace kmMqtt
 				m_connectionInfo.lastControlPacketTime = std::chrono::steady_clock::now();
 			}
 
+			if (m_batchResultData.becameWritable)
+			{
+				DISPATCH_EVENT_TO_CONSUMER([&]() { m_writableEvent(); });
+			}
+
 			//If result from sending action was specified as unrecoverable, then log error and start disconnect.
 			if (!m_batchResultData.isRecoverable)
 			{
@@ -1338,12 +1844,115 @@ namespace kmMqtt
 		{
 			//Check, decode, and handle received packets.
 			const DecodeResult result{ m_receiveQueue.receiveNextBatch() };
+
+			//One durability barrier for every ack held by this batch, so the store syncs once for all of them.
+			if (m_clientOptions.getAsyncSessionStatePersistantStore() != nullptr)
+			{
+				m_durableAckTracker.requestBarrier(*m_clientOptions.getAsyncSessionStatePersistantStore());
+			}
+
+			//Acks queued while handling the batch go into the send buffer together, ready for the next send.
+			m_sendQueue.flushAcknowledgements();
+
 			if (!result.isSuccess())
 			{
 				handleDecodeError(result);
 			}
 		}
 
+		void MqttClientImpl::tickHeldAcknowledgements()
+		{
+			const auto& store{ m_clientOptions.getAsyncSessionStatePersistantStore() };
+			if (store == nullptr)
+			{
+				return;
+			}
+
+			//Acks held outside of a receive batch, e.g. by AckMode::AFTER_CALLBACK on a dispatcher thread.
+			m_durableAckTracker.requestBarrier(*store);
+
+			std::vector<DurableAckTracker::Ack> acks;
+			const std::size_t droppedCount{ m_durableAckTracker.takeReleased(acks) };
+
+			if (droppedCount > 0U)
+			{
+				//Not acking leaves the messages unacknowledged on the broker, which redelivers them on the next connection.
+				LOG_ERROR("MqttClient", "Failed to persist session state, %d received publishes were not acknowledged.", droppedCount);
+				DISPATCH_EVENT_TO_CONSUMER([&]() {m_errorEvent({ ClientErrorCode::Failed_Writing_To_Persistent_Storage, "Failed to persist received publishes, acknowledgements were not sent." }, {}); });
+			}
+
+			for (const auto& ack : acks)
+			{
+				if (ack.qos == Qos::QOS_1)
+				{
+					pubAck(ack.packetId, PubAckReasonCode::SUCCESS, PubAckOptions{});
+				}
+				else
+				{
+					pubRec(ack.packetId, PubRecReasonCode::SUCCESS, PubRecOptions{});
+				}
+			}
+
+			if (!acks.empty())
+			{
+				m_sendQueue.flushAcknowledgements();
+			}
+		}
+
+		void MqttClientImpl::tickInboundFlowControl()
+		{
+			const bool isPaused{ m_inboundFlowControl.isPaused() };
+
+			if (isPaused != m_isSocketReadPaused)
+			{
+				LOG_DEBUG("MqttClient", isPaused ? "Inbound backlog reached its high watermark, pausing reads." : "Inbound backlog drained, resuming reads.");
+				m_socket->setReadPaused(isPaused);
+				m_isSocketReadPaused = isPaused;
+			}
+
+			std::vector<InboundFlowControl::Ack> acks;
+			m_inboundFlowControl.takeReleasedAcks(acks);
+
+			for (const auto& ack : acks)
+			{
+				sendReceivedPublishAck(ack.qos, ack.packetId);
+			}
+
+			if (!acks.empty())
+			{
+				m_sendQueue.flushAcknowledgements();
+			}
+		}
+
+		void MqttClientImpl::tickOfflineSpool()
+		{
+			if (m_offlineSpool == nullptr || m_connectionStatus != ConnectionStatus::CONNECTED)
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> spoolGuard{ m_offlineSpoolMutex };
+
+			const TimePoint now{ std::chrono::steady_clock::now() };
+			const std::size_t expiredBefore{ m_offlineSpool->getExpiredCount() };
+
+			//Checked per publish, a publish() on another thread may still go over the soft high watermark in between.
+			PublishMessageData message;
+			while (!m_offlineSpool->empty() && m_sendQueue.isWritable() && m_offlineSpool->tryTakeDrainToken(now) && m_offlineSpool->pop(message, now))
+			{
+				const ReqResult result{ queuePublish(message.topic.c_str(), std::move(message.payload), std::move(message.options)) };
+				if (!result.noError())
+				{
+					LOG_ERROR("MqttClient", "Failed to queue spooled publish, Topic: %s", message.topic.c_str());
+				}
+			}
+
+			if (m_offlineSpool->getExpiredCount() != expiredBefore)
+			{
+				LOG_INFO("MqttClient", "Dropped %d spooled publishes whose message expiry elapsed while offline.", m_offlineSpool->getExpiredCount() - expiredBefore);
+			}
+		}
+
 		void MqttClientImpl::tickPendingPublishMessageRetries()
 		{
 			const auto& msgs{ m_connectionInfo.sessionState.messages() };
@@ -1354,7 +1963,7 @@ namespace kmMqtt
 				{
 					PacketType type{ msg.getRetryPacketType() };
 
-					LogTrace("MqttClient", "Retrying message: Type: %s, Packet ID: %d, Topic: %s",
+					LOG_TRACE("MqttClient", "Retrying message: Type: %s, Packet ID: %d, Topic: %s",
 						packetTypeToString(type),
 						msg.data.packetID,
 						msg.data.publishMsgData.topic.c_str());
@@ -1372,7 +1981,10 @@ namespace kmMqtt
 							std::move(payloadCopy),
 							std::move(options),
 							&m_receiveMaximumTracker,
-							true));
+							true,
+							msg.queuedTime));
+
+						m_metrics.addPublishRetry();
 					}
 					else if (type == PacketType::PUBLISH_RECEIVED)
 					{
@@ -1390,9 +2002,67 @@ namespace kmMqtt
 			}
 		}
 
+		void MqttClientImpl::recordTickMetrics(TimePoint tickStart) noexcept
+		{
+			const std::uint32_t maxSendAllowance{ m_receiveMaximumTracker.getMaxSendAllowance() };
+			const std::uint32_t sendAllowance{ std::min(m_receiveMaximumTracker.getCurrentSendAllowance(), maxSendAllowance) };
+			m_metrics.setInFlight(maxSendAllowance - sendAllowance, maxSendAllowance);
+			recordMemoryStats();
+			m_metrics.recordTickDuration(std::chrono::steady_clock::now() - tickStart);
+		}
+
+		void MqttClientImpl::recordMemoryStats() noexcept
+		{
+			MqttClientMemoryStats stats;
+
+			std::size_t sendQueueBytes{ 0U };
+			std::size_t sendBufferBytes{ 0U };
+			m_sendQueue.getQueuedBytes(sendQueueBytes, sendBufferBytes);
+			stats.sendQueueBytes = sendQueueBytes;
+			stats.sendBufferBytes = sendBufferBytes;
+
+			{
+				LockGuard guard{ m_receiverMutex };
+				stats.receiveQueueBytes = m_leftOverBuffer.size();
+			}
+
+			stats.receiveQueueBytes += m_receiveQueue.getQueuedBytes();
+			stats.pendingCallbackBytes = m_inboundFlowControl.getDeliveryBytes();
+			stats.sessionStateBytes = m_connectionInfo.sessionState.getPayloadBytes();
+			stats.propertyBytes = m_connectionInfo.sessionState.getPropertyBytes();
+			stats.topicAliasBytes = m_connectionInfo.topicAliases.getTopicNameBytes();
+
+			{
+				std::lock_guard<std::mutex> spoolGuard{ m_offlineSpoolMutex };
+				if (m_offlineSpool != nullptr)
+				{
+					stats.offlineSpoolBytes = m_offlineSpool->getMemoryUsedBytes();
+				}
+			}
+
+			stats.loggerBytes = getAsyncLogBufferBytes();
+			m_metrics.setMemoryStats(stats);
+
+			const std::size_t budget{ m_clientOptions.getMemoryBudget() };
+			if (budget == 0U)
+			{
+				return;
+			}
+
+			//Fires once per crossing, a total hovering over the budget does not flood the consumer.
+			const bool isOverBudget{ stats.totalBytes() > budget };
+			if (isOverBudget && !m_isOverMemoryBudget)
+			{
+				LOG_WARNING("MqttClient", "Memory budget of %zu bytes exceeded, %llu bytes in use.", budget, static_cast<unsigned long long>(stats.totalBytes()));
+				DISPATCH_EVENT_TO_CONSUMER([&, s = stats]() { m_memoryBudgetExceededEvent(s); });
+			}
+
+			m_isOverMemoryBudget = isOverBudget;
+		}
+
 		void MqttClientImpl::handleFailedReconnect(ConnectAck&& packet, ClientErrorCode errorCode)
 		{
-			LogDebug("MqttClient", "Client could not reconnect. ConnectReasonCode: %d", static_cast<std::uint8_t>(packet.getVariableHeader().reasonCode));
+			LOG_DEBUG("MqttClient", "Client could not reconnect. ConnectReasonCode: %d", static_cast<std::uint8_t>(packet.getVariableHeader().reasonCode));
 			m_socket->close();
 			m_receiveQueue.clear();
 
@@ -1416,7 +2086,7 @@ namespace kmMqtt
 		void MqttClientImpl::handleFailedConnect(ConnectAck&& packet, ClientErrorCode errorCode)
 		{
 			m_connectionStatus = ConnectionStatus::DISCONNECTED;
-			LogDebug("MqttClient", "Client could not connect to broker. ConnectReasonCode: %d", static_cast<std::uint8_t>(packet.getVariableHeader().reasonCode));
+			LOG_DEBUG("MqttClient", "Client could not connect to broker. ConnectReasonCode: %d", static_cast<std::uint8_t>(packet.getVariableHeader().reasonCode));
 
 			m_socket->close();
 			m_receiveQueue.clear();
@@ -1439,7 +2109,7 @@ namespace kmMqtt
 		void MqttClientImpl::handleTimeOutConnect()
 		{
 			m_connectionStatus = ConnectionStatus::DISCONNECTED;
-			LogDebug("MqttClient", "Client could not connect to broker. Connection timed out");
+			LOG_DEBUG("MqttClient", "Client could not connect to broker. Connection timed out");
 
 			m_socket->setOnDisconnectCallback(nullptr);
 			m_socket->close();
@@ -1452,7 +2122,7 @@ namespace kmMqtt
 
 		void MqttClientImpl::handleTimeOutReconnect()
 		{
-			LogDebug("MqttClient", "Client could not reconnect. Connection timed out.");
+			LOG_DEBUG("MqttClient", "Client could not reconnect. Connection timed out.");
 			m_socket->setOnDisconnectCallback(nullptr);
 			m_socket->close();
 			m_receiveQueue.clear();
@@ -1479,7 +2149,9 @@ namespace kmMqtt
 			DisconnectArgs args{ false, false, true };
 			args.disconnectReasonText = result.reason;
 
-			LogInfo("MqttClient", "Failed to decode received packet. Packet Type: %d, Reason: %s", static_cast<std::uint8_t>(result.packetType), result.reason.c_str());
+			m_metrics.addDecodeError();
+
+			LOG_INFO("MqttClient", "Failed to decode received packet. Packet Type: %d, Reason: %s", static_cast<std::uint8_t>(result.packetType), result.reason.c_str());
 
 			if (m_connectionStatus == ConnectionStatus::CONNECTING)
 			{
@@ -1496,24 +2168,40 @@ namespace kmMqtt
 		{
 			if (m_socket == nullptr)
 			{
-				LogError("MqttClient", "Cannot send packet, socket is nullptr. Packet Type: %d", static_cast<std::uint8_t>(packet.getPacketType()));
+				LOG_ERROR("MqttClient", "Cannot send packet, socket is nullptr. Packet Type: %d", static_cast<std::uint8_t>(packet.getPacketType()));
 				return -1;
 			}
 
-			LogInfo("MqttClient",
+			LOG_INFO("MqttClient",
 				"Sending packet. PacketType: %s, Size: %d",
 				packetTypeToString(packet.getPacketType()),
 				packet.getFixedHeader().getEncodedBytesSize() + packet.getFixedHeader().remainingLength.uint32Value());
 
 			const ByteBuffer& bufferRef{ packet.getDataBuffer() };
 
-			if (static_cast<std::size_t>(m_socket->send(bufferRef)) == bufferRef.size())
+			trace(m_traceSinkPtr, TraceStage::COMPOSED, packet.getPacketType(), 0U, bufferRef.size());
+
+			const TimePoint sendStart{ std::chrono::steady_clock::now() };
+			const int sendResult{ m_socket->send(bufferRef) };
+			const TimePoint sendEnd{ std::chrono::steady_clock::now() };
+			m_metrics.recordSocketSendTime(sendEnd - sendStart);
+
+			if (sendResult > 0)
 			{
-				LogTrace("MqttClient", "Packet sent, Bytes: %s.", bufferRef.toString().c_str());
+				captureWire(m_wireCaptureSinkPtr, WireDirection::SENT, bufferRef.bytes(), std::min(static_cast<std::size_t>(sendResult), bufferRef.size()));
+			}
+
+			if (static_cast<std::size_t>(sendResult) == bufferRef.size())
+			{
+				m_metrics.addPacketSent(packet.getPacketType(), bufferRef.size());
+				trace(m_traceSinkPtr, TraceStage::FIRST_BYTE_SENT, packet.getPacketType(), 0U, bufferRef.size(), sendEnd);
+				trace(m_traceSinkPtr, TraceStage::LAST_BYTE_SENT, packet.getPacketType(), 0U, bufferRef.size(), sendEnd);
+
+				LOG_TRACE("MqttClient", "Packet sent, Bytes: %s.", bufferRef.toString().c_str());
 				return 0;
 			}
 
-			LogError("MqttClient", "Sending packet failed at socket level: %d", m_socket->getLastError());
+			LOG_ERROR("MqttClient", "Sending packet failed at socket level: %d", m_socket->getLastError());
 
 			return m_socket->getLastError();
 		}
@@ -0,0 +1,149 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/MqttClientMetrics.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		namespace
+		{
+			constexpr double k_exportedQuantiles[]{ 0.5, 0.9, 0.99, 0.999 };
+
+			void appendHeader(std::string& out, const char* prefix, const char* name, const char* type, const char* help)
+			{
+				out.append("# HELP ").append(prefix).append("_").append(name).append(" ").append(help).append("\n");
+				out.append("# TYPE ").append(prefix).append("_").append(name).append(" ").append(type).append("\n");
+			}
+
+			void appendValue(std::string& out, const char* prefix, const char* name, const char* labels, std::uint64_t value)
+			{
+				char text[32];
+				std::snprintf(text, sizeof(text), " %" PRIu64 "\n", value);
+				out.append(prefix).append("_").append(name).append(labels).append(text);
+			}
+
+			void appendSeconds(std::string& out, const char* prefix, const char* name, const char* labels, std::uint64_t microseconds)
+			{
+				char text[48];
+				std::snprintf(text, sizeof(text), " %.6f\n", static_cast<double>(microseconds) / 1000000.0);
+				out.append(prefix).append("_").append(name).append(labels).append(text);
+			}
+
+			void appendPerPacketType(std::string& out, const char* prefix, const char* name, const char* help,
+				const std::array<std::uint64_t, k_packetTypeCount>& values)
+			{
+				appendHeader(out, prefix, name, "counter", help);
+
+				//RESERVED is never sent or accepted, it would only be an empty series.
+				for (std::size_t i = 1; i < k_packetTypeCount; ++i)
+				{
+					const std::string labels{ std::string{ "{type=\"" } + k_packetTypeName[i] + "\"}" };
+					appendValue(out, prefix, name, labels.c_str(), values[i]);
+				}
+			}
+
+			void appendGauge(std::string& out, const char* prefix, const char* name, const char* help, std::uint64_t value)
+			{
+				appendHeader(out, prefix, name, "gauge", help);
+				appendValue(out, prefix, name, "", value);
+			}
+
+			void appendMemory(std::string& out, const char* prefix, const MqttClientMemoryStats& memory)
+			{
+				const char* name{ "memory_bytes" };
+				appendHeader(out, prefix, name, "gauge", "Live bytes held by each part of the client.");
+				appendValue(out, prefix, name, "{subsystem=\"send_queue\"}", memory.sendQueueBytes);
+				appendValue(out, prefix, name, "{subsystem=\"send_buffer\"}", memory.sendBufferBytes);
+				appendValue(out, prefix, name, "{subsystem=\"receive_queue\"}", memory.receiveQueueBytes);
+				appendValue(out, prefix, name, "{subsystem=\"pending_callbacks\"}", memory.pendingCallbackBytes);
+				appendValue(out, prefix, name, "{subsystem=\"session_state\"}", memory.sessionStateBytes);
+				appendValue(out, prefix, name, "{subsystem=\"properties\"}", memory.propertyBytes);
+				appendValue(out, prefix, name, "{subsystem=\"topic_aliases\"}", memory.topicAliasBytes);
+				appendValue(out, prefix, name, "{subsystem=\"offline_spool\"}", memory.offlineSpoolBytes);
+				appendValue(out, prefix, name, "{subsystem=\"logger\"}", memory.loggerBytes);
+			}
+
+			void appendCounter(std::string& out, const char* prefix, const char* name, const char* help, std::uint64_t value)
+			{
+				appendHeader(out, prefix, name, "counter", help);
+				appendValue(out, prefix, name, "", value);
+			}
+
+			void appendSummary(std::string& out, const char* prefix, const char* name, const char* help, const LatencyHistogramSnapshot& histogram)
+			{
+				appendHeader(out, prefix, name, "summary", help);
+
+				for (const double quantile : k_exportedQuantiles)
+				{
+					char labels[32];
+					std::snprintf(labels, sizeof(labels), "{quantile=\"%g\"}", quantile);
+					appendSeconds(out, prefix, name, labels, histogram.getValueAtQuantile(quantile));
+				}
+
+				const std::string baseName{ name };
+				appendSeconds(out, prefix, (baseName + "_sum").c_str(), "", histogram.sumMicroseconds);
+				appendValue(out, prefix, (baseName + "_count").c_str(), "", histogram.count);
+			}
+		}
+
+		std::uint64_t LatencyHistogramSnapshot::getValueAtQuantile(double quantile) const noexcept
+		{
+			if (count == 0U)
+			{
+				return 0U;
+			}
+
+			quantile = std::min(std::max(quantile, 0.0), 1.0);
+			const std::uint64_t rank{ std::max<std::uint64_t>(1U, static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(count)))) };
+
+			std::uint64_t seen{ 0U };
+			for (const Bucket& bucket : buckets)
+			{
+				seen += bucket.count;
+				if (seen >= rank)
+				{
+					return std::min(bucket.upperBoundMicroseconds, maxMicroseconds);
+				}
+			}
+
+			return maxMicroseconds;
+		}
+
+		std::string toPrometheusText(const MqttClientMetrics& metrics, const char* prefix)
+		{
+			std::string out;
+			out.reserve(8192U);
+
+			appendPerPacketType(out, prefix, "packets_sent_total", "MQTT packets sent by type.", metrics.packetsSent);
+			appendPerPacketType(out, prefix, "bytes_sent_total", "Bytes of MQTT packets sent by type.", metrics.bytesSent);
+			appendPerPacketType(out, prefix, "packets_received_total", "MQTT packets received by type.", metrics.packetsReceived);
+			appendPerPacketType(out, prefix, "bytes_received_total", "Bytes of MQTT packets received by type.", metrics.bytesReceived);
+
+			appendCounter(out, prefix, "publish_retries_total", "QoS 1/2 publishes resent with the DUP flag.", metrics.publishRetries);
+			appendCounter(out, prefix, "reconnects_total", "Reconnect attempts.", metrics.reconnects);
+			appendCounter(out, prefix, "decode_errors_total", "Received packets that failed to decode.", metrics.decodeErrors);
+
+			appendGauge(out, prefix, "send_queue_packets", "Packets queued and not composed yet.", metrics.sendQueuePackets);
+			appendGauge(out, prefix, "send_queue_bytes", "Bytes queued and not sent yet.", metrics.sendQueueBytes);
+			appendGauge(out, prefix, "in_flight_publishes", "QoS 1/2 publishes sent and not acknowledged yet.", metrics.inFlightPublishes);
+			appendGauge(out, prefix, "receive_maximum", "Server receive maximum, the limit for in flight publishes.", metrics.receiveMaximum);
+
+			appendMemory(out, prefix, metrics.memory);
+
+			appendSummary(out, prefix, "publish_ack_latency_seconds", "Time from sending a QoS 1/2 publish to its PUBACK or PUBREC.", metrics.publishAckLatency);
+			appendSummary(out, prefix, "tick_duration_seconds", "Time taken by one pass of the tick loop.", metrics.tickDuration);
+			appendSummary(out, prefix, "socket_send_seconds", "Time taken by one socket send call.", metrics.socketSendTime);
+
+			return out;
+		}
+	}
+}
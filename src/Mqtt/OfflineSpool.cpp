@@ -0,0 +1,405 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/OfflineSpool.h"
+#include "kmMqtt/Logger/LogMacros.h"
+#include "kmMqtt/Mqtt/MessageExpiry.h"
+#include "kmMqtt/Mqtt/PublishMessageCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		namespace
+		{
+			std::int64_t toMilliseconds(TimePoint time) noexcept
+			{
+				return std::chrono::duration_cast<Milliseconds>(time.time_since_epoch()).count();
+			}
+		}
+
+		void SpoolRing::reset(std::uint8_t* base, std::size_t capacity) noexcept
+		{
+			m_base = base;
+			m_capacity = base != nullptr ? capacity : 0U;
+			m_head = 0U;
+			m_tail = 0U;
+			m_count = 0U;
+			m_usedBytes = 0U;
+		}
+
+		bool SpoolRing::push(const std::vector<std::uint8_t>& record) noexcept
+		{
+			const std::size_t size{ k_lengthSize + record.size() };
+
+			if (!canEverFit(record.size()))
+			{
+				return false;
+			}
+
+			if (m_count == 0U)
+			{
+				m_head = 0U;
+				m_tail = 0U;
+			}
+
+			std::size_t writeOffset{ m_tail };
+
+			if (m_count == 0U || m_tail > m_head)
+			{
+				if (m_capacity - m_tail < size)
+				{
+					//Not enough room before the end, wrap to the start if the oldest record leaves enough room there.
+					if (size > m_head && m_count != 0U)
+					{
+						return false;
+					}
+
+					if (m_capacity - m_tail >= k_lengthSize)
+					{
+						std::memcpy(m_base + m_tail, &k_wrapMarker, k_lengthSize);
+					}
+
+					writeOffset = 0U;
+				}
+			}
+			else if (m_head - m_tail < size)
+			{
+				return false;
+			}
+
+			const std::uint32_t recordSize{ static_cast<std::uint32_t>(record.size()) };
+			std::memcpy(m_base + writeOffset, &recordSize, k_lengthSize);
+			std::memcpy(m_base + writeOffset + k_lengthSize, record.data(), record.size());
+
+			m_tail = writeOffset + size;
+			++m_count;
+			m_usedBytes += size;
+
+			return true;
+		}
+
+		void SpoolRing::skipWrap() noexcept
+		{
+			if (m_capacity - m_head < k_lengthSize)
+			{
+				m_head = 0U;
+				return;
+			}
+
+			std::uint32_t recordSize{ 0U };
+			std::memcpy(&recordSize, m_base + m_head, k_lengthSize);
+
+			if (recordSize == k_wrapMarker)
+			{
+				m_head = 0U;
+			}
+		}
+
+		bool SpoolRing::front(const std::uint8_t*& outData, std::uint32_t& outSize) noexcept
+		{
+			if (m_count == 0U)
+			{
+				return false;
+			}
+
+			skipWrap();
+			std::memcpy(&outSize, m_base + m_head, k_lengthSize);
+			outData = m_base + m_head + k_lengthSize;
+
+			return true;
+		}
+
+		void SpoolRing::pop() noexcept
+		{
+			if (m_count == 0U)
+			{
+				return;
+			}
+
+			skipWrap();
+
+			std::uint32_t recordSize{ 0U };
+			std::memcpy(&recordSize, m_base + m_head, k_lengthSize);
+
+			m_head += k_lengthSize + recordSize;
+			m_usedBytes -= k_lengthSize + recordSize;
+			--m_count;
+		}
+
+		OfflineSpool::OfflineSpool(const OfflineSpoolOptions& options)
+			: m_options(options)
+		{
+			const bool hasSpillFile{ !m_options.spillFilePath.empty() };
+			const std::size_t memoryBytes{ hasSpillFile ? std::min(m_options.maxMemoryBytes, m_options.maxBytes) : m_options.maxBytes };
+
+			m_memory.resize(memoryBytes);
+			m_memoryRing.reset(m_memory.data(), m_memory.size());
+
+			if (hasSpillFile && m_options.maxBytes > memoryBytes)
+			{
+				if (openSpillFile(m_options.maxBytes - memoryBytes))
+				{
+					m_fileRing.reset(m_mappedFile, m_mappedSize);
+				}
+				else
+				{
+					LOG_ERROR("OfflineSpool", "Failed to map spill file %s, offline spool is limited to %d bytes of memory.", m_options.spillFilePath.c_str(), memoryBytes);
+				}
+			}
+
+			resetDrainBudget(std::chrono::steady_clock::now());
+		}
+
+		OfflineSpool::~OfflineSpool() noexcept
+		{
+			closeSpillFile();
+		}
+
+		bool OfflineSpool::push(const char* topic, const ByteBuffer& payload, const PublishOptions& options)
+		{
+			std::vector<std::uint8_t> record;
+			record.reserve(64U + std::strlen(topic) + payload.size());
+
+			BinaryWriter writer{ record };
+			writer.i64(toMilliseconds(std::chrono::steady_clock::now()));
+
+			ByteBuffer payloadCopy{ payload.size() };
+			payloadCopy.append(payload);
+			encodePublishMessageData(writer, PublishMessageData{ topic, std::move(payloadCopy), options });
+
+			if (!m_memoryRing.canEverFit(record.size()) && !m_fileRing.canEverFit(record.size()))
+			{
+				LOG_WARNING("OfflineSpool", "Publish of %d bytes is larger than the offline spool.", record.size());
+				return false;
+			}
+
+			while (!tryPushRecord(record))
+			{
+				SpoolRing* ring{ oldestRing() };
+				if (m_options.overflow != OfflineSpoolOverflow::DROP_OLDEST || ring == nullptr)
+				{
+					return false;
+				}
+
+				ring->pop();
+				++m_droppedCount;
+			}
+
+			return true;
+		}
+
+		bool OfflineSpool::tryPushRecord(const std::vector<std::uint8_t>& record) noexcept
+		{
+			//Memory only takes records while nothing is spilled, to keep every file record newer than every memory record.
+			if (m_fileRing.empty() && m_memoryRing.push(record))
+			{
+				return true;
+			}
+
+			return m_fileRing.push(record);
+		}
+
+		SpoolRing* OfflineSpool::oldestRing() noexcept
+		{
+			if (!m_memoryRing.empty())
+			{
+				return &m_memoryRing;
+			}
+
+			return m_fileRing.empty() ? nullptr : &m_fileRing;
+		}
+
+		bool OfflineSpool::pop(PublishMessageData& outData, TimePoint now)
+		{
+			while (SpoolRing* ring = oldestRing())
+			{
+				const std::uint8_t* data{ nullptr };
+				std::uint32_t size{ 0U };
+				ring->front(data, size);
+
+				BinaryReader reader{ data, size };
+				const std::int64_t ageMs{ toMilliseconds(now) - reader.i64() };
+
+				PublishMessageData message;
+				const bool isDecoded{ decodePublishMessageData(reader, message) };
+				ring->pop();
+
+				if (!isDecoded)
+				{
+					LOG_ERROR("OfflineSpool", "Dropping corrupt offline spool record of %d bytes.", size);
+					++m_droppedCount;
+					continue;
+				}
+
+				if (!applyHeldTimeToMessageExpiry(message.options, Milliseconds{ ageMs }))
+				{
+					LOG_DEBUG("OfflineSpool", "Dropping expired offline publish, Topic: %s", message.topic.c_str());
+					++m_expiredCount;
+					continue;
+				}
+
+				outData = std::move(message);
+				return true;
+			}
+
+			return false;
+		}
+
+		void OfflineSpool::resetDrainBudget(TimePoint now) noexcept
+		{
+			m_drainTokens = static_cast<double>(std::max<std::uint32_t>(m_options.drainBurst, 1U));
+			m_lastDrainRefill = now;
+		}
+
+		void OfflineSpool::refillDrainTokens(TimePoint now) noexcept
+		{
+			const double elapsedSeconds{ std::chrono::duration<double>(now - m_lastDrainRefill).count() };
+			if (elapsedSeconds <= 0.0)
+			{
+				return;
+			}
+
+			const double burst{ static_cast<double>(std::max<std::uint32_t>(m_options.drainBurst, 1U)) };
+			m_drainTokens = std::min(burst, m_drainTokens + elapsedSeconds * m_options.drainMessagesPerSecond);
+			m_lastDrainRefill = now;
+		}
+
+		bool OfflineSpool::tryTakeDrainToken(TimePoint now) noexcept
+		{
+			if (m_options.drainMessagesPerSecond == 0U)
+			{
+				return true;
+			}
+
+			refillDrainTokens(now);
+
+			if (m_drainTokens < 1.0)
+			{
+				return false;
+			}
+
+			m_drainTokens -= 1.0;
+			return true;
+		}
+
+		TimePoint OfflineSpool::nextDrainTime(TimePoint now) const noexcept
+		{
+			if (m_options.drainMessagesPerSecond == 0U)
+			{
+				return now;
+			}
+
+			const double elapsedSeconds{ std::chrono::duration<double>(now - m_lastDrainRefill).count() };
+			const double tokens{ m_drainTokens + std::max(elapsedSeconds, 0.0) * m_options.drainMessagesPerSecond };
+			if (tokens >= 1.0)
+			{
+				return now;
+			}
+
+			const double waitSeconds{ (1.0 - tokens) / m_options.drainMessagesPerSecond };
+			return now + std::chrono::duration_cast<TimePoint::duration>(std::chrono::duration<double>(waitSeconds));
+		}
+
+#if defined(_WIN32)
+		bool OfflineSpool::openSpillFile(std::size_t capacity) noexcept
+		{
+			HANDLE file{ ::CreateFileA(m_options.spillFilePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+				FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr) };
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return false;
+			}
+
+			const std::uint64_t size{ capacity };
+			HANDLE mapping{ ::CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr) };
+			void* view{ mapping != nullptr ? ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity) : nullptr };
+
+			if (view == nullptr)
+			{
+				if (mapping != nullptr)
+				{
+					::CloseHandle(mapping);
+				}
+				::CloseHandle(file);
+				return false;
+			}
+
+			m_fileHandle = file;
+			m_mappingHandle = mapping;
+			m_mappedFile = static_cast<std::uint8_t*>(view);
+			m_mappedSize = capacity;
+			return true;
+		}
+
+		void OfflineSpool::closeSpillFile() noexcept
+		{
+			if (m_mappedFile != nullptr)
+			{
+				::UnmapViewOfFile(m_mappedFile);
+				::CloseHandle(m_mappingHandle);
+				::CloseHandle(m_fileHandle); //FILE_FLAG_DELETE_ON_CLOSE removes the file.
+			}
+
+			m_mappedFile = nullptr;
+			m_mappedSize = 0U;
+		}
+#else
+		bool OfflineSpool::openSpillFile(std::size_t capacity) noexcept
+		{
+			const int fd{ ::open(m_options.spillFilePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600) };
+			if (fd < 0)
+			{
+				return false;
+			}
+
+			if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+			{
+				::close(fd);
+				::unlink(m_options.spillFilePath.c_str());
+				return false;
+			}
+
+			void* view{ ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+			if (view == MAP_FAILED)
+			{
+				::close(fd);
+				::unlink(m_options.spillFilePath.c_str());
+				return false;
+			}
+
+			m_fileDescriptor = fd;
+			m_mappedFile = static_cast<std::uint8_t*>(view);
+			m_mappedSize = capacity;
+			return true;
+		}
+
+		void OfflineSpool::closeSpillFile() noexcept
+		{
+			if (m_mappedFile != nullptr)
+			{
+				::munmap(m_mappedFile, m_mappedSize);
+				::close(m_fileDescriptor);
+				::unlink(m_options.spillFilePath.c_str());
+			}
+
+			m_mappedFile = nullptr;
+			m_mappedSize = 0U;
+			m_fileDescriptor = -1;
+		}
+#endif
+	}
+}
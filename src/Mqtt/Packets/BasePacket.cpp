@@ -4,6 +4,7 @@
 // See LICENSE file in the project root for full license information.
 
 #include <kmMqtt/Mqtt/Packets/BasePacket.h>
+#include <kmMqtt/Logger/LogMacros.h>
 #include <kmMqtt/Interfaces/ILogger.h>
 #include <stdexcept>
 
@@ -102,7 +103,7 @@ namespace kmMqtt
 			//Minimum packet size is 2 bytes (1 byte for type and flags + minimum 1 byte for remaining length)
 			if (m_dataBuffer.size() < 2)
 			{
-				LogError("BasePacket", "Cannot decode packet with less than 2 bytes of data.");
+				LOG_ERROR("BasePacket", "Cannot decode packet with less than 2 bytes of data.");
 				result.code = DecodeErrorCode::MALFORMED_PACKET;
 				result.reason = "Received packet data is less than 2 bytes.";
 				return result;
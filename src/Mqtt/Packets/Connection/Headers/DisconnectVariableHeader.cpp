@@ -46,8 +46,19 @@ namespace kmMqtt
 		{
 			DecodeResult result;
 
+			//Remaining length 0 means NORMAL_DISCONNECTION, below 2 there is no property length (mqtt 5).
+			if (buffer.readHeadroom() == 0)
+			{
+				reasonCode = DisconnectReasonCode::NORMAL_DISCONNECTION;
+				return result;
+			}
+
 			reasonCode = static_cast<DisconnectReasonCode>(buffer.readUint8());
-			result = properties.decode(buffer);
+
+			if (buffer.readHeadroom() > 0)
+			{
+				result = properties.decode(buffer);
+			}
 
 			return result;
 		}
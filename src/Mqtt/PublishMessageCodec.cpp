@@ -0,0 +1,79 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/PublishMessageCodec.h"
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		void encodePublishMessageData(BinaryWriter& w, const PublishMessageData& data)
+		{
+			const PublishOptions& options{ data.options };
+
+			w.str(data.topic);
+			w.u32(static_cast<std::uint32_t>(data.payload.size()));
+			w.bytes(data.payload.bytes(), data.payload.size());
+			w.u8(static_cast<std::uint8_t>(options.qos));
+			w.u8(options.retain ? 1U : 0U);
+			w.u8(static_cast<std::uint8_t>(options.payloadFormatIndicator));
+			w.u8(options.addMessageExpiryInterval ? 1U : 0U);
+			w.u32(options.messageExpiryInterval);
+			w.u16(options.topicAlias);
+			w.str(options.responseTopic);
+			w.u8(options.correlationData != nullptr ? 1U : 0U);
+			if (options.correlationData != nullptr)
+			{
+				w.u16(options.correlationData->size());
+				w.bytes(options.correlationData->bytes(), options.correlationData->size());
+			}
+			w.u16(static_cast<std::uint16_t>(options.userProperties.size()));
+			for (const auto& property : options.userProperties)
+			{
+				w.str(property.first);
+				w.str(property.second);
+			}
+		}
+
+		bool decodePublishMessageData(BinaryReader& r, PublishMessageData& out)
+		{
+			out.topic = r.str();
+
+			const std::uint32_t payloadSize{ r.u32() };
+			const std::uint8_t* payload{ r.bytes(payloadSize) };
+			out.payload = ByteBuffer{ payloadSize };
+			if (payload != nullptr)
+			{
+				out.payload.append(payload, payloadSize);
+			}
+
+			PublishOptions& options{ out.options };
+			options.qos = static_cast<Qos>(r.u8());
+			options.retain = r.u8() != 0U;
+			options.payloadFormatIndicator = static_cast<PayloadFormatIndicator>(r.u8());
+			options.addMessageExpiryInterval = r.u8() != 0U;
+			options.messageExpiryInterval = r.u32();
+			options.topicAlias = r.u16();
+			options.responseTopic = r.str();
+			if (r.u8() != 0U)
+			{
+				const std::uint16_t correlationSize{ r.u16() };
+				const std::uint8_t* correlation{ r.bytes(correlationSize) };
+				if (correlation != nullptr)
+				{
+					options.correlationData = std::make_unique<BinaryData>(correlationSize, correlation);
+				}
+			}
+			const std::uint16_t propertyCount{ r.u16() };
+			for (std::uint16_t i = 0U; i < propertyCount && r.ok; ++i)
+			{
+				std::string key{ r.str() };
+				options.userProperties.emplace(std::move(key), r.str());
+			}
+
+			return r.ok;
+		}
+	}
+}
@@ -18,6 +18,7 @@ namespace kmMqtt
 
 			const auto id{ msg.data.packetID };
 
+			addMessageBytes(msg, true);
 			m_messageList.push_back(std::move(msg));
 			
 			auto iter = std::prev(m_messageList.end());
@@ -34,6 +35,7 @@ namespace kmMqtt
 			}
 
 			const auto iter{ m_packetIDToMessageMap[packetId] };
+			addMessageBytes(*iter, false);
 			m_messageList.erase(iter);
 			m_packetIDToMessageMap.erase(packetId);
 		}
@@ -73,6 +75,38 @@ namespace kmMqtt
 		{
 			m_messageList.clear();
 			m_packetIDToMessageMap.clear();
+			m_payloadBytes = 0U;
+			m_propertyBytes = 0U;
+		}
+
+		void MessageContainer::addMessageBytes(const MessageContainerData& msg, bool isAdded) noexcept
+		{
+			const PublishMessageData& publishMsgData{ msg.data.publishMsgData };
+			const PublishOptions& options{ publishMsgData.options };
+
+			const std::size_t payloadBytes{ publishMsgData.topic.size() + publishMsgData.payload.size() };
+
+			std::size_t propertyBytes{ options.responseTopic.size() };
+			if (options.correlationData != nullptr)
+			{
+				propertyBytes += options.correlationData->size();
+			}
+
+			for (const auto& userProperty : options.userProperties)
+			{
+				propertyBytes += userProperty.first.size() + userProperty.second.size();
+			}
+
+			if (isAdded)
+			{
+				m_payloadBytes += payloadBytes;
+				m_propertyBytes += propertyBytes;
+			}
+			else
+			{
+				m_payloadBytes -= payloadBytes;
+				m_propertyBytes -= propertyBytes;
+			}
 		}
 	}
 }
@@ -4,6 +4,7 @@
 // See LICENSE file in the project root for full license information.
 
 #include <kmMqtt/Mqtt/State/SessionState/SessionState.h>
+#include <kmMqtt/Logger/LogMacros.h>
 #include <kmMqtt/Mqtt/Enums/ClientErrorCode.h>
 
 namespace kmMqtt
@@ -12,10 +13,11 @@ namespace kmMqtt
 	{
 		SessionState::SessionState(const char* clientId,
 			std::uint32_t sessionExpiryInterval,
-			std::uint32_t retryInterval) noexcept :
+			std::uint32_t retryInterval,
+			std::shared_ptr<ISessionStatePersistantStore> persistantStore) noexcept :
 			m_clientId{ clientId },
 			m_retryInterval{ Milliseconds(retryInterval)},
-			m_persistantStore{ nullptr }, //TODO: Add persistant store parameter later.
+			m_persistantStore{ std::move(persistantStore) },
 			m_sessionExpiryInterval{ Milliseconds(sessionExpiryInterval)}
 		{
 		}
@@ -55,7 +57,27 @@ namespace kmMqtt
 			{
 				if (!m_messages.contains(msgData.data.packetID))
 				{
-					ClientErrorCode err{ addPrevStateMessage(msgData.data.packetID, msgData.data.publishMsgData) };
+					ClientErrorCode err{ addPrevStateMessage(msgData.data) };
+
+					if (err != ClientErrorCode::No_Error)
+					{
+						return err;
+					}
+				}
+			}
+
+			return ClientErrorCode{ ClientErrorCode::No_Error };
+		}
+
+		ClientErrorCode SessionState::restoreSavedMessages(const std::vector<SavedData>& savedData) noexcept
+		{
+			LockGuard guard{ m_mutex };
+
+			for (const auto& data : savedData)
+			{
+				if (!m_messages.contains(data.packetID))
+				{
+					ClientErrorCode err{ addPrevStateMessage(data) };
 
 					if (err != ClientErrorCode::No_Error)
 					{
@@ -75,16 +97,17 @@ namespace kmMqtt
 			{
 				LockGuard guard{ m_mutex };
 
-				//TODO: Persistant Storage - needs rethink to work async. Commented out until future implementation.
-				/*if (m_persistantStore != nullptr)
+				if (m_persistantStore != nullptr)
 				{
 					if (!m_persistantStore->write(m_clientId, static_cast<std::uint32_t>(m_sessionExpiryInterval.count()), data.data))
 					{
-						LogError("SessionState", "Failed to write to session state message to persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
+						LOG_ERROR("SessionState", "Failed to write to session state message to persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
 					}
-
-					LogTrace("SessionState", "Session state message written to persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
-				}*/
+					else
+					{
+						LOG_TRACE("SessionState", "Session state message written to persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
+					}
+				}
 
 				m_messages.push(std::move(data));
 			}
@@ -92,22 +115,13 @@ namespace kmMqtt
 			return ClientErrorCode::No_Error;
 		}
 
-		ClientErrorCode SessionState::addPrevStateMessage(const std::uint16_t packetId, const PublishMessageData& publishMsgData) noexcept
+		ClientErrorCode SessionState::addPrevStateMessage(const SavedData& savedData) noexcept
 		{
 			//std::chrono::steady_clock::now() to Retry ASAP when restoring previous session state messages.
-			MessageContainerData data{ packetId, std::move(publishMsgData), std::chrono::steady_clock::now(), true };
-
-			//TODO: Persistant Storage - needs rethink to work async. Commented out until future implementation.
-			/*if (m_persistantStore != nullptr)
-			{
-				if (!m_persistantStore->write(m_clientId, static_cast<std::uint32_t>(m_sessionExpiryInterval.count()), data.data))
-				{
-					LogWarning("SessionState", "Failed to write to previous session state message to persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
-				}
-
-				LogTrace("SessionState", "Previous session state message written to persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
-			}*/
+			MessageContainerData data{ savedData.packetID, savedData.publishMsgData, std::chrono::steady_clock::now(), true };
+			data.data.status = savedData.status;
 
+			//Previous session messages are already in the persistant store under the same client ID, no need to write them again.
 			m_messages.push(std::move(data));
 
 			return ClientErrorCode::No_Error;
@@ -121,7 +135,7 @@ namespace kmMqtt
 				auto iter{ *(m_messages.get(packetId)) };
 				if (iter == m_messages.end())
 				{
-					LogWarning("SessionState", "Failed to update message, Packet ID: %d not found in session state", packetId);
+					LOG_WARNING("SessionState", "Failed to update message, Packet ID: %d not found in session state", packetId);
 					return;
 				}
 
@@ -132,16 +146,19 @@ namespace kmMqtt
 					return;
 				}
 
+				const bool bringToFront{ shouldBringToFront(iter->data.status, newStatus) };
+
 				iter->data.status = newStatus;
 
-				const bool bringToFront{ shouldBringToFront(iter->data.status, newStatus) };
 				if (bringToFront)
 				{
 					m_messages.moveToEnd(packetId);
 				}
 
-				//TODO: Persistant Storage - needs rethink to work async. Commented out until future implementation.
-				//m_persistantStore->updateMessage(m_clientId, packetId, newStatus, bringToFront);
+				if (m_persistantStore != nullptr && !m_persistantStore->updateMessage(m_clientId, packetId, newStatus, bringToFront))
+				{
+					LOG_WARNING("SessionState", "Failed to update session state message in persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
+				}
 			}
 		}
 		
@@ -152,19 +169,32 @@ namespace kmMqtt
 
 				m_messages.erase(packetId);
 
-				//TODO: Persistant Storage - needs rethink to work async. Commented out until future implementation.
-				/*if (m_persistantStore != nullptr)
+				if (m_persistantStore != nullptr)
 				{
 					if (!m_persistantStore->removeMessage(m_clientId, packetId))
 					{
-						LogWarning("SessionState", "Failed to remove session state message from persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
+						LOG_WARNING("SessionState", "Failed to remove session state message from persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
 					}
-
-					LogTrace("SessionState", "Session state message removed from persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
-				}*/
+					else
+					{
+						LOG_TRACE("SessionState", "Session state message removed from persistant storage, Client ID: %s, Packet ID: %d", m_clientId, packetId);
+					}
+				}
 			}
 		}
 
+		std::size_t SessionState::getPayloadBytes() const noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_messages.getPayloadBytes();
+		}
+
+		std::size_t SessionState::getPropertyBytes() const noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_messages.getPropertyBytes();
+		}
+
 		void SessionState::clear() noexcept
 		{
 			{
@@ -172,16 +202,17 @@ namespace kmMqtt
 
 				m_messages.clear();
 
-				//TODO: Persistant Storage - needs rethink to work async. Commented out until future implementation.
-				/*if (m_persistantStore != nullptr)
+				if (m_persistantStore != nullptr)
 				{
 					if (!m_persistantStore->removeFromStore(m_clientId))
 					{
-						LogWarning("SessionState", "Failed to clear session state messages from persistant storage, Client ID: %s", m_clientId);
+						LOG_WARNING("SessionState", "Failed to clear session state messages from persistant storage, Client ID: %s", m_clientId);
 					}
-
-					LogTrace("SessionState", "Session state messages cleared from persistant storage, Client ID: %s", m_clientId);
-				}*/
+					else
+					{
+						LOG_TRACE("SessionState", "Session state messages cleared from persistant storage, Client ID: %s", m_clientId);
+					}
+				}
 			}
 		}
 
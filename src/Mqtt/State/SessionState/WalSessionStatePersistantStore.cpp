@@ -0,0 +1,1211 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/State/SessionState/WalSessionStatePersistantStore.h"
+#include "kmMqtt/Logger/LogMacros.h"
+#include "kmMqtt/Mqtt/PublishMessageCodec.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		namespace
+		{
+			//Record frame: [u32 body length][u32 crc32 of body][body]. Body starts with: [u8 type][i64 unix time][u16 packet id].
+			constexpr std::size_t k_frameHeaderSize{ 8U };
+			constexpr std::size_t k_maxRecordBodySize{ 512U * 1024U * 1024U };
+			constexpr std::uint32_t k_sessionNeverExpires{ 0xFFFFFFFFU };
+			constexpr const char* k_segmentExtension{ ".wal" };
+
+			enum class RecordType : std::uint8_t
+			{
+				WRITE = 1U,
+				UPDATE = 2U,
+				REMOVE = 3U,
+			};
+
+			std::uint32_t crc32(const std::uint8_t* data, std::size_t size) noexcept
+			{
+				static const auto table = []()
+				{
+					std::uint32_t t[256];
+					for (std::uint32_t i = 0U; i < 256U; ++i)
+					{
+						std::uint32_t c{ i };
+						for (int k = 0; k < 8; ++k)
+						{
+							c = (c & 1U) != 0U ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+						}
+						t[i] = c;
+					}
+
+					std::vector<std::uint32_t> v(t, t + 256);
+					return v;
+				}();
+
+				std::uint32_t crc{ 0xFFFFFFFFU };
+				for (std::size_t i = 0U; i < size; ++i)
+				{
+					crc = table[(crc ^ data[i]) & 0xFFU] ^ (crc >> 8);
+				}
+
+				return crc ^ 0xFFFFFFFFU;
+			}
+
+			std::int64_t unixTimeSeconds() noexcept
+			{
+				return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			}
+
+			void encodeHeader(BinaryWriter& w, RecordType type, std::uint16_t packetId, std::int64_t time)
+			{
+				w.u8(static_cast<std::uint8_t>(type));
+				w.i64(time);
+				w.u16(packetId);
+			}
+
+			void encodeWriteBody(BinaryWriter& w, std::uint32_t sessionExpiryInterval, const SavedData& data)
+			{
+				w.u32(sessionExpiryInterval);
+				w.u8(static_cast<std::uint8_t>(data.status));
+				encodePublishMessageData(w, data.publishMsgData);
+			}
+
+			bool decodeWriteBody(BinaryReader& r, std::uint16_t packetId, SavedData& out)
+			{
+				r.u32(); //Session expiry interval, only needed by the index.
+				out.packetID = packetId;
+				out.status = static_cast<PublishMessageStatus>(r.u8());
+				return decodePublishMessageData(r, out.publishMsgData);
+			}
+
+			std::vector<std::uint8_t> frameRecord(const std::vector<std::uint8_t>& body)
+			{
+				std::vector<std::uint8_t> frame;
+				frame.reserve(k_frameHeaderSize + body.size());
+
+				BinaryWriter w{ frame };
+				w.u32(static_cast<std::uint32_t>(body.size()));
+				w.u32(crc32(body.data(), body.size()));
+				w.bytes(body.data(), body.size());
+
+				return frame;
+			}
+
+			std::string toHex(const std::string& value)
+			{
+				static constexpr const char* digits{ "0123456789abcdef" };
+
+				std::string hex;
+				hex.reserve(value.size() * 2U);
+				for (const unsigned char c : value)
+				{
+					hex += digits[c >> 4];
+					hex += digits[c & 0x0FU];
+				}
+
+				return hex;
+			}
+
+			bool fromHex(const std::string& hex, std::string& outValue)
+			{
+				if (hex.size() % 2U != 0U)
+				{
+					return false;
+				}
+
+				auto nibble = [](char c) -> int
+				{
+					if (c >= '0' && c <= '9') return c - '0';
+					if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+					return -1;
+				};
+
+				outValue.clear();
+				for (std::size_t i = 0U; i < hex.size(); i += 2U)
+				{
+					const int hi{ nibble(hex[i]) };
+					const int lo{ nibble(hex[i + 1U]) };
+					if (hi < 0 || lo < 0)
+					{
+						return false;
+					}
+					outValue += static_cast<char>((hi << 4) | lo);
+				}
+
+				return true;
+			}
+
+			//Segment files are named "<hex client id>-<8 hex digit index>.wal", the hex client id is empty for an empty client id.
+			std::string segmentFileName(const std::string& prefix, std::uint32_t index)
+			{
+				char indexStr[9];
+				std::snprintf(indexStr, sizeof(indexStr), "%08x", index);
+				return prefix + "-" + indexStr + k_segmentExtension;
+			}
+
+			bool parseSegmentFileName(const std::string& fileName, std::string& outPrefix, std::uint32_t& outIndex)
+			{
+				const std::size_t extensionSize{ std::strlen(k_segmentExtension) };
+				if (fileName.size() < 9U + extensionSize || fileName.compare(fileName.size() - extensionSize, extensionSize, k_segmentExtension) != 0)
+				{
+					return false;
+				}
+
+				const std::size_t dash{ fileName.size() - extensionSize - 9U };
+				if (fileName[dash] != '-')
+				{
+					return false;
+				}
+
+				std::string clientId;
+				outPrefix = fileName.substr(0U, dash);
+				if (!fromHex(outPrefix, clientId))
+				{
+					return false;
+				}
+
+				const std::string indexStr{ fileName.substr(dash + 1U, 8U) };
+				char* end{ nullptr };
+				const unsigned long index{ std::strtoul(indexStr.c_str(), &end, 16) };
+				if (end == nullptr || *end != '\0')
+				{
+					return false;
+				}
+
+				outIndex = static_cast<std::uint32_t>(index);
+				return true;
+			}
+
+			//Thin portable layer over the few file operations the log needs.
+			namespace file
+			{
+#if defined(_WIN32)
+				int openAppend(const std::string& path) { return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE); }
+				int openRead(const std::string& path) { return ::_open(path.c_str(), _O_RDONLY | _O_BINARY); }
+				void close(int fd) { ::_close(fd); }
+				bool sync(int fd) { return ::_commit(fd) == 0; }
+				bool truncate(int fd, std::uint64_t size) { return ::_chsize_s(fd, static_cast<long long>(size)) == 0; }
+				bool remove(const std::string& path) { return ::_unlink(path.c_str()) == 0; }
+				bool exists(const std::string& path) { struct _stat info; return ::_stat(path.c_str(), &info) == 0; }
+				void makeDirectory(const std::string& path) { ::_mkdir(path.c_str()); }
+				void syncDirectory(const std::string&) {}
+
+				std::int64_t size(int fd)
+				{
+					return ::_lseeki64(fd, 0, SEEK_END);
+				}
+
+				bool readAt(int fd, std::uint64_t offset, std::uint8_t* out, std::size_t size)
+				{
+					if (::_lseeki64(fd, static_cast<long long>(offset), SEEK_SET) < 0)
+					{
+						return false;
+					}
+
+					std::size_t done{ 0U };
+					while (done < size)
+					{
+						const int n{ ::_read(fd, out + done, static_cast<unsigned int>(size - done)) };
+						if (n <= 0)
+						{
+							return false;
+						}
+						done += static_cast<std::size_t>(n);
+					}
+
+					return true;
+				}
+
+				bool writeAll(int fd, const std::uint8_t* data, std::size_t size)
+				{
+					std::size_t done{ 0U };
+					while (done < size)
+					{
+						const int n{ ::_write(fd, data + done, static_cast<unsigned int>(size - done)) };
+						if (n <= 0)
+						{
+							return false;
+						}
+						done += static_cast<std::size_t>(n);
+					}
+
+					return true;
+				}
+
+				void list(const std::string& directory, std::vector<std::string>& outNames)
+				{
+					WIN32_FIND_DATAA findData;
+					HANDLE handle{ ::FindFirstFileA((directory + "\\*").c_str(), &findData) };
+					if (handle == INVALID_HANDLE_VALUE)
+					{
+						return;
+					}
+
+					do
+					{
+						outNames.emplace_back(findData.cFileName);
+					} while (::FindNextFileA(handle, &findData));
+
+					::FindClose(handle);
+				}
+#else
+				int openAppend(const std::string& path) { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644); }
+				int openRead(const std::string& path) { return ::open(path.c_str(), O_RDONLY | O_CLOEXEC); }
+				void close(int fd) { ::close(fd); }
+				bool truncate(int fd, std::uint64_t size) { return ::ftruncate(fd, static_cast<off_t>(size)) == 0; }
+				bool remove(const std::string& path) { return ::unlink(path.c_str()) == 0; }
+				bool exists(const std::string& path) { struct stat info; return ::stat(path.c_str(), &info) == 0; }
+				void makeDirectory(const std::string& path) { ::mkdir(path.c_str(), 0755); }
+
+				bool sync(int fd)
+				{
+#if defined(__APPLE__)
+					return ::fsync(fd) == 0;
+#else
+					return ::fdatasync(fd) == 0;
+#endif
+				}
+
+				void syncDirectory(const std::string& directory)
+				{
+					//Makes creation and removal of segment files durable.
+					const int fd{ ::open(directory.c_str(), O_RDONLY | O_CLOEXEC) };
+					if (fd >= 0)
+					{
+						::fsync(fd);
+						::close(fd);
+					}
+				}
+
+				std::int64_t size(int fd)
+				{
+					struct stat st;
+					return ::fstat(fd, &st) == 0 ? static_cast<std::int64_t>(st.st_size) : -1;
+				}
+
+				bool readAt(int fd, std::uint64_t offset, std::uint8_t* out, std::size_t size)
+				{
+					std::size_t done{ 0U };
+					while (done < size)
+					{
+						const ssize_t n{ ::pread(fd, out + done, size - done, static_cast<off_t>(offset + done)) };
+						if (n <= 0)
+						{
+							return false;
+						}
+						done += static_cast<std::size_t>(n);
+					}
+
+					return true;
+				}
+
+				bool writeAll(int fd, const std::uint8_t* data, std::size_t size)
+				{
+					std::size_t done{ 0U };
+					while (done < size)
+					{
+						const ssize_t n{ ::write(fd, data + done, size - done) };
+						if (n <= 0)
+						{
+							return false;
+						}
+						done += static_cast<std::size_t>(n);
+					}
+
+					return true;
+				}
+
+				void list(const std::string& directory, std::vector<std::string>& outNames)
+				{
+					DIR* dir{ ::opendir(directory.c_str()) };
+					if (dir == nullptr)
+					{
+						return;
+					}
+
+					while (const dirent* entry = ::readdir(dir))
+					{
+						outNames.emplace_back(entry->d_name);
+					}
+
+					::closedir(dir);
+				}
+#endif
+			}
+		}
+
+		struct WalSessionStatePersistantStore::ClientLog
+		{
+			struct LiveRecord
+			{
+				std::uint32_t segment{ 0U };
+				std::uint64_t offset{ 0U };
+				std::uint32_t size{ 0U };
+				PublishMessageStatus status{ PublishMessageStatus::WaitingForAck };
+				std::list<std::uint16_t>::iterator orderIter;
+			};
+
+			std::mutex mutex;
+			std::string clientId;
+			std::string prefix;
+
+			std::vector<std::uint32_t> segments; //Segment indices on disk (or about to be), ascending. Last one is active.
+			int activeFd{ -1 };
+			std::uint64_t activeSize{ 0U }; //Bytes written to the active segment.
+			std::vector<std::uint8_t> pending; //Framed records not yet written to the active segment.
+
+			std::list<std::uint16_t> order;
+			std::unordered_map<std::uint16_t, LiveRecord> live;
+			std::uint64_t totalBytes{ 0U };
+			std::uint64_t liveBytes{ 0U };
+
+			std::uint32_t sessionExpiryInterval{ 0U };
+			std::int64_t lastRecordTime{ 0 };
+
+			std::string segmentPath(const std::string& directory, std::uint32_t index) const
+			{
+				return directory + "/" + segmentFileName(prefix, index);
+			}
+
+			void closeActive()
+			{
+				if (activeFd >= 0)
+				{
+					file::close(activeFd);
+					activeFd = -1;
+				}
+			}
+
+			//Apply a record to the live index. Body must have passed the checksum.
+			bool apply(const std::uint8_t* body, std::size_t bodySize, std::uint32_t segment, std::uint64_t offset, std::uint32_t frameSize)
+			{
+				BinaryReader r{ body, bodySize };
+				const RecordType type{ static_cast<RecordType>(r.u8()) };
+				const std::int64_t time{ r.i64() };
+				const std::uint16_t packetId{ r.u16() };
+
+				if (!r.ok)
+				{
+					return false;
+				}
+
+				lastRecordTime = std::max(lastRecordTime, time);
+				totalBytes += frameSize;
+
+				auto iter{ live.find(packetId) };
+
+				switch (type)
+				{
+				case RecordType::WRITE:
+				{
+					sessionExpiryInterval = r.u32();
+					const PublishMessageStatus status{ static_cast<PublishMessageStatus>(r.u8()) };
+
+					if (iter != live.end())
+					{
+						liveBytes -= iter->second.size;
+						order.erase(iter->second.orderIter);
+						live.erase(iter);
+					}
+
+					order.push_back(packetId);
+					live[packetId] = LiveRecord{ segment, offset, frameSize, status, std::prev(order.end()) };
+					liveBytes += frameSize;
+					return r.ok;
+				}
+				case RecordType::UPDATE:
+				{
+					const PublishMessageStatus status{ static_cast<PublishMessageStatus>(r.u8()) };
+					const bool bringToEnd{ r.u8() != 0U };
+
+					if (iter != live.end())
+					{
+						iter->second.status = status;
+
+						if (bringToEnd)
+						{
+							order.splice(order.end(), order, iter->second.orderIter);
+						}
+					}
+					return r.ok;
+				}
+				case RecordType::REMOVE:
+				{
+					if (iter != live.end())
+					{
+						liveBytes -= iter->second.size;
+						order.erase(iter->second.orderIter);
+						live.erase(iter);
+					}
+					return true;
+				}
+				default:
+					return false;
+				}
+			}
+		};
+
+		WalSessionStatePersistantStore::WalSessionStatePersistantStore(const WalSessionStoreOptions& options)
+			: m_options(options)
+		{
+			if (m_options.directory.empty())
+			{
+				m_options.directory = ".";
+			}
+
+			file::makeDirectory(m_options.directory);
+
+			m_commitThread = std::thread(&WalSessionStatePersistantStore::commitLoop, this);
+		}
+
+		WalSessionStatePersistantStore::~WalSessionStatePersistantStore()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_commitMutex };
+				m_isStopping = true;
+			}
+			m_commitCondition.notify_all();
+
+			if (m_commitThread.joinable())
+			{
+				m_commitThread.join();
+			}
+
+			for (auto& entry : m_logs)
+			{
+				std::lock_guard<std::mutex> lock{ entry.second->mutex };
+				commitLog(*entry.second);
+				entry.second->closeActive();
+			}
+		}
+
+		bool WalSessionStatePersistantStore::initialize(const char* clientId)
+		{
+			return getOrOpenLog(clientId) != nullptr;
+		}
+
+		bool WalSessionStatePersistantStore::write(const char* clientId, uint32_t sessionExpiryInterval, const SavedData& data)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return false;
+			}
+
+			std::vector<std::uint8_t> body;
+			body.reserve(64U + data.publishMsgData.topic.size() + data.publishMsgData.payload.size());
+
+			BinaryWriter w{ body };
+			encodeHeader(w, RecordType::WRITE, data.packetID, unixTimeSeconds());
+			encodeWriteBody(w, sessionExpiryInterval, data);
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+			return appendRecord(*log, body);
+		}
+
+		bool WalSessionStatePersistantStore::readAll(const char* clientId, std::vector<SavedData>& outData)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+
+			if (!commitLog(*log))
+			{
+				return false;
+			}
+
+			std::map<std::uint32_t, int> readFds;
+			std::vector<std::uint8_t> frame;
+			bool success{ true };
+
+			outData.reserve(outData.size() + log->live.size());
+
+			for (const std::uint16_t packetId : log->order)
+			{
+				const auto& record{ log->live[packetId] };
+
+				//Opened once per segment, a failed open stays -1 so the segment is not retried. 0 is a valid descriptor.
+				auto fdIt{ readFds.find(record.segment) };
+				if (fdIt == readFds.end())
+				{
+					fdIt = readFds.emplace(record.segment, file::openRead(log->segmentPath(m_options.directory, record.segment))).first;
+				}
+
+				const int fd{ fdIt->second };
+
+				frame.resize(record.size);
+				if (fd < 0 || !file::readAt(fd, record.offset, frame.data(), frame.size()))
+				{
+					LOG_ERROR("WalSessionStore", "Failed to read record for packet ID %d of client: %s", packetId, clientId);
+					success = false;
+					continue;
+				}
+
+				BinaryReader r{ frame.data() + k_frameHeaderSize, frame.size() - k_frameHeaderSize };
+				r.u8();
+				r.i64();
+				r.u16();
+
+				SavedData data;
+				if (!decodeWriteBody(r, packetId, data))
+				{
+					LOG_ERROR("WalSessionStore", "Failed to decode record for packet ID %d of client: %s", packetId, clientId);
+					success = false;
+					continue;
+				}
+
+				data.status = record.status;
+				outData.push_back(std::move(data));
+			}
+
+			for (const auto& entry : readFds)
+			{
+				if (entry.second >= 0)
+				{
+					file::close(entry.second);
+				}
+			}
+
+			return success;
+		}
+
+		bool WalSessionStatePersistantStore::removeMessage(const char* clientId, std::uint16_t packetId)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return false;
+			}
+
+			std::vector<std::uint8_t> body;
+			BinaryWriter w{ body };
+			encodeHeader(w, RecordType::REMOVE, packetId, unixTimeSeconds());
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+
+			if (log->live.find(packetId) == log->live.end())
+			{
+				return true; //Nothing to remove, no need to log it.
+			}
+
+			return appendRecord(*log, body);
+		}
+
+		bool WalSessionStatePersistantStore::updateMessage(const char* clientId, std::uint16_t packetId, PublishMessageStatus newStatus, bool bringToEnd)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return false;
+			}
+
+			std::vector<std::uint8_t> body;
+			BinaryWriter w{ body };
+			encodeHeader(w, RecordType::UPDATE, packetId, unixTimeSeconds());
+			w.u8(static_cast<std::uint8_t>(newStatus));
+			w.u8(bringToEnd ? 1U : 0U);
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+
+			if (log->live.find(packetId) == log->live.end())
+			{
+				return false;
+			}
+
+			return appendRecord(*log, body);
+		}
+
+		bool WalSessionStatePersistantStore::removeFromStore(const char* clientId)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+
+			log->closeActive();
+
+			bool success{ true };
+			for (const std::uint32_t segment : log->segments)
+			{
+				const std::string path{ log->segmentPath(m_options.directory, segment) };
+				if (!file::remove(path) && file::exists(path))
+				{
+					LOG_ERROR("WalSessionStore", "Failed to remove segment file: %s", path.c_str());
+					success = false;
+				}
+			}
+
+			file::syncDirectory(m_options.directory);
+
+			log->segments.clear();
+			log->activeSize = 0U;
+			log->pending.clear();
+			log->order.clear();
+			log->live.clear();
+			log->totalBytes = 0U;
+			log->liveBytes = 0U;
+
+			return success;
+		}
+
+		bool WalSessionStatePersistantStore::removeExpiredFromStore()
+		{
+			std::vector<std::string> names;
+			file::list(m_options.directory, names);
+
+			std::vector<std::string> clientIds;
+			for (const auto& name : names)
+			{
+				std::string prefix;
+				std::uint32_t index{ 0U };
+				std::string clientId;
+
+				if (parseSegmentFileName(name, prefix, index) && fromHex(prefix, clientId) &&
+					std::find(clientIds.begin(), clientIds.end(), clientId) == clientIds.end())
+				{
+					clientIds.push_back(std::move(clientId));
+				}
+			}
+
+			const std::int64_t now{ unixTimeSeconds() };
+			bool success{ true };
+
+			for (const auto& clientId : clientIds)
+			{
+				ClientLog* log{ getOrOpenLog(clientId) };
+				if (log == nullptr)
+				{
+					success = false;
+					continue;
+				}
+
+				bool isExpired{ false };
+				{
+					std::lock_guard<std::mutex> lock{ log->mutex };
+					isExpired = log->live.empty() ||
+						(log->sessionExpiryInterval != k_sessionNeverExpires && now >= log->lastRecordTime + log->sessionExpiryInterval);
+				}
+
+				if (isExpired)
+				{
+					LOG_DEBUG("WalSessionStore", "Removing expired session state of client: %s", clientId.c_str());
+					success = removeFromStore(clientId.c_str()) && success;
+				}
+			}
+
+			return success;
+		}
+
+		bool WalSessionStatePersistantStore::flush()
+		{
+			std::unique_lock<std::mutex> lock{ m_commitMutex };
+
+			const std::uint64_t target{ m_appendedSequence };
+			m_flushRequested = true;
+			m_commitCondition.notify_all();
+
+			//A failed commit is retried, waiting for the retry to succeed could block forever on a failing disk.
+			m_durableCondition.wait(lock, [this, target]() { return m_durableSequence >= target || m_failedSequence >= target || m_isStopping; });
+
+			return m_durableSequence >= target;
+		}
+
+		void WalSessionStatePersistantStore::notifyWhenDurable(DurableCallback callback)
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_commitMutex };
+
+				const std::uint64_t target{ m_appendedSequence };
+				if (target > m_durableSequence || !m_durableCallbacks.empty())
+				{
+					m_durableCallbacks.emplace_back(target, std::move(callback));
+					return;
+				}
+			}
+
+			callback(true);
+		}
+
+		bool WalSessionStatePersistantStore::compact(const char* clientId)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+			return compactLog(*log);
+		}
+
+		std::size_t WalSessionStatePersistantStore::getSegmentCount(const char* clientId)
+		{
+			ClientLog* log{ getOrOpenLog(clientId) };
+			if (log == nullptr)
+			{
+				return 0U;
+			}
+
+			std::lock_guard<std::mutex> lock{ log->mutex };
+			return log->segments.size();
+		}
+
+		WalSessionStatePersistantStore::ClientLog* WalSessionStatePersistantStore::getOrOpenLog(const std::string& clientId)
+		{
+			std::lock_guard<std::mutex> logsLock{ m_logsMutex };
+
+			auto iter{ m_logs.find(clientId) };
+			if (iter != m_logs.end())
+			{
+				return iter->second.get();
+			}
+
+			std::unique_ptr<ClientLog> log{ new ClientLog() };
+			log->clientId = clientId;
+			log->prefix = toHex(clientId);
+
+			//Find this client's segments.
+			std::vector<std::string> names;
+			file::list(m_options.directory, names);
+
+			for (const auto& name : names)
+			{
+				std::string prefix;
+				std::uint32_t index{ 0U };
+
+				if (parseSegmentFileName(name, prefix, index) && prefix == log->prefix)
+				{
+					log->segments.push_back(index);
+				}
+			}
+
+			std::sort(log->segments.begin(), log->segments.end());
+
+			//Replay segments in order to rebuild the live index.
+			std::vector<std::uint8_t> content;
+
+			for (std::size_t i = 0U; i < log->segments.size(); ++i)
+			{
+				const std::uint32_t segment{ log->segments[i] };
+				const bool isLastSegment{ i + 1U == log->segments.size() };
+				const std::string path{ log->segmentPath(m_options.directory, segment) };
+
+				const int fd{ file::openRead(path) };
+				const std::int64_t size{ fd >= 0 ? file::size(fd) : -1 };
+
+				if (size < 0)
+				{
+					LOG_ERROR("WalSessionStore", "Failed to open segment file: %s", path.c_str());
+					if (fd >= 0)
+					{
+						file::close(fd);
+					}
+					continue;
+				}
+
+				content.resize(static_cast<std::size_t>(size));
+				const bool isRead{ content.empty() || file::readAt(fd, 0U, content.data(), content.size()) };
+				file::close(fd);
+
+				if (!isRead)
+				{
+					LOG_ERROR("WalSessionStore", "Failed to read segment file: %s", path.c_str());
+					continue;
+				}
+
+				std::size_t offset{ 0U };
+				while (offset < content.size())
+				{
+					BinaryReader header{ content.data() + offset, content.size() - offset };
+					const std::uint32_t bodySize{ header.u32() };
+					const std::uint32_t checksum{ header.u32() };
+
+					if (!header.ok || bodySize > k_maxRecordBodySize || bodySize > content.size() - offset - k_frameHeaderSize)
+					{
+						break;
+					}
+
+					const std::uint8_t* body{ content.data() + offset + k_frameHeaderSize };
+					const std::uint32_t frameSize{ static_cast<std::uint32_t>(k_frameHeaderSize + bodySize) };
+
+					if (crc32(body, bodySize) != checksum || !log->apply(body, bodySize, segment, offset, frameSize))
+					{
+						break;
+					}
+
+					offset += frameSize;
+				}
+
+				if (offset < content.size())
+				{
+					if (isLastSegment)
+					{
+						//Torn write from a crash mid-commit, drop the partial tail so new records follow valid ones.
+						LOG_WARNING("WalSessionStore", "Truncating %d bytes of incomplete records at the end of segment: %s", content.size() - offset, path.c_str());
+
+						const int truncateFd{ file::openAppend(path) };
+						if (truncateFd < 0 || !file::truncate(truncateFd, offset) || !file::sync(truncateFd))
+						{
+							LOG_ERROR("WalSessionStore", "Failed to truncate segment file: %s", path.c_str());
+						}
+						if (truncateFd >= 0)
+						{
+							file::close(truncateFd);
+						}
+					}
+					else
+					{
+						LOG_ERROR("WalSessionStore", "Corrupt record in sealed segment %s at offset %d, skipping rest of segment.", path.c_str(), offset);
+					}
+				}
+
+				if (isLastSegment)
+				{
+					log->activeSize = offset;
+				}
+			}
+
+			LOG_DEBUG("WalSessionStore", "Opened session state log of client: %s, Segments: %d, Live messages: %d",
+				clientId.c_str(), log->segments.size(), log->live.size());
+
+			ClientLog* logPtr{ log.get() };
+			m_logs.emplace(clientId, std::move(log));
+			return logPtr;
+		}
+
+		bool WalSessionStatePersistantStore::appendRecord(ClientLog& log, const std::vector<std::uint8_t>& body)
+		{
+			std::vector<std::uint8_t> frame{ frameRecord(body) };
+
+			const std::uint64_t activeBytes{ log.activeSize + log.pending.size() };
+			const bool needsRotation{ activeBytes > 0U && activeBytes + frame.size() > m_options.segmentMaxBytes };
+
+			if (log.segments.empty() || needsRotation)
+			{
+				if (needsRotation && !commitLog(log))
+				{
+					return false;
+				}
+
+				log.closeActive();
+				log.segments.push_back(log.segments.empty() ? 1U : log.segments.back() + 1U);
+				log.activeSize = 0U;
+			}
+
+			const std::uint64_t offset{ log.activeSize + log.pending.size() };
+			if (!log.apply(body.data(), body.size(), log.segments.back(), offset, static_cast<std::uint32_t>(frame.size())))
+			{
+				return false;
+			}
+
+			log.pending.insert(log.pending.end(), frame.begin(), frame.end());
+
+			{
+				std::lock_guard<std::mutex> lock{ m_commitMutex };
+
+				if (m_pendingBytes == 0U)
+				{
+					m_firstPendingTime = std::chrono::steady_clock::now();
+				}
+
+				++m_appendedSequence;
+				m_pendingBytes += frame.size();
+
+				if (m_commitFailed)
+				{
+					return false;
+				}
+			}
+
+			m_commitCondition.notify_one();
+			return true;
+		}
+
+		bool WalSessionStatePersistantStore::commitLog(ClientLog& log)
+		{
+			if (log.pending.empty())
+			{
+				return true;
+			}
+
+			if (log.activeFd < 0)
+			{
+				const std::string path{ log.segmentPath(m_options.directory, log.segments.back()) };
+				log.activeFd = file::openAppend(path);
+
+				if (log.activeFd < 0)
+				{
+					LOG_ERROR("WalSessionStore", "Failed to open segment file for writing: %s", path.c_str());
+					return false;
+				}
+
+				file::syncDirectory(m_options.directory);
+			}
+
+			if (!file::writeAll(log.activeFd, log.pending.data(), log.pending.size()) || !file::sync(log.activeFd))
+			{
+				LOG_ERROR("WalSessionStore", "Failed to write %d bytes to session state log of client: %s", log.pending.size(), log.clientId.c_str());
+
+				//Drop anything partially written so the records can be retried on the next commit.
+				file::truncate(log.activeFd, log.activeSize);
+				return false;
+			}
+
+			log.activeSize += log.pending.size();
+			log.pending.clear();
+
+			return true;
+		}
+
+		bool WalSessionStatePersistantStore::compactLog(ClientLog& log)
+		{
+			if (log.segments.empty() || !commitLog(log))
+			{
+				return false;
+			}
+
+			const std::uint32_t newSegment{ log.segments.back() + 1U };
+			const std::int64_t now{ unixTimeSeconds() };
+
+			std::map<std::uint32_t, int> readFds;
+			std::vector<std::uint8_t> frame;
+			std::vector<std::uint8_t> compacted;
+			std::vector<std::pair<std::uint16_t, std::pair<std::uint64_t, std::uint32_t>>> newLocations;
+			bool success{ true };
+
+			for (const std::uint16_t packetId : log.order)
+			{
+				const auto& record{ log.live[packetId] };
+
+				//Opened once per segment, a failed open stays -1 so the segment is not retried. 0 is a valid descriptor.
+				auto fdIt{ readFds.find(record.segment) };
+				if (fdIt == readFds.end())
+				{
+					fdIt = readFds.emplace(record.segment, file::openRead(log.segmentPath(m_options.directory, record.segment))).first;
+				}
+
+				const int fd{ fdIt->second };
+
+				frame.resize(record.size);
+				if (fd < 0 || !file::readAt(fd, record.offset, frame.data(), frame.size()))
+				{
+					success = false;
+					break;
+				}
+
+				BinaryReader r{ frame.data() + k_frameHeaderSize, frame.size() - k_frameHeaderSize };
+				r.u8();
+				r.i64();
+				r.u16();
+				const std::uint32_t sessionExpiryInterval{ r.u32() };
+				r.pos -= 4U;
+
+				SavedData data;
+				if (!decodeWriteBody(r, packetId, data))
+				{
+					success = false;
+					break;
+				}
+
+				data.status = record.status;
+
+				std::vector<std::uint8_t> body;
+				BinaryWriter w{ body };
+				encodeHeader(w, RecordType::WRITE, packetId, now);
+				encodeWriteBody(w, sessionExpiryInterval, data);
+
+				const std::vector<std::uint8_t> newFrame{ frameRecord(body) };
+				newLocations.push_back({ packetId, { compacted.size(), static_cast<std::uint32_t>(newFrame.size()) } });
+				compacted.insert(compacted.end(), newFrame.begin(), newFrame.end());
+			}
+
+			for (const auto& entry : readFds)
+			{
+				if (entry.second >= 0)
+				{
+					file::close(entry.second);
+				}
+			}
+
+			const std::string newPath{ log.segmentPath(m_options.directory, newSegment) };
+			int newFd{ -1 };
+
+			if (success)
+			{
+				newFd = file::openAppend(newPath);
+				success = newFd >= 0 &&
+					(compacted.empty() || file::writeAll(newFd, compacted.data(), compacted.size())) &&
+					file::sync(newFd);
+			}
+
+			if (!success)
+			{
+				LOG_ERROR("WalSessionStore", "Failed to compact session state log of client: %s", log.clientId.c_str());
+
+				if (newFd >= 0)
+				{
+					file::close(newFd);
+				}
+				file::remove(newPath);
+				return false;
+			}
+
+			file::syncDirectory(m_options.directory);
+
+			//New segment holds the full live state, older segments can go. A crash before they are removed just replays
+			//them first, the new segment then re-applies the same live records on top.
+			log.closeActive();
+			for (const std::uint32_t segment : log.segments)
+			{
+				file::remove(log.segmentPath(m_options.directory, segment));
+			}
+			file::syncDirectory(m_options.directory);
+
+			for (const auto& location : newLocations)
+			{
+				auto& record{ log.live[location.first] };
+				record.segment = newSegment;
+				record.offset = location.second.first;
+				record.size = location.second.second;
+			}
+
+			LOG_DEBUG("WalSessionStore", "Compacted session state log of client: %s, %d bytes -> %d bytes.",
+				log.clientId.c_str(), log.totalBytes, compacted.size());
+
+			log.segments.assign(1U, newSegment);
+			log.activeFd = newFd;
+			log.activeSize = compacted.size();
+			log.totalBytes = compacted.size();
+			log.liveBytes = compacted.size();
+
+			return true;
+		}
+
+		void WalSessionStatePersistantStore::commitLoop()
+		{
+			while (true)
+			{
+				std::uint64_t target{ 0U };
+
+				{
+					std::unique_lock<std::mutex> lock{ m_commitMutex };
+					m_commitCondition.wait(lock, [this]() { return m_pendingBytes > 0U || m_flushRequested || m_isStopping; });
+
+					//Group commit: give other records a chance to join the batch, unless it is already large enough.
+					const auto deadline{ m_firstPendingTime + std::chrono::milliseconds(m_options.groupCommitIntervalMs) };
+					m_commitCondition.wait_until(lock, deadline, [this]()
+					{
+						return m_pendingBytes >= m_options.groupCommitMaxBytes || m_flushRequested || m_isStopping;
+					});
+
+					if (m_isStopping && m_pendingBytes == 0U)
+					{
+						//Anything still waiting was never made durable.
+						std::deque<std::pair<std::uint64_t, DurableCallback>> remaining{ std::move(m_durableCallbacks) };
+						lock.unlock();
+
+						for (auto& callback : remaining)
+						{
+							callback.second(callback.first <= m_durableSequence);
+						}
+
+						m_durableCondition.notify_all();
+						return;
+					}
+
+					target = m_appendedSequence;
+					m_pendingBytes = 0U;
+					m_flushRequested = false;
+				}
+
+				std::vector<ClientLog*> logs;
+				{
+					std::lock_guard<std::mutex> logsLock{ m_logsMutex };
+					for (auto& entry : m_logs)
+					{
+						logs.push_back(entry.second.get());
+					}
+				}
+
+				bool success{ true };
+				for (ClientLog* log : logs)
+				{
+					std::lock_guard<std::mutex> lock{ log->mutex };
+					success = commitLog(*log) && success;
+
+					const bool shouldCompact{ log->totalBytes >= m_options.compactionMinBytes &&
+						static_cast<float>(log->totalBytes - log->liveBytes) > static_cast<float>(log->totalBytes) * m_options.compactionMaxGarbageRatio };
+
+					if (success && shouldCompact)
+					{
+						compactLog(*log);
+					}
+				}
+
+				std::vector<DurableCallback> completed;
+				{
+					std::lock_guard<std::mutex> lock{ m_commitMutex };
+					m_commitFailed = !success;
+
+					if (success)
+					{
+						m_durableSequence = std::max(m_durableSequence, target);
+					}
+					else
+					{
+						m_failedSequence = std::max(m_failedSequence, target);
+					}
+
+					if (!success && m_pendingBytes == 0U && !m_isStopping)
+					{
+						//Retry the failed records after the usual interval.
+						m_pendingBytes = 1U;
+						m_firstPendingTime = std::chrono::steady_clock::now();
+					}
+
+					//Callbacks covered by this commit, on failure they are told so rather than waiting on the retry.
+					while (!m_durableCallbacks.empty() && m_durableCallbacks.front().first <= target)
+					{
+						completed.push_back(std::move(m_durableCallbacks.front().second));
+						m_durableCallbacks.pop_front();
+					}
+				}
+				m_durableCondition.notify_all();
+
+				for (auto& callback : completed)
+				{
+					callback(success);
+				}
+			}
+		}
+	}
+}
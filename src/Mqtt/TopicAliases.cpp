@@ -4,7 +4,7 @@
 // See LICENSE file in the project root for full license information.
 
 #include <kmMqtt/Mqtt/TopicAliases.h>
-#include <kmMqtt/Logger/Log.h>
+#include <kmMqtt/Logger/LogMacros.h>
 
 namespace kmMqtt
 {
@@ -12,29 +12,32 @@ namespace kmMqtt
 	{
 		bool TopicAliases::tryAddTopicAlias(const char* topicName, const std::uint16_t topicAlias)
 		{
-			LogTrace("TopicAliases", "Trying to map topic name [%s] to topic alias [%d].", topicName, topicAlias);
+			LOG_TRACE("TopicAliases", "Trying to map topic name [%s] to topic alias [%d].", topicName, topicAlias);
 
 			if (topicName == nullptr || *topicName == '\0')
 			{
-				LogWarning("TopicAliases", "topicName argument is invalid. Empty topicName.");
+				LOG_WARNING("TopicAliases", "topicName argument is invalid. Empty topicName.");
 				return false;
 			}
 
 			auto iter{ m_topicAliasToNameMap.find(topicAlias) };
 			if (iter != m_topicAliasToNameMap.end())
 			{
-				if (std::strcmp(topicName, iter->second) == 0)
+				if (iter->second == topicName)
 				{
-					LogTrace("TopicAliases", "Topic name [%s] already mapped under requested topic alias [%d].", topicName, topicAlias);
+					LOG_TRACE("TopicAliases", "Topic name [%s] already mapped under requested topic alias [%d].", topicName, topicAlias);
 					return true;
 				}
 
-				LogTrace("TopicAliases", "Topic alias[%d] found in existing mapping to topic name [%s]. Erasing mapping.", topicAlias, iter->second);
+				LOG_TRACE("TopicAliases", "Topic alias[%d] found in existing mapping to topic name [%s]. Erasing mapping.", topicAlias, iter->second.c_str());
+				m_topicNameBytes -= iter->second.size();
 				m_topicAliasToNameMap.erase(topicAlias);
 			}
 
-			m_topicAliasToNameMap.insert({ topicAlias, topicName });
-			LogTrace("TopicAliases", "Succesfully mapped topic name to topic alias.");
+			//Copied, the caller's topic name only lives as long as the packet it was received in.
+			const auto inserted{ m_topicAliasToNameMap.emplace(topicAlias, topicName) };
+			m_topicNameBytes += inserted->second.size();
+			LOG_TRACE("TopicAliases", "Succesfully mapped topic name to topic alias.");
 
 			return true;
 		}
@@ -50,7 +53,7 @@ namespace kmMqtt
 				return false;
 			}
 
-			outTopicName = iter->second;
+			outTopicName = iter->second.c_str();
 			return true;
 		}
 	}
@@ -0,0 +1,144 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/Tracing/BinaryTraceFileSink.h"
+#include "kmMqtt/Logger/LogMacros.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		namespace
+		{
+			void writeLittleEndian(std::uint8_t* out, std::uint64_t value, std::size_t size) noexcept
+			{
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					out[i] = static_cast<std::uint8_t>(value >> (8U * i));
+				}
+			}
+
+			std::uint64_t readLittleEndian(const std::uint8_t* data, std::size_t size) noexcept
+			{
+				std::uint64_t value{ 0U };
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					value |= static_cast<std::uint64_t>(data[i]) << (8U * i);
+				}
+
+				return value;
+			}
+		}
+
+		constexpr std::size_t BinaryTraceFileSink::k_recordSize;
+		constexpr char BinaryTraceFileSink::k_magic[];
+
+		BinaryTraceFileSink::BinaryTraceFileSink(const std::string& path, std::size_t bufferBytes)
+			: m_bufferBytes{ std::max<std::size_t>(bufferBytes, k_recordSize) }
+		{
+			m_file = std::fopen(path.c_str(), "wb");
+			if (m_file == nullptr)
+			{
+				LOG_ERROR("Trace", "Failed to open trace file: %s", path.c_str());
+				return;
+			}
+
+			m_buffer.reserve(m_bufferBytes);
+			m_buffer.insert(m_buffer.end(), std::begin(k_magic), std::end(k_magic));
+		}
+
+		BinaryTraceFileSink::~BinaryTraceFileSink()
+		{
+			if (m_file != nullptr)
+			{
+				writeBuffer();
+				std::fclose(m_file);
+			}
+		}
+
+		void BinaryTraceFileSink::onTraceEvent(const TraceEvent& event) noexcept
+		{
+			if (m_file == nullptr)
+			{
+				return;
+			}
+
+			std::uint8_t record[k_recordSize];
+			const auto nanoseconds{ std::chrono::duration_cast<std::chrono::nanoseconds>(event.time.time_since_epoch()).count() };
+			writeLittleEndian(record, static_cast<std::uint64_t>(nanoseconds), 8U);
+			writeLittleEndian(record + 8, event.bytes, 4U);
+			writeLittleEndian(record + 12, event.packetId, 2U);
+			record[14] = static_cast<std::uint8_t>(event.stage);
+			record[15] = static_cast<std::uint8_t>(event.packetType);
+
+			LockGuard guard{ m_mutex };
+
+			if (m_buffer.size() + k_recordSize > m_bufferBytes)
+			{
+				writeBuffer();
+			}
+
+			m_buffer.insert(m_buffer.end(), record, record + k_recordSize);
+		}
+
+		void BinaryTraceFileSink::flush() noexcept
+		{
+			if (m_file == nullptr)
+			{
+				return;
+			}
+
+			LockGuard guard{ m_mutex };
+			writeBuffer();
+			std::fflush(m_file);
+		}
+
+		void BinaryTraceFileSink::writeBuffer() noexcept
+		{
+			if (!m_buffer.empty() && std::fwrite(m_buffer.data(), 1U, m_buffer.size(), m_file) != m_buffer.size())
+			{
+				LOG_ERROR("Trace", "Failed to write %d bytes to trace file.", m_buffer.size());
+			}
+
+			m_buffer.clear();
+		}
+
+		bool BinaryTraceFileSink::readFile(const std::string& path, std::vector<TraceEvent>& outEvents)
+		{
+			std::FILE* file{ std::fopen(path.c_str(), "rb") };
+			if (file == nullptr)
+			{
+				return false;
+			}
+
+			char magic[sizeof(k_magic)];
+			if (std::fread(magic, 1U, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, k_magic, sizeof(k_magic)) != 0)
+			{
+				std::fclose(file);
+				return false;
+			}
+
+			std::uint8_t record[k_recordSize];
+			while (std::fread(record, 1U, k_recordSize, file) == k_recordSize)
+			{
+				TraceEvent event;
+				event.time = TimePoint{ std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds{ static_cast<std::int64_t>(readLittleEndian(record, 8U)) }) };
+				event.bytes = static_cast<std::uint32_t>(readLittleEndian(record + 8, 4U));
+				event.packetId = static_cast<std::uint16_t>(readLittleEndian(record + 12, 2U));
+				event.stage = static_cast<TraceStage>(record[14]);
+				event.packetType = static_cast<PacketType>(record[15]);
+				outEvents.push_back(event);
+			}
+
+			std::fclose(file);
+			return true;
+		}
+	}
+}
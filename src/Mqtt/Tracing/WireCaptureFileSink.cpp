@@ -0,0 +1,161 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Mqtt/Tracing/WireCaptureFileSink.h"
+#include "kmMqtt/Logger/LogMacros.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+
+namespace kmMqtt
+{
+	namespace mqtt
+	{
+		namespace
+		{
+			void writeLittleEndian(std::uint8_t* out, std::uint64_t value, std::size_t size) noexcept
+			{
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					out[i] = static_cast<std::uint8_t>(value >> (8U * i));
+				}
+			}
+
+			std::uint64_t readLittleEndian(const std::uint8_t* data, std::size_t size) noexcept
+			{
+				std::uint64_t value{ 0U };
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					value |= static_cast<std::uint64_t>(data[i]) << (8U * i);
+				}
+
+				return value;
+			}
+		}
+
+		constexpr std::size_t WireCaptureFileSink::k_recordHeaderSize;
+		constexpr char WireCaptureFileSink::k_magic[];
+
+		WireCaptureFileSink::WireCaptureFileSink(const std::string& path, std::size_t bufferBytes)
+			: m_bufferBytes{ std::max<std::size_t>(bufferBytes, k_recordHeaderSize) }
+		{
+			m_file = std::fopen(path.c_str(), "wb");
+			if (m_file == nullptr)
+			{
+				LOG_ERROR("WireCapture", "Failed to open wire capture file: %s", path.c_str());
+				return;
+			}
+
+			m_buffer.reserve(m_bufferBytes);
+			m_buffer.insert(m_buffer.end(), std::begin(k_magic), std::end(k_magic));
+		}
+
+		WireCaptureFileSink::~WireCaptureFileSink()
+		{
+			if (m_file != nullptr)
+			{
+				writeBuffer();
+				std::fclose(m_file);
+			}
+		}
+
+		void WireCaptureFileSink::onWireBytes(WireDirection direction, const std::uint8_t* bytes, std::size_t size, TimePoint time) noexcept
+		{
+			if (m_file == nullptr || size == 0U)
+			{
+				return;
+			}
+
+			std::uint8_t header[k_recordHeaderSize];
+			const auto nanoseconds{ std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count() };
+			writeLittleEndian(header, static_cast<std::uint64_t>(nanoseconds), 8U);
+			writeLittleEndian(header + 8, size, 4U);
+			header[12] = static_cast<std::uint8_t>(direction);
+
+			LockGuard guard{ m_mutex };
+			write(header, k_recordHeaderSize);
+			write(bytes, size);
+		}
+
+		void WireCaptureFileSink::flush() noexcept
+		{
+			if (m_file == nullptr)
+			{
+				return;
+			}
+
+			LockGuard guard{ m_mutex };
+			writeBuffer();
+			std::fflush(m_file);
+		}
+
+		void WireCaptureFileSink::write(const std::uint8_t* data, std::size_t size) noexcept
+		{
+			if (m_buffer.size() + size > m_bufferBytes)
+			{
+				writeBuffer();
+			}
+
+			if (size > m_bufferBytes)
+			{
+				if (std::fwrite(data, 1U, size, m_file) != size)
+				{
+					LOG_ERROR("WireCapture", "Failed to write %zu bytes to wire capture file.", size);
+				}
+
+				return;
+			}
+
+			m_buffer.insert(m_buffer.end(), data, data + size);
+		}
+
+		void WireCaptureFileSink::writeBuffer() noexcept
+		{
+			if (!m_buffer.empty() && std::fwrite(m_buffer.data(), 1U, m_buffer.size(), m_file) != m_buffer.size())
+			{
+				LOG_ERROR("WireCapture", "Failed to write %zu bytes to wire capture file.", m_buffer.size());
+			}
+
+			m_buffer.clear();
+		}
+
+		bool WireCaptureFileSink::readFile(const std::string& path, std::vector<WireCaptureRecord>& outRecords)
+		{
+			std::FILE* file{ std::fopen(path.c_str(), "rb") };
+			if (file == nullptr)
+			{
+				return false;
+			}
+
+			char magic[sizeof(k_magic)];
+			if (std::fread(magic, 1U, sizeof(magic), file) != sizeof(magic) || std::memcmp(magic, k_magic, sizeof(k_magic)) != 0)
+			{
+				std::fclose(file);
+				return false;
+			}
+
+			std::uint8_t header[k_recordHeaderSize];
+			while (std::fread(header, 1U, k_recordHeaderSize, file) == k_recordHeaderSize)
+			{
+				WireCaptureRecord record;
+				record.time = TimePoint{ std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds{ static_cast<std::int64_t>(readLittleEndian(header, 8U)) }) };
+				record.direction = static_cast<WireDirection>(header[12]);
+				record.bytes.resize(static_cast<std::size_t>(readLittleEndian(header + 8, 4U)));
+
+				if (std::fread(record.bytes.data(), 1U, record.bytes.size(), file) != record.bytes.size())
+				{
+					break;
+				}
+
+				outRecords.push_back(std::move(record));
+			}
+
+			std::fclose(file);
+			return true;
+		}
+	}
+}
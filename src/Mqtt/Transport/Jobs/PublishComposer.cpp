@@ -4,6 +4,7 @@
 // See LICENSE file in the project root for full license information.
 
 #include "kmMqtt/Mqtt/Transport/Jobs/PublishComposer.h"
+#include "kmMqtt/Mqtt/MessageExpiry.h"
 #include "kmMqtt/Mqtt/PacketHelper.h"
 
 namespace kmMqtt
@@ -17,7 +18,8 @@ namespace kmMqtt
 			ByteBuffer&& payload,
 			PublishOptions&& pubOptions,
 			ReceiveMaximumTracker* recMaxTracker,
-			bool isDup) noexcept :
+			bool isDup,
+			TimePoint queuedTime) noexcept :
 			IPacketComposer(connectionInfo),
 			m_packetIdPool{ packetIdPool },
 			m_packetId{ packetId },
@@ -25,7 +27,8 @@ namespace kmMqtt
 			m_payload{ std::move(payload) },
 			m_publishOptions{ std::move(pubOptions) },
 			m_recMaxTracker{ recMaxTracker },
-			m_isDup{ isDup }
+			m_isDup{ isDup },
+			m_queuedTime{ queuedTime }
 		{
 		}
 
@@ -41,6 +44,14 @@ namespace kmMqtt
 
 		ComposeResult PublishComposer::compose() noexcept
 		{
+			if (m_publishOptions.addMessageExpiryInterval)
+			{
+				//Result ignored, a retry past its interval is still sent as the broker may hold the first attempt.
+				const TimePoint now{ std::chrono::steady_clock::now() };
+				applyHeldTimeToMessageExpiry(m_publishOptions, std::chrono::duration_cast<Milliseconds>(now - m_queuedTime));
+				m_queuedTime = now;
+			}
+
 			Publish packet{ createPublishPacket(*m_mqttConnectionInfo, m_isDup, m_topic.c_str(), m_payload, m_publishOptions, m_packetId)};
 			EncodeResult result{ packet.encode() };
 			result.packetId = m_packetId;
@@ -53,6 +64,54 @@ namespace kmMqtt
 			return m_publishOptions.qos;
 		}
 
+		std::size_t PublishComposer::getEstimatedSize() const noexcept
+		{
+			//Fixed header, topic length prefix, packet ID and a few bytes of properties on top of topic and payload.
+			static constexpr std::size_t k_overhead{ 16U };
+
+			return k_overhead + m_topic.size() + m_payload.size();
+		}
+
+		SendPriority PublishComposer::getPriority() const noexcept
+		{
+			return m_publishOptions.qos == Qos::QOS_0 ? SendPriority::BULK : SendPriority::QOS;
+		}
+
+		const std::string* PublishComposer::getConflationKey() const noexcept
+		{
+			if (!m_publishOptions.conflate || m_publishOptions.qos != Qos::QOS_0 || m_topic.empty())
+			{
+				return nullptr;
+			}
+
+			return &m_topic;
+		}
+
+		void PublishComposer::conflate(IPacketComposer&& newer) noexcept
+		{
+			PublishComposer& newerPublish{ static_cast<PublishComposer&>(newer) };
+
+			m_payload = std::move(newerPublish.m_payload);
+			m_publishOptions = std::move(newerPublish.m_publishOptions);
+			m_queuedTime = newerPublish.m_queuedTime;
+		}
+
+		bool PublishComposer::isExpired(TimePoint now) const noexcept
+		{
+			if (!m_publishOptions.addMessageExpiryInterval || m_isDup)
+			{
+				//A retry was sent before, the broker may still acknowledge it, so its packet ID must stay reserved until then.
+				return false;
+			}
+
+			return now - m_queuedTime >= std::chrono::seconds{ m_publishOptions.messageExpiryInterval };
+		}
+
+		std::uint16_t PublishComposer::getPacketId() const noexcept
+		{
+			return m_packetId;
+		}
+
 		void PublishComposer::cancel() noexcept
 		{
 			m_packetIdPool->releaseId(m_packetId);
@@ -4,10 +4,14 @@
 // See LICENSE file in the project root for full license information.
 
 #include "kmMqtt/Mqtt/Transport/ReceiveQueue.h"
+#include "kmMqtt/Logger/LogMacros.h"
 #include "kmMqtt/Mqtt/Packets/PacketType.h"
 #include "kmMqtt/Mqtt/Packets/PacketUtils.h"
 #include "kmMqtt/Mqtt/Packets/ErrorCodes.h"
 #include "kmMqtt/Mqtt/ReceiveMaximumTracker.h"
+#include "kmMqtt/Mqtt/InboundFlowControl.h"
+#include "kmMqtt/Mqtt/ClientMetrics.h"
+#include "kmMqtt/Mqtt/Tracing/Trace.h"
 
 namespace kmMqtt
 {
@@ -19,15 +23,34 @@ decodeResult = packet.decode();\
 \
 if (!decodeResult.isSuccess())\
 {\
-	LogInfo("ReceiveQueue", "Failed to decode packet.");\
+	LOG_INFO("ReceiveQueue", "Failed to decode packet.");\
 	return decodeResult;\
 }\
 \
+traceDecoded(packet);\
+\
 if (callback != nullptr)\
 {\
 	callback(std::move(packet));\
 }\
 
+		namespace
+		{
+			std::uint16_t getTracePacketId(const Publish& packet) noexcept { return packet.getVariableHeader().packetIdentifier; }
+			std::uint16_t getTracePacketId(const PublishAck& packet) noexcept { return packet.getVariableHeader().packetId; }
+			std::uint16_t getTracePacketId(const PublishRec& packet) noexcept { return packet.getVariableHeader().packetId; }
+			std::uint16_t getTracePacketId(const PublishRel& packet) noexcept { return packet.getVariableHeader().packetId; }
+			std::uint16_t getTracePacketId(const PublishComp& packet) noexcept { return packet.getVariableHeader().packetId; }
+			std::uint16_t getTracePacketId(const SubscribeAck& packet) noexcept { return packet.getVariableHeader().packetId; }
+			std::uint16_t getTracePacketId(const UnSubscribeAck& packet) noexcept { return packet.getVariableHeader().packetId; }
+
+			template<typename T>
+			std::uint16_t getTracePacketId(const T&) noexcept
+			{
+				return 0U; //CONNACK, PINGRESP and DISCONNECT have no packet identifier.
+			}
+		}
+
 		struct InProgressDataGuard
 		{
 			InProgressDataGuard(std::queue<ByteBuffer>& inProgressData) noexcept
@@ -57,7 +80,18 @@ if (callback != nullptr)\
 		{
 			LockGuard guard{ m_mutex };
 
+			m_inQueueBytes += byteBuffer.size();
 			m_inQueueData.push(std::move(byteBuffer));
+
+			if (m_traceSinkPtr != nullptr)
+			{
+				m_inQueueFrameTimes.push(std::chrono::steady_clock::now());
+			}
+
+			if (m_inboundFlowControlPtr != nullptr)
+			{
+				m_inboundFlowControlPtr->setReceiveQueueSize(m_inQueueBytes, m_inQueueData.size());
+			}
 		}
 
 		const DecodeResult ReceiveQueue::receiveNextBatch()
@@ -73,30 +107,61 @@ if (callback != nullptr)\
 				}
 
 				std::swap(m_inQueueData, m_inProgressData);
+				m_inQueueBytes = 0U;
+
+				std::queue<TimePoint> emptyFrameTimes;
+				m_inProgressFrameTimes.swap(emptyFrameTimes);
+				std::swap(m_inQueueFrameTimes, m_inProgressFrameTimes);
+
+				//Publishes in the batch are counted again by the client as they are handed to the consumer.
+				if (m_inboundFlowControlPtr != nullptr)
+				{
+					m_inboundFlowControlPtr->setReceiveQueueSize(0U, 0U);
+				}
 			}
 
 			InProgressDataGuard inProgressDataGuard{ m_inProgressData }; //RAII to clear in-progress data on exit
 			PacketType packetType{ PacketType::RESERVED };
 
-			LogTrace("ReceiveQueue", "Processing queue of %d received packets.", m_inProgressData.size());
+			LOG_TRACE("ReceiveQueue", "Processing queue of %d received packets.", m_inProgressData.size());
 
 			while (!m_inProgressData.empty())
 			{
 				packetType = checkPacketType(m_inProgressData.front().bytes(), m_inProgressData.front().size());
 				decodeResult.packetType = packetType;
 
-				LogInfo("ReceiveQueue", "Processing next MQTT packet.");
+				TimePoint frameTime{};
+				if (!m_inProgressFrameTimes.empty())
+				{
+					frameTime = m_inProgressFrameTimes.front();
+					m_inProgressFrameTimes.pop();
+				}
+
+				const std::size_t frameSize{ m_inProgressData.front().size() };
+				const auto traceDecoded = [this, packetType, frameSize, frameTime](const auto& packet)
+				{
+					if (m_traceSinkPtr != nullptr)
+					{
+						const std::uint16_t packetId{ getTracePacketId(packet) };
+						trace(m_traceSinkPtr, TraceStage::FRAME_RECEIVED, packetType, packetId, frameSize, frameTime);
+						trace(m_traceSinkPtr, TraceStage::DECODED, packetType, packetId, frameSize);
+					}
+				};
 
 				if (packetType >= PacketType::_COUNT)
 				{
-					LogTrace("ReceiveQueue", "Binary Buffer: %s", m_inProgressData.front().toString().c_str());
-					LogError("ReceiveQueue", "Could not determine packet type, the packet has packet type value that's outside the range of allowed packet types. PacketType: %d",
+					LOG_TRACE("ReceiveQueue", "Binary Buffer: %s", m_inProgressData.front().toString().c_str());
+					LOG_ERROR("ReceiveQueue", "Could not determine packet type, the packet has packet type value that's outside the range of allowed packet types. PacketType: %d",
 						static_cast<std::uint8_t>(packetType));
 					decodeResult.code = DecodeErrorCode::PROTOCOL_ERROR;
 				}
+				else if (m_metricsPtr != nullptr)
+				{
+					m_metricsPtr->addPacketReceived(packetType, m_inProgressData.front().size());
+				}
 
-				LogInfo("ReceiveQueue", "Type: %s", mqtt::k_packetTypeName[static_cast<std::uint8_t>(packetType)]);
-				LogTrace("ReceiveQueue", "Binary Buffer: %s", m_inProgressData.front().toString().c_str());
+				LOG_TRACE("ReceiveQueue", "Processing next MQTT packet, Type: %s", mqtt::k_packetTypeName[static_cast<std::uint8_t>(packetType)]);
+				LOG_TRACE("ReceiveQueue", "Binary Buffer: %s", m_inProgressData.front().toString().c_str());
 
 				switch (packetType)
 				{
@@ -112,15 +177,17 @@ if (callback != nullptr)\
 
 					if (!decodeResult.isSuccess())
 					{
-						LogInfo("ReceiveQueue", "Failed to decode packet.");
+						LOG_INFO("ReceiveQueue", "Failed to decode packet.");
 						return decodeResult;
 					}
 
+					traceDecoded(packet);
+
 					if (packet.getVariableHeader().qos != Qos::QOS_0)
 					{
 						if (!m_receiveMaximumTrackerPtr->decrementReceiveAllowance(packet.getVariableHeader().packetIdentifier))
 						{
-							LogError("ReceiveQueue", "Receive Maximum would exceeded. Receive Maximum: %u", m_receiveMaximumTrackerPtr->getMaxReceiveAllowance());
+							LOG_ERROR("ReceiveQueue", "Receive Maximum would exceeded. Receive Maximum: %u", m_receiveMaximumTrackerPtr->getMaxReceiveAllowance());
 
 							decodeResult.code = DecodeErrorCode::RECEIVE_MAXIMUM_EXCEEDED;
 							decodeResult.reason = "Receive Maximum exceeded.";
@@ -142,10 +209,12 @@ if (callback != nullptr)\
 
 					if (!decodeResult.isSuccess())
 					{
-						LogInfo("ReceiveQueue", "Failed to decode packet.");
+						LOG_INFO("ReceiveQueue", "Failed to decode packet.");
 						return decodeResult;
 					}
 
+					traceDecoded(packet);
+
 					m_receiveMaximumTrackerPtr->incrementSendAllowance(packet.getVariableHeader().packetId);
 
 					if (m_pubAckCallback != nullptr)
@@ -162,10 +231,12 @@ if (callback != nullptr)\
 
 					if (!decodeResult.isSuccess()) 
 					{
-						LogInfo("ReceiveQueue", "Failed to decode packet.");
+						LOG_INFO("ReceiveQueue", "Failed to decode packet.");
 						return decodeResult;
 					}
 
+					traceDecoded(packet);
+
 					m_receiveMaximumTrackerPtr->incrementSendAllowance(packet.getVariableHeader().packetId);
 
 					if (m_pubCompCallback != nullptr) 
@@ -181,10 +252,12 @@ if (callback != nullptr)\
 
 					if (!decodeResult.isSuccess())
 					{
-						LogInfo("ReceiveQueue", "Failed to decode packet.");
+						LOG_INFO("ReceiveQueue", "Failed to decode packet.");
 						return decodeResult;
 					}
 
+					traceDecoded(packet);
+
 					if (packet.getVariableHeader().reasonCode >= PubRecReasonCode::UNSPECIFIED_ERROR)
 					{
 						m_receiveMaximumTrackerPtr->incrementSendAllowance(packet.getVariableHeader().packetId);
@@ -230,7 +303,7 @@ if (callback != nullptr)\
 				case PacketType::AUTH:
 				case PacketType::_COUNT:
 					default:
-					LogError("ReceiveQueue", "Received unsupported packet type: %s", mqtt::k_packetTypeName[static_cast<std::uint8_t>(packetType)]);
+					LOG_ERROR("ReceiveQueue", "Received unsupported packet type: %s", mqtt::k_packetTypeName[static_cast<std::uint8_t>(packetType)]);
 					decodeResult.code = DecodeErrorCode::PROTOCOL_ERROR;
 					return decodeResult;
 				}
@@ -240,19 +313,42 @@ if (callback != nullptr)\
 					m_inProgressData.pop();
 				}
 
-				LogInfo("ReceiveQueue", "Succesfully decoded packet.");
+				LOG_TRACE("ReceiveQueue", "Succesfully decoded packet.");
 			}
 
-			LogTrace("ReceiveQueue", "All received packets proccessed.");
+			LOG_TRACE("ReceiveQueue", "All received packets proccessed.");
 			return decodeResult;
 		}
 
+		bool ReceiveQueue::hasPendingPackets() noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return !m_inQueueData.empty(); //In-progress data is always fully drained by the end of receiveNextBatch().
+		}
+
+		std::size_t ReceiveQueue::getQueuedBytes() noexcept
+		{
+			LockGuard guard{ m_mutex };
+			return m_inQueueBytes;
+		}
+
 		void ReceiveQueue::clear() noexcept
 		{
 			std::queue<ByteBuffer> emptyQueueData;
 			std::queue<ByteBuffer> emptyProcessData;
 			m_inQueueData.swap(emptyQueueData);
 			m_inProgressData.swap(emptyProcessData);
+			m_inQueueBytes = 0U;
+
+			std::queue<TimePoint> emptyQueueFrameTimes;
+			std::queue<TimePoint> emptyProcessFrameTimes;
+			m_inQueueFrameTimes.swap(emptyQueueFrameTimes);
+			m_inProgressFrameTimes.swap(emptyProcessFrameTimes);
+
+			if (m_inboundFlowControlPtr != nullptr)
+			{
+				m_inboundFlowControlPtr->setReceiveQueueSize(0U, 0U);
+			}
 
 			m_conAckCallback = nullptr;
 			m_DisconnectCallback = nullptr;
@@ -291,6 +387,21 @@ if (callback != nullptr)\
 			m_receiveMaximumTrackerPtr = tracker;
 		}
 
+		void ReceiveQueue::setInboundFlowControl(InboundFlowControl* const flowControl) noexcept
+		{
+			m_inboundFlowControlPtr = flowControl;
+		}
+
+		void ReceiveQueue::setMetrics(ClientMetrics* const metrics) noexcept
+		{
+			m_metricsPtr = metrics;
+		}
+
+		void ReceiveQueue::setTraceSink(ITraceSink* const traceSink) noexcept
+		{
+			m_traceSinkPtr = traceSink;
+		}
+
 		void ReceiveQueue::setPublishAcknowledgeCallback(PubAckCallback& callback) noexcept
 		{
 			m_pubAckCallback = callback;
@@ -4,8 +4,13 @@
 // See LICENSE file in the project root for full license information.
 
 #include "kmMqtt/Mqtt/Transport/SendQueue.h"
-#include "kmMqtt/Logger/Log.h"
+#include "kmMqtt/Logger/LogMacros.h"
+#include "kmMqtt/Mqtt/ClientMetrics.h"
 #include "kmMqtt/Mqtt/ReceiveMaximumTracker.h"
+#include "kmMqtt/Mqtt/Tracing/Trace.h"
+#include "kmMqtt/Utils/TcpSocketOptions.h"
+
+#include <algorithm>
 
 namespace kmMqtt
 {
@@ -31,17 +36,116 @@ namespace kmMqtt
 			m_receiveMaximumTrackerPtr = tracker;
 		}
 
+		void SendQueue::setMetrics(ClientMetrics* metrics) noexcept
+		{
+			m_metricsPtr = metrics;
+		}
+
+		void SendQueue::setTraceSink(ITraceSink* traceSink) noexcept
+		{
+			m_traceSinkPtr = traceSink;
+		}
+
+		void SendQueue::setWireCaptureSink(IWireCaptureSink* wireCaptureSink) noexcept
+		{
+			m_wireCaptureSinkPtr = wireCaptureSink;
+		}
+
+		void SendQueue::setOptions(const SendQueueOptions& options) noexcept
+		{
+			LockGuard guard{ m_mutex };
+			m_options = options;
+		}
+
 		void SendQueue::addToQueue(PacketSendJobPtr packetSendJob)
 		{
 			LockGuard guard{ m_mutex };
-			m_nextPacketComposersBatch.push_back(std::move(packetSendJob));
+
+			const std::string* conflationKey{ packetSendJob->getConflationKey() };
+			if (conflationKey != nullptr)
+			{
+				const auto queued{ m_conflationIndex.find(*conflationKey) };
+				if (queued != m_conflationIndex.end())
+				{
+					//Older value for the topic is still unsent, replace it in place.
+					const std::size_t replacedSize{ queued->second->getEstimatedSize() };
+					queued->second->conflate(std::move(*packetSendJob));
+					m_queuedComposerBytes = m_queuedComposerBytes - replacedSize + queued->second->getEstimatedSize();
+					++m_conflatedCount;
+					return;
+				}
+
+				m_conflationIndex.emplace(*conflationKey, packetSendJob.get());
+			}
+
+			const SendPriority priority{ packetSendJob->getPriority() };
+			if ((priority == SendPriority::QOS || priority == SendPriority::BULK) && getQueuedPublishCount() == 0U)
+			{
+				//Flush delay runs from the oldest publish waiting to be sent.
+				m_oldestQueuedPublishTime = std::chrono::steady_clock::now();
+			}
+
+			m_queuedComposerBytes += packetSendJob->getEstimatedSize();
+			m_lanes[static_cast<std::size_t>(priority)].push_back(std::move(packetSendJob));
+
+			if (!m_isFull && isAtHighWatermark())
+			{
+				LOG_DEBUG("SendQueue", "Send queue reached high watermark. Queued bytes: %d, Queued packets: %d.", m_queuedComposerBytes + m_sendBuffer.size(), getQueuedPacketCount());
+				m_isFull = true;
+			}
+
+			reportQueueSize();
+		}
+
+		bool SendQueue::waitUntilWritable(Milliseconds timeout)
+		{
+			std::unique_lock<std::mutex> lock{ m_mutex };
+			return m_writableCondition.wait_for(lock, timeout, [this]() { return !m_isFull; });
+		}
+
+		void SendQueue::addAcknowledgement(PacketType packetType, std::uint16_t packetId)
+		{
+			assert(packetType == PacketType::PUBLISH_ACKNOWLEDGE ||
+				packetType == PacketType::PUBLISH_RECEIVED ||
+				packetType == PacketType::PUBLISH_RELEASED ||
+				packetType == PacketType::PUBLISH_COMPLETE);
+
+			LockGuard guard{ m_ackMutex };
+			m_pendingAcks.push_back({ packetType, packetId });
+		}
+
+		void SendQueue::flushAcknowledgements()
+		{
+			LockGuard guard{ m_mutex };
+			appendAcknowledgements();
 		}
 
 		void SendQueue::sendNextBatch(SendBatchResult& outResult)
+		{
+			{
+				LockGuard guard{ m_mutex };
+				processNextBatch(outResult);
+				m_expiredPacketIdsToNotify.swap(m_expiredPacketIds);
+			}
+
+			//Outside the lock, the listener completes the publish to the user, who may publish again from the callback.
+			for (const std::uint16_t packetId : m_expiredPacketIdsToNotify)
+			{
+				if (m_onPublishExpiredCallback)
+				{
+					m_onPublishExpiredCallback(packetId);
+				}
+			}
+
+			m_expiredPacketIdsToNotify.clear();
+		}
+
+		void SendQueue::processNextBatch(SendBatchResult& outResult)
 		{
 			outResult.totalBytesSent = 0;
 			outResult.isRecoverable = true;
 			outResult.socketError = NO_SOCKET_ERROR;
+			outResult.becameWritable = false;
 
 			if (m_sendBatchRetryCount != 0)
 			{
@@ -55,7 +159,6 @@ namespace kmMqtt
 
 			m_currentLocalRetry = 0;
 
-			LockGuard guard{ m_mutex };
 			while (m_currentLocalRetry < maxLocalRetries)
 			{
 				++m_currentLocalRetry;
@@ -65,15 +168,16 @@ namespace kmMqtt
 					if (m_startGracefulClear)
 					{
 						m_startGracefulClear = false;
+						updateWritableState(outResult);
 						return;
 					}
 
-					LogInfo("SendQueue", "Failed to proccess and send an outgoing packet. Reason: %d.", static_cast<std::uint8_t>(m_lastSendData.noSendReason));
+					LOG_INFO("SendQueue", "Failed to proccess and send an outgoing packet. Reason: %d.", static_cast<std::uint8_t>(m_lastSendData.noSendReason));
 
 					if (m_lastSendData.noSendReason == NoSendReason::SOCKET_SEND_ERROR)
 					{
 						//Can retry same packets a few times before registering as a concrete fail for the overall send queue.
-						LogInfo("SendQueue", "Attempting to retry failed packets. Retry turn: %d | Max Retries Allowed per Packet: %d.", m_currentLocalRetry, maxLocalRetries);
+						LOG_INFO("SendQueue", "Attempting to retry failed packets. Retry turn: %d | Max Retries Allowed per Packet: %d.", m_currentLocalRetry, maxLocalRetries);
 
 						if (m_currentLocalRetry == maxLocalRetries)
 						{
@@ -92,6 +196,7 @@ namespace kmMqtt
 						outResult.unrecoverableReasonStr = m_lastSendData.encodeResult.reason;
 						outResult.lastSendResult = m_lastSendData;
 
+						updateWritableState(outResult);
 						return;
 					}
 
@@ -104,7 +209,7 @@ namespace kmMqtt
 
 			if (m_sendBatchRetryCount >= k_maxSendBatchRetries)
 			{
-				LogInfo("SendQueue", "Failed send queue processing.");
+				LOG_INFO("SendQueue", "Failed send queue processing.");
 
 				static constexpr const char* rsnStr{ "Reached max consecutive failed retries." };
 
@@ -113,6 +218,8 @@ namespace kmMqtt
 			}
 
 			outResult.lastSendResult = m_lastSendData;
+
+			updateWritableState(outResult);
 		}
 
         void SendQueue::clearQueue(const bool graceful) noexcept
@@ -126,15 +233,61 @@ namespace kmMqtt
 			{
 				LockGuard guard{ m_mutex };
 
-				for (const auto& c : m_nextPacketComposersBatch)
-				{
-					c->cancel();
-				}
+				cancelQueuedPackets();
 
-				m_nextPacketComposersBatch.clear();
+				//Connection is being torn down, bytes left over in the buffer belong to it and must not leak into the next one.
+				m_sendBuffer.clear();
+				m_packetsMetadataInBuffer.clear();
+				m_isDisconnectComposed = false;
+
+				//Release publishers waiting on the queue, they see the client is no longer connected.
+				m_isFull = false;
+				m_writableCondition.notify_all();
 			}
+
+			LockGuard ackGuard{ m_ackMutex };
+			m_pendingAcks.clear();
         }
 
+		TimePoint SendQueue::nextSendTime(TimePoint now) noexcept
+		{
+			LockGuard guard{ m_mutex };
+
+			bool hasWork{ m_sendBuffer.size() > 0 };
+
+			if (!hasWork)
+			{
+				LockGuard ackGuard{ m_ackMutex };
+				hasWork = !m_pendingAcks.empty();
+			}
+
+			//Lanes are sent in order, only the packet at the front of each can be next.
+			for (std::size_t i = 0; !hasWork && i < m_lanes.size(); ++i)
+			{
+				hasWork = !m_lanes[i].empty() && m_lanes[i].front()->canSend();
+			}
+
+			if (!hasWork)
+			{
+				return TimePoint::max();
+			}
+
+			const bool hasOtherWork{ m_sendBuffer.size() > 0 || hasSendableControlPacket() || !m_lanes[static_cast<std::size_t>(SendPriority::DISCONNECT)].empty() };
+			if (!hasOtherWork && getFlushTrigger(now) == FlushTrigger::NOT_DUE)
+			{
+				//Only publishes are waiting, and the flush policy holds them.
+				return m_oldestQueuedPublishTime + m_options.flushDelay;
+			}
+
+			if (m_sendBatchRetryCount != 0)
+			{
+				const TimePoint retryTime{ m_lastRetryTime + k_retryDelayMs };
+				return retryTime > now ? retryTime : now;
+			}
+
+			return now;
+		}
+
 		void SendQueue::setOnPingSentCallback(const std::function<void()>& callback) noexcept
 		{
 			m_onPingSentCallback = callback;
@@ -160,133 +313,208 @@ namespace kmMqtt
 			m_onDisconnectSentCallback = callback;
 		}
 
-		bool SendQueue::trySendBatch(SendBatchResult& outResult, SendResultData& outLastSendResult)
+		void SendQueue::setOnPublishExpiredCallback(const std::function<void(std::uint16_t)>& callback) noexcept
 		{
-			if (m_nextPacketComposersBatch.size() <= 0)
+			m_onPublishExpiredCallback = callback;
+		}
+
+		void SendQueue::appendAcknowledgements()
+		{
+			if (m_isDisconnectComposed)
 			{
-				//Early successful return, no packets to proccess for sending.
-				return true;
+				//Acks are not sent after DISCONNECT, the broker redelivers the publishes.
+				return;
 			}
 
-			//Check if we are in the process of gracefully clearing the send queue.
-			// If so, cancel all pending packet composers and exit without sending anything.
-			if (m_startGracefulClear)
 			{
-				LogInfo("SendQueue", "Gracefully clearing send queue.");
-				for (const auto& c : m_nextPacketComposersBatch)
+				LockGuard ackGuard{ m_ackMutex };
+				m_acksToAppend.swap(m_pendingAcks);
+			}
+
+			if (m_acksToAppend.empty())
+			{
+				return;
+			}
+
+			static constexpr std::size_t k_ackPacketSize{ 4U };
+
+			LOG_TRACE("SendQueue", "Appending %d acknowledgements to send buffer.", m_acksToAppend.size());
+
+			reserveSendBuffer(m_sendBuffer.size() + (m_acksToAppend.size() * k_ackPacketSize));
+
+			for (const auto& ack : m_acksToAppend)
+			{
+				//Fixed header (PUBREL has reserved flag bits 0010), remaining length of 2, packet identifier.
+				const std::uint8_t flags{ ack.packetType == PacketType::PUBLISH_RELEASED ? static_cast<std::uint8_t>(0x02U) : static_cast<std::uint8_t>(0x00U) };
+				m_sendBuffer += static_cast<std::uint8_t>((static_cast<std::uint8_t>(ack.packetType) << 4) | flags);
+				m_sendBuffer += static_cast<std::uint8_t>(0x02U);
+				m_sendBuffer.append(ack.packetId);
+
+				trace(m_traceSinkPtr, TraceStage::COMPOSED, ack.packetType, ack.packetId, k_ackPacketSize);
+
+				if (ack.packetType == PacketType::PUBLISH_ACKNOWLEDGE)
 				{
-					c->cancel();
+					assert(m_receiveMaximumTrackerPtr != nullptr);
+
+					m_receiveMaximumTrackerPtr->incrementReceiveAllowance(ack.packetId);
+
+					if (isTrackingAllPackets())
+					{
+						m_packetsMetadataInBuffer.push_back({ m_sendBuffer.size(), ack.packetType, ack.packetId, k_ackPacketSize });
+					}
+				}
+				else
+				{
+					if (ack.packetType == PacketType::PUBLISH_COMPLETE)
+					{
+						assert(m_receiveMaximumTrackerPtr != nullptr);
+
+						m_receiveMaximumTrackerPtr->incrementReceiveAllowance(ack.packetId);
+					}
+
+					//Track for sent callbacks, same as composed acks.
+					m_packetsMetadataInBuffer.push_back({ m_sendBuffer.size(), ack.packetType, ack.packetId, k_ackPacketSize });
 				}
-				m_nextPacketComposersBatch.clear();
+			}
+
+			m_acksToAppend.clear();
+		}
+
+		void SendQueue::reserveSendBuffer(std::size_t size)
+		{
+			if (size > m_sendBuffer.capacity())
+			{
+				auto tempBuffer = ByteBuffer{ size };
+				tempBuffer.append(m_sendBuffer);
+				m_sendBuffer = std::move(tempBuffer);
+			}
+		}
+
+		bool SendQueue::trySendBatch(SendBatchResult& outResult, SendResultData& outLastSendResult)
+		{
+			//Check if we are in the process of gracefully clearing the send queue.
+			// If so, cancel all pending packet composers and acks and exit without sending anything.
+			if (m_startGracefulClear)
+			{
+				LOG_INFO("SendQueue", "Gracefully clearing send queue.");
+				cancelQueuedPackets();
+				m_sendBuffer.clear();
+				m_packetsMetadataInBuffer.clear();
+				m_isDisconnectComposed = false;
+
+				LockGuard ackGuard{ m_ackMutex };
+				m_pendingAcks.clear();
 				return false;
 			}
 
-			LogTrace("SendQueue", "Processing queue of %d outgoing packets.", m_nextPacketComposersBatch.size());
+			appendAcknowledgements();
 
-			std::vector<ByteBuffer> encodedDataQueue; //Encoded data ready to send through socket.
-			std::size_t fullOutgoingDataSize{ m_sendBuffer.size() }; //Data size to send, init with any left over data in send buffer.
-			bool hasPingPacket{ false }; //Track if there is a ping packet in the batch.
-			std::size_t pingPacketLastByte{ 0 }; //Byte index in buffer where ping packet ends.
+			if (getQueuedPacketCount() <= 0 && m_sendBuffer.size() <= 0)
+			{
+				//Early successful return, no packets to proccess for sending.
+				return true;
+			}
+
+			LOG_TRACE("SendQueue", "Processing queue of %d outgoing packets.", getQueuedPacketCount());
 
-			std::vector<PacketSendJobPtr> delayedPackets; //Packets delayed due to no being allowed to send yet.
+			m_encodedDataQueue.clear();
+			std::size_t fullOutgoingDataSize{ m_sendBuffer.size() }; //Data size to send, init with any left over data in send buffer.
 
 			/**
-			 * First step: Compose all packets in batch into encoded data.
-			 * Perform some prelimenery checks:
-			 * - if packet cannot be sent now, delay it for next batch.
+			 * First step: Compose packets from the lanes into encoded data.
+			 * - control lane is always composed in full, so pings and acks never wait behind publishes.
+			 * - publish lanes are composed once the flush policy is due, or along with anything else being sent.
+			 * - publish lanes are interleaved by weight at packet boundaries, until the batch holds maxBatchBytes.
+			 * - a lane stops at its first packet that cannot be sent yet (e.g. receive maximum), keeping its order.
+			 * - a graceful DISCONNECT is composed once no publish can be sent, and nothing is composed after it.
 			 * - if packet fails to encode, return error.
-			 * - track some packets for callback to listeners later.
-			 * - accumulate total size of encoded data to send.
-			 * - move encoded data into send queue.
 			 */
-			for (auto& c : m_nextPacketComposersBatch)
+			std::deque<PacketSendJobPtr>& controlLane{ m_lanes[static_cast<std::size_t>(SendPriority::CONTROL)] };
+			std::deque<PacketSendJobPtr>& disconnectLane{ m_lanes[static_cast<std::size_t>(SendPriority::DISCONNECT)] };
+			while (!m_isDisconnectComposed && !controlLane.empty() && controlLane.front()->canSend())
 			{
-				//Check if packet can be sent now. If not, delay it for next batch.
-				if (!c->canSend())
+				if (!composeNextInLane(controlLane, fullOutgoingDataSize, outResult, outLastSendResult))
 				{
-					delayedPackets.push_back(std::move(c));
-					continue;
+					return false;
 				}
+			}
 
-				//Compose packet into encoded data.
-				auto result{ c->compose() };
+			const TimePoint now{ std::chrono::steady_clock::now() };
+			FlushTrigger flushTrigger{ getQueuedPublishCount() > 0U ? getFlushTrigger(now) : FlushTrigger::NOT_DUE };
 
-				//Check for encode errors.
-				if (!result.encodeResult.isSuccess())
-				{
-					outLastSendResult = {};
-					outLastSendResult.encodeResult = result.encodeResult;
-					outLastSendResult.noSendReason = NoSendReason::ENCODE_ERROR;
-					outLastSendResult.wasSent = false;
+			if (flushTrigger == FlushTrigger::NOT_DUE && (fullOutgoingDataSize > 0U || !disconnectLane.empty()) && getQueuedPublishCount() > 0U)
+			{
+				//A write happens anyway, publishes waiting for the flush go out with it, or ahead of a pending DISCONNECT.
+				flushTrigger = FlushTrigger::PIGGYBACK;
+			}
 
-					outResult.isRecoverable = false;
-					outResult.unrecoverableReasonStr = result.encodeResult.reason;
+			if (flushTrigger != FlushTrigger::NOT_DUE)
+			{
+				updateAdaptiveFlushTarget(flushTrigger);
+				m_lastPublishFlushTime = now;
+			}
 
-					return false;
-				}
+			const std::size_t maxBatchBytes{ std::max<std::size_t>(m_options.maxBatchBytes, 1U) };
+			static constexpr SendPriority k_publishLanes[]{ SendPriority::QOS, SendPriority::BULK };
 
-				//Track if there is a ping packet in the batch for callback later.
-				if(result.encodeResult.packetType == PacketType::PING_REQUQEST)
-				{
-					if (!hasPingPacket)
-					{
-						//Track byte index in buffer where ping packet ends so we can notify listener when it is fully sent through socket.
-						pingPacketLastByte = fullOutgoingDataSize + result.encodedData.size();
-						hasPingPacket = true;
-					}
-				}
-				else if (result.encodeResult.packetType == PacketType::PUBLISH_ACKNOWLEDGE)
-				{
-					assert(m_receiveMaximumTrackerPtr != nullptr);
+			bool hasComposed{ !m_isDisconnectComposed && flushTrigger != FlushTrigger::NOT_DUE };
+			while (hasComposed && fullOutgoingDataSize < maxBatchBytes)
+			{
+				hasComposed = false;
 
-					m_receiveMaximumTrackerPtr->incrementReceiveAllowance(result.encodeResult.packetId);
-				}
-				else if (result.encodeResult.packetType == PacketType::PUBLISH_COMPLETE ||
-					result.encodeResult.packetType == PacketType::PUBLISH_RECEIVED ||
-					result.encodeResult.packetType == PacketType::PUBLISH_RELEASED ||
-					result.encodeResult.packetType == PacketType::DISCONNECT)
+				for (const SendPriority priority : k_publishLanes)
 				{
-					if (result.encodeResult.packetType == PacketType::PUBLISH_COMPLETE)
+					std::deque<PacketSendJobPtr>& lane{ m_lanes[static_cast<std::size_t>(priority)] };
+					const std::uint8_t weight{ std::max<std::uint8_t>(priority == SendPriority::QOS ? m_options.qosLaneWeight : m_options.bulkLaneWeight, 1U) };
+
+					for (std::uint8_t i = 0; i < weight && fullOutgoingDataSize < maxBatchBytes && !lane.empty() && lane.front()->canSend(); ++i)
 					{
-						assert(m_receiveMaximumTrackerPtr != nullptr);
+						if (!composeNextInLane(lane, fullOutgoingDataSize, outResult, outLastSendResult))
+						{
+							return false;
+						}
 
-						m_receiveMaximumTrackerPtr->incrementReceiveAllowance(result.encodeResult.packetId);
+						hasComposed = true;
 					}
-
-					//Track some packets by adding to buffer so we can notify listeners when they are sent successfully.
-					m_packetsMetadataInBuffer.push_back({ fullOutgoingDataSize + result.encodedData.size(), result.encodeResult.packetType,  result.encodeResult.packetId });
 				}
-				else if (result.encodeResult.packetType == PacketType::PUBLISH)
-				{
-					if (c->getQos() != Qos::QOS_0)
-					{
-						assert(m_receiveMaximumTrackerPtr != nullptr);
+			}
 
-						m_receiveMaximumTrackerPtr->decrementSendAllowance(result.encodeResult.packetId);
-					}
+			if (flushTrigger != FlushTrigger::NOT_DUE && getQueuedPublishCount() > 0U)
+			{
+				//Publishes left over by the batch cap are already due.
+				m_oldestQueuedPublishTime = TimePoint{};
+			}
+
+			if (!m_isDisconnectComposed && !disconnectLane.empty() && disconnectLane.front()->canSend() && !hasSendablePublish())
+			{
+				//Publishes queued before disconnect() go first, MQTT allows nothing after DISCONNECT on the connection.
+				if (!composeNextInLane(disconnectLane, fullOutgoingDataSize, outResult, outLastSendResult))
+				{
+					return false;
 				}
 
-				fullOutgoingDataSize += result.encodedData.size();
-				encodedDataQueue.push_back(std::move(result.encodedData)); //Move encoded data to send queue.
+				m_isDisconnectComposed = true;
 			}
 
-			//Move delayed packets back to main batch for next send attempt.
-			m_nextPacketComposersBatch = std::move(delayedPackets);
+			const bool isCorked{ applyTcpOptions(m_encodedDataQueue.size() > 1U) };
 
 			//Ensure send buffer has enough capacity to hold all data.
-			if (fullOutgoingDataSize > m_sendBuffer.capacity())
-			{
-				auto tempBuffer = ByteBuffer{ fullOutgoingDataSize };
-				tempBuffer.append(m_sendBuffer);
-				m_sendBuffer = std::move(tempBuffer);
-			}
+			reserveSendBuffer(fullOutgoingDataSize);
 
 			//Append all encoded data to send buffer for sending all at once rather than packet by packet.
-			for(const auto& data : encodedDataQueue)
+			for(const auto& data : m_encodedDataQueue)
 			{
 				m_sendBuffer.append(data);
 			}
 
+			m_encodedDataQueue.clear();
+
+			if (m_sendBuffer.size() <= 0)
+			{
+				//Everything queued is held back for now.
+				return true;
+			}
+
 			static constexpr std::uint8_t kMax_Partial_Send_Loops{ 3 };
 			std::uint8_t partialSendLoopCount{ 0 };
 
@@ -295,10 +523,8 @@ namespace kmMqtt
 			/**
 			 * Second step: Try sending all data in send buffer.
 			 * - Loop to handle partial sends up to a max number of loops.
-			 * - On successful send of all data, clear buffer and return.
-			 * - On partial send, remove sent data from buffer and loop to try send remaining data.
+			 * - Sent bytes are removed from the buffer, relevant listeners are notified of every tracked packet sent in full.
 			 * - On socket send error, return error.
-			 * - Notify relevant listeners of sent packets.
 			 * - If max partial send loops reached, return success with bytes sent. Remained will try send next batch/tick.
 			 */
 			while (partialSendLoopCount <= kMax_Partial_Send_Loops)
@@ -308,126 +534,40 @@ namespace kmMqtt
 				//Try sending data in buffer through socket.
 				sendResult = sendData(m_sendBuffer);
 
-				//If send was successful (full or partial), process result.
-				if (sendResult >= 0)
+				if (sendResult < 0)
 				{
-					outResult.controlPacketSent = true;
-					outResult.totalBytesSent = sendResult;
-
-					/**
-					 * If all data was sent successfully, clear buffer and return.
-					 * If only partial data was sent, remove sent data from buffer and loop to try send remaining data.
-					 * Notify relevant listeners of sent packets.
-					 */
-					if (sendResult == static_cast<int>(m_sendBuffer.size()))
-					{
-						if (hasPingPacket)
-						{
-							//Ping packet was sent successfully.
-							m_onPingSentCallback();
-						}
+					break;
+				}
 
-						//Since all data was sent, notify all tracked packets as sent.
-						for (auto& metadata : m_packetsMetadataInBuffer)
-						{
-							switch (metadata.packetType)
-							{
-							case PacketType::PUBLISH_COMPLETE:
-								m_onPubCompSentCallback(metadata.packetId);
-								break;
-							case PacketType::PUBLISH_RELEASED:
-								m_onPubRelSentCallback(metadata.packetId);
-								break;
-							case PacketType::PUBLISH_RECEIVED:
-								m_onPubRecSentCallback(metadata.packetId);
-								break;
-							case PacketType::PUBLISH:
-							case PacketType::AUTH:
-							case PacketType::CONNECT:
-							case PacketType::CONNECT_ACKNOWLEDGE:
-							case PacketType::PING_REQUQEST:
-							case PacketType::PING_RESPONSE:
-							case PacketType::RESERVED:
-							case PacketType::SUBSCRIBE:
-							case PacketType::SUBSCRIBE_ACKNOWLEDGE:
-							case PacketType::UNSUBSCRIBE:
-							case PacketType::UNSUBSCRIBE_ACKNOWLEDGE:
-							case PacketType::PUBLISH_ACKNOWLEDGE:
-							case PacketType::_COUNT:
-								break;
-							case PacketType::DISCONNECT:
-								m_onDisconnectSentCallback();
-								break;
-							}
-						}
+				outResult.controlPacketSent = true;
+				outResult.totalBytesSent += sendResult;
 
-						m_packetsMetadataInBuffer.clear();
+				const bool isAllSent{ sendResult == static_cast<int>(m_sendBuffer.size()) };
 
-						//Reset buffer to free up memory if over max allowed persistent size so we don't hold onto too much memory unnecessarily.
-						if (m_sendBuffer.capacity() > MAX_ALLOWED_PERSISTENT_SEND_BUFFER_SIZE)
-						{
-							m_sendBuffer = ByteBuffer{};
-						}
-						else
-						{
-							m_sendBuffer.removeFromBeginning(sendResult);
-						}
+				notifySentPackets(static_cast<std::size_t>(sendResult));
 
-						return true;
+				if (isAllSent)
+				{
+					//Reset buffer to free up memory if over max allowed persistent size so we don't hold onto too much memory unnecessarily.
+					if (m_sendBuffer.capacity() > MAX_ALLOWED_PERSISTENT_SEND_BUFFER_SIZE)
+					{
+						m_sendBuffer = ByteBuffer{};
 					}
 					else
 					{
-						if (hasPingPacket)
-						{
-							if (sendResult >= static_cast<int>(pingPacketLastByte))
-							{
-								//Ping packet was sent successfully.
-								m_onPingSentCallback();
-							}
-
-							//Notify other tracked packets as sent if their end byte index is within the sent data range.
-							for (auto& metadata : m_packetsMetadataInBuffer)
-							{
-								if (sendResult >= static_cast<int>(metadata.endByteInBuffer))
-								{
-									switch (metadata.packetType)
-									{
-									case PacketType::PUBLISH_COMPLETE:
-										m_onPubCompSentCallback(metadata.packetId);
-										break;
-									case PacketType::PUBLISH_RELEASED:
-										m_onPubRelSentCallback(metadata.packetId);
-										break;
-									case PacketType::PUBLISH_RECEIVED:
-										m_onPubRecSentCallback(metadata.packetId);
-										break;
-									case PacketType::PUBLISH:
-									case PacketType::AUTH:
-									case PacketType::CONNECT:
-									case PacketType::CONNECT_ACKNOWLEDGE:
-									case PacketType::PING_REQUQEST:
-									case PacketType::PING_RESPONSE:
-									case PacketType::RESERVED:
-									case PacketType::SUBSCRIBE:
-									case PacketType::SUBSCRIBE_ACKNOWLEDGE:
-									case PacketType::UNSUBSCRIBE:
-									case PacketType::UNSUBSCRIBE_ACKNOWLEDGE:
-									case PacketType::PUBLISH_ACKNOWLEDGE:
-									case PacketType::_COUNT:
-										break;
-									case PacketType::DISCONNECT:
-										m_onDisconnectSentCallback();
-										break;
-									}
-
-									m_packetsMetadataInBuffer.erase(m_packetsMetadataInBuffer.begin());
-								}
-							}
-						}
-
 						m_sendBuffer.removeFromBeginning(sendResult);
 					}
+
+					break;
 				}
+
+				m_sendBuffer.removeFromBeginning(sendResult);
+			}
+
+			if (isCorked)
+			{
+				//Uncorking pushes out whatever the socket held back.
+				tcp::setCork(m_tcpOptionsHandle, false);
 			}
 
 			if (sendResult >= 0)
@@ -442,32 +582,413 @@ namespace kmMqtt
 			return false;
 		}
 
+		bool SendQueue::composeNextInLane(std::deque<PacketSendJobPtr>& lane, std::size_t& fullOutgoingDataSize, SendBatchResult& outResult, SendResultData& outLastSendResult)
+		{
+			PacketSendJobPtr c{ std::move(lane.front()) };
+			lane.pop_front();
+
+			m_queuedComposerBytes -= c->getEstimatedSize();
+
+			const std::string* conflationKey{ c->getConflationKey() };
+			if (conflationKey != nullptr)
+			{
+				//Composed packets are as good as sent, newer values queue behind them.
+				m_conflationIndex.erase(*conflationKey);
+			}
+
+			if (c->isExpired(std::chrono::steady_clock::now()))
+			{
+				//Nobody can use it anymore, sending it would only cost bandwidth and broker work.
+				LOG_DEBUG("SendQueue", "Dropping expired publish, Packet ID: %d", c->getPacketId());
+				++m_expiredCount;
+				m_expiredPacketIds.push_back(c->getPacketId());
+
+				return true;
+			}
+
+			//Compose packet into encoded data.
+			auto result{ c->compose() };
+
+			//Check for encode errors.
+			if (!result.encodeResult.isSuccess())
+			{
+				outLastSendResult = {};
+				outLastSendResult.encodeResult = result.encodeResult;
+				outLastSendResult.noSendReason = NoSendReason::ENCODE_ERROR;
+				outLastSendResult.wasSent = false;
+
+				outResult.isRecoverable = false;
+				outResult.unrecoverableReasonStr = result.encodeResult.reason;
+
+				return false;
+			}
+
+			const std::size_t endByteInBuffer{ fullOutgoingDataSize + result.encodedData.size() };
+
+			trace(m_traceSinkPtr, TraceStage::COMPOSED, result.encodeResult.packetType, result.encodeResult.packetId, result.encodedData.size());
+			const std::size_t trackedPacketCount{ m_packetsMetadataInBuffer.size() };
+
+			if (result.encodeResult.packetType == PacketType::PING_REQUQEST)
+			{
+				//Track where the ping ends so the listener is notified once it is fully sent through the socket.
+				m_packetsMetadataInBuffer.push_back({ endByteInBuffer, result.encodeResult.packetType, result.encodeResult.packetId, result.encodedData.size() });
+			}
+			else if (result.encodeResult.packetType == PacketType::PUBLISH_ACKNOWLEDGE)
+			{
+				assert(m_receiveMaximumTrackerPtr != nullptr);
+
+				m_receiveMaximumTrackerPtr->incrementReceiveAllowance(result.encodeResult.packetId);
+			}
+			else if (result.encodeResult.packetType == PacketType::PUBLISH_COMPLETE ||
+				result.encodeResult.packetType == PacketType::PUBLISH_RECEIVED ||
+				result.encodeResult.packetType == PacketType::PUBLISH_RELEASED ||
+				result.encodeResult.packetType == PacketType::DISCONNECT)
+			{
+				if (result.encodeResult.packetType == PacketType::PUBLISH_COMPLETE)
+				{
+					assert(m_receiveMaximumTrackerPtr != nullptr);
+
+					m_receiveMaximumTrackerPtr->incrementReceiveAllowance(result.encodeResult.packetId);
+				}
+
+				//Track some packets by adding to buffer so we can notify listeners when they are sent successfully.
+				m_packetsMetadataInBuffer.push_back({ endByteInBuffer, result.encodeResult.packetType, result.encodeResult.packetId, result.encodedData.size() });
+			}
+			else if (result.encodeResult.packetType == PacketType::PUBLISH)
+			{
+				if (c->getQos() != Qos::QOS_0)
+				{
+					assert(m_receiveMaximumTrackerPtr != nullptr);
+
+					m_receiveMaximumTrackerPtr->decrementSendAllowance(result.encodeResult.packetId);
+				}
+			}
+
+			if (isTrackingAllPackets() && m_packetsMetadataInBuffer.size() == trackedPacketCount)
+			{
+				m_packetsMetadataInBuffer.push_back({ endByteInBuffer, result.encodeResult.packetType, result.encodeResult.packetId, result.encodedData.size() });
+			}
+
+			fullOutgoingDataSize = endByteInBuffer;
+			m_encodedDataQueue.push_back(std::move(result.encodedData)); //Move encoded data to send queue.
+
+			return true;
+		}
+
+		void SendQueue::notifySentPackets(std::size_t bytesSent)
+		{
+			if (m_traceSinkPtr != nullptr)
+			{
+				traceSentPackets(bytesSent);
+			}
+
+			const TimePoint now{ m_metricsPtr != nullptr ? std::chrono::steady_clock::now() : TimePoint{} };
+
+			//Metadata is in buffer order, notify every packet that ends within the sent bytes.
+			std::size_t sentCount{ 0U };
+			for (; sentCount < m_packetsMetadataInBuffer.size() && m_packetsMetadataInBuffer[sentCount].endByteInBuffer <= bytesSent; ++sentCount)
+			{
+				const PacketSectionMetadata& metadata{ m_packetsMetadataInBuffer[sentCount] };
+
+				if (m_metricsPtr != nullptr)
+				{
+					//Counted once the socket took the last byte, packets dropped from the buffer on disconnect never were sent.
+					m_metricsPtr->addPacketSent(metadata.packetType, metadata.packetSize);
+
+					if (metadata.packetType == PacketType::PUBLISH && metadata.packetId != 0U)
+					{
+						m_metricsPtr->markPublishSent(metadata.packetId, now);
+					}
+				}
+
+				switch (metadata.packetType)
+				{
+				case PacketType::PING_REQUQEST:
+					m_onPingSentCallback();
+					break;
+				case PacketType::PUBLISH_COMPLETE:
+					m_onPubCompSentCallback(metadata.packetId);
+					break;
+				case PacketType::PUBLISH_RELEASED:
+					m_onPubRelSentCallback(metadata.packetId);
+					break;
+				case PacketType::PUBLISH_RECEIVED:
+					m_onPubRecSentCallback(metadata.packetId);
+					break;
+				case PacketType::DISCONNECT:
+					m_onDisconnectSentCallback();
+					break;
+				case PacketType::PUBLISH:
+				case PacketType::AUTH:
+				case PacketType::CONNECT:
+				case PacketType::CONNECT_ACKNOWLEDGE:
+				case PacketType::PING_RESPONSE:
+				case PacketType::RESERVED:
+				case PacketType::SUBSCRIBE:
+				case PacketType::SUBSCRIBE_ACKNOWLEDGE:
+				case PacketType::UNSUBSCRIBE:
+				case PacketType::UNSUBSCRIBE_ACKNOWLEDGE:
+				case PacketType::PUBLISH_ACKNOWLEDGE:
+				case PacketType::_COUNT:
+					break;
+				}
+			}
+
+			m_packetsMetadataInBuffer.erase(m_packetsMetadataInBuffer.begin(), m_packetsMetadataInBuffer.begin() + sentCount);
+
+			//Remaining packets move up by the bytes removed from the front of the buffer.
+			for (auto& metadata : m_packetsMetadataInBuffer)
+			{
+				metadata.endByteInBuffer -= bytesSent;
+			}
+		}
+
+		void SendQueue::traceSentPackets(std::size_t bytesSent) noexcept
+		{
+			const TimePoint now{ std::chrono::steady_clock::now() };
+
+			for (auto& metadata : m_packetsMetadataInBuffer)
+			{
+				//Start of a partly sent packet was removed from the buffer by an earlier send.
+				const std::size_t startByte{ metadata.endByteInBuffer > metadata.packetSize ? metadata.endByteInBuffer - metadata.packetSize : 0U };
+				if (startByte >= bytesSent)
+				{
+					break;
+				}
+
+				if (!metadata.isFirstByteSent)
+				{
+					metadata.isFirstByteSent = true;
+					trace(m_traceSinkPtr, TraceStage::FIRST_BYTE_SENT, metadata.packetType, metadata.packetId, metadata.packetSize, now);
+				}
+
+				if (metadata.endByteInBuffer <= bytesSent)
+				{
+					trace(m_traceSinkPtr, TraceStage::LAST_BYTE_SENT, metadata.packetType, metadata.packetId, metadata.packetSize, now);
+				}
+			}
+		}
+
+		void SendQueue::cancelQueuedPackets() noexcept
+		{
+			for (auto& lane : m_lanes)
+			{
+				for (const auto& c : lane)
+				{
+					c->cancel();
+				}
+
+				lane.clear();
+			}
+
+			m_conflationIndex.clear();
+			m_queuedComposerBytes = 0U;
+		}
+
+		void SendQueue::getQueuedBytes(std::size_t& outQueuedBytes, std::size_t& outSendBufferBytes)
+		{
+			LockGuard guard{ m_mutex };
+			outQueuedBytes = m_queuedComposerBytes;
+			outSendBufferBytes = m_sendBuffer.size();
+		}
+
+		std::size_t SendQueue::getQueuedPacketCount() const noexcept
+		{
+			std::size_t count{ 0U };
+			for (const auto& lane : m_lanes)
+			{
+				count += lane.size();
+			}
+
+			return count;
+		}
+
+		TimePoint SendQueue::nextFlushTime(TimePoint now) noexcept
+		{
+			LockGuard guard{ m_mutex };
+
+			if (m_options.flushMode == FlushMode::IMMEDIATE || getQueuedPublishCount() == 0U)
+			{
+				return TimePoint::max();
+			}
+
+			return getFlushTrigger(now) == FlushTrigger::NOT_DUE ? m_oldestQueuedPublishTime + m_options.flushDelay : now;
+		}
+
+		SendQueue::FlushTrigger SendQueue::getFlushTrigger(TimePoint now) const noexcept
+		{
+			if (m_options.flushMode == FlushMode::IMMEDIATE)
+			{
+				return FlushTrigger::IMMEDIATE;
+			}
+
+			if (m_options.flushMode == FlushMode::ADAPTIVE && now - m_lastPublishFlushTime >= m_options.flushDelay)
+			{
+				return FlushTrigger::IDLE;
+			}
+
+			if (now >= m_oldestQueuedPublishTime + m_options.flushDelay)
+			{
+				return FlushTrigger::DEADLINE;
+			}
+
+			const std::size_t packetThreshold{ m_options.flushMode == FlushMode::ADAPTIVE ? m_adaptiveFlushPackets : m_options.flushPackets };
+			if (m_queuedComposerBytes >= m_options.flushBytes || getQueuedPublishCount() >= std::max<std::size_t>(packetThreshold, 1U))
+			{
+				return FlushTrigger::THRESHOLD;
+			}
+
+			return FlushTrigger::NOT_DUE;
+		}
+
+		void SendQueue::updateAdaptiveFlushTarget(FlushTrigger trigger) noexcept
+		{
+			if (m_options.flushMode != FlushMode::ADAPTIVE)
+			{
+				return;
+			}
+
+			switch (trigger)
+			{
+			case FlushTrigger::IDLE:
+				//Link was quiet, send single publishes straight away again.
+				m_adaptiveFlushPackets = 1U;
+				break;
+			case FlushTrigger::THRESHOLD:
+				//Publishes arrive faster than they are flushed, wait for bigger batches.
+				m_adaptiveFlushPackets = std::min(m_adaptiveFlushPackets * 2U, std::max<std::size_t>(m_options.flushPackets, 1U));
+				break;
+			case FlushTrigger::DEADLINE:
+				//Threshold was not reached in time, back off so fewer publishes wait for the delay.
+				m_adaptiveFlushPackets = std::max<std::size_t>(m_adaptiveFlushPackets / 2U, 1U);
+				break;
+			case FlushTrigger::NOT_DUE:
+			case FlushTrigger::IMMEDIATE:
+			case FlushTrigger::PIGGYBACK:
+				break;
+			}
+		}
+
+		bool SendQueue::applyTcpOptions(bool isMultiPacketBatch) noexcept
+		{
+			if (!m_options.manageTcpOptions || m_socket == nullptr)
+			{
+				return false;
+			}
+
+			const int handle{ m_socket->getNativeHandle() };
+			if (handle < 0)
+			{
+				return false;
+			}
+
+			if (handle != m_tcpOptionsHandle)
+			{
+				//Batching is done here, Nagle's algorithm would only delay the last segment of every batch.
+				if (!tcp::setNoDelay(handle, true))
+				{
+					LOG_DEBUG("SendQueue", "Failed to set TCP_NODELAY on socket handle %d.", handle);
+				}
+
+				m_tcpOptionsHandle = handle;
+			}
+
+			return isMultiPacketBatch && tcp::setCork(handle, true);
+		}
+
+		bool SendQueue::hasSendableControlPacket() const noexcept
+		{
+			const std::deque<PacketSendJobPtr>& controlLane{ m_lanes[static_cast<std::size_t>(SendPriority::CONTROL)] };
+			return !controlLane.empty() && controlLane.front()->canSend();
+		}
+
+		bool SendQueue::hasSendablePublish() const noexcept
+		{
+			const std::deque<PacketSendJobPtr>& qosLane{ m_lanes[static_cast<std::size_t>(SendPriority::QOS)] };
+			const std::deque<PacketSendJobPtr>& bulkLane{ m_lanes[static_cast<std::size_t>(SendPriority::BULK)] };
+			return (!qosLane.empty() && qosLane.front()->canSend()) || (!bulkLane.empty() && bulkLane.front()->canSend());
+		}
+
+		std::size_t SendQueue::getQueuedPublishCount() const noexcept
+		{
+			return m_lanes[static_cast<std::size_t>(SendPriority::QOS)].size() + m_lanes[static_cast<std::size_t>(SendPriority::BULK)].size();
+		}
+
+		void SendQueue::updateWritableState(SendBatchResult& outResult) noexcept
+		{
+			reportQueueSize();
+
+			if (!m_isFull)
+			{
+				//Acks and partial sends grow the buffer outside of addToQueue().
+				m_isFull = isAtHighWatermark();
+				return;
+			}
+
+			if (isAtLowWatermark())
+			{
+				LOG_DEBUG("SendQueue", "Send queue drained to low watermark, accepting publishes again.");
+
+				m_isFull = false;
+				outResult.becameWritable = true;
+				m_writableCondition.notify_all();
+			}
+		}
+
+		bool SendQueue::isAtHighWatermark() const noexcept
+		{
+			return (m_options.highWatermarkBytes != 0U && m_queuedComposerBytes + m_sendBuffer.size() >= m_options.highWatermarkBytes) ||
+				(m_options.highWatermarkPackets != 0U && getQueuedPacketCount() >= m_options.highWatermarkPackets);
+		}
+
+		bool SendQueue::isAtLowWatermark() const noexcept
+		{
+			return (m_options.highWatermarkBytes == 0U || m_queuedComposerBytes + m_sendBuffer.size() <= m_options.lowWatermarkBytes) &&
+				(m_options.highWatermarkPackets == 0U || getQueuedPacketCount() <= m_options.lowWatermarkPackets);
+		}
+
+		void SendQueue::reportQueueSize() noexcept
+		{
+			if (m_metricsPtr != nullptr)
+			{
+				m_metricsPtr->setSendQueueSize(getQueuedPacketCount(), m_queuedComposerBytes + m_sendBuffer.size());
+			}
+		}
+
 		int SendQueue::sendData(const ByteBuffer& data)
 		{
 			if (m_socket == nullptr)
 			{
-				LogError("SendQueue", "Cannot send data, socket is nullptr.");
+				LOG_ERROR("SendQueue", "Cannot send data, socket is nullptr.");
 				return -1;
 			}
 
-			LogTrace("SendQueue", "Sending data. Size: %d", data.size());
+			LOG_TRACE("SendQueue", "Sending data. Size: %d", data.size());
 
 			if (data.size() > 0)
 			{
+				const TimePoint sendStart{ std::chrono::steady_clock::now() };
 				int sendResult{ m_socket->send(data) };
 
+				if (m_metricsPtr != nullptr)
+				{
+					m_metricsPtr->recordSocketSendTime(std::chrono::steady_clock::now() - sendStart);
+				}
+
 				if (sendResult >= 0)
 				{
-					LogTrace("SendQueue", "Data sent, Bytes: %d of %d.", sendResult, data.size());
+					captureWire(m_wireCaptureSinkPtr, WireDirection::SENT, data.bytes(), std::min(static_cast<std::size_t>(sendResult), data.size()));
+
+					LOG_TRACE("SendQueue", "Data sent, Bytes: %d of %d.", sendResult, data.size());
 					return sendResult;
 				}
 
-				LogError("SendQueue", "Sending packet failed at socket level: %d", m_socket->getLastError());
+				LOG_ERROR("SendQueue", "Sending packet failed at socket level: %d", m_socket->getLastError());
 
 				return m_socket->getLastError();
 			}
 
-			LogWarning("SendQueue", "Cannot send data, data buffer size is 0.");
+			LOG_WARNING("SendQueue", "Cannot send data, data buffer size is 0.");
 			return 0;
 		}
 	}
@@ -64,6 +64,21 @@ namespace kmMqtt
 			return m_impl->tick();
 		}
 
+		int MqttClient::getWakeupHandle() const noexcept
+		{
+			return m_impl->getWakeupHandle();
+		}
+
+		int MqttClient::getSocketHandle() const noexcept
+		{
+			return m_impl->getSocketHandle();
+		}
+
+		TimePoint MqttClient::nextDeadline() noexcept
+		{
+			return m_impl->nextDeadline();
+		}
+
 		ErrorEvent& MqttClient::onErrorEvent() noexcept
 		{
 			return m_impl->onErrorEvent();
@@ -104,6 +119,16 @@ namespace kmMqtt
 			return m_impl->onUnSubscribeAckEvent();
 		}
 
+		WritableEvent& MqttClient::onWritableEvent() noexcept
+		{
+			return m_impl->onWritableEvent();
+		}
+
+		MemoryBudgetExceededEvent& MqttClient::onMemoryBudgetExceededEvent() noexcept
+		{
+			return m_impl->onMemoryBudgetExceededEvent();
+		}
+
 		ConnectionStatus MqttClient::getConnectionStatus() const noexcept
 		{
 			return m_impl->getConnectionStatus();
@@ -118,5 +143,25 @@ namespace kmMqtt
 		{
 			return m_impl->getIsTickingAsync();
 		}
+
+		std::size_t MqttClient::getInboundConflatedCount() const noexcept
+		{
+			return m_impl->getInboundConflatedCount();
+		}
+
+		std::size_t MqttClient::getExpiredPublishCount() noexcept
+		{
+			return m_impl->getExpiredPublishCount();
+		}
+
+		MqttClientMetrics MqttClient::getMetrics() const
+		{
+			return m_impl->getMetrics();
+		}
+
+		MqttClientMemoryStats MqttClient::getMemoryStats() const noexcept
+		{
+			return m_impl->getMemoryStats();
+		}
 	}
 }
\ No newline at end of file
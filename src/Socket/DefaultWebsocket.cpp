@@ -6,7 +6,7 @@
 #ifdef BUILD_IXWEBSOCKET
 
 #include "kmMqtt/Sockets/DefaultWebsocket.h"
-#include "kmMqtt/Logger/Log.h"
+#include "kmMqtt/Logger/LogMacros.h"
 
 #include <ixwebsocket/IXNetSystem.h>
 
@@ -27,7 +27,7 @@ namespace kmMqtt
 			{
 				if (msg->type == ix::WebSocketMessageType::Open)
 				{
-					LogInfo("DefaultWebsocket", "WebSocket connection established.");
+					LOG_INFO("DefaultWebsocket", "WebSocket connection established.");
 					m_connected = true;
 					m_lastError = 0;
 
@@ -38,7 +38,7 @@ namespace kmMqtt
 				}
 				else if (msg->type == ix::WebSocketMessageType::Close)
 				{
-					LogInfo("DefaultWebsocket", "WebSocket connection closed.");
+					LOG_INFO("DefaultWebsocket", "WebSocket connection closed.");
 					m_connected = false;
 					m_lastCloseCode = msg->closeInfo.code;
 					m_lastCloseReason = msg->closeInfo.reason;
@@ -64,7 +64,7 @@ namespace kmMqtt
 				}
 				else if (msg->type == ix::WebSocketMessageType::Error)
 				{
-					LogError("DefaultWebsocket", msg->errorInfo.reason.c_str());
+					LOG_ERROR("DefaultWebsocket", msg->errorInfo.reason.c_str());
 					m_connected = false;
 					m_lastError = static_cast<int>(msg->errorInfo.retries);
 
@@ -96,24 +96,24 @@ namespace kmMqtt
 
 			if (!m_websocket)
 			{
-				LogError("DefaultWebsocket", "WebSocket instance is null.");
+				LOG_ERROR("DefaultWebsocket", "WebSocket instance is null.");
 				return false;
 			}
 
 			std::string url{ address.url() };
-			LogInfo("DefaultWebsocket", ("Connecting to: " + url).c_str());
+			LOG_INFO("DefaultWebsocket", ("Connecting to: " + url).c_str());
 
 			m_websocket->setUrl(url);
 			m_websocket->setExtraHeaders({ {"Sec-WebSocket-Protocol", "mqtt"} });
 
 			m_websocket->start();
 
-			LogInfo("DefaultWebsocket", "Connection initiated.");
+			LOG_INFO("DefaultWebsocket", "Connection initiated.");
 			return true;
 		}
 		catch (const std::exception& e)
 		{
-			LogError("DefaultWebsocket", "Exception during connect: %s", e.what());
+			LOG_ERROR("DefaultWebsocket", "Exception during connect: %s", e.what());
 #if defined(_WIN32) || defined(_WIN64)
 			ix::uninitNetSystem();
 #endif
@@ -121,7 +121,7 @@ namespace kmMqtt
 		}
 		catch (...)
 		{
-			LogError("DefaultWebsocket", "Unknown exception during connect.");
+			LOG_ERROR("DefaultWebsocket", "Unknown exception during connect.");
 #if defined(_WIN32) || defined(_WIN64)
 			ix::uninitNetSystem();
 #endif
@@ -135,7 +135,7 @@ namespace kmMqtt
 		{
 			if (!m_connected || !m_websocket)
 			{
-				LogError("DefaultWebsocket", "Cannot send: not connected.");
+				LOG_ERROR("DefaultWebsocket", "Cannot send: not connected.");
 				return -1;
 			}
 
@@ -148,19 +148,19 @@ namespace kmMqtt
 			}
 			else
 			{
-				LogError("DefaultWebsocket", "Send failed");
+				LOG_ERROR("DefaultWebsocket", "Send failed");
 				m_lastError = -1;
 				return -1;
 			}
 		}
 		catch (const std::exception& e)
 		{
-			LogError("DefaultWebsocket", "Exception during send: %s", e.what());
+			LOG_ERROR("DefaultWebsocket", "Exception during send: %s", e.what());
 			return -1;
 		}
 		catch (...)
 		{
-			LogError("DefaultWebsocket", "Unknown exception during send.");
+			LOG_ERROR("DefaultWebsocket", "Unknown exception during send.");
 			return -1;
 		}
 	}
@@ -175,7 +175,7 @@ namespace kmMqtt
 		{
 			if (m_websocket)
 			{
-				LogInfo("DefaultWebsocket", "Closing WebSocket connection.");
+				LOG_INFO("DefaultWebsocket", "Closing WebSocket connection.");
 				m_websocket->stop();
 				m_connected = false;
 			}
@@ -183,12 +183,12 @@ namespace kmMqtt
 		}
 		catch (const std::exception& e)
 		{
-			LogError("DefaultWebsocket", "Exception during close: %s", e.what());
+			LOG_ERROR("DefaultWebsocket", "Exception during close: %s", e.what());
 			return false;
 		}
 		catch (...)
 		{
-			LogError("DefaultWebsocket", "Unknown exception during close.");
+			LOG_ERROR("DefaultWebsocket", "Unknown exception during close.");
 			return false;
 		}
 	}
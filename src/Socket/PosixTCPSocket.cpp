@@ -0,0 +1,218 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include "kmMqtt/Sockets/PosixTCPSocket.h"
+#include "kmMqtt/Logger/LogMacros.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace kmMqtt
+{
+	PosixTCPSocket::~PosixTCPSocket()
+	{
+		close();
+	}
+
+	bool PosixTCPSocket::connect(const mqtt::Address& address) noexcept
+	{
+		close();
+
+		struct addrinfo hints = {};
+		struct addrinfo* result = nullptr;
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+
+		const int resolveResult{ ::getaddrinfo(address.hostname().c_str(), address.port().c_str(), &hints, &result) };
+		if (resolveResult != 0)
+		{
+			LOG_ERROR("PosixTCPSocket", "getaddrinfo() failed for %s: %s", address.hostname().c_str(), ::gai_strerror(resolveResult));
+			return false;
+		}
+
+		m_socket = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+		if (m_socket < 0)
+		{
+			m_lastError = -errno;
+			LOG_ERROR("PosixTCPSocket", "socket() failed: %s", std::strerror(errno));
+			::freeaddrinfo(result);
+			return false;
+		}
+
+		::fcntl(m_socket, F_SETFD, FD_CLOEXEC);
+		::fcntl(m_socket, F_SETFL, ::fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK);
+
+#if defined(SO_NOSIGPIPE)
+		//No MSG_NOSIGNAL on Apple platforms, a broker closing the connection must not kill the process.
+		const int noSigPipe{ 1 };
+		::setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+		const int connectResult{ ::connect(m_socket, result->ai_addr, result->ai_addrlen) };
+		const int connectError{ errno };
+		::freeaddrinfo(result);
+
+		if (connectResult != 0 && connectError != EINPROGRESS)
+		{
+			LOG_ERROR("PosixTCPSocket", "connect() failed: %s", std::strerror(connectError));
+			close();
+			m_lastError = -connectError;
+			return false;
+		}
+
+		//Completion is reported from tick(), even when a local connect finished straight away.
+		m_isConnecting = true;
+		LOG_INFO("PosixTCPSocket", "Connection pending.");
+
+		return true;
+	}
+
+	int PosixTCPSocket::send(const ByteBuffer& data) noexcept
+	{
+		if (!m_connected || m_socket < 0)
+		{
+			return -1;
+		}
+
+#if defined(MSG_NOSIGNAL)
+		const ssize_t sent{ ::send(m_socket, data.bytes(), data.size(), MSG_NOSIGNAL) };
+#else
+		const ssize_t sent{ ::send(m_socket, data.bytes(), data.size(), 0) };
+#endif
+
+		if (sent >= 0)
+		{
+			return static_cast<int>(sent);
+		}
+
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+		{
+			//Kernel send buffer is full, the SDK keeps the rest for the next batch.
+			return 0;
+		}
+
+		m_lastError = -errno;
+		return m_lastError;
+	}
+
+	bool PosixTCPSocket::close() noexcept
+	{
+		if (m_socket >= 0)
+		{
+			::close(m_socket);
+			m_socket = -1;
+		}
+
+		m_connected = false;
+		m_isConnecting = false;
+		return true;
+	}
+
+	void PosixTCPSocket::tick() noexcept
+	{
+		if (m_socket < 0 || (m_connected && m_isReadPaused))
+		{
+			return;
+		}
+
+		struct pollfd pollFd = {};
+		pollFd.fd = m_socket;
+		pollFd.events = m_isConnecting ? POLLOUT : POLLIN;
+
+		if (::poll(&pollFd, 1, 0) <= 0)
+		{
+			return;
+		}
+
+		if (m_isConnecting)
+		{
+			int error{ 0 };
+			socklen_t errorSize{ sizeof(error) };
+			if (::getsockopt(m_socket, SOL_SOCKET, SO_ERROR, &error, &errorSize) != 0)
+			{
+				error = errno;
+			}
+
+			m_isConnecting = false;
+
+			if (error != 0)
+			{
+				LOG_ERROR("PosixTCPSocket", "Connection failed to establish: %s", std::strerror(error));
+				close();
+				m_lastError = -error;
+
+				if (m_onConnectCallback)
+				{
+					m_onConnectCallback(false);
+				}
+
+				if (m_onErrorCallback)
+				{
+					m_onErrorCallback(static_cast<std::uint16_t>(error));
+				}
+
+				return;
+			}
+
+			LOG_INFO("PosixTCPSocket", "Connection established.");
+			m_connected = true;
+
+			if (m_onConnectCallback)
+			{
+				m_onConnectCallback(true);
+			}
+
+			return;
+		}
+
+		readAvailable();
+	}
+
+	void PosixTCPSocket::readAvailable() noexcept
+	{
+		std::uint8_t buffer[65536];
+		const ssize_t bytesReceived{ ::recv(m_socket, buffer, sizeof(buffer), 0) };
+
+		if (bytesReceived > 0)
+		{
+			ByteBuffer byteBuffer{ static_cast<std::size_t>(bytesReceived) };
+			byteBuffer.append(buffer, static_cast<std::size_t>(bytesReceived));
+
+			if (m_onRecvdCallback)
+			{
+				m_onRecvdCallback(std::move(byteBuffer));
+			}
+		}
+		else if (bytesReceived == 0)
+		{
+			LOG_INFO("PosixTCPSocket", "Connection closed by peer.");
+			close();
+
+			if (m_onDisconnectCallback)
+			{
+				m_onDisconnectCallback();
+			}
+		}
+		else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+		{
+			const int error{ errno };
+			LOG_ERROR("PosixTCPSocket", "recv() failed: %s", std::strerror(error));
+			close();
+			m_lastError = -error;
+
+			if (m_onErrorCallback)
+			{
+				m_onErrorCallback(static_cast<std::uint16_t>(error));
+			}
+		}
+	}
+}
+#endif //!defined(_WIN32) && !defined(_WIN64)
@@ -129,11 +129,64 @@ namespace kmMqtt
 		WSACleanup();
 
 		m_connected = false;
+		m_hasUnreadData = false;
 		return true;
 	}
 
+	int WindowsTCPSocket::getNativeHandle() const noexcept
+	{
+		//Kernel handles only use their low 32 bits, so the SOCKET fits the int of the interface.
+		return m_socket != INVALID_SOCKET ? static_cast<int>(m_socket) : -1;
+	}
+
+	void WindowsTCPSocket::setReadPaused(bool paused) noexcept
+	{
+		m_isReadPaused = paused;
+	}
+
+	void WindowsTCPSocket::readAvailable() noexcept
+	{
+		char buffer[65536];
+		const int bytesReceived = recv(m_socket, buffer, sizeof(buffer), 0);
+
+		if (bytesReceived > 0)
+		{
+			ByteBuffer byteBuffer{ static_cast<std::size_t>(bytesReceived) };
+			byteBuffer.append(reinterpret_cast<const std::uint8_t*>(buffer), bytesReceived);
+
+			if (m_onRecvdCallback)
+			{
+				m_onRecvdCallback(std::move(byteBuffer));
+			}
+		}
+		else if (bytesReceived == 0)
+		{
+			if (m_onDisconnectCallback)
+			{
+				m_onDisconnectCallback();
+			}
+			m_connected = false;
+			logInfo("recv event with 0 bytes. Disconnected.");
+		}
+		else
+		{
+			if (m_onErrorCallback)
+			{
+				m_onErrorCallback(static_cast<std::int16_t>(WSAGetLastError()));
+			}
+			m_connected = false;
+			logInfo("recv below 0 bytes. Disconnected.");
+		}
+	}
+
 	void WindowsTCPSocket::tick() noexcept
 	{
+		if (!m_isReadPaused && m_hasUnreadData)
+		{
+			m_hasUnreadData = false;
+			readAvailable();
+		}
+
 		if (WSAWaitForMultipleEvents(1, &m_event, FALSE, 0, FALSE) == WSA_WAIT_TIMEOUT)
 		{
 			return;
@@ -177,36 +230,13 @@ namespace kmMqtt
 
 		if (networkEvents.lNetworkEvents & FD_READ)
 		{
-			char buffer[65536];
-			const int bytesReceived = recv(m_socket, buffer, sizeof(buffer), 0);
-
-			if (bytesReceived > 0)
+			if (m_isReadPaused)
 			{
-				ByteBuffer byteBuffer{ static_cast<std::size_t>(bytesReceived) };
-				byteBuffer.append(reinterpret_cast<const std::uint8_t*>(buffer), bytesReceived);
-
-				if (m_onRecvdCallback)
-				{
-					m_onRecvdCallback(std::move(byteBuffer));
-				}
-			}
-			else if (bytesReceived == 0)
-			{
-				if (m_onDisconnectCallback)
-				{
-					m_onDisconnectCallback();
-				}
-				m_connected = false;
-				logInfo("recv event with 0 bytes. Disconnected.");
+				m_hasUnreadData = true;
 			}
 			else
 			{
-				if (m_onErrorCallback)
-				{
-					m_onErrorCallback(static_cast<std::int16_t>(WSAGetLastError()));
-				}
-				m_connected = false;
-				logInfo("recv below 0 bytes. Disconnected.");
+				readAvailable();
 			}
 		}
 
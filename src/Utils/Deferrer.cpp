@@ -9,22 +9,130 @@ namespace kmMqtt
 {
 	namespace events
 	{
+		//Blocks kept for reuse after a burst of deferred events, anything above is released on reset.
+		static constexpr std::size_t k_maxRetainedArenaBlocks{ 4U };
+
+		Deferrer::~Deferrer() noexcept
+		{
+			clear();
+		}
+
 		void Deferrer::invokeEvents() noexcept
 		{
-			while (!m_events.empty())
+			++m_invokeDepth;
+
+			//Events deferred while invoking are appended to the tail and invoked in the same pass.
+			while (m_head != nullptr)
 			{
-				m_events.front()->call();
-				m_events.pop();
+				ICallable* callable{ m_head };
+				m_head = callable->next;
+
+				if (m_head == nullptr)
+				{
+					m_tail = nullptr;
+				}
+
+				callable->call();
+				destroy(callable);
+			}
+
+			--m_invokeDepth;
+
+			if (m_invokeDepth == 0U)
+			{
+				resetArena();
 			}
 		}
 
 		void Deferrer::clear() noexcept
 		{
-			if (!m_events.empty())
+			while (m_head != nullptr)
+			{
+				ICallable* callable{ m_head };
+				m_head = callable->next;
+				destroy(callable);
+			}
+
+			m_tail = nullptr;
+
+			//An outer invokeEvents() may still be running a callable that lives in the arena.
+			if (m_invokeDepth == 0U)
+			{
+				resetArena();
+			}
+		}
+
+		void* Deferrer::allocate(std::size_t size, std::size_t alignment)
+		{
+			if (size + alignment > DEFERRER_ARENA_BLOCK_SIZE)
 			{
-				std::queue<std::unique_ptr<ICallable>> empty;
-				m_events.swap(empty);
+				return nullptr;
 			}
+
+			while (true)
+			{
+				if (m_currentBlock == m_blocks.size())
+				{
+					ArenaBlock block;
+					block.memory.reset(new unsigned char[DEFERRER_ARENA_BLOCK_SIZE]);
+					m_blocks.push_back(std::move(block));
+				}
+
+				ArenaBlock& block{ m_blocks[m_currentBlock] };
+
+				const std::uintptr_t base{ reinterpret_cast<std::uintptr_t>(block.memory.get()) };
+				const std::uintptr_t aligned{ (base + block.used + alignment - 1U) & ~(static_cast<std::uintptr_t>(alignment) - 1U) };
+				const std::size_t offset{ static_cast<std::size_t>(aligned - base) };
+
+				if (offset + size <= DEFERRER_ARENA_BLOCK_SIZE)
+				{
+					block.used = offset + size;
+					return reinterpret_cast<void*>(aligned);
+				}
+
+				++m_currentBlock;
+			}
+		}
+
+		void Deferrer::push(ICallable* callable) noexcept
+		{
+			if (m_tail == nullptr)
+			{
+				m_head = callable;
+			}
+			else
+			{
+				m_tail->next = callable;
+			}
+
+			m_tail = callable;
+		}
+
+		void Deferrer::destroy(ICallable* callable) noexcept
+		{
+			if (callable->isHeapAllocated)
+			{
+				delete callable;
+			}
+			else
+			{
+				callable->~ICallable();
+			}
+		}
+
+		void Deferrer::resetArena() noexcept
+		{
+			if (m_blocks.size() > k_maxRetainedArenaBlocks)
+			{
+				m_blocks.resize(k_maxRetainedArenaBlocks);
+			}
+
+			for (auto& block : m_blocks)
+			{
+				block.used = 0U;
+			}
+
+			m_currentBlock = 0U;
 		}
 	}
 }
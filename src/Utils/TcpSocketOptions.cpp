@@ -0,0 +1,56 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Utils/TcpSocketOptions.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace kmMqtt
+{
+	namespace tcp
+	{
+		bool setNoDelay(int handle, bool enable) noexcept
+		{
+			if (handle < 0)
+			{
+				return false;
+			}
+
+			const int value{ enable ? 1 : 0 };
+
+#if defined(_WIN32) || defined(_WIN64)
+			return ::setsockopt(static_cast<SOCKET>(handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&value), sizeof(value)) == 0;
+#else
+			return ::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) == 0;
+#endif
+		}
+
+		bool setCork(int handle, bool enable) noexcept
+		{
+			if (handle < 0)
+			{
+				return false;
+			}
+
+			const int value{ enable ? 1 : 0 };
+
+#if defined(__linux__)
+			return ::setsockopt(handle, IPPROTO_TCP, TCP_CORK, &value, sizeof(value)) == 0;
+#elif defined(TCP_NOPUSH)
+			return ::setsockopt(handle, IPPROTO_TCP, TCP_NOPUSH, &value, sizeof(value)) == 0;
+#else
+			(void)value;
+			return false;
+#endif
+		}
+	}
+}
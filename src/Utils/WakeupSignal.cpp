@@ -0,0 +1,119 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include "kmMqtt/Utils/WakeupSignal.h"
+#include "kmMqtt/Logger/LogMacros.h"
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+
+namespace kmMqtt
+{
+	WakeupSignal::~WakeupSignal() noexcept
+	{
+#if !defined(_WIN32) && !defined(_WIN64)
+		if (m_readHandle >= 0)
+		{
+			::close(m_readHandle);
+		}
+
+		if (m_writeHandle >= 0 && m_writeHandle != m_readHandle)
+		{
+			::close(m_writeHandle);
+		}
+#endif
+	}
+
+	bool WakeupSignal::open() noexcept
+	{
+		if (m_readHandle >= 0)
+		{
+			return true;
+		}
+
+#if defined(__linux__)
+		m_readHandle = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		m_writeHandle = m_readHandle;
+#elif !defined(_WIN32) && !defined(_WIN64)
+		int handles[2]{ -1, -1 };
+		if (::pipe(handles) == 0)
+		{
+			for (const int handle : handles)
+			{
+				::fcntl(handle, F_SETFL, ::fcntl(handle, F_GETFL) | O_NONBLOCK);
+				::fcntl(handle, F_SETFD, FD_CLOEXEC);
+			}
+
+			m_readHandle = handles[0];
+			m_writeHandle = handles[1];
+		}
+#endif
+
+		if (m_readHandle < 0)
+		{
+			LOG_WARNING("WakeupSignal", "Pollable wakeup handle is not available on this platform.");
+			return false;
+		}
+
+		return true;
+	}
+
+	void WakeupSignal::signal() noexcept
+	{
+#if defined(__linux__)
+		if (m_writeHandle >= 0)
+		{
+			const std::uint64_t value{ 1U };
+			if (::write(m_writeHandle, &value, sizeof(value)) < 0)
+			{
+				//Only fails with EAGAIN when the counter is saturated, handle is readable either way.
+			}
+		}
+#elif !defined(_WIN32) && !defined(_WIN64)
+		if (m_writeHandle >= 0)
+		{
+			const char value{ 1 };
+			if (::write(m_writeHandle, &value, sizeof(value)) < 0)
+			{
+				//Only fails with EAGAIN when the pipe is full, handle is readable either way.
+			}
+		}
+#endif
+	}
+
+	void WakeupSignal::clear() noexcept
+	{
+#if defined(__linux__)
+		if (m_readHandle >= 0)
+		{
+			std::uint64_t value{ 0U };
+			if (::read(m_readHandle, &value, sizeof(value)) < 0)
+			{
+				//EAGAIN, nothing was signalled.
+			}
+		}
+#elif !defined(_WIN32) && !defined(_WIN64)
+		if (m_readHandle >= 0)
+		{
+			char drain[64];
+			while (::read(m_readHandle, drain, sizeof(drain)) > 0)
+			{
+			}
+		}
+#endif
+	}
+
+	int WakeupSignal::getHandle() const noexcept
+	{
+		return m_readHandle;
+	}
+}
@@ -15,10 +15,8 @@
 // Helper to create a connected MqttClient with a mock socket
 struct TestClientContext 
 {
-    TestClientContext(const kmMqtt::Config& config = {}, bool socketConnectResult = true)
+    TestClientContext(const kmMqtt::Config& config = {}, bool socketConnectResult = true, const MqttClientOptions& options = MqttClientOptions{ kmMqtt::TickMode::SYNC })
     {
-        MqttClientOptions options{ kmMqtt::TickMode::SYNC };
-
         auto env{ TestEnvironment() };
         env.config = config;
 
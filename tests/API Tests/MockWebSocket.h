@@ -31,6 +31,7 @@ public:
     std::vector<ByteBuffer> sentPackets;
     std::queue<ByteBuffer> pendingResponses;
     bool connected = false;
+    bool readPaused = false;
 
     bool connect(const mqtt::Address& address) noexcept override
     {
@@ -86,7 +87,7 @@ public:
     void tick() noexcept override 
     {
         // Simulate receiving a packet if one is queued
-        if (connected && !pendingResponses.empty()) 
+        if (connected && !readPaused && !pendingResponses.empty()) 
         {
             ByteBuffer resp = std::move(pendingResponses.front());
             pendingResponses.pop();
@@ -97,6 +98,7 @@ public:
         }
     }
 
+    void setReadPaused(bool paused) noexcept override { readPaused = paused; }
     bool isConnected() const noexcept override { return isConnectedResult; }
     int getLastError() const noexcept override { return lastError; }
     int getLastCloseCode() const noexcept override { return lastCloseCode; }
@@ -131,6 +133,7 @@ public:
         sentPackets.clear();
         while (!pendingResponses.empty()) pendingResponses.pop();
         connected = false;
+        readPaused = false;
     }
 };
 
@@ -164,4 +164,20 @@ TEST_SUITE("MqttClientOptions Tests")
 		CHECK(options.getCallbackDispatcher() == customDispatcher);
 		CHECK(options.isUsingInternalCallbackDeferrer() == false);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("MqttClientOptions - Publish Ordering Key")
+	{
+		MqttClientOptions options;
+
+		//Default is a hash of the full topic
+		REQUIRE(options.getPublishOrderingKey());
+		CHECK(options.getPublishOrderingKey()("a/b") == std::hash<std::string>{}("a/b"));
+
+		options.publishOrderingKey([](const std::string& topic) { return topic.size(); });
+		CHECK(options.getPublishOrderingKey()("abc") == 3);
+
+		//nullptr restores default
+		options.publishOrderingKey(nullptr);
+		CHECK(options.getPublishOrderingKey()("a/b") == std::hash<std::string>{}("a/b"));
+	}
+}
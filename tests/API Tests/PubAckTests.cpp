@@ -5,13 +5,129 @@
 
 #include <doctest.h>
 #include <kmMqtt/MqttClient.h>
+#include <kmMqtt/Mqtt/State/SessionState/IAsyncSessionStatePersistantStore.h>
 #include <string>
+#include <vector>
 #include "MockWebSocket.h"
 #include "Helpers.h"
 
 using namespace kmMqtt;
 using namespace kmMqtt::mqtt;
 
+//Inbound PUBLISH on topic "test" with a 2 byte payload.
+static ByteBuffer createInboundPublish(std::uint8_t fixedHeader, std::uint16_t packetId)
+{
+    ByteBuffer pub(13);
+    pub += fixedHeader;
+    pub += 0x0B; //Remaining length
+    pub += 0x00; //Topic length MSB
+    pub += 0x04; //Topic length LSB
+    pub += 't';
+    pub += 'e';
+    pub += 's';
+    pub += 't';
+    pub.append(packetId);
+    pub += 0x00; //No properties
+    pub += 0x01; //Payload
+    pub += 0x02;
+
+    return pub;
+}
+
+//Inbound QoS 0 PUBLISH on topic "tst" + `topicSuffix` with a 1 byte payload.
+static ByteBuffer createInboundQos0Publish(char topicSuffix, std::uint8_t payload)
+{
+    ByteBuffer pub(10);
+    pub += 0x30;
+    pub += 0x08; //Remaining length
+    pub += 0x00; //Topic length MSB
+    pub += 0x04; //Topic length LSB
+    pub += 't';
+    pub += 's';
+    pub += 't';
+    pub += static_cast<std::uint8_t>(topicSuffix);
+    pub += 0x00; //No properties
+    pub += payload;
+
+    return pub;
+}
+
+//Packet ids of every PUBACK sent, in order, across however the acks were batched into sends.
+static std::vector<std::uint16_t> sentPubAckIds(const std::vector<ByteBuffer>& sentPackets)
+{
+    std::vector<std::uint16_t> ids;
+    for (const auto& buffer : sentPackets)
+    {
+        for (std::size_t i = 0; i + 4 <= buffer.size() && buffer[i] == 0x40; i += 4)
+        {
+            ids.push_back(static_cast<std::uint16_t>((buffer[i + 2] << 8) | buffer[i + 3]));
+        }
+    }
+
+    return ids;
+}
+
+static bool isFixedAck(const ByteBuffer& buffer, std::uint8_t fixedHeader, std::uint16_t packetId)
+{
+    return buffer.size() == 4 &&
+        buffer[0] == fixedHeader &&
+        buffer[1] == 0x02 &&
+        buffer[2] == static_cast<std::uint8_t>(packetId >> 8) &&
+        buffer[3] == static_cast<std::uint8_t>(packetId & 0xFF);
+}
+
+//Holds callbacks until the test runs them, to observe ack timing relative to the publish callback.
+class HeldCallbackDispatcher : public ICallbackDispatcher
+{
+public:
+    void dispatch(UniqueFunction callback) noexcept override
+    {
+        callbacks.push_back(std::move(callback));
+    }
+
+    void runAll()
+    {
+        for (auto& callback : callbacks)
+        {
+            callback();
+        }
+
+        callbacks.clear();
+    }
+
+    std::vector<UniqueFunction> callbacks;
+};
+
+//Async store that only reports changes durable when the test completes its barriers.
+class ManualAsyncStore : public IAsyncSessionStatePersistantStore
+{
+public:
+    bool initialize(const char*) override { return true; }
+    bool write(const char*, std::uint32_t, const SavedData&) override { return true; }
+    bool readAll(const char*, std::vector<SavedData>&) override { return true; }
+    bool removeMessage(const char*, std::uint16_t) override { return true; }
+    bool updateMessage(const char*, std::uint16_t, PublishMessageStatus, bool) override { return true; }
+    bool removeFromStore(const char*) override { return true; }
+    bool removeExpiredFromStore() override { return true; }
+
+    void notifyWhenDurable(DurableCallback callback) override
+    {
+        barriers.push_back(std::move(callback));
+    }
+
+    void completeAll(bool success)
+    {
+        for (auto& barrier : barriers)
+        {
+            barrier(success);
+        }
+
+        barriers.clear();
+    }
+
+    std::vector<DurableCallback> barriers;
+};
+
 TEST_SUITE("MqttClient PubAck")
 {
     TEST_CASE("Successful PubAck after QOS 1 Publish")
@@ -505,4 +621,308 @@ TEST_SUITE("MqttClient PubAck")
 
         CHECK(actualOrder == expectedOrder);
     }
-}
\ No newline at end of file
+
+    TEST_CASE("Received QOS 1 Publish is acknowledged with a fixed 4 byte PUBACK")
+    {
+        TestClientContext testContext;
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        testContext.receiveResponse(createInboundPublish(0x32, 5));
+        testContext.socketPtr->sentPackets.clear();
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        CHECK(isFixedAck(testContext.socketPtr->sentPackets[0], 0x40, 5));
+    }
+
+    TEST_CASE("Acks for a batch of received publishes are sent together")
+    {
+        TestClientContext testContext;
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        ByteBuffer batch(39);
+        batch.append(createInboundPublish(0x32, 1));
+        batch.append(createInboundPublish(0x32, 2));
+        batch.append(createInboundPublish(0x34, 3));
+
+        testContext.receiveResponse(batch);
+        testContext.socketPtr->sentPackets.clear();
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+
+        const ByteBuffer& sent{ testContext.socketPtr->sentPackets[0] };
+        REQUIRE(sent.size() == 12);
+
+        const std::uint8_t expected[12]{ 0x40, 0x02, 0x00, 0x01, 0x40, 0x02, 0x00, 0x02, 0x50, 0x02, 0x00, 0x03 };
+        for (std::size_t i = 0; i < 12; ++i)
+        {
+            CHECK(sent[i] == expected[i]);
+        }
+    }
+
+    TEST_CASE("Received QOS 2 Publish flow uses fixed format PUBREC and PUBCOMP")
+    {
+        TestClientContext testContext;
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        testContext.receiveResponse(createInboundPublish(0x34, 7));
+        testContext.socketPtr->sentPackets.clear();
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        CHECK(isFixedAck(testContext.socketPtr->sentPackets[0], 0x50, 7));
+
+        ByteBuffer pubRel(4);
+        pubRel += 0x62;
+        pubRel += 0x02;
+        pubRel += 0x00;
+        pubRel += 0x07;
+
+        testContext.receiveResponse(pubRel);
+        testContext.socketPtr->sentPackets.clear();
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        CHECK(isFixedAck(testContext.socketPtr->sentPackets[0], 0x70, 7));
+    }
+
+    TEST_CASE("ON_DECODE ack mode acknowledges before the publish callback runs")
+    {
+        auto dispatcher{ std::make_shared<HeldCallbackDispatcher>() };
+        MqttClientOptions options{ TickMode::SYNC };
+        options.callbackDispatcher(dispatcher);
+
+        TestClientContext testContext{ {}, true, options };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        bool publishReceived{ false };
+        testContext.client->onPublishEvent().add([&](const PublishEventDetails&, const Publish&) { publishReceived = true; });
+
+        testContext.receiveResponse(createInboundPublish(0x32, 3));
+        CHECK(testContext.client->tick().noError());
+
+        CHECK_FALSE(publishReceived);
+        REQUIRE(testContext.socketPtr->sentPackets.size() > 0);
+        CHECK(isFixedAck(testContext.socketPtr->sentPackets.back(), 0x40, 3));
+    }
+
+    TEST_CASE("AFTER_CALLBACK ack mode acknowledges once the publish callback has run")
+    {
+        auto dispatcher{ std::make_shared<HeldCallbackDispatcher>() };
+        MqttClientOptions options{ TickMode::SYNC };
+        options.callbackDispatcher(dispatcher).ackMode(AckMode::AFTER_CALLBACK);
+
+        TestClientContext testContext{ {}, true, options };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        bool publishReceived{ false };
+        testContext.client->onPublishEvent().add([&](const PublishEventDetails&, const Publish&) { publishReceived = true; });
+
+        testContext.receiveResponse(createInboundPublish(0x32, 3));
+        testContext.socketPtr->sentPackets.clear();
+        CHECK(testContext.client->tick().noError());
+
+        CHECK_FALSE(publishReceived);
+        CHECK(testContext.socketPtr->sentPackets.empty());
+
+        dispatcher->runAll();
+        CHECK(publishReceived);
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        CHECK(isFixedAck(testContext.socketPtr->sentPackets[0], 0x40, 3));
+    }
+
+    TEST_CASE("Async session store holds acks until received publishes are durable")
+    {
+        auto store{ std::make_shared<ManualAsyncStore>() };
+        MqttClientOptions options{ TickMode::SYNC };
+        options.asyncSessionStatePersistantStore(store);
+
+        TestClientContext testContext{ {}, true, options };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        ByteBuffer batch(26);
+        batch.append(createInboundPublish(0x32, 1));
+        batch.append(createInboundPublish(0x34, 2));
+
+        testContext.receiveResponse(batch);
+        testContext.socketPtr->sentPackets.clear();
+
+        CHECK(testContext.client->tick().noError());
+        CHECK(testContext.socketPtr->sentPackets.empty());
+        REQUIRE(store->barriers.size() == 1);
+
+        //Other traffic keeps flowing while acks are held.
+        ByteBuffer payload(1);
+        payload += 0x01;
+        CHECK(testContext.client->publish("test/topic", std::move(payload), PublishOptions{}).noError());
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        CHECK(testContext.socketPtr->sentPackets[0][0] == 0x30);
+        testContext.socketPtr->sentPackets.clear();
+
+        store->completeAll(true);
+        const auto deadline{ testContext.client->nextDeadline() };
+        CHECK(deadline <= std::chrono::steady_clock::now());
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+
+        const ByteBuffer& sent{ testContext.socketPtr->sentPackets[0] };
+        REQUIRE(sent.size() == 8);
+
+        const std::uint8_t expected[8]{ 0x40, 0x02, 0x00, 0x01, 0x50, 0x02, 0x00, 0x02 };
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            CHECK(sent[i] == expected[i]);
+        }
+    }
+
+    TEST_CASE("Async session store failure drops held acks and raises error")
+    {
+        auto store{ std::make_shared<ManualAsyncStore>() };
+        MqttClientOptions options{ TickMode::SYNC };
+        options.asyncSessionStatePersistantStore(store);
+
+        TestClientContext testContext{ {}, true, options };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        ClientErrorCode errorCode{ ClientErrorCode::No_Error };
+        testContext.client->onErrorEvent().add([&](ClientError error, SendResultData) { errorCode = error.errorCode; });
+
+        testContext.receiveResponse(createInboundPublish(0x34, 4));
+        testContext.socketPtr->sentPackets.clear();
+        CHECK(testContext.client->tick().noError());
+
+        store->completeAll(false);
+        CHECK(testContext.client->tick().noError());
+        CHECK(testContext.client->tick().noError());
+
+        CHECK(testContext.socketPtr->sentPackets.empty());
+        CHECK(errorCode == ClientErrorCode::Failed_Writing_To_Persistent_Storage);
+    }
+
+    TEST_CASE("Conflated QoS 0 publishes deliver only the newest message per topic to a slow consumer")
+    {
+        auto dispatcher{ std::make_shared<HeldCallbackDispatcher>() };
+        MqttClientOptions options{ TickMode::SYNC };
+        ReceiveQueueOptions receiveOptions;
+        receiveOptions.conflateQos0 = true;
+        options.callbackDispatcher(dispatcher).receiveQueue(receiveOptions);
+
+        TestClientContext testContext{ {}, true, options };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        std::vector<std::string> topics;
+        std::vector<std::uint8_t> payloads;
+        testContext.client->onPublishEvent().add([&](const PublishEventDetails& details, const Publish&)
+        {
+            topics.push_back(details.topic);
+            payloads.push_back((*details.payload)[0]);
+        });
+
+        dispatcher->callbacks.clear();
+
+        ByteBuffer batch(66);
+        batch.append(createInboundQos0Publish('a', 1));
+        batch.append(createInboundQos0Publish('b', 2));
+        batch.append(createInboundPublish(0x32, 4));
+        batch.append(createInboundQos0Publish('a', 3));
+        batch.append(createInboundPublish(0x32, 5));
+        batch.append(createInboundQos0Publish('a', 4));
+
+        testContext.receiveResponse(batch);
+
+        CHECK(dispatcher->callbacks.size() == 4U);
+        CHECK(testContext.client->getInboundConflatedCount() == 2U);
+
+        dispatcher->runAll();
+
+        CHECK(topics == std::vector<std::string>{ "tsta", "tstb", "test", "test" });
+        CHECK(payloads == std::vector<std::uint8_t>{ 4, 2, 1, 1 });
+
+        //Once delivered, the next message on the topic is dispatched again.
+        testContext.receiveResponse(createInboundQos0Publish('a', 5));
+        dispatcher->runAll();
+
+        CHECK(topics.back() == "tsta");
+        CHECK(payloads.back() == 5U);
+        CHECK(testContext.client->getInboundConflatedCount() == 2U);
+    }
+
+    TEST_CASE("Inbound backlog over the high watermark pauses reads and holds acks until it drains")
+    {
+        auto dispatcher{ std::make_shared<HeldCallbackDispatcher>() };
+        MqttClientOptions options{ TickMode::SYNC };
+        ReceiveQueueOptions receiveOptions;
+        receiveOptions.highWatermarkMessages = 2U;
+        receiveOptions.lowWatermarkMessages = 0U;
+        options.callbackDispatcher(dispatcher).receiveQueue(receiveOptions);
+
+        TestClientContext testContext{ {}, true, options };
+        CHECK(testContext.tryConnectWithResponse().noError());
+        dispatcher->runAll();
+
+        ByteBuffer batch(26);
+        batch.append(createInboundPublish(0x32, 1));
+        batch.append(createInboundPublish(0x32, 2));
+
+        testContext.receiveResponse(batch);
+        testContext.socketPtr->sentPackets.clear();
+        CHECK(testContext.client->tick().noError());
+
+        //Second publish reached the high watermark, its ack is held and reading is paused.
+        CHECK(testContext.socketPtr->readPaused);
+        CHECK(sentPubAckIds(testContext.socketPtr->sentPackets) == std::vector<std::uint16_t>{ 1 });
+
+        testContext.socketPtr->queueMockResponse(createInboundPublish(0x32, 3));
+        CHECK(testContext.client->tick().noError());
+        CHECK(testContext.socketPtr->pendingResponses.size() == 1U);
+
+        //Consumer drains to the low watermark, reading resumes and held acks go out ahead of new ones.
+        dispatcher->runAll();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            CHECK(testContext.client->tick().noError());
+        }
+
+        CHECK_FALSE(testContext.socketPtr->readPaused);
+        CHECK(testContext.socketPtr->pendingResponses.empty());
+        CHECK(sentPubAckIds(testContext.socketPtr->sentPackets) == std::vector<std::uint16_t>{ 1, 2, 3 });
+    }
+
+    TEST_CASE("Publishes split across socket reads are reassembled")
+    {
+        TestClientContext testContext;
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        std::vector<std::uint16_t> receivedIds;
+        testContext.client->onPublishEvent().add([&](const PublishEventDetails&, const Publish& packet)
+            {
+                receivedIds.push_back(packet.getVariableHeader().packetIdentifier);
+            });
+
+        ByteBuffer stream(39);
+        stream.append(createInboundPublish(0x32, 1));
+        stream.append(createInboundPublish(0x32, 2));
+        stream.append(createInboundPublish(0x32, 3));
+
+        //Cut after the second packet's type byte, then at a packet boundary.
+        const std::size_t cuts[4]{ 0, 14, 26, 39 };
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            ByteBuffer read(cuts[i + 1] - cuts[i]);
+            read.append(stream.bytes() + cuts[i], cuts[i + 1] - cuts[i]);
+            testContext.receiveResponse(read);
+        }
+
+        CHECK(testContext.client->tick().noError());
+        REQUIRE(receivedIds.size() == 3);
+        CHECK(receivedIds[0] == 1);
+        CHECK(receivedIds[1] == 2);
+        CHECK(receivedIds[2] == 3);
+    }
+}
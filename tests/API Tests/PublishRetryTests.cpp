@@ -10,6 +10,7 @@
 #include <doctest.h>
 #include <string>
 #include <thread>
+#include <vector>
 
 using namespace kmMqtt;
 using namespace kmMqtt::mqtt;
@@ -402,4 +403,68 @@ TEST_SUITE("MqttClient Publish Retry and Session State")
         REQUIRE(leftOver == 0);
         REQUIRE(packets.size() == 1);
     }
-}
\ No newline at end of file
+
+    TEST_CASE("Retry of a sent publish is not expired and keeps its packet ID until acknowledged")
+    {
+        Config config;
+        config.retryPublishIntervalMS = 50;
+        config.pingAlways = false;
+
+        TestClientContext testContext{ config };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        std::vector<PublishCompleteEventDetails> completed;
+        testContext.client->onPublishCompletedEvent().add([&](const PublishCompleteEventDetails& details) { completed.push_back(details); });
+
+        testContext.socketPtr->sentPackets.clear();
+
+        const auto publish = [&]()
+            {
+                ByteBuffer payload(1);
+                payload += 0xAA;
+
+                PublishOptions options;
+                options.qos = Qos::QOS_1;
+                options.addMessageExpiryInterval = true;
+                options.messageExpiryInterval = 1U;
+
+                CHECK(testContext.client->publish("test/expiry", std::move(payload), std::move(options)).noError());
+                testContext.client->tick();
+            };
+
+        publish();
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+        testContext.client->tick(); //Process pending retries into queue for sending
+        testContext.client->tick(); //Send pending retries from queue
+
+        //The retry goes out although the expiry has passed, the broker may already hold the first attempt.
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 2);
+        CHECK((testContext.socketPtr->sentPackets[1].bytes()[0] & 0x08) == 0x08); //DUP flag
+        CHECK(completed.empty());
+
+        //Packet ID 1 is still reserved, a new publish cannot take it.
+        publish();
+
+        std::vector<ByteBuffer> packets;
+        std::size_t leftOver;
+        REQUIRE(separateMqttPacketByteBuffers(testContext.socketPtr->sentPackets.back(), packets, leftOver));
+        const ByteBuffer& newPublish{ packets.back() };
+        REQUIRE((newPublish.bytes()[0] & 0x08) == 0x00); //Not a retry
+        const std::size_t packetIdOffset{ 2U + 2U + 11U }; //Fixed header, topic length and "test/expiry".
+        CHECK(((newPublish.bytes()[packetIdOffset] << 8) | newPublish.bytes()[packetIdOffset + 1]) != 1);
+
+        ByteBuffer pubAckBuffer(4);
+        pubAckBuffer += 0x40; //PUBACK type
+        pubAckBuffer += 0x02; //Remaining length
+        pubAckBuffer += 0x00; //Packet ID MSB
+        pubAckBuffer += 0x01; //Packet ID LSB
+        testContext.receiveResponse(pubAckBuffer);
+
+        REQUIRE(completed.size() == 1);
+        CHECK(completed[0].packetId == 1);
+        CHECK(completed[0].packetType == PacketType::PUBLISH_ACKNOWLEDGE);
+    }
+}
@@ -5,14 +5,49 @@
 
 #include <doctest.h>
 #include <kmMqtt/MqttClient.h>
+#include <kmMqtt/Mqtt/Tracing/ITraceSink.h>
+#include <kmMqtt/Mqtt/Tracing/WireCaptureFileSink.h>
+#include <algorithm>
+#include <cstdio>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include "MockWebSocket.h"
 #include "Helpers.h"
 
 using namespace kmMqtt;
 using namespace kmMqtt::mqtt;
 
+struct RecordingTraceSink : public ITraceSink
+{
+    void onTraceEvent(const TraceEvent& event) noexcept override
+    {
+        std::lock_guard<std::mutex> guard{ mutex };
+        events.push_back(event);
+    }
+
+    std::vector<TraceStage> stagesFor(PacketType packetType, std::uint16_t packetId)
+    {
+        std::lock_guard<std::mutex> guard{ mutex };
+
+        std::vector<TraceStage> stages;
+        for (const auto& event : events)
+        {
+            if (event.packetType == packetType && event.packetId == packetId)
+            {
+                stages.push_back(event.stage);
+            }
+        }
+
+        return stages;
+    }
+
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+};
+
 TEST_SUITE("MqttClient Publish")
 {
     TEST_CASE("Successful Publish QOS 0")
@@ -474,4 +509,435 @@ TEST_SUITE("MqttClient Publish")
             CHECK((flags & 0x01) == 0x01); //Retain flag should be set
         }
     }
+
+    TEST_CASE("Publish while disconnected is spooled and sent in order after connect")
+    {
+        OfflineSpoolOptions spoolOptions;
+        spoolOptions.maxBytes = 4096U;
+
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        clientOptions.offlineSpool(spoolOptions);
+
+        TestClientContext testContext{ {}, true, clientOptions };
+
+        for (std::uint8_t i = 0; i < 3; ++i)
+        {
+            ByteBuffer payload(1);
+            payload += i;
+            auto result{ testContext.client->publish("test/spool", std::move(payload), PublishOptions{}) };
+            CHECK(result.noError());
+        }
+
+        CHECK(testContext.tryConnectWithResponse().noError());
+        testContext.socketPtr->sentPackets.clear();
+        testContext.client->tick();
+
+        //Spooled publishes are drained together and sent in one batch.
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        const ByteBuffer& sent{ testContext.socketPtr->sentPackets[0] };
+        REQUIRE(sent.size() >= 3 * 18);
+
+        //Publishes are last in the batch, after any ping: header, length, topic, properties (payload format), payload.
+        const std::size_t start{ sent.size() - 3 * 18 };
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            CHECK(sent[start + i * 18] == 0x30);
+            CHECK(sent[start + i * 18 + 17] == static_cast<std::uint8_t>(i));
+        }
+    }
+
+    TEST_CASE("Publish while disconnected fails when offline spool is full")
+    {
+        OfflineSpoolOptions spoolOptions;
+        spoolOptions.maxBytes = 64U;
+
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        clientOptions.offlineSpool(spoolOptions);
+
+        TestClientContext testContext{ {}, true, clientOptions };
+
+        ClientErrorCode lastError{ ClientErrorCode::No_Error };
+        for (int i = 0; i < 8 && lastError == ClientErrorCode::No_Error; ++i)
+        {
+            ByteBuffer payload(1);
+            payload += 0x01;
+            lastError = testContext.client->publish("test/spool", std::move(payload), PublishOptions{}).errorCode();
+        }
+
+        CHECK(lastError == ClientErrorCode::Offline_Spool_Full);
+    }
+
+    TEST_CASE("Publish returns Would_Block while send queue is over its high watermark")
+    {
+        SendQueueOptions queueOptions;
+        queueOptions.highWatermarkPackets = 2U;
+        queueOptions.lowWatermarkPackets = 0U;
+
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        clientOptions.sendQueue(queueOptions);
+
+        TestClientContext testContext{ {}, true, clientOptions };
+        CHECK(testContext.tryConnectWithResponse().noError());
+        testContext.client->tick(); //Send anything queued by the connect, so the queue starts empty.
+
+        int writableCount{ 0 };
+        testContext.client->onWritableEvent().add([&]() { ++writableCount; });
+
+        for (int i = 0; i < 2; ++i)
+        {
+            ByteBuffer payload(1);
+            payload += 0x01;
+            CHECK(testContext.client->publish("test/queue", std::move(payload), PublishOptions{}).noError());
+        }
+
+        ByteBuffer payload(1);
+        payload += 0x01;
+        CHECK(testContext.client->publish("test/queue", std::move(payload), PublishOptions{}).errorCode() == ClientErrorCode::Would_Block);
+        CHECK(writableCount == 0);
+
+        testContext.client->tick();
+
+        CHECK(writableCount == 1);
+
+        ByteBuffer retryPayload(1);
+        retryPayload += 0x01;
+        CHECK(testContext.client->publish("test/queue", std::move(retryPayload), PublishOptions{}).noError());
+    }
+
+    TEST_CASE("Publish returns Would_Block once queued bytes reach the high watermark")
+    {
+        SendQueueOptions queueOptions;
+        queueOptions.highWatermarkBytes = 64U;
+        queueOptions.lowWatermarkBytes = 16U;
+
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        clientOptions.sendQueue(queueOptions);
+
+        TestClientContext testContext{ {}, true, clientOptions };
+        CHECK(testContext.tryConnectWithResponse().noError());
+        testContext.client->tick(); //Send anything queued by the connect, so the queue starts empty.
+
+        ByteBuffer payload(64);
+        payload.append(std::vector<std::uint8_t>(64, 0xAB).data(), 64);
+        CHECK(testContext.client->publish("test/queue", std::move(payload), PublishOptions{}).noError());
+
+        ByteBuffer smallPayload(1);
+        smallPayload += 0x01;
+        CHECK(testContext.client->publish("test/queue", std::move(smallPayload), PublishOptions{}).errorCode() == ClientErrorCode::Would_Block);
+    }
+
+    TEST_CASE("Blocking publish times out with Would_Block when the queue does not drain")
+    {
+        SendQueueOptions queueOptions;
+        queueOptions.highWatermarkPackets = 1U;
+        queueOptions.fullPolicy = SendQueueFullPolicy::BLOCK;
+        queueOptions.blockTimeout = Milliseconds{ 10 };
+
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        clientOptions.sendQueue(queueOptions);
+
+        TestClientContext testContext{ {}, true, clientOptions };
+        CHECK(testContext.tryConnectWithResponse().noError());
+        testContext.client->tick(); //Send anything queued by the connect, so the queue starts empty.
+
+        ByteBuffer payload(1);
+        payload += 0x01;
+        CHECK(testContext.client->publish("test/queue", std::move(payload), PublishOptions{}).noError());
+
+        const auto start{ std::chrono::steady_clock::now() };
+        ByteBuffer blockedPayload(1);
+        blockedPayload += 0x01;
+        CHECK(testContext.client->publish("test/queue", std::move(blockedPayload), PublishOptions{}).errorCode() == ClientErrorCode::Would_Block);
+        CHECK(std::chrono::steady_clock::now() - start >= Milliseconds{ 10 });
+    }
+
+    TEST_CASE("Blocking publish continues once another thread drains the queue")
+    {
+        SendQueueOptions queueOptions;
+        queueOptions.highWatermarkPackets = 1U;
+        queueOptions.fullPolicy = SendQueueFullPolicy::BLOCK;
+        queueOptions.blockTimeout = Milliseconds{ 5000 };
+
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        clientOptions.sendQueue(queueOptions);
+
+        TestClientContext testContext{ {}, true, clientOptions };
+        CHECK(testContext.tryConnectWithResponse().noError());
+        testContext.client->tick(); //Send anything queued by the connect, so the queue starts empty.
+
+        ByteBuffer payload(1);
+        payload += 0x01;
+        CHECK(testContext.client->publish("test/queue", std::move(payload), PublishOptions{}).noError());
+
+        std::thread ticker([&]()
+        {
+            std::this_thread::sleep_for(Milliseconds{ 20 });
+            testContext.client->tick();
+        });
+
+        ByteBuffer blockedPayload(1);
+        blockedPayload += 0x02;
+        const auto result{ testContext.client->publish("test/queue", std::move(blockedPayload), PublishOptions{}) };
+        ticker.join();
+
+        CHECK(result.noError());
+    }
+
+    TEST_CASE("Conflated QoS 0 publishes replace the unsent value for their topic")
+    {
+        MqttClientOptions clientOptions{ TickMode::SYNC };
+        TestClientContext testContext{ {}, true, clientOptions };
+        CHECK(testContext.tryConnectWithResponse().noError());
+        testContext.client->tick();
+        testContext.socketPtr->sentPackets.clear();
+
+        auto publish = [&](const char* topic, std::uint8_t value, bool conflate)
+        {
+            ByteBuffer payload(1);
+            payload += value;
+            PublishOptions options;
+            options.conflate = conflate;
+            CHECK(testContext.client->publish(topic, std::move(payload), std::move(options)).noError());
+        };
+
+        publish("sensor/a", 1, true);
+        publish("sensor/b", 2, true);
+        publish("sensor/a", 3, true);
+        publish("sensor/a", 4, true);
+        publish("sensor/c", 5, false);
+        publish("sensor/c", 6, false);
+
+        testContext.client->tick();
+
+        //Each publish is 16 bytes: header, length, topic (2 + 8), properties (payload format), payload.
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        const ByteBuffer& sent{ testContext.socketPtr->sentPackets[0] };
+        REQUIRE(sent.size() == 4 * 16);
+
+        //sensor/a keeps its place in the queue with the latest value, non conflated publishes are all sent.
+        CHECK(sent[15] == 4);
+        CHECK(sent[16 + 15] == 2);
+        CHECK(sent[32 + 15] == 5);
+        CHECK(sent[48 + 15] == 6);
+
+        //Value sent, the next one queues again.
+        testContext.socketPtr->sentPackets.clear();
+        publish("sensor/a", 7, true);
+        testContext.client->tick();
+
+        REQUIRE(testContext.socketPtr->sentPackets.size() == 1);
+        CHECK(testContext.socketPtr->sentPackets[0][15] == 7);
+    }
+
+    TEST_CASE("Client metrics count packets by type and time the PUBACK")
+    {
+        TestClientContext testContext;
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        std::string topic = "test/qos1";
+        ByteBuffer payload(2);
+        payload += 0xAA;
+        payload += 0xBB;
+
+        PublishOptions options;
+        options.qos = Qos::QOS_1;
+
+        CHECK(testContext.client->publish(topic.c_str(), std::move(payload), std::move(options)).noError());
+        CHECK(testContext.client->tick().noError());
+
+        MqttClientMetrics metrics{ testContext.client->getMetrics() };
+        CHECK(metrics.packetsSent[static_cast<std::size_t>(PacketType::CONNECT)] == 1U);
+        CHECK(metrics.packetsSent[static_cast<std::size_t>(PacketType::PUBLISH)] == 1U);
+        CHECK(metrics.packetsReceived[static_cast<std::size_t>(PacketType::CONNECT_ACKNOWLEDGE)] == 1U);
+        CHECK(metrics.inFlightPublishes == 1U);
+        CHECK(metrics.publishAckLatency.count == 0U);
+
+        ByteBuffer pubAckBuffer(4);
+        pubAckBuffer += 0x40; //PUBACK type
+        pubAckBuffer += 0x02; //Remaining length
+        pubAckBuffer += 0x00; //Packet ID MSB
+        pubAckBuffer += 0x01; //Packet ID LSB
+
+        testContext.receiveResponse(pubAckBuffer);
+
+        metrics = testContext.client->getMetrics();
+        CHECK(metrics.packetsReceived[static_cast<std::size_t>(PacketType::PUBLISH_ACKNOWLEDGE)] == 1U);
+        CHECK(metrics.bytesReceived[static_cast<std::size_t>(PacketType::PUBLISH_ACKNOWLEDGE)] == 4U);
+        CHECK(metrics.inFlightPublishes == 0U);
+        CHECK(metrics.publishAckLatency.count == 1U);
+        CHECK(metrics.tickDuration.count >= 3U);
+        CHECK(metrics.socketSendTime.count >= 2U);
+
+        const std::string text{ toPrometheusText(metrics) };
+        CHECK(text.find("kmmqtt_packets_sent_total{type=\"PUBLISH\"} 1\n") != std::string::npos);
+        CHECK(text.find("kmmqtt_publish_ack_latency_seconds_count 1\n") != std::string::npos);
+    }
+
+    TEST_CASE("Memory stats track unacknowledged publishes and fire the budget event once per crossing")
+    {
+        TestClientContext testContext{ {}, true, MqttClientOptions{ TickMode::SYNC }.memoryBudget(10U) };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        std::vector<MqttClientMemoryStats> exceeded;
+        testContext.client->onMemoryBudgetExceededEvent().add([&](const MqttClientMemoryStats& stats)
+            {
+                exceeded.push_back(stats);
+            });
+
+        const auto publishQos1{ [&]()
+            {
+                ByteBuffer payload(2);
+                payload += 0xAA;
+                payload += 0xBB;
+
+                PublishOptions options;
+                options.qos = Qos::QOS_1;
+                options.userProperties.emplace("k", "v");
+
+                CHECK(testContext.client->publish("test/qos1", std::move(payload), std::move(options)).noError());
+                CHECK(testContext.client->tick().noError());
+            } };
+
+        publishQos1();
+
+        MqttClientMemoryStats stats{ testContext.client->getMemoryStats() };
+        CHECK(stats.sessionStateBytes == 11U); //Topic and payload.
+        CHECK(stats.propertyBytes == 2U);
+        CHECK(stats.sendQueueBytes == 0U);
+        CHECK(stats.sendBufferBytes == 0U);
+        CHECK(testContext.client->getMetrics().memory.sessionStateBytes == 11U);
+
+        testContext.client->tick(); //Deferred event runs on the next tick.
+        REQUIRE(exceeded.size() == 1U);
+        CHECK(exceeded[0].totalBytes() >= 13U);
+
+        //Still over the budget, no new event.
+        testContext.client->tick();
+        CHECK(exceeded.size() == 1U);
+
+        ByteBuffer pubAckBuffer(4);
+        pubAckBuffer += 0x40; //PUBACK type
+        pubAckBuffer += 0x02; //Remaining length
+        pubAckBuffer += 0x00; //Packet ID MSB
+        pubAckBuffer += 0x01; //Packet ID LSB
+        testContext.receiveResponse(pubAckBuffer);
+
+        stats = testContext.client->getMemoryStats();
+        CHECK(stats.sessionStateBytes == 0U);
+        CHECK(stats.propertyBytes == 0U);
+
+        //Back under the budget, the next crossing fires again.
+        publishQos1();
+        testContext.client->tick();
+        CHECK(exceeded.size() == 2U);
+    }
+
+    TEST_CASE("Trace sink receives the lifecycle stamps of outbound and inbound publishes")
+    {
+        auto sink{ std::make_shared<RecordingTraceSink>() };
+        TestClientContext testContext{ {}, true, MqttClientOptions{ TickMode::SYNC }.traceSink(sink) };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        ByteBuffer payload(2);
+        payload += 0xAA;
+        payload += 0xBB;
+
+        PublishOptions options;
+        options.qos = Qos::QOS_1;
+
+        CHECK(testContext.client->publish("test/qos1", std::move(payload), std::move(options)).noError());
+        CHECK(testContext.client->tick().noError());
+
+        ByteBuffer pubAckBuffer(4);
+        pubAckBuffer += 0x40; //PUBACK type
+        pubAckBuffer += 0x02; //Remaining length
+        pubAckBuffer += 0x00; //Packet ID MSB
+        pubAckBuffer += 0x01; //Packet ID LSB
+
+        testContext.receiveResponse(pubAckBuffer);
+
+        const std::vector<TraceStage> outbound{ sink->stagesFor(PacketType::PUBLISH, 1U) };
+        REQUIRE(outbound.size() == 4U);
+        CHECK(outbound[0] == TraceStage::PUBLISH_QUEUED);
+        CHECK(outbound[1] == TraceStage::COMPOSED);
+        CHECK(outbound[2] == TraceStage::FIRST_BYTE_SENT);
+        CHECK(outbound[3] == TraceStage::LAST_BYTE_SENT);
+
+        const std::vector<TraceStage> ack{ sink->stagesFor(PacketType::PUBLISH_ACKNOWLEDGE, 1U) };
+        REQUIRE(ack.size() == 3U);
+        CHECK(ack[0] == TraceStage::FRAME_RECEIVED);
+        CHECK(ack[1] == TraceStage::DECODED);
+        CHECK(ack[2] == TraceStage::ACK_RECEIVED);
+
+        ByteBuffer inbound(12);
+        inbound += 0x32; //PUBLISH QoS 1
+        inbound += 0x0A; //Remaining length
+        inbound += 0x00; //Topic length MSB
+        inbound += 0x03; //Topic length LSB
+        inbound += 'a';
+        inbound += '/';
+        inbound += 'b';
+        inbound += 0x00; //Packet ID MSB
+        inbound += 0x09; //Packet ID LSB
+        inbound += 0x00; //No properties
+        inbound += 0x01; //Payload
+        inbound += 0x02;
+
+        testContext.receiveResponse(inbound);
+        CHECK(testContext.client->tick().noError());
+
+        const std::vector<TraceStage> received{ sink->stagesFor(PacketType::PUBLISH, 9U) };
+        REQUIRE(received.size() == 4U);
+        CHECK(received[0] == TraceStage::FRAME_RECEIVED);
+        CHECK(received[1] == TraceStage::DECODED);
+        CHECK(received[2] == TraceStage::DISPATCHED);
+        CHECK(received[3] == TraceStage::CALLBACK_COMPLETED);
+    }
+
+    TEST_CASE("Wire capture file holds the bytes read from and written to the socket")
+    {
+        const std::string path{ "wire_capture_test.kmwire" };
+        auto sink{ std::make_shared<WireCaptureFileSink>(path) };
+        REQUIRE(sink->isOpen());
+
+        TestClientContext testContext{ {}, true, MqttClientOptions{ TickMode::SYNC }.wireCapture(sink) };
+        CHECK(testContext.tryConnectWithResponse().noError());
+
+        const std::vector<std::uint8_t> inboundBytes{
+            0x32, //PUBLISH QoS 1
+            0x0A, //Remaining length
+            0x00, 0x03, 'a', '/', 'b', //Topic
+            0x00, 0x09, //Packet ID
+            0x00, //No properties
+            0x01, 0x02 }; //Payload
+
+        ByteBuffer inbound(inboundBytes.size());
+        inbound.append(inboundBytes.data(), inboundBytes.size());
+
+        testContext.receiveResponse(inbound);
+        CHECK(testContext.client->tick().noError());
+        CHECK(testContext.client->tick().noError());
+
+        sink->flush();
+
+        std::vector<WireCaptureRecord> records;
+        REQUIRE(WireCaptureFileSink::readFile(path, records));
+        std::remove(path.c_str());
+
+        //Keep alive PINGREQs depend on the test environment's ping config.
+        records.erase(std::remove_if(records.begin(), records.end(), [](const WireCaptureRecord& record) { return record.bytes[0] == 0xC0; }), records.end());
+
+        REQUIRE(records.size() == 4U);
+
+        CHECK(records[0].direction == WireDirection::SENT);
+        CHECK(records[0].bytes[0] == 0x10); //CONNECT
+        CHECK(records[1].direction == WireDirection::RECEIVED);
+        CHECK(records[1].bytes[0] == 0x20); //CONNACK
+        CHECK(records[2].direction == WireDirection::RECEIVED);
+        CHECK(records[2].bytes == inboundBytes);
+        CHECK(records[3].direction == WireDirection::SENT);
+        CHECK(records[3].bytes == std::vector<std::uint8_t>{ 0x40, 0x02, 0x00, 0x09 }); //PUBACK
+        CHECK(records[1].time <= records[2].time);
+        CHECK(records[2].time <= records[3].time);
+    }
 }
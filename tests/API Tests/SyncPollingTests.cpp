@@ -0,0 +1,163 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <doctest.h>
+#include <kmMqtt/MqttClient.h>
+#include <chrono>
+#include <string>
+#include "MockWebSocket.h"
+#include "Helpers.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <kmMqtt/Sockets/PosixTCPSocket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static bool isHandleReadable(int handle)
+{
+	pollfd pfd{ handle, POLLIN, 0 };
+	return ::poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN) != 0;
+}
+
+struct PosixTCPEnvironment : public IMqttEnvironment
+{
+	Config createConfig() const noexcept override { return Config{}; }
+	std::shared_ptr<IWebSocket> createWebSocket() const noexcept override { return std::make_shared<PosixTCPSocket>(); }
+};
+#endif
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+TEST_SUITE("MqttClient Sync Polling")
+{
+	TEST_CASE("Socket handle defaults to unavailable")
+	{
+		TestClientContext testContext;
+		CHECK(testContext.client->getSocketHandle() == -1);
+	}
+
+	TEST_CASE("Idle disconnected client has no deadline")
+	{
+		TestClientContext testContext;
+		CHECK(testContext.client->nextDeadline() == TimePoint::max());
+	}
+
+	TEST_CASE("Pending connect packet makes deadline immediate")
+	{
+		TestClientContext testContext;
+		CHECK(testContext.tryConnect().noError());
+
+		const auto deadline{ testContext.client->nextDeadline() };
+		CHECK(deadline <= std::chrono::steady_clock::now());
+	}
+
+	TEST_CASE("Connected idle client deadline is keep alive ping")
+	{
+		TestClientContext testContext;
+		CHECK(testContext.tryConnectWithResponse().noError());
+		testContext.client->tick();
+
+		const auto& info{ testContext.client->getConnectionInfo() };
+		const auto deadline{ testContext.client->nextDeadline() };
+		const auto now{ std::chrono::steady_clock::now() };
+
+		//Either the next ping or the response timeout of an in-flight ping, never later than a full ping interval.
+		CHECK(deadline > now);
+		CHECK(deadline <= now + info.pingInterval);
+	}
+
+	TEST_CASE("Publish makes deadline immediate")
+	{
+		TestClientContext testContext;
+		CHECK(testContext.tryConnectWithResponse().noError());
+		testContext.client->tick();
+
+		ByteBuffer payload(1);
+		payload += 0x01;
+		PublishOptions options;
+
+		CHECK(testContext.client->publish("test/topic", std::move(payload), std::move(options)).noError());
+		const auto deadline{ testContext.client->nextDeadline() };
+		CHECK(deadline <= std::chrono::steady_clock::now());
+
+		testContext.client->tick();
+		const auto now{ std::chrono::steady_clock::now() };
+		CHECK(testContext.client->nextDeadline() > now);
+	}
+
+#if defined(__linux__) || defined(__APPLE__)
+	TEST_CASE("Wakeup handle signals on publish and received data")
+	{
+		TestClientContext testContext;
+		const int handle{ testContext.client->getWakeupHandle() };
+		REQUIRE(handle >= 0);
+
+		CHECK(testContext.tryConnectWithResponse().noError());
+		testContext.client->tick();
+		CHECK(isHandleReadable(handle) == false);
+
+		ByteBuffer payload(1);
+		payload += 0x01;
+		PublishOptions options;
+
+		CHECK(testContext.client->publish("test/topic", std::move(payload), std::move(options)).noError());
+		CHECK(isHandleReadable(handle) == true);
+
+		testContext.client->tick();
+		CHECK(isHandleReadable(handle) == false);
+
+		//PINGRESP delivered by socket during tick, leaving a packet in the receive queue for the next tick.
+		ByteBuffer pingResp(2);
+		pingResp += 0xD0;
+		pingResp += 0x00;
+		testContext.socketPtr->queueMockResponse(pingResp);
+
+		testContext.client->tick();
+		CHECK(isHandleReadable(handle) == true);
+		const auto deadline{ testContext.client->nextDeadline() };
+		CHECK(deadline <= std::chrono::steady_clock::now());
+
+		testContext.client->tick();
+		CHECK(isHandleReadable(handle) == false);
+	}
+
+	TEST_CASE("Socket handle is the descriptor of a PosixTCPSocket")
+	{
+		const int listenSocket{ ::socket(AF_INET, SOCK_STREAM, 0) };
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t addressSize{ sizeof(address) };
+		REQUIRE(::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+		REQUIRE(::listen(listenSocket, 1) == 0);
+		::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &addressSize);
+		const std::string port{ std::to_string(ntohs(address.sin_port)) };
+
+		PosixTCPEnvironment environment;
+		MqttClient client{ &environment, MqttClientOptions{ TickMode::SYNC } };
+		CHECK(client.getSocketHandle() == -1);
+
+		ConnectAddress connectAddress;
+		connectAddress.primaryAddress = Address::createIp4("", "127.0.0.1", port.c_str(), "");
+		CHECK(client.connect(ConnectArgs{ "sync_socket_handle" }, std::move(connectAddress)).noError());
+		client.tick();
+
+		const int handle{ client.getSocketHandle() };
+		REQUIRE(handle >= 0);
+
+		int socketType{ 0 };
+		socklen_t socketTypeSize{ sizeof(socketType) };
+		CHECK(::getsockopt(handle, SOL_SOCKET, SO_TYPE, &socketType, &socketTypeSize) == 0);
+		CHECK(socketType == SOCK_STREAM);
+
+		client.disconnect();
+		::close(listenSocket);
+	}
+#endif
+}
@@ -5,6 +5,8 @@
 
 #include <doctest.h>
 #include <kmMqtt/Utils/Deferrer.h>
+#include <array>
+#include <memory>
 
 TEST_SUITE("Deferrer Tests")
 {
@@ -107,4 +109,80 @@ TEST_SUITE("Deferrer Tests")
 		deferrer.invokeEvents();
 		CHECK(count == 2);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Deferrer events deferred while invoking run in same pass")
+	{
+		Deferrer deferrer;
+		int sequence = 0;
+		int nested = 0;
+
+		deferrer.defer([&]() {
+			++sequence;
+			deferrer.defer([&]() { nested = ++sequence; });
+		});
+
+		deferrer.invokeEvents();
+
+		CHECK(nested == 2);
+		CHECK(deferrer.hasEvents() == false);
+	}
+
+	TEST_CASE("Deferrer callable larger than arena block")
+	{
+		Deferrer deferrer;
+		std::array<char, DEFERRER_ARENA_BLOCK_SIZE> bigCapture{};
+		bigCapture[0] = 7;
+		int result = 0;
+
+		deferrer.defer([&result, bigCapture]() { result = bigCapture[0]; });
+		deferrer.invokeEvents();
+
+		CHECK(result == 7);
+	}
+
+	TEST_CASE("Deferrer reuses arena blocks between invokes")
+	{
+		Deferrer deferrer;
+		int count = 0;
+
+		//Enough 64 byte captures to span several blocks.
+		const int eventsPerTick = static_cast<int>(DEFERRER_ARENA_BLOCK_SIZE / 64) * 3;
+
+		for (int tick = 0; tick < 3; ++tick)
+		{
+			for (int i = 0; i < eventsPerTick; ++i)
+			{
+				std::array<char, 48> padding{};
+				deferrer.defer([&count, padding]() { count += 1 + padding[0]; });
+			}
+
+			deferrer.invokeEvents();
+		}
+
+		CHECK(count == eventsPerTick * 3);
+		CHECK(deferrer.getArenaBlockCount() >= 3);
+		CHECK(deferrer.getArenaBlockCount() <= 4);
+	}
+
+	TEST_CASE("Deferrer destroys captures on invoke, clear, and destruction")
+	{
+		auto resource = std::make_shared<int>(1);
+
+		{
+			Deferrer deferrer;
+			deferrer.defer([resource]() {});
+			CHECK(resource.use_count() == 2);
+			deferrer.invokeEvents();
+			CHECK(resource.use_count() == 1);
+
+			deferrer.defer([resource]() {});
+			deferrer.clear();
+			CHECK(resource.use_count() == 1);
+
+			deferrer.defer([resource]() {});
+			CHECK(resource.use_count() == 2);
+		}
+
+		CHECK(resource.use_count() == 1);
+	}
+}
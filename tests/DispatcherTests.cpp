@@ -6,6 +6,7 @@
 #include <doctest.h>
 #include <kmMqtt/Dispatchers/DefaultDispatcher.h>
 #include <kmMqtt/Dispatchers/ImmediateDispatcher.h>
+#include <kmMqtt/Dispatchers/OrderedParallelDispatcher.h>
 #include <kmMqtt/MqttClientOptions.h>
 #include <kmMqtt/Interfaces/ICallbackDispatcher.h>
 #include <atomic>
@@ -14,6 +15,9 @@
 #include <vector>
 #include <cstring>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
 
 using namespace kmMqtt;
 
@@ -144,4 +148,193 @@ TEST_SUITE("Dispatcher Tests")
 		CHECK(data["first"][0] == 1);
 		CHECK(data["second"][2] == 6);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("ICallbackDispatcher - dispatchOrdered Defaults To dispatch")
+	{
+		ImmediateDispatcher dispatcher;
+		bool callbackExecuted = false;
+
+		dispatcher.dispatchOrdered(UniqueFunction([&callbackExecuted]() {
+			callbackExecuted = true;
+		}), 1234U);
+
+		CHECK(callbackExecuted == true);
+	}
+
+	TEST_CASE("OrderedParallelDispatcher - Executes All Callbacks")
+	{
+		OrderedParallelDispatcherOptions options;
+		options.threadCount = 4;
+
+		OrderedParallelDispatcher dispatcher{ options };
+		std::atomic<int> executionCount{ 0 };
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			dispatcher.dispatchOrdered(UniqueFunction([&executionCount]() {
+				executionCount++;
+			}), static_cast<std::size_t>(i));
+		}
+
+		dispatcher.waitUntilIdle();
+
+		CHECK(executionCount == 1000);
+		CHECK(dispatcher.getQueuedCount() == 0);
+		CHECK(dispatcher.getThreadCount() == 4);
+	}
+
+	TEST_CASE("OrderedParallelDispatcher - Preserves Order Per Key")
+	{
+		OrderedParallelDispatcherOptions options;
+		options.threadCount = 4;
+		options.laneCount = 8;
+		options.maxCallbacksPerLaneTurn = 2; //Force lanes to be rescheduled between workers.
+
+		OrderedParallelDispatcher dispatcher{ options };
+
+		constexpr std::size_t keyCount = 8;
+		std::vector<int> executionOrder[keyCount];
+
+		for (int i = 0; i < 200; ++i)
+		{
+			for (std::size_t key = 0; key < keyCount; ++key)
+			{
+				//Each key maps to its own lane, so its vector is only ever touched by one worker at a time.
+				dispatcher.dispatchOrdered(UniqueFunction([&executionOrder, key, i]() {
+					executionOrder[key].push_back(i);
+				}), key);
+			}
+		}
+
+		dispatcher.waitUntilIdle();
+
+		for (std::size_t key = 0; key < keyCount; ++key)
+		{
+			REQUIRE(executionOrder[key].size() == 200);
+			for (int i = 0; i < 200; ++i)
+			{
+				CHECK(executionOrder[key][i] == i);
+			}
+		}
+	}
+
+	TEST_CASE("OrderedParallelDispatcher - Slow Key Does Not Block Other Keys")
+	{
+		OrderedParallelDispatcherOptions options;
+		options.threadCount = 2;
+		options.laneCount = 4;
+
+		OrderedParallelDispatcher dispatcher{ options };
+
+		std::mutex blockMutex;
+		std::condition_variable blockCondition;
+		bool release = false;
+		std::atomic<bool> otherKeyExecuted{ false };
+
+		dispatcher.dispatchOrdered(UniqueFunction([&]() {
+			std::unique_lock<std::mutex> lock{ blockMutex };
+			blockCondition.wait_for(lock, std::chrono::seconds(5), [&release]() { return release; });
+		}), 1U);
+
+		dispatcher.dispatchOrdered(UniqueFunction([&otherKeyExecuted]() {
+			otherKeyExecuted = true;
+		}), 2U);
+
+		const auto start = std::chrono::steady_clock::now();
+		while (!otherKeyExecuted && std::chrono::steady_clock::now() - start < std::chrono::seconds(2))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		CHECK(otherKeyExecuted == true);
+
+		{
+			std::lock_guard<std::mutex> lock{ blockMutex };
+			release = true;
+		}
+		blockCondition.notify_all();
+
+		dispatcher.waitUntilIdle();
+	}
+
+	TEST_CASE("OrderedParallelDispatcher - Blocks Dispatch When Queue Is Full")
+	{
+		OrderedParallelDispatcherOptions options;
+		options.threadCount = 1;
+		options.maxQueuedCallbacks = 2;
+
+		OrderedParallelDispatcher dispatcher{ options };
+
+		std::mutex blockMutex;
+		std::condition_variable blockCondition;
+		bool release = false;
+
+		auto makeBlockingCallback = [&]() {
+			return UniqueFunction([&]() {
+				std::unique_lock<std::mutex> lock{ blockMutex };
+				blockCondition.wait_for(lock, std::chrono::seconds(5), [&release]() { return release; });
+			});
+		};
+
+		dispatcher.dispatch(makeBlockingCallback());
+		dispatcher.dispatch(makeBlockingCallback());
+
+		std::atomic<bool> thirdDispatched{ false };
+		std::thread producer([&]() {
+			dispatcher.dispatch(UniqueFunction([]() {}));
+			thirdDispatched = true;
+		});
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		CHECK(thirdDispatched == false);
+
+		{
+			std::lock_guard<std::mutex> lock{ blockMutex };
+			release = true;
+		}
+		blockCondition.notify_all();
+
+		producer.join();
+		dispatcher.waitUntilIdle();
+
+		CHECK(thirdDispatched == true);
+		CHECK(dispatcher.getQueuedCount() == 0);
+	}
+
+	TEST_CASE("OrderedParallelDispatcher - Destructor Drains Queued Callbacks")
+	{
+		std::atomic<int> executionCount{ 0 };
+
+		{
+			OrderedParallelDispatcherOptions options;
+			options.threadCount = 2;
+
+			OrderedParallelDispatcher dispatcher{ options };
+
+			for (int i = 0; i < 100; ++i)
+			{
+				dispatcher.dispatchOrdered(UniqueFunction([&executionCount]() {
+					executionCount++;
+				}), static_cast<std::size_t>(i % 3));
+			}
+		}
+
+		CHECK(executionCount == 100);
+	}
+
+	TEST_CASE("OrderedParallelDispatcher - Survives Throwing Callback")
+	{
+		OrderedParallelDispatcherOptions options;
+		options.threadCount = 1;
+
+		OrderedParallelDispatcher dispatcher{ options };
+		bool secondExecuted = false;
+
+		dispatcher.dispatch(UniqueFunction([]() { throw std::runtime_error("test"); }));
+		dispatcher.dispatch(UniqueFunction([&secondExecuted]() { secondExecuted = true; }));
+
+		dispatcher.waitUntilIdle();
+
+		CHECK(secondExecuted == true);
+	}
+}
@@ -5,6 +5,9 @@
 
 #include <doctest.h>
 #include <kmMqtt/Utils/Event.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 TEST_SUITE("Events Tests")
 {
@@ -71,4 +74,79 @@ TEST_SUITE("Events Tests")
 		event.invoke(1);
 		CHECK(count == 1);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Event remove keeps order of remaining callbacks")
+	{
+		Event<int> event;
+		std::vector<int> calls;
+
+		auto cb1 = [&](int) { calls.push_back(1); };
+		auto cb2 = [&](int) { calls.push_back(2); };
+		auto cb3 = [&](int) { calls.push_back(3); };
+
+		event.add(cb1);
+		event.add(cb2);
+		event.add(cb3);
+		CHECK(event.size() == 3);
+
+		event.remove(cb1);
+		CHECK(event.size() == 2);
+
+		event.invoke(0);
+		REQUIRE(calls.size() == 2);
+		CHECK(calls[0] == 2);
+		CHECK(calls[1] == 3);
+	}
+
+	TEST_CASE("Event callback can modify listeners during invoke")
+	{
+		Event<int> event;
+		int count = 0;
+
+		auto other = [&](int) { ++count; };
+		std::function<void(int)> self = [&](int) { event.add(other); event.removeAll(); };
+
+		event.add(self);
+		event.invoke(1); //Must not deadlock, runs on the snapshot taken before the modification.
+
+		CHECK(count == 0);
+		CHECK(event.size() == 0);
+	}
+
+	TEST_CASE("Event concurrent invoke while adding and removing")
+	{
+		Event<int> event;
+		std::atomic<int> sum{ 0 };
+		std::atomic<bool> stop{ false };
+
+		auto counter = [&sum](int v) { sum += v; };
+		event.add(counter);
+
+		std::vector<std::thread> invokers;
+		for (int i = 0; i < 4; ++i)
+		{
+			invokers.emplace_back([&]() {
+				while (!stop)
+				{
+					event.invoke(1);
+				}
+			});
+		}
+
+		auto other = [](int) {};
+		for (int i = 0; i < 1000 || sum == 0; ++i)
+		{
+			event.add(other);
+			event.remove(other);
+		}
+
+		stop = true;
+		for (auto& t : invokers)
+		{
+			t.join();
+		}
+
+		CHECK(event.size() == 1);
+		CHECK(sum > 0);
+	}
+}
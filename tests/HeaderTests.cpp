@@ -7,6 +7,7 @@
 #include <kmMqtt/Mqtt/Packets/FixedHeader.h>
 #include <kmMqtt/Mqtt/Packets/Connection/Headers/ConnectVariableHeader.h>
 #include <kmMqtt/Mqtt/Packets/Connection/Headers/ConnectPayloadHeader.h>
+#include <kmMqtt/Mqtt/Packets/Connection/Headers/DisconnectVariableHeader.h>
 #include <kmMqtt/ByteBuffer.h>
 #include <kmMqtt/Mqtt/Packets/PacketUtils.h>
 #include <kmMqtt/Mqtt/Packets/Publish/Headers/PublishPayloadHeader.h>
@@ -917,4 +918,36 @@ TEST_SUITE("Header Tests")
 			CHECK(std::string(result.reason).find("Packet ID cannot be zero") != std::string::npos);
 		}
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Disconnect Variable Header")
+	{
+		using namespace kmMqtt::mqtt;
+
+		SUBCASE("Decoding Empty Variable Header")
+		{
+			ByteBuffer buffer{ 0 };
+
+			DisconnectVariableHeader header{ DisconnectReasonCode::SERVER_BUSY, Properties{} };
+			auto result = header.decode(buffer);
+
+			CHECK(result.isSuccess());
+			CHECK(header.reasonCode == DisconnectReasonCode::NORMAL_DISCONNECTION);
+		}
+
+		SUBCASE("Decoding Reason Code Without Property Length")
+		{
+			const std::uint8_t data[] = {
+				0x8E			// Reason code = SESSION_TAKEN_OVER
+			};
+			ByteBuffer buffer{ sizeof(data) };
+			buffer.append(data, sizeof(data));
+
+			DisconnectVariableHeader header;
+			auto result = header.decode(buffer);
+
+			CHECK(result.isSuccess());
+			CHECK(header.reasonCode == DisconnectReasonCode::SESSION_TAKEN_OVER);
+			CHECK(header.properties.size() == 0);
+		}
+	}
+}
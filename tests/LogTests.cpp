@@ -0,0 +1,200 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <doctest.h>
+#include <kmMqtt/Logger/AsyncLog.h>
+#include <kmMqtt/Logger/Log.h>
+#include <kmMqtt/Logger/LoggerInstance.h>
+#include <kmMqtt/Logger/LogMacros.h>
+#include <kmMqtt/Logger/LogRecord.h>
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace kmMqtt;
+
+namespace
+{
+	class CapturingLogger : public ILogger
+	{
+	public:
+		void Log(const LogLevel logLvl, const char* const msg) const noexcept override
+		{
+			Log(logLvl, "", msg);
+		}
+
+		void Log(const LogLevel logLvl, const char* const category, const char* const msg) const noexcept override
+		{
+			(void)logLvl;
+			logs.push_back(std::string{ category } + ": " + msg);
+		}
+
+		mutable std::vector<std::string> logs;
+	};
+
+	//Swaps in a CapturingLogger for the scope of a test.
+	struct ScopedCapturingLogger
+	{
+		explicit ScopedCapturingLogger(LogLevel lowestLogLevel)
+			: previous{ getLogger() }
+		{
+			logger.setLowestLogLevel(lowestLogLevel);
+			setLogger(&logger, false);
+		}
+
+		~ScopedCapturingLogger()
+		{
+			stopAsyncLogging();
+			setLogger(previous, false);
+		}
+
+		CapturingLogger logger;
+		ILogger* previous;
+	};
+
+	const char* countCall(int& calls)
+	{
+		++calls;
+		return "evaluated";
+	}
+
+	//Text of the log call both through vsnprintf and through a captured record.
+	void formatBothWays(std::string& outExpected, std::string& outFormatted, const char* format, ...)
+	{
+		char expected[256];
+		va_list args;
+		va_start(args, format);
+		std::vsnprintf(expected, sizeof(expected), format, args);
+		va_end(args);
+
+		std::uint8_t record[512];
+		va_start(args, format);
+		const std::size_t size{ encodeLogRecord(record, sizeof(record), LogLevel::Info, "Category", format, args) };
+		va_end(args);
+
+		char formatted[256];
+		LogLevel level{ LogLevel::Trace };
+		const char* category{ nullptr };
+		formatLogRecord(record, size, formatted, sizeof(formatted), level, category);
+
+		outExpected = expected;
+		outFormatted = formatted;
+		CHECK(level == LogLevel::Info);
+		CHECK(std::string{ category } == "Category");
+	}
+}
+
+TEST_SUITE("Log Tests")
+{
+	TEST_CASE("Captured log records format the same as vsnprintf")
+	{
+		std::string expected;
+		std::string formatted;
+		const char notTerminated[]{ 'a', 'b', 'c', 'd' };
+
+		formatBothWays(expected, formatted, "%d %u %x %c %% %5.2f %s|%-6s|%.2s",
+			-42, 42U, 255U, 'z', 3.14159, "topic", "ab", notTerminated);
+		CHECK(formatted == expected);
+
+		formatBothWays(expected, formatted, "%zu %lld %*d %.*s %p %s",
+			static_cast<std::size_t>(123456789U), -5LL, 6, 7, 3, notTerminated, static_cast<void*>(&expected), static_cast<const char*>(nullptr));
+		CHECK(formatted == expected);
+	}
+
+	TEST_CASE("Log ring keeps record order across wrap around")
+	{
+		LogRing ring{ 64U };
+		std::uint8_t record[20];
+		std::uint8_t next{ 0U };
+		std::uint8_t expected{ 0U };
+
+		for (int round = 0; round < 10; ++round)
+		{
+			//Fill with records of different sizes, so the ring wraps at a different offset every round.
+			std::uint8_t pushed{ 0U };
+			while (true)
+			{
+				for (std::size_t i = 0; i < sizeof(record); ++i)
+				{
+					record[i] = next;
+				}
+
+				if (!ring.tryPush(record, 5U + static_cast<std::size_t>(next % 4U) * 5U))
+				{
+					break;
+				}
+
+				++next;
+				++pushed;
+			}
+
+			CHECK(pushed >= 2U);
+
+			const std::uint8_t* data{ nullptr };
+			std::uint32_t size{ 0U };
+			while (ring.front(data, size))
+			{
+				CHECK(data[0] == expected);
+				CHECK(data[size - 1U] == expected);
+				ring.pop();
+				++expected;
+			}
+
+			CHECK(expected == next);
+		}
+
+		CHECK(ring.empty());
+		CHECK_FALSE(ring.tryPush(record, 64U));
+	}
+
+	TEST_CASE("Logs below the logger's lowest log level are skipped")
+	{
+		ScopedCapturingLogger scope{ LogLevel::Warning };
+
+		LogInfo("Log", "Info %d", 1);
+		LogWarning("Log", "Warning %d", 2);
+
+		CHECK(scope.logger.logs == std::vector<std::string>{ "Log: Warning 2" });
+	}
+
+	TEST_CASE("Async logging formats captured logs on the background thread")
+	{
+		ScopedCapturingLogger scope{ LogLevel::Trace };
+		startAsyncLogging();
+		CHECK(isAsyncLoggingRunning());
+
+		std::string topic{ "sensor/1" };
+		LogInfo("Log", "Published to %s, %d bytes", topic.c_str(), 12);
+		topic = "changed";
+		LogError("Log", "Failed %u times", 3U);
+
+		flushAsyncLogs();
+		CHECK(scope.logger.logs == std::vector<std::string>{ "Log: Published to sensor/1, 12 bytes", "Log: Failed 3 times" });
+
+		stopAsyncLogging();
+		CHECK_FALSE(isAsyncLoggingRunning());
+
+		LogInfo("Log", "Sync again");
+		CHECK(scope.logger.logs.back() == "Log: Sync again");
+	}
+
+	TEST_CASE("Log macro arguments are only evaluated when the log is written")
+	{
+		ScopedCapturingLogger scope{ LogLevel::Warning };
+		int calls{ 0 };
+
+		LOG_IF_ENABLED(LogLevel::Info, LogInfo, "Log", "%s", countCall(calls));
+		CHECK(calls == 0);
+
+		LOG_IF_ENABLED(LogLevel::Warning, LogWarning, "Log", "%s", countCall(calls));
+		CHECK(calls == 1);
+		CHECK(scope.logger.logs == std::vector<std::string>{ "Log: evaluated" });
+
+		LOG_COMPILED_OUT(LogError, "Log", "%s", countCall(calls));
+		CHECK(calls == 1);
+	}
+}
@@ -0,0 +1,137 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <doctest.h>
+#include <kmMqtt/Mqtt/ClientMetrics.h>
+#include <kmMqtt/Mqtt/MqttClientMetrics.h>
+
+#include <chrono>
+#include <initializer_list>
+#include <string>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+TEST_SUITE("Metrics Tests")
+{
+	TEST_CASE("Latency histogram buckets keep values within 1/16th")
+	{
+		for (std::uint64_t value : std::initializer_list<std::uint64_t>{ 0U, 1U, 15U, 16U, 17U, 31U, 32U, 1000U, 123456U, LatencyHistogram::k_maxValue })
+		{
+			const std::size_t index{ LatencyHistogram::getBucketIndex(value) };
+			const std::uint64_t upperBound{ LatencyHistogram::getBucketUpperBound(index) };
+
+			REQUIRE(index < LatencyHistogram::k_bucketCount);
+			CHECK(upperBound >= value);
+			CHECK(upperBound - value <= value / 16U);
+
+			if (index > 0U)
+			{
+				CHECK(LatencyHistogram::getBucketUpperBound(index - 1U) < value);
+			}
+		}
+
+		CHECK(LatencyHistogram::getBucketIndex(LatencyHistogram::k_maxValue) == LatencyHistogram::k_bucketCount - 1U);
+		CHECK(LatencyHistogram::getBucketIndex(UINT64_MAX) == LatencyHistogram::k_bucketCount - 1U);
+	}
+
+	TEST_CASE("Latency histogram quantiles")
+	{
+		LatencyHistogram histogram;
+		CHECK(histogram.snapshot().getValueAtQuantile(0.5) == 0U);
+
+		for (std::uint64_t value = 1; value <= 100; ++value)
+		{
+			histogram.record(value * 100U);
+		}
+
+		const LatencyHistogramSnapshot snapshot{ histogram.snapshot() };
+		CHECK(snapshot.count == 100U);
+		CHECK(snapshot.sumMicroseconds == 505000U);
+		CHECK(snapshot.minMicroseconds == 100U);
+		CHECK(snapshot.maxMicroseconds == 10000U);
+
+		const std::uint64_t median{ snapshot.getValueAtQuantile(0.5) };
+		CHECK(median >= 5000U);
+		CHECK(median <= 5000U + 5000U / 16U);
+		CHECK(snapshot.getValueAtQuantile(1.0) == 10000U);
+		CHECK(snapshot.getValueAtQuantile(0.0) == snapshot.buckets.front().upperBoundMicroseconds);
+
+		histogram.reset();
+		CHECK(histogram.snapshot().count == 0U);
+		CHECK(histogram.snapshot().buckets.empty());
+	}
+
+	TEST_CASE("Publish acknowledgement latency is timed from the first send")
+	{
+		ClientMetrics metrics;
+		const TimePoint start{ std::chrono::steady_clock::now() };
+
+		metrics.markPublishSent(1U, start);
+		metrics.markPublishSent(1U, start + std::chrono::milliseconds(5));
+		metrics.markPublishAcknowledged(1U, start + std::chrono::milliseconds(10));
+		metrics.markPublishAcknowledged(2U, start + std::chrono::milliseconds(10));
+
+		metrics.markPublishSent(3U, start);
+		metrics.clearPendingAcks();
+		metrics.markPublishAcknowledged(3U, start + std::chrono::milliseconds(10));
+
+		const MqttClientMetrics snapshot{ metrics.snapshot() };
+		CHECK(snapshot.publishAckLatency.count == 1U);
+		CHECK(snapshot.publishAckLatency.sumMicroseconds == 10000U);
+	}
+
+	TEST_CASE("Metrics export as Prometheus text")
+	{
+		ClientMetrics metrics;
+		metrics.addPacketSent(PacketType::PUBLISH, 20U);
+		metrics.addPacketSent(PacketType::PUBLISH, 30U);
+		metrics.addPacketReceived(PacketType::PUBLISH_ACKNOWLEDGE, 4U);
+		metrics.addPacketReceived(PacketType::_COUNT, 4U);
+		metrics.addReconnect();
+		metrics.setSendQueueSize(3U, 120U);
+		metrics.setInFlight(2U, 10U);
+		metrics.recordTickDuration(std::chrono::microseconds(1500));
+
+		const std::string text{ toPrometheusText(metrics.snapshot(), "mqtt") };
+
+		CHECK(text.find("# TYPE mqtt_packets_sent_total counter\n") != std::string::npos);
+		CHECK(text.find("mqtt_packets_sent_total{type=\"PUBLISH\"} 2\n") != std::string::npos);
+		CHECK(text.find("mqtt_bytes_sent_total{type=\"PUBLISH\"} 50\n") != std::string::npos);
+		CHECK(text.find("mqtt_packets_received_total{type=\"PUBLISH_ACKNOWLEDGE\"} 1\n") != std::string::npos);
+		CHECK(text.find("RESERVED") == std::string::npos);
+		CHECK(text.find("mqtt_reconnects_total 1\n") != std::string::npos);
+		CHECK(text.find("mqtt_send_queue_bytes 120\n") != std::string::npos);
+		CHECK(text.find("mqtt_in_flight_publishes 2\n") != std::string::npos);
+		CHECK(text.find("mqtt_receive_maximum 10\n") != std::string::npos);
+		CHECK(text.find("# TYPE mqtt_tick_duration_seconds summary\n") != std::string::npos);
+		CHECK(text.find("mqtt_tick_duration_seconds{quantile=\"0.99\"} 0.001500\n") != std::string::npos);
+		CHECK(text.find("mqtt_tick_duration_seconds_sum 0.001500\n") != std::string::npos);
+		CHECK(text.find("mqtt_tick_duration_seconds_count 1\n") != std::string::npos);
+		CHECK(text.find("mqtt_socket_send_seconds_count 0\n") != std::string::npos);
+	}
+
+	TEST_CASE("Memory stats are part of the snapshot and the Prometheus text")
+	{
+		ClientMetrics metrics;
+
+		MqttClientMemoryStats stats;
+		stats.sendQueueBytes = 100U;
+		stats.receiveQueueBytes = 20U;
+		stats.sessionStateBytes = 3U;
+		metrics.setMemoryStats(stats);
+
+		CHECK(metrics.getMemoryStats().totalBytes() == 123U);
+
+		const MqttClientMetrics snapshot{ metrics.snapshot() };
+		CHECK(snapshot.memory.sendQueueBytes == 100U);
+
+		const std::string text{ toPrometheusText(snapshot, "mqtt") };
+		CHECK(text.find("# TYPE mqtt_memory_bytes gauge\n") != std::string::npos);
+		CHECK(text.find("mqtt_memory_bytes{subsystem=\"send_queue\"} 100\n") != std::string::npos);
+		CHECK(text.find("mqtt_memory_bytes{subsystem=\"receive_queue\"} 20\n") != std::string::npos);
+		CHECK(text.find("mqtt_memory_bytes{subsystem=\"session_state\"} 3\n") != std::string::npos);
+	}
+}
@@ -0,0 +1,167 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <doctest.h>
+#include <kmMqtt/Mqtt/OfflineSpool.h>
+#include <chrono>
+#include <string>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+static ByteBuffer spoolTestPayload(std::uint8_t value)
+{
+	ByteBuffer payload(8);
+	for (int i = 0; i < 8; ++i)
+	{
+		payload += value;
+	}
+
+	return payload;
+}
+
+static std::string popTopic(OfflineSpool& spool, TimePoint now = std::chrono::steady_clock::now())
+{
+	PublishMessageData message;
+	return spool.pop(message, now) ? message.topic : std::string{};
+}
+
+TEST_SUITE("OfflineSpool Tests")
+{
+	TEST_CASE("Memory ring keeps publish order across wrap around")
+	{
+		OfflineSpoolOptions options;
+		options.maxBytes = 200U;
+
+		OfflineSpool spool{ options };
+		int nextPushed{ 0 };
+		int nextPopped{ 0 };
+
+		for (int round = 0; round < 20; ++round)
+		{
+			while (spool.push(("t" + std::to_string(nextPushed)).c_str(), spoolTestPayload(1U), PublishOptions{}))
+			{
+				++nextPushed;
+			}
+
+			CHECK(popTopic(spool) == "t" + std::to_string(nextPopped++));
+			CHECK(popTopic(spool) == "t" + std::to_string(nextPopped++));
+		}
+
+		while (!spool.empty())
+		{
+			CHECK(popTopic(spool) == "t" + std::to_string(nextPopped++));
+		}
+
+		CHECK(nextPopped == nextPushed);
+		CHECK(spool.getUsedBytes() == 0);
+	}
+
+	TEST_CASE("Publishes spill to file once memory is full and drain in order")
+	{
+		OfflineSpoolOptions options;
+		options.maxBytes = 4096U;
+		options.maxMemoryBytes = 128U;
+		options.spillFilePath = "offline_spool_test.spool";
+
+		OfflineSpool spool{ options };
+		for (int i = 0; i < 40; ++i)
+		{
+			REQUIRE(spool.push(("t" + std::to_string(i)).c_str(), spoolTestPayload(static_cast<std::uint8_t>(i)), PublishOptions{}));
+		}
+
+		CHECK(spool.getCount() == 40);
+		CHECK(spool.getUsedBytes() > options.maxMemoryBytes);
+
+		for (int i = 0; i < 40; ++i)
+		{
+			PublishMessageData message;
+			REQUIRE(spool.pop(message, std::chrono::steady_clock::now()));
+			CHECK(message.topic == "t" + std::to_string(i));
+			REQUIRE(message.payload.size() == 8);
+			CHECK(message.payload[0] == static_cast<std::uint8_t>(i));
+		}
+
+		CHECK(spool.empty());
+	}
+
+	TEST_CASE("Full spool rejects new or drops oldest publishes")
+	{
+		OfflineSpoolOptions options;
+		options.maxBytes = 150U;
+
+		OfflineSpool rejecting{ options };
+		int accepted{ 0 };
+		while (rejecting.push(("t" + std::to_string(accepted)).c_str(), spoolTestPayload(1U), PublishOptions{}))
+		{
+			++accepted;
+		}
+		CHECK(accepted > 0);
+		CHECK(popTopic(rejecting) == "t0");
+
+		options.overflow = OfflineSpoolOverflow::DROP_OLDEST;
+		OfflineSpool dropping{ options };
+		for (int i = 0; i < accepted + 2; ++i)
+		{
+			CHECK(dropping.push(("t" + std::to_string(i)).c_str(), spoolTestPayload(1U), PublishOptions{}));
+		}
+		CHECK(dropping.getDroppedCount() == 2);
+		CHECK(popTopic(dropping) == "t2");
+
+		ByteBuffer tooLarge(400);
+		for (int i = 0; i < 400; ++i)
+		{
+			tooLarge += 0x00;
+		}
+		CHECK_FALSE(dropping.push("large", tooLarge, PublishOptions{}));
+	}
+
+	TEST_CASE("Expired publishes are dropped and expiry is rewritten to time left")
+	{
+		OfflineSpoolOptions options;
+		options.maxBytes = 1024U;
+
+		OfflineSpool spool{ options };
+		const TimePoint start{ std::chrono::steady_clock::now() };
+
+		PublishOptions expiring;
+		expiring.addMessageExpiryInterval = true;
+		expiring.messageExpiryInterval = 1U;
+
+		PublishOptions longLived;
+		longLived.addMessageExpiryInterval = true;
+		longLived.messageExpiryInterval = 10U;
+
+		CHECK(spool.push("expiring", spoolTestPayload(1U), expiring));
+		CHECK(spool.push("longLived", spoolTestPayload(1U), longLived));
+
+		PublishMessageData message;
+		REQUIRE(spool.pop(message, start + std::chrono::milliseconds(2500)));
+		CHECK(message.topic == "longLived");
+		CHECK(message.options.messageExpiryInterval == 8U);
+		CHECK(spool.getExpiredCount() == 1);
+	}
+
+	TEST_CASE("Drain rate limits publishes after the burst")
+	{
+		OfflineSpoolOptions options;
+		options.maxBytes = 1024U;
+		options.drainMessagesPerSecond = 10U;
+		options.drainBurst = 2U;
+
+		OfflineSpool spool{ options };
+		const TimePoint start{ std::chrono::steady_clock::now() };
+		spool.resetDrainBudget(start);
+
+		CHECK(spool.tryTakeDrainToken(start));
+		CHECK(spool.tryTakeDrainToken(start));
+		CHECK_FALSE(spool.tryTakeDrainToken(start));
+
+		const TimePoint next{ spool.nextDrainTime(start) };
+		CHECK(next > start);
+		CHECK(next <= start + std::chrono::milliseconds(101));
+		CHECK(spool.tryTakeDrainToken(start + std::chrono::milliseconds(101)));
+	}
+}
@@ -11,12 +11,14 @@
 #include <kmMqtt/Mqtt/Transport/Jobs/SubscribeComposer.h>
 #include <kmMqtt/Mqtt/Transport/Jobs/UnSubscribeComposer.h>
 #include <kmMqtt/Mqtt/MqttConnectionInfo.h>
+#include <kmMqtt/Mqtt/Packets/Publish/Publish.h>
 #include <kmMqtt/Utils/PacketIdPool.h>
 
 TEST_SUITE("PacketComposer Tests")
 {
 	using namespace kmMqtt::mqtt;
 	using kmMqtt::PacketIdPool;
+	using kmMqtt::TimePoint;
 
 	TEST_CASE("ConnectComposer compose creates valid packet")
 	{
@@ -126,7 +128,7 @@ TEST_SUITE("PacketComposer Tests")
 		options.qos = Qos::QOS_1;
 		ReceiveMaximumTracker tracker{ 65535 , 65535};
 
-		PublishComposer composer(&connectionInfo, &packetIdPool, packetId, "test/topic", std::move(payload), std::move(options), &tracker, false);
+		PublishComposer composer(&connectionInfo, &packetIdPool, packetId, "test/topic", std::move(payload), std::move(options), &tracker, false, std::chrono::steady_clock::now());
 		ComposeResult result = composer.compose();
 
 		CHECK(result.encodeResult.isSuccess());
@@ -143,7 +145,7 @@ TEST_SUITE("PacketComposer Tests")
 		options.qos = Qos::QOS_0;
 		ReceiveMaximumTracker tracker{ 65535 , 65535 };
 
-		PublishComposer composer(&connectionInfo, &packetIdPool, 0, "sensor/data", std::move(payload), std::move(options), &tracker, false);
+		PublishComposer composer(&connectionInfo, &packetIdPool, 0, "sensor/data", std::move(payload), std::move(options), &tracker, false, std::chrono::steady_clock::now());
 		ComposeResult result = composer.compose();
 
 		CHECK(result.encodeResult.isSuccess());
@@ -161,7 +163,7 @@ TEST_SUITE("PacketComposer Tests")
 
 		CHECK(packetId == 1);
 
-		PublishComposer composer(&connectionInfo, &packetIdPool, packetId, "test/topic", std::move(payload), std::move(options), &tracker, false);
+		PublishComposer composer(&connectionInfo, &packetIdPool, packetId, "test/topic", std::move(payload), std::move(options), &tracker, false, std::chrono::steady_clock::now());
 		composer.cancel();
 
 		std::uint16_t reusedId = packetIdPool.getId();
@@ -179,13 +181,65 @@ TEST_SUITE("PacketComposer Tests")
 		options.retain = true;
 		ReceiveMaximumTracker tracker{ 65535 , 65535 };
 
-		PublishComposer composer(&connectionInfo, &packetIdPool, packetId, "status/topic", std::move(payload), std::move(options), &tracker, false);
+		PublishComposer composer(&connectionInfo, &packetIdPool, packetId, "status/topic", std::move(payload), std::move(options), &tracker, false, std::chrono::steady_clock::now());
 		ComposeResult result = composer.compose();
 
 		CHECK(result.encodeResult.isSuccess());
 		CHECK(result.encodedData.size() > 0);
 	}
 
+	TEST_CASE("PublishComposer reports expiry once the interval has passed since it was queued")
+	{
+		MqttConnectionInfo connectionInfo;
+		PacketIdPool packetIdPool;
+		PublishOptions options;
+		options.addMessageExpiryInterval = true;
+		options.messageExpiryInterval = 2U;
+		ReceiveMaximumTracker tracker{ 65535 , 65535 };
+
+		const TimePoint now{ std::chrono::steady_clock::now() };
+		PublishComposer composer(&connectionInfo, &packetIdPool, 0, "test/topic", kmMqtt::ByteBuffer(5), std::move(options), &tracker, false, now - std::chrono::seconds{ 5 });
+
+		CHECK(composer.isExpired(now));
+		CHECK_FALSE(composer.isExpired(now - std::chrono::seconds{ 4 }));
+	}
+
+	TEST_CASE("PublishComposer never expires a retry of a publish already sent")
+	{
+		MqttConnectionInfo connectionInfo;
+		PacketIdPool packetIdPool;
+		PublishOptions options;
+		options.addMessageExpiryInterval = true;
+		options.messageExpiryInterval = 2U;
+		ReceiveMaximumTracker tracker{ 65535 , 65535 };
+
+		const TimePoint now{ std::chrono::steady_clock::now() };
+		PublishComposer composer(&connectionInfo, &packetIdPool, 1, "test/topic", kmMqtt::ByteBuffer(5), std::move(options), &tracker, true, now - std::chrono::seconds{ 5 });
+
+		CHECK_FALSE(composer.isExpired(now));
+	}
+
+	TEST_CASE("PublishComposer sends the expiry interval left after the time spent queued")
+	{
+		MqttConnectionInfo connectionInfo;
+		PacketIdPool packetIdPool;
+		PublishOptions options;
+		options.addMessageExpiryInterval = true;
+		options.messageExpiryInterval = 10U;
+		ReceiveMaximumTracker tracker{ 65535 , 65535 };
+
+		PublishComposer composer(&connectionInfo, &packetIdPool, 0, "test/topic", kmMqtt::ByteBuffer(5), std::move(options), &tracker, false, std::chrono::steady_clock::now() - std::chrono::milliseconds{ 5500 });
+		ComposeResult result = composer.compose();
+		REQUIRE(result.encodeResult.isSuccess());
+
+		Publish packet{ std::move(result.encodedData) };
+		REQUIRE(packet.decode().isSuccess());
+
+		const std::uint32_t* expiryInterval{ nullptr };
+		REQUIRE(packet.getVariableHeader().properties.tryGetProperty<std::uint32_t>(PropertyType::MESSAGE_EXPIRY_INTERVAL, expiryInterval));
+		CHECK(*expiryInterval == 5U);
+	}
+
 	TEST_CASE("SubscribeComposer compose creates valid packet")
 	{
 		MqttConnectionInfo connectionInfo;
@@ -341,7 +395,7 @@ TEST_SUITE("PacketComposer Tests")
 		PublishOptions pubOptions;
 		pubOptions.qos = Qos::QOS_1;
 		ReceiveMaximumTracker tracker{ 65535 , 65535 };
-		PublishComposer publishComposer(&connectionInfo, &packetIdPool, pubId, "test/topic", std::move(payload), std::move(pubOptions), &tracker, false);
+		PublishComposer publishComposer(&connectionInfo, &packetIdPool, pubId, "test/topic", std::move(payload), std::move(pubOptions), &tracker, false, std::chrono::steady_clock::now());
 		ComposeResult publishResult = publishComposer.compose();
 
 		CHECK(connectResult.encodeResult.isSuccess());
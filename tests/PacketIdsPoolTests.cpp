@@ -82,4 +82,32 @@ TEST_SUITE("Packet Utils Tests")
 		CHECK(reused == id1); // id1 should be reused once
 		CHECK(next == 3);     // Next should be the next incremented value
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Reserve rejects IDs outside the pool")
+	{
+		PacketIdPool pool;
+
+		CHECK_FALSE(pool.reserveId(0));
+		CHECK_FALSE(pool.reserveId(static_cast<std::uint16_t>(PACKET_POOL_ID_SIZE)));
+		pool.releaseId(static_cast<std::uint16_t>(PACKET_POOL_ID_SIZE)); // Should do nothing
+
+		CHECK(pool.reserveId(static_cast<std::uint16_t>(PACKET_POOL_ID_SIZE - 1U)));
+		CHECK(pool.getId() == 1);
+	}
+
+	TEST_CASE("Exhausted pool returns 0")
+	{
+		PacketIdPool pool;
+		CHECK(pool.reserveId(static_cast<std::uint16_t>(PACKET_POOL_ID_SIZE - 1U)));
+
+		for (std::uint32_t i = 1; i < PACKET_POOL_ID_SIZE - 1U; ++i)
+		{
+			pool.getId();
+		}
+
+		CHECK(pool.getId() == 0);
+
+		pool.releaseId(7);
+		CHECK(pool.getId() == 7);
+	}
+}
@@ -0,0 +1,188 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#if !defined(_WIN32) && !defined(_WIN64)
+
+#include <doctest.h>
+#include <kmMqtt/Sockets/PosixTCPSocket.h>
+#include <kmMqtt/Mqtt/Transport/SendQueue.h>
+#include <kmMqtt/Mqtt/Transport/Jobs/PingComposer.h>
+#include <kmMqtt/Mqtt/ReceiveMaximumTracker.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+namespace
+{
+	//Loopback listener accepting a single connection.
+	struct LoopbackListener
+	{
+		LoopbackListener()
+		{
+			listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			address.sin_port = 0;
+			::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+			::listen(listenSocket, 1);
+
+			socklen_t addressSize{ sizeof(address) };
+			::getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &addressSize);
+			port = std::to_string(ntohs(address.sin_port));
+		}
+
+		~LoopbackListener()
+		{
+			if (peerSocket >= 0) ::close(peerSocket);
+			if (listenSocket >= 0) ::close(listenSocket);
+		}
+
+		//Ticks the socket until it connected and the listener accepted it.
+		bool connect(PosixTCPSocket& socket)
+		{
+			if (!socket.connect(Address::createIp4("", "127.0.0.1", port.c_str(), "")))
+			{
+				return false;
+			}
+
+			peerSocket = ::accept(listenSocket, nullptr, nullptr);
+			return tickUntil(socket, [&socket]() { return socket.isConnected(); }) && peerSocket >= 0;
+		}
+
+		template<typename Predicate>
+		static bool tickUntil(PosixTCPSocket& socket, Predicate predicate)
+		{
+			const auto timeout{ std::chrono::steady_clock::now() + std::chrono::seconds(5) };
+			while (!predicate())
+			{
+				if (std::chrono::steady_clock::now() > timeout)
+				{
+					return false;
+				}
+
+				socket.tick();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+
+			return true;
+		}
+
+		int listenSocket{ -1 };
+		int peerSocket{ -1 };
+		std::string port;
+	};
+
+	int getTcpNoDelay(int handle)
+	{
+		int value{ -1 };
+		socklen_t valueSize{ sizeof(value) };
+		::getsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &value, &valueSize);
+		return value;
+	}
+}
+
+TEST_SUITE("PosixTCPSocket Tests")
+{
+	TEST_CASE("Connects, exchanges data and exposes its descriptor")
+	{
+		LoopbackListener listener;
+		PosixTCPSocket socket;
+
+		bool isConnected{ false };
+		std::string received;
+		socket.setOnConnectCallback([&](bool success) { isConnected = success; });
+		socket.setOnRecvdCallback([&](ByteBuffer&& data) { received.append(reinterpret_cast<const char*>(data.bytes()), data.size()); });
+
+		CHECK(socket.getNativeHandle() == -1);
+		REQUIRE(listener.connect(socket));
+		CHECK(isConnected);
+		CHECK(socket.getNativeHandle() >= 0);
+
+		ByteBuffer data{ 4 };
+		data.append(reinterpret_cast<const std::uint8_t*>("ping"), 4);
+		CHECK(socket.send(data) == 4);
+
+		char peerBuffer[4]{};
+		CHECK(::recv(listener.peerSocket, peerBuffer, sizeof(peerBuffer), MSG_WAITALL) == 4);
+		CHECK(std::memcmp(peerBuffer, "ping", 4) == 0);
+
+		CHECK(::send(listener.peerSocket, "pong", 4, 0) == 4);
+		CHECK(LoopbackListener::tickUntil(socket, [&]() { return received.size() == 4; }));
+		CHECK(received == "pong");
+
+		socket.close();
+		CHECK(socket.getNativeHandle() == -1);
+		CHECK_FALSE(socket.isConnected());
+	}
+
+	TEST_CASE("Disconnect is reported when the peer closes")
+	{
+		LoopbackListener listener;
+		PosixTCPSocket socket;
+
+		bool isDisconnected{ false };
+		socket.setOnDisconnectCallback([&]() { isDisconnected = true; });
+
+		REQUIRE(listener.connect(socket));
+
+		::close(listener.peerSocket);
+		listener.peerSocket = -1;
+
+		CHECK(LoopbackListener::tickUntil(socket, [&]() { return isDisconnected; }));
+		CHECK_FALSE(socket.isConnected());
+		CHECK(socket.getNativeHandle() == -1);
+	}
+
+	TEST_CASE("SendQueue sets TCP_NODELAY on the socket with manageTcpOptions")
+	{
+		LoopbackListener listener;
+		auto socket{ std::make_shared<PosixTCPSocket>() };
+		REQUIRE(listener.connect(*socket));
+		CHECK(getTcpNoDelay(socket->getNativeHandle()) == 0);
+
+		SendQueueOptions options;
+		options.manageTcpOptions = true;
+
+		MqttConnectionInfo connectionInfo;
+		ReceiveMaximumTracker tracker{ 100U, 100U };
+		SendQueue queue;
+		queue.setSocket(socket);
+		queue.setReceiveMaximumTracker(&tracker);
+		queue.setOptions(options);
+		queue.setOnPingSentCallback([]() {});
+		queue.setOnPubCompSentCallback([](std::uint16_t) {});
+		queue.setOnPubRelSentCallback([](std::uint16_t) {});
+		queue.setOnPubRecSentCallback([](std::uint16_t) {});
+		queue.setOnDisconnectSentCallback([]() {});
+
+		queue.addToQueue(std::make_unique<PingComposer>(&connectionInfo));
+
+		SendBatchResult result;
+		queue.sendNextBatch(result);
+
+		CHECK(result.totalBytesSent == 2);
+		CHECK(getTcpNoDelay(socket->getNativeHandle()) != 0);
+
+		std::uint8_t ping[2]{};
+		CHECK(::recv(listener.peerSocket, ping, sizeof(ping), MSG_WAITALL) == 2);
+		CHECK(ping[0] == 0xC0);
+	}
+}
+
+#endif //!defined(_WIN32) && !defined(_WIN64)
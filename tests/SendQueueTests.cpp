@@ -0,0 +1,485 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <doctest.h>
+#include <kmMqtt/Mqtt/Transport/SendQueue.h>
+#include <kmMqtt/Mqtt/ClientMetrics.h>
+#include <kmMqtt/Mqtt/ReceiveMaximumTracker.h>
+#include "API Tests/MockWebSocket.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+namespace
+{
+	//Composes `size` bytes of `marker`, so the order packets went out in can be read back from the sent bytes.
+	class MarkerComposer : public IPacketComposer
+	{
+	public:
+		MarkerComposer(PacketType type, std::uint8_t marker, std::size_t size, Qos qos = Qos::QOS_0) noexcept
+			: IPacketComposer(nullptr), m_type{ type }, m_marker{ marker }, m_size{ size }, m_qos{ qos }
+		{
+		}
+
+		ComposeResult compose() noexcept override
+		{
+			EncodeResult result;
+			result.packetType = m_type;
+			result.packetId = m_marker;
+
+			ByteBuffer data{ m_size };
+			for (std::size_t i = 0; i < m_size; ++i)
+			{
+				data += m_marker;
+			}
+
+			return ComposeResult{ result, std::move(data) };
+		}
+
+		Qos getQos() const noexcept override { return m_qos; }
+		std::size_t getEstimatedSize() const noexcept override { return m_size; }
+
+		SendPriority getPriority() const noexcept override
+		{
+			if (m_type == PacketType::DISCONNECT)
+			{
+				return SendPriority::DISCONNECT;
+			}
+
+			if (m_type != PacketType::PUBLISH)
+			{
+				return SendPriority::CONTROL;
+			}
+
+			return m_qos == Qos::QOS_0 ? SendPriority::BULK : SendPriority::QOS;
+		}
+
+		void cancel() noexcept override {}
+
+	private:
+		PacketType m_type;
+		std::uint8_t m_marker;
+		std::size_t m_size;
+		Qos m_qos;
+	};
+
+	//MarkerComposer whose message expiry has already passed.
+	class ExpiredComposer : public MarkerComposer
+	{
+	public:
+		ExpiredComposer(std::uint8_t marker, std::size_t size) noexcept
+			: MarkerComposer(PacketType::PUBLISH, marker, size, Qos::QOS_1)
+		{
+		}
+
+		bool isExpired(TimePoint now) const noexcept override { (void)now; return true; }
+		std::uint16_t getPacketId() const noexcept override { return 7U; }
+	};
+
+	//Accepts at most `budget` bytes until topped up again, to simulate a socket that only takes part of the buffer.
+	class BudgetWebSocket : public MockWebSocket
+	{
+	public:
+		std::size_t budget{ SIZE_MAX };
+		std::vector<std::uint8_t> sentBytes;
+
+		int send(const ByteBuffer& data) noexcept override
+		{
+			const std::size_t size{ std::min(budget, data.size()) };
+			sentBytes.insert(sentBytes.end(), data.bytes(), data.bytes() + size);
+			budget -= size;
+			return static_cast<int>(size);
+		}
+	};
+
+	struct CapturingTraceSink : public ITraceSink
+	{
+		void onTraceEvent(const TraceEvent& event) noexcept override
+		{
+			events.push_back(event);
+		}
+
+		std::vector<std::pair<TraceStage, std::uint16_t>> stages() const
+		{
+			std::vector<std::pair<TraceStage, std::uint16_t>> result;
+			for (const auto& event : events)
+			{
+				result.emplace_back(event.stage, event.packetId);
+			}
+
+			return result;
+		}
+
+		std::vector<TraceEvent> events;
+	};
+
+	struct SendQueueContext
+	{
+		SendQueueContext(const SendQueueOptions& options = {})
+		{
+			queue.setSocket(socket);
+			queue.setReceiveMaximumTracker(&tracker);
+			queue.setOptions(options);
+			queue.setOnPingSentCallback([this]() { ++pingsSent; });
+			queue.setOnPubCompSentCallback([](std::uint16_t) {});
+			queue.setOnPubRelSentCallback([](std::uint16_t) {});
+			queue.setOnPubRecSentCallback([this](std::uint16_t packetId) { pubRecsSent.push_back(packetId); });
+			queue.setOnDisconnectSentCallback([this]() { ++disconnectsSent; });
+		}
+
+		void add(PacketType type, std::uint8_t marker, std::size_t size, Qos qos = Qos::QOS_0)
+		{
+			queue.addToQueue(std::make_unique<MarkerComposer>(type, marker, size, qos));
+		}
+
+		//First byte of every `size` byte packet sent, in order.
+		std::vector<std::uint8_t> sentMarkers(std::size_t size) const
+		{
+			std::vector<std::uint8_t> markers;
+			for (std::size_t i = 0; i < socket->sentBytes.size(); i += size)
+			{
+				markers.push_back(socket->sentBytes[i]);
+			}
+
+			return markers;
+		}
+
+		std::shared_ptr<BudgetWebSocket> socket{ std::make_shared<BudgetWebSocket>() };
+		ReceiveMaximumTracker tracker{ 100U, 100U };
+		SendQueue queue;
+		SendBatchResult result;
+		int pingsSent{ 0 };
+		int disconnectsSent{ 0 };
+		std::vector<std::uint16_t> pubRecsSent;
+	};
+}
+
+TEST_SUITE("SendQueue Tests")
+{
+	TEST_CASE("Control packets are sent before publishes queued ahead of them")
+	{
+		SendQueueContext context;
+
+		context.add(PacketType::PUBLISH, 0x10, 8);
+		context.add(PacketType::PUBLISH, 0x11, 8);
+		context.add(PacketType::PUBLISH, 0x20, 8, Qos::QOS_1);
+		context.add(PacketType::PING_REQUQEST, 0xC0, 8);
+
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(8) == std::vector<std::uint8_t>{ 0xC0, 0x20, 0x10, 0x11 });
+		CHECK(context.pingsSent == 1);
+	}
+
+	TEST_CASE("Publish lanes are interleaved by weight")
+	{
+		SendQueueOptions options;
+		options.qosLaneWeight = 2U;
+		options.bulkLaneWeight = 1U;
+		SendQueueContext context{ options };
+
+		for (std::uint8_t i = 0; i < 4; ++i)
+		{
+			context.add(PacketType::PUBLISH, static_cast<std::uint8_t>(0x21 + i), 4, Qos::QOS_1);
+		}
+		context.add(PacketType::PUBLISH, 0x11, 4);
+		context.add(PacketType::PUBLISH, 0x12, 4);
+
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x21, 0x22, 0x11, 0x23, 0x24, 0x12 });
+	}
+
+	TEST_CASE("Publishes composed per batch are capped, control packets go ahead of the rest")
+	{
+		SendQueueOptions options;
+		options.maxBatchBytes = 100U;
+		SendQueueContext context{ options };
+
+		for (std::uint8_t i = 0; i < 6; ++i)
+		{
+			context.add(PacketType::PUBLISH, static_cast<std::uint8_t>(0x10 + i), 40);
+		}
+
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(40) == std::vector<std::uint8_t>{ 0x10, 0x11, 0x12 });
+
+		context.add(PacketType::PING_REQUQEST, 0xC0, 40);
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(40) == std::vector<std::uint8_t>{ 0x10, 0x11, 0x12, 0xC0, 0x13, 0x14 });
+	}
+
+	TEST_CASE("Graceful disconnect is sent after the publishes queued before it")
+	{
+		SendQueueOptions options;
+		options.maxBatchBytes = 100U;
+		SendQueueContext context{ options };
+
+		for (std::uint8_t i = 0; i < 3; ++i)
+		{
+			context.add(PacketType::PUBLISH, static_cast<std::uint8_t>(0x10 + i), 40);
+		}
+		context.add(PacketType::PUBLISH, 0x20, 40, Qos::QOS_1);
+		context.add(PacketType::DISCONNECT, 0xE0, 40);
+
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(40) == std::vector<std::uint8_t>{ 0x20, 0x10, 0x11 });
+		CHECK(context.disconnectsSent == 0);
+
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(40) == std::vector<std::uint8_t>{ 0x20, 0x10, 0x11, 0x12, 0xE0 });
+		CHECK(context.disconnectsSent == 1);
+	}
+
+	TEST_CASE("Nothing is sent after a partly sent disconnect")
+	{
+		SendQueueContext context;
+
+		context.add(PacketType::PUBLISH, 0x10, 4);
+		context.add(PacketType::DISCONNECT, 0xE0, 4);
+
+		context.socket->budget = 6U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.disconnectsSent == 0);
+
+		context.add(PacketType::PING_REQUQEST, 0xC0, 4);
+		context.add(PacketType::PUBLISH, 0x11, 4);
+		context.queue.addAcknowledgement(PacketType::PUBLISH_ACKNOWLEDGE, 1U);
+
+		context.socket->budget = SIZE_MAX;
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x10, 0xE0 });
+		CHECK(context.disconnectsSent == 1);
+		CHECK(context.pingsSent == 0);
+	}
+
+	TEST_CASE("Queued bytes follow packets added, composed and cleared")
+	{
+		SendQueueOptions options;
+		options.maxBatchBytes = 100U;
+		SendQueueContext context{ options };
+
+		for (std::uint8_t i = 0; i < 6; ++i)
+		{
+			context.add(PacketType::PUBLISH, static_cast<std::uint8_t>(0x10 + i), 40);
+		}
+
+		std::size_t queuedBytes{ 0U };
+		std::size_t sendBufferBytes{ 0U };
+		context.queue.getQueuedBytes(queuedBytes, sendBufferBytes);
+		CHECK(queuedBytes == 240U);
+
+		context.queue.sendNextBatch(context.result);
+		context.queue.getQueuedBytes(queuedBytes, sendBufferBytes);
+		CHECK(queuedBytes == 120U);
+
+		context.queue.clearQueue(false);
+		context.queue.getQueuedBytes(queuedBytes, sendBufferBytes);
+		CHECK(queuedBytes == 0U);
+	}
+
+	TEST_CASE("Sent callbacks fire once a packet is fully sent across partial sends")
+	{
+		SendQueueContext context;
+
+		context.add(PacketType::PING_REQUQEST, 0xC0, 2);
+		context.add(PacketType::PUBLISH_RECEIVED, 0x07, 4);
+
+		context.socket->budget = 1U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.pingsSent == 0);
+
+		context.socket->budget = 2U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.pingsSent == 1);
+		CHECK(context.pubRecsSent.empty());
+
+		context.socket->budget = 10U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.pingsSent == 1);
+		CHECK(context.pubRecsSent == std::vector<std::uint16_t>{ 0x07 });
+	}
+
+	TEST_CASE("Sent packet metrics are recorded once the socket took the whole packet")
+	{
+		SendQueueContext context;
+		ClientMetrics metrics;
+		context.queue.setMetrics(&metrics);
+
+		context.add(PacketType::PUBLISH, 0x21, 8, Qos::QOS_1);
+
+		context.socket->budget = 4U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(metrics.snapshot().packetsSent[static_cast<std::size_t>(PacketType::PUBLISH)] == 0U);
+
+		//Acknowledged before the publish was fully sent, no latency is started yet.
+		metrics.markPublishAcknowledged(0x21, std::chrono::steady_clock::now());
+		CHECK(metrics.snapshot().publishAckLatency.count == 0U);
+
+		context.socket->budget = SIZE_MAX;
+		context.queue.sendNextBatch(context.result);
+
+		const MqttClientMetrics sent{ metrics.snapshot() };
+		CHECK(sent.packetsSent[static_cast<std::size_t>(PacketType::PUBLISH)] == 1U);
+		CHECK(sent.bytesSent[static_cast<std::size_t>(PacketType::PUBLISH)] == 8U);
+
+		metrics.markPublishAcknowledged(0x21, std::chrono::steady_clock::now());
+		CHECK(metrics.snapshot().publishAckLatency.count == 1U);
+	}
+
+	TEST_CASE("Threshold flush holds publishes until enough are queued")
+	{
+		SendQueueOptions options;
+		options.flushMode = FlushMode::THRESHOLD;
+		options.flushPackets = 3U;
+		options.flushDelay = std::chrono::seconds{ 10 };
+		SendQueueContext context{ options };
+
+		context.add(PacketType::PUBLISH, 0x10, 4);
+		context.add(PacketType::PUBLISH, 0x11, 4);
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.socket->sentBytes.empty());
+		const TimePoint now{ std::chrono::steady_clock::now() };
+		CHECK(context.queue.nextSendTime(now) > now);
+
+		context.add(PacketType::PUBLISH, 0x12, 4);
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x10, 0x11, 0x12 });
+	}
+
+	TEST_CASE("Threshold flush sends held publishes once the flush delay passes")
+	{
+		SendQueueOptions options;
+		options.flushMode = FlushMode::THRESHOLD;
+		options.flushDelay = std::chrono::milliseconds{ 2 };
+		SendQueueContext context{ options };
+
+		context.add(PacketType::PUBLISH, 0x10, 4);
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.socket->sentBytes.empty());
+
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 5 });
+		const TimePoint now{ std::chrono::steady_clock::now() };
+		CHECK(context.queue.nextFlushTime(now) == now);
+
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x10 });
+	}
+
+	TEST_CASE("Held publishes go out together with a control packet")
+	{
+		SendQueueOptions options;
+		options.flushMode = FlushMode::THRESHOLD;
+		options.flushDelay = std::chrono::seconds{ 10 };
+		SendQueueContext context{ options };
+
+		context.add(PacketType::PUBLISH, 0x10, 4);
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.socket->sentBytes.empty());
+
+		context.add(PacketType::PING_REQUQEST, 0xC0, 4);
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0xC0, 0x10 });
+	}
+
+	TEST_CASE("Adaptive flush sends straight away when idle and grows batches under load")
+	{
+		SendQueueOptions options;
+		options.flushMode = FlushMode::ADAPTIVE;
+		options.flushPackets = 8U;
+		options.flushDelay = std::chrono::seconds{ 10 };
+		SendQueueContext context{ options };
+
+		//Idle link, first publish is flushed straight away.
+		context.add(PacketType::PUBLISH, 0x10, 4);
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x10 });
+
+		//Publish right after a flush reaches the threshold of 1, which then doubles.
+		context.add(PacketType::PUBLISH, 0x11, 4);
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x10, 0x11 });
+
+		context.add(PacketType::PUBLISH, 0x12, 4);
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(4).size() == 2U);
+
+		context.add(PacketType::PUBLISH, 0x13, 4);
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x10, 0x11, 0x12, 0x13 });
+	}
+
+	TEST_CASE("Expired publishes are dropped before they are composed")
+	{
+		SendQueueContext context;
+		std::vector<std::uint16_t> expiredIds;
+		context.queue.setOnPublishExpiredCallback([&expiredIds](std::uint16_t packetId) { expiredIds.push_back(packetId); });
+
+		context.queue.addToQueue(std::make_unique<ExpiredComposer>(0x20, 4));
+		context.add(PacketType::PUBLISH, 0x21, 4, Qos::QOS_1);
+		context.queue.sendNextBatch(context.result);
+
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x21 });
+		CHECK(context.queue.getExpiredCount() == 1U);
+		CHECK(expiredIds == std::vector<std::uint16_t>{ 7U });
+	}
+
+	TEST_CASE("Publish expired listener can queue packets from the callback")
+	{
+		SendQueueContext context;
+		bool isRequeued{ false };
+		context.queue.setOnPublishExpiredCallback([&](std::uint16_t)
+			{
+				//Would deadlock if the listener was called with the queue locked.
+				context.add(PacketType::PUBLISH, 0x22, 4, Qos::QOS_1);
+				isRequeued = true;
+			});
+
+		context.queue.addToQueue(std::make_unique<ExpiredComposer>(0x20, 4));
+		context.queue.sendNextBatch(context.result);
+		REQUIRE(isRequeued);
+
+		context.queue.sendNextBatch(context.result);
+		CHECK(context.sentMarkers(4) == std::vector<std::uint8_t>{ 0x22 });
+	}
+
+	TEST_CASE("Trace stamps the first and last byte of each packet across partial sends")
+	{
+		SendQueueContext context;
+		CapturingTraceSink sink;
+		context.queue.setTraceSink(&sink);
+
+		context.add(PacketType::PUBLISH, 0x10, 4);
+		context.add(PacketType::PUBLISH, 0x11, 4);
+
+		using Stages = std::vector<std::pair<TraceStage, std::uint16_t>>;
+
+		context.socket->budget = 2U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(sink.stages() == Stages{ { TraceStage::COMPOSED, 0x10 }, { TraceStage::COMPOSED, 0x11 }, { TraceStage::FIRST_BYTE_SENT, 0x10 } });
+
+		sink.events.clear();
+		context.socket->budget = 4U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(sink.stages() == Stages{ { TraceStage::LAST_BYTE_SENT, 0x10 }, { TraceStage::FIRST_BYTE_SENT, 0x11 } });
+
+		sink.events.clear();
+		context.socket->budget = 10U;
+		context.queue.sendNextBatch(context.result);
+		CHECK(sink.stages() == Stages{ { TraceStage::LAST_BYTE_SENT, 0x11 } });
+		CHECK(sink.events[0].bytes == 4U);
+	}
+}
@@ -9,9 +9,24 @@
 #include <kmMqtt/Mqtt/State/SessionState/ISessionStatePersistantStore.h>
 #include <kmMqtt/Mqtt/State/SessionState/MessageContainer.h>
 #include <kmMqtt/Mqtt/State/SessionState/MessageContainerData.h>
+#include <kmMqtt/Mqtt/State/SessionState/WalSessionStatePersistantStore.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if defined(_WIN32)
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 using namespace kmMqtt;
 using namespace kmMqtt::mqtt;
 
@@ -51,7 +66,7 @@ namespace
             return true;
         }
 
-        bool readAll(const char* clientId, std::vector<const SavedData>& outData) override
+        bool readAll(const char* clientId, std::vector<SavedData>& outData) override
         {
             log.push_back("readAll:" + std::string(clientId));
             return true;
@@ -123,6 +138,312 @@ TEST_SUITE("SessionState Tests")
         CHECK(state.addMessage(46, std::move(msgData)) == ClientErrorCode::No_Error);
         state.clear();
     }
+
+    TEST_CASE("Payload and property bytes follow added and removed messages")
+    {
+        SessionState state("client7", 1000, 500);
+
+        ByteBuffer firstPayload{ 4 };
+        firstPayload += 0x01;
+        firstPayload += 0x02;
+        firstPayload += 0x03;
+        firstPayload += 0x04;
+
+        PublishOptions options;
+        options.qos = Qos::QOS_1;
+        options.responseTopic = "reply";
+        options.userProperties.emplace("key", "value");
+        CHECK(state.addMessage(47, { "a/b", std::move(firstPayload), std::move(options) }) == ClientErrorCode::No_Error);
+
+        CHECK(state.getPayloadBytes() == 7U);
+        CHECK(state.getPropertyBytes() == 13U);
+
+        ByteBuffer secondPayload{ 1 };
+        secondPayload += 0x05;
+        PublishOptions secondOptions;
+        secondOptions.qos = Qos::QOS_2;
+        CHECK(state.addMessage(48, { "c", std::move(secondPayload), std::move(secondOptions) }) == ClientErrorCode::No_Error);
+
+        CHECK(state.getPayloadBytes() == 9U);
+
+        state.removeMessage(47);
+        CHECK(state.getPayloadBytes() == 2U);
+        CHECK(state.getPropertyBytes() == 0U);
+
+        state.clear();
+        CHECK(state.getPayloadBytes() == 0U);
+    }
+
+    TEST_CASE("Changes are mirrored to persistant store")
+    {
+        auto store = std::make_shared<DummyPersistantStore>();
+        SessionState state("client7", 1000, 500, store);
+
+        CHECK(state.addMessage(47, createTestPublishMessageData()) == ClientErrorCode::No_Error);
+        state.updateMessage(47, PublishMessageStatus::WaitingForPubComp);
+        state.removeMessage(47);
+        state.clear();
+
+        REQUIRE(store->log.size() == 4);
+        CHECK(store->log[0] == "write:client7");
+        CHECK(store->log[1] == "update:client7");
+        CHECK(store->log[2] == "remove:client7");
+        CHECK(store->log[3] == "clear:client7");
+    }
+
+    TEST_CASE("restoreSavedMessages does not write back to store")
+    {
+        auto store = std::make_shared<DummyPersistantStore>();
+        SessionState state("client8", 1000, 500, store);
+
+        std::vector<SavedData> saved(1);
+        saved[0].packetID = 48;
+        saved[0].status = PublishMessageStatus::WaitingForPubComp;
+        saved[0].publishMsgData = createTestPublishMessageData();
+
+        CHECK(state.restoreSavedMessages(saved) == ClientErrorCode::No_Error);
+        CHECK(store->log.empty());
+
+        REQUIRE(state.messages().contains(48));
+        CHECK(state.messages().begin()->data.packetID == 48);
+        CHECK(state.messages().begin()->data.status == PublishMessageStatus::WaitingForPubComp);
+    }
+}
+
+TEST_SUITE("WalSessionStatePersistantStore Tests")
+{
+    /**
+     * @brief Unique directory under the system temp directory, removed with the files in it on destruction.
+     */
+    struct WalTestDirectory
+    {
+        explicit WalTestDirectory(const char* name)
+        {
+#if defined(_WIN32)
+            const char* temp{ std::getenv("TEMP") };
+            path = std::string{ temp != nullptr && *temp != '\0' ? temp : "." } + "\\";
+#else
+            const char* temp{ std::getenv("TMPDIR") };
+            path = std::string{ temp != nullptr && *temp != '\0' ? temp : "/tmp" } + "/";
+#endif
+            path += name + std::string{ "_" } + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+
+        ~WalTestDirectory()
+        {
+#if defined(_WIN32)
+            _finddata_t findData;
+            const intptr_t handle{ ::_findfirst((path + "\\*").c_str(), &findData) };
+            if (handle != -1)
+            {
+                do
+                {
+                    std::remove((path + "\\" + findData.name).c_str());
+                } while (::_findnext(handle, &findData) == 0);
+
+                ::_findclose(handle);
+            }
+
+            ::_rmdir(path.c_str());
+#else
+            if (DIR* dir{ ::opendir(path.c_str()) })
+            {
+                while (const dirent* entry{ ::readdir(dir) })
+                {
+                    std::remove((path + "/" + entry->d_name).c_str());
+                }
+
+                ::closedir(dir);
+            }
+
+            ::rmdir(path.c_str());
+#endif
+        }
+
+        std::string path;
+    };
+
+    WalSessionStoreOptions walTestOptions(const WalTestDirectory& directory)
+    {
+        WalSessionStoreOptions options;
+        options.directory = directory.path;
+        options.groupCommitIntervalMs = 1U;
+        return options;
+    }
+
+    SavedData walTestMessage(std::uint16_t packetId, const std::string& topic)
+    {
+        SavedData data;
+        data.packetID = packetId;
+        data.status = PublishMessageStatus::WaitingForAck;
+        data.publishMsgData = createTestPublishMessageData(topic);
+        data.publishMsgData.options.userProperties.emplace("key", "value");
+        data.publishMsgData.options.correlationData = std::make_unique<BinaryData>(std::uint16_t{ 2U }, reinterpret_cast<const std::uint8_t*>("id"));
+        return data;
+    }
+
+    TEST_CASE("readAll returns live messages in order")
+    {
+        const WalTestDirectory directory{ "wal_test_order" };
+        WalSessionStatePersistantStore store{ walTestOptions(directory) };
+        REQUIRE(store.initialize("client"));
+
+        CHECK(store.write("client", 1000U, walTestMessage(1U, "a")));
+        CHECK(store.write("client", 1000U, walTestMessage(2U, "b")));
+        CHECK(store.write("client", 1000U, walTestMessage(3U, "c")));
+        CHECK(store.updateMessage("client", 1U, PublishMessageStatus::WaitingForPubComp, true));
+        CHECK(store.removeMessage("client", 2U));
+        CHECK(store.flush());
+
+        std::vector<SavedData> data;
+        CHECK(store.readAll("client", data));
+        REQUIRE(data.size() == 2);
+        CHECK(data[0].packetID == 3U);
+        CHECK(data[0].publishMsgData.topic == "c");
+        CHECK(data[1].packetID == 1U);
+        CHECK(data[1].status == PublishMessageStatus::WaitingForPubComp);
+        CHECK(data[1].publishMsgData.payload.size() == 4);
+        CHECK(data[1].publishMsgData.options.qos == Qos::QOS_1);
+        CHECK(data[1].publishMsgData.options.userProperties.at("key") == "value");
+        REQUIRE(data[1].publishMsgData.options.correlationData != nullptr);
+        CHECK(data[1].publishMsgData.options.correlationData->size() == 2);
+
+        CHECK(store.removeFromStore("client"));
+    }
+
+    TEST_CASE("Messages are recovered by a new store instance")
+    {
+        const WalTestDirectory directory{ "wal_test_recover" };
+        {
+            WalSessionStatePersistantStore store{ walTestOptions(directory) };
+            CHECK(store.write("client", 1000U, walTestMessage(10U, "a")));
+            CHECK(store.write("client", 1000U, walTestMessage(11U, "b")));
+            CHECK(store.updateMessage("client", 10U, PublishMessageStatus::WaitingForPubComp, false));
+        }
+
+        WalSessionStatePersistantStore store{ walTestOptions(directory) };
+        std::vector<SavedData> data;
+        CHECK(store.readAll("client", data));
+        REQUIRE(data.size() == 2);
+        CHECK(data[0].packetID == 10U);
+        CHECK(data[0].status == PublishMessageStatus::WaitingForPubComp);
+        CHECK(data[1].packetID == 11U);
+
+        CHECK(store.removeFromStore("client"));
+    }
+
+    TEST_CASE("Torn record at end of log is dropped on recovery")
+    {
+        const WalTestDirectory directory{ "wal_test_torn" };
+        {
+            WalSessionStatePersistantStore store{ walTestOptions(directory) };
+            CHECK(store.write("client", 1000U, walTestMessage(20U, "a")));
+            CHECK(store.flush());
+            REQUIRE(store.getSegmentCount("client") == 1);
+        }
+
+        //Client ID "client" is hex encoded in the segment file name.
+        std::FILE* segment{ std::fopen((directory.path + "/636c69656e74-00000001.wal").c_str(), "ab") };
+        REQUIRE(segment != nullptr);
+        const std::uint8_t garbage[] = { 0x00, 0x00, 0x01, 0x00, 0xAB, 0xCD };
+        std::fwrite(garbage, 1, sizeof(garbage), segment);
+        std::fclose(segment);
+
+        WalSessionStatePersistantStore store{ walTestOptions(directory) };
+        CHECK(store.write("client", 1000U, walTestMessage(21U, "b")));
+        CHECK(store.flush());
+
+        WalSessionStatePersistantStore reopened{ walTestOptions(directory) };
+        std::vector<SavedData> data;
+        CHECK(reopened.readAll("client", data));
+        REQUIRE(data.size() == 2);
+        CHECK(data[0].packetID == 20U);
+        CHECK(data[1].packetID == 21U);
+
+        CHECK(reopened.removeFromStore("client"));
+    }
+
+    TEST_CASE("Compaction merges segments and keeps live messages")
+    {
+        const WalTestDirectory directory{ "wal_test_compact" };
+        WalSessionStoreOptions options{ walTestOptions(directory) };
+        options.segmentMaxBytes = 256U;
+        options.compactionMinBytes = static_cast<std::size_t>(-1);
+
+        WalSessionStatePersistantStore store{ options };
+        for (std::uint16_t id = 1U; id <= 20U; ++id)
+        {
+            CHECK(store.write("client", 1000U, walTestMessage(id, "topic")));
+            if (id % 4U != 0U)
+            {
+                CHECK(store.removeMessage("client", id));
+            }
+        }
+        CHECK(store.flush());
+        CHECK(store.getSegmentCount("client") > 1);
+
+        CHECK(store.compact("client"));
+        CHECK(store.getSegmentCount("client") == 1);
+
+        std::vector<SavedData> data;
+        CHECK(store.readAll("client", data));
+        REQUIRE(data.size() == 5);
+        CHECK(data[0].packetID == 4U);
+        CHECK(data[4].packetID == 20U);
+
+        CHECK(store.removeFromStore("client"));
+        CHECK(store.getSegmentCount("client") == 0);
+    }
+
+    TEST_CASE("notifyWhenDurable completes once earlier writes are committed")
+    {
+        const WalTestDirectory directory{ "wal_test_durable" };
+        WalSessionStatePersistantStore store{ walTestOptions(directory) };
+
+        bool isIdleDurable{ false };
+        store.notifyWhenDurable([&](bool success) { isIdleDurable = success; });
+        CHECK(isIdleDurable);
+
+        CHECK(store.write("client", 1000U, walTestMessage(1U, "a")));
+
+        std::atomic<int> completedCount{ 0 };
+        std::atomic<bool> isDurable{ false };
+        store.notifyWhenDurable([&](bool success) { isDurable = success; ++completedCount; });
+
+        CHECK(store.flush());
+
+        //Callbacks run on the commit thread right after the commit flush() waits for.
+        const auto timeout{ std::chrono::steady_clock::now() + std::chrono::seconds(5) };
+        while (completedCount == 0 && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::yield();
+        }
+
+        CHECK(isDurable);
+        CHECK(completedCount == 1);
+
+        CHECK(store.removeFromStore("client"));
+    }
+
+    TEST_CASE("removeExpiredFromStore removes logs without live messages")
+    {
+        const WalTestDirectory directory{ "wal_test_expired" };
+        {
+            WalSessionStatePersistantStore store{ walTestOptions(directory) };
+            CHECK(store.write("done", 1000U, walTestMessage(1U, "a")));
+            CHECK(store.removeMessage("done", 1U));
+            CHECK(store.write("expired", 0U, walTestMessage(1U, "a")));
+            CHECK(store.write("live", 1000U, walTestMessage(1U, "a")));
+        }
+
+        WalSessionStatePersistantStore store{ walTestOptions(directory) };
+        CHECK(store.removeExpiredFromStore());
+        CHECK(store.getSegmentCount("done") == 0);
+        CHECK(store.getSegmentCount("expired") == 0);
+        CHECK(store.getSegmentCount("live") == 1);
+
+        CHECK(store.removeFromStore("live"));
+    }
 }
 
 TEST_SUITE("MessageContainerData Tests")
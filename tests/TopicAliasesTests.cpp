@@ -6,6 +6,7 @@
 #include <doctest.h>
 #include <kmMqtt/Mqtt/TopicAliases.h>
 #include <cstring>
+#include <string>
 
 TEST_SUITE("Topic Aliases")
 {
@@ -75,4 +76,35 @@ TEST_SUITE("Topic Aliases")
 		CHECK_FALSE(aliases.tryFindTopicName(42, out));
 		CHECK(out == nullptr);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Topic name outlives the string it was added from")
+	{
+		TopicAliases aliases;
+		const char* out = nullptr;
+
+		{
+			std::string topic{ "sensor/pressure" };
+			CHECK(aliases.tryAddTopicAlias(topic.c_str(), 3));
+			topic.assign("overwritten/topic");
+		}
+
+		CHECK(aliases.tryFindTopicName(3, out));
+		CHECK(std::strcmp(out, "sensor/pressure") == 0);
+	}
+
+	TEST_CASE("Topic name bytes")
+	{
+		TopicAliases aliases;
+		CHECK(aliases.getTopicNameBytes() == 0U);
+
+		CHECK(aliases.tryAddTopicAlias("abc", 1));
+		CHECK(aliases.tryAddTopicAlias("defgh", 2));
+		CHECK(aliases.getTopicNameBytes() == 8U);
+
+		CHECK(aliases.tryAddTopicAlias("xy", 2));
+		CHECK(aliases.getTopicNameBytes() == 5U);
+
+		CHECK(aliases.tryAddTopicAlias("xy", 2));
+		CHECK(aliases.getTopicNameBytes() == 5U);
+	}
+}
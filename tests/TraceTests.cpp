@@ -0,0 +1,116 @@
+// kmMqtt (https://github.com/KMiseckas/kmMqtt)
+// Copyright (c) 2026 Klaudijus Miseckas
+// Licensed under the Apache License, Version 2.0
+// See LICENSE file in the project root for full license information.
+
+#include <doctest.h>
+#include <kmMqtt/Mqtt/Tracing/BinaryTraceFileSink.h>
+#include <kmMqtt/Mqtt/Tracing/WireCaptureFileSink.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace kmMqtt;
+using namespace kmMqtt::mqtt;
+
+TEST_SUITE("Trace Tests")
+{
+	TEST_CASE("Binary trace file reads back the events written to it")
+	{
+		const std::string path{ "trace_test.kmtrace" };
+		const TimePoint start{ std::chrono::steady_clock::now() };
+
+		{
+			//Buffer of two records, so the third event writes the first two to the file.
+			BinaryTraceFileSink sink{ path, 2U * BinaryTraceFileSink::k_recordSize };
+			REQUIRE(sink.isOpen());
+
+			sink.onTraceEvent({ TraceStage::PUBLISH_QUEUED, PacketType::PUBLISH, 1U, 12U, start });
+			sink.onTraceEvent({ TraceStage::LAST_BYTE_SENT, PacketType::PUBLISH, 1U, 30U, start + std::chrono::microseconds(250) });
+			sink.onTraceEvent({ TraceStage::ACK_RECEIVED, PacketType::PUBLISH_ACKNOWLEDGE, 0xBEEFU, 0U, start + std::chrono::milliseconds(3) });
+			sink.flush();
+			sink.onTraceEvent({ TraceStage::CALLBACK_COMPLETED, PacketType::PUBLISH, 65535U, 0xFFFFFFFFU, start + std::chrono::seconds(1) });
+		}
+
+		std::vector<TraceEvent> events;
+		REQUIRE(BinaryTraceFileSink::readFile(path, events));
+		std::remove(path.c_str());
+
+		REQUIRE(events.size() == 4U);
+		CHECK(events[0].stage == TraceStage::PUBLISH_QUEUED);
+		CHECK(events[0].packetType == PacketType::PUBLISH);
+		CHECK(events[0].packetId == 1U);
+		CHECK(events[0].bytes == 12U);
+		CHECK(events[1].time - events[0].time == std::chrono::microseconds(250));
+		CHECK(events[2].stage == TraceStage::ACK_RECEIVED);
+		CHECK(events[2].packetType == PacketType::PUBLISH_ACKNOWLEDGE);
+		CHECK(events[2].packetId == 0xBEEFU);
+		CHECK(events[3].packetId == 65535U);
+		CHECK(events[3].bytes == 0xFFFFFFFFU);
+		CHECK(events[3].time - events[0].time == std::chrono::seconds(1));
+	}
+
+	TEST_CASE("Binary trace file rejects other files")
+	{
+		const std::string path{ "trace_test_invalid.kmtrace" };
+
+		std::FILE* file{ std::fopen(path.c_str(), "wb") };
+		REQUIRE(file != nullptr);
+		std::fputs("NOTATRACE", file);
+		std::fclose(file);
+
+		std::vector<TraceEvent> events;
+		CHECK_FALSE(BinaryTraceFileSink::readFile(path, events));
+		CHECK_FALSE(BinaryTraceFileSink::readFile("missing.kmtrace", events));
+		std::remove(path.c_str());
+	}
+
+	TEST_CASE("Wire capture file reads back the bytes written to it")
+	{
+		const std::string path{ "wire_capture_test.kmwire" };
+		const TimePoint start{ std::chrono::steady_clock::now() };
+
+		const std::vector<std::uint8_t> connAck{ 0x20, 0x03, 0x00, 0x00, 0x00 };
+		const std::vector<std::uint8_t> large(64U, 0xA5U);
+
+		{
+			//A buffer smaller than the large record, which is written straight through after the buffered ones.
+			WireCaptureFileSink sink{ path, 32U };
+			REQUIRE(sink.isOpen());
+
+			sink.onWireBytes(WireDirection::SENT, connAck.data(), 2U, start);
+			sink.onWireBytes(WireDirection::RECEIVED, connAck.data(), connAck.size(), start + std::chrono::microseconds(250));
+			sink.onWireBytes(WireDirection::RECEIVED, large.data(), large.size(), start + std::chrono::milliseconds(3));
+			sink.onWireBytes(WireDirection::SENT, connAck.data(), 0U, start + std::chrono::seconds(1)); //Nothing sent, not recorded.
+		}
+
+		std::vector<WireCaptureRecord> records;
+		REQUIRE(WireCaptureFileSink::readFile(path, records));
+
+		REQUIRE(records.size() == 3U);
+		CHECK(records[0].direction == WireDirection::SENT);
+		CHECK(records[0].bytes == std::vector<std::uint8_t>{ 0x20, 0x03 });
+		CHECK(records[1].direction == WireDirection::RECEIVED);
+		CHECK(records[1].bytes == connAck);
+		CHECK(records[1].time - records[0].time == std::chrono::microseconds(250));
+		CHECK(records[2].bytes == large);
+		CHECK(records[2].time - records[0].time == std::chrono::milliseconds(3));
+
+		//A record cut short, e.g. by a crash while writing, is dropped.
+		std::FILE* file{ std::fopen(path.c_str(), "ab") };
+		REQUIRE(file != nullptr);
+		const std::uint8_t partial[]{ 0x01, 0x02, 0x03 };
+		std::fwrite(partial, 1U, sizeof(partial), file);
+		std::fclose(file);
+
+		records.clear();
+		REQUIRE(WireCaptureFileSink::readFile(path, records));
+		CHECK(records.size() == 3U);
+
+		std::remove(path.c_str());
+
+		CHECK_FALSE(WireCaptureFileSink::readFile("missing.kmwire", records));
+	}
+}
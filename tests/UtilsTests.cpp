@@ -183,4 +183,43 @@ TEST_SUITE("Utils Tests")
 
 		CHECK(leftOverPos == 0);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Split Up MQTT packets - fixed header cut short is left over")
+	{
+		using namespace kmMqtt;
+
+		//PUBACK followed by the first bytes of a packet with a 2-byte remaining length (300).
+		const std::uint8_t bytes[7]{ 0x40, 0x02, 0x00, 0x01, 0x30, 0xAC, 0x02 };
+
+		std::vector<ByteBuffer> packets;
+		std::size_t leftOverPos{ 0 };
+
+		//Only the packet type byte.
+		ByteBuffer typeOnly{ 5 };
+		typeOnly.append(bytes, 5);
+		CHECK(separateMqttPacketByteBuffers(typeOnly, packets, leftOverPos));
+		CHECK(packets.size() == 1);
+		CHECK(leftOverPos == 1);
+
+		//Remaining length missing its second byte.
+		ByteBuffer partialLength{ 6 };
+		partialLength.append(bytes, 6);
+		CHECK(separateMqttPacketByteBuffers(partialLength, packets, leftOverPos));
+		CHECK(packets.size() == 1);
+		CHECK(leftOverPos == 2);
+
+		//Whole fixed header, body missing.
+		ByteBuffer headerOnly{ 7 };
+		headerOnly.append(bytes, 7);
+		CHECK(separateMqttPacketByteBuffers(headerOnly, packets, leftOverPos));
+		CHECK(packets.size() == 1);
+		CHECK(leftOverPos == 3);
+
+		//Nothing complete at all.
+		ByteBuffer lengthOnly{ 2 };
+		lengthOnly.append(bytes + 4, 2);
+		CHECK_FALSE(separateMqttPacketByteBuffers(lengthOnly, packets, leftOverPos));
+		CHECK(packets.empty());
+		CHECK(leftOverPos == 2);
+	}
+}